@@ -28,6 +28,7 @@
 #include <tfcp/exact.h>
 
 namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
 
     //======================================================================
     //
@@ -190,8 +191,8 @@ namespace tfcp {
     {
         T q0, r0, r1, r, y;
         q0 = x0 / y0;
-        r0 = fnmadd(q0, y0, x0);  // r = x - q0*y
-        r1 = fnmadd(q0, y1, x1);
+        r0 = exact_fnmadd(q0, y0, x0);  // r = x - q0*y
+        r1 = fast_fnmadd(q0, y1, x1);
         r = r0 + r1;              // main part of twofold r0 + r1
         y = y0 + y1;
         z1 = r / y;
@@ -203,7 +204,7 @@ namespace tfcp {
     {
         T q0, r0, r1, r;
         q0 = x0 / y0;
-        r0 = fnmadd(q0, y0, x0);  // r = x - q0*y
+        r0 = exact_fnmadd(q0, y0, x0);  // r = x - q0*y
         r1 = x1;
         r = r0 + r1;              // main part of remainder
         z1 = r / y0;
@@ -215,7 +216,7 @@ namespace tfcp {
     {
         T q0, r0, r1, r, y;
         q0 = x0 / y0;
-        r0 = fnmadd(q0, y0, x0);  // r = x - q0*y
+        r0 = exact_fnmadd(q0, y0, x0);  // r = x - q0*y
         r1 =       -q0 * y1;
         r = r0 + r1;              // main part remainder
         y = y0 + y1;
@@ -228,7 +229,7 @@ namespace tfcp {
     {
         T q0, r0;
         q0 = x0 / y0;
-        r0 = fnmadd(q0, y0, x0);  // r = x - q0*y
+        r0 = exact_fnmadd(q0, y0, x0);  // r = x - q0*y
         z1 = r0 / y0;
         return q0;
     }
@@ -239,8 +240,8 @@ namespace tfcp {
     {
         T q0, r0, r1, r;
         q0 = x0 / y0;
-        r0 = fnmadd(q0, y0, x0);  // r = x - q0*y
-        r1 = fnmadd(q0, y1, x1);
+        r0 = exact_fnmadd(q0, y0, x0);  // r = x - q0*y
+        r1 = fast_fnmadd(q0, y1, x1);
         r = r0 + r1;              // main part of remainder
         z1 = r / y0;
         return q0;
@@ -257,7 +258,7 @@ namespace tfcp {
     {
         T r0, r1;
         r0 = hw_sqrt(x0);
-        r1 = fnmadd(r0, r0, x0);  // r = x - sqrt(x)^2
+        r1 = exact_fnmadd(r0, r0, x0);  // r = x - sqrt(x)^2
         z1 = r1 / (r0 + r0);      // Newton iteration
         return r0;
     }
@@ -268,7 +269,7 @@ namespace tfcp {
     {
         T r0, r1;
         r0 = hw_sqrt(x0);
-        r1 = fnmadd(r0, r0, x0) + x1;  // r = x - sqrt(x)^2
+        r1 = exact_fnmadd(r0, r0, x0) + x1;  // r = x - sqrt(x)^2
         z1 = r1 / (r0 + r0);           // Newton iteration
         return r0;
     }
@@ -374,7 +375,7 @@ namespace tfcp {
     }
 
     // Coupled: z0 + z1 = x0 * (y0 + y1)
-    template<typename T> inline T pmul2(T x0, T x1, T y0, T y1, T& z1)
+    template<typename T> inline T pmul2(T x0, T y0, T y1, T& z1)
     {
         T r0, r1;
         r0 = tmul2(x0, y0, y1, r1);      // r = x * y
@@ -437,6 +438,54 @@ namespace tfcp {
         return tsqrt0(x0, z1);  // no need to renormalize
     }
 
+    //------------------------------------------------------------------
+    //
+    //  Coupled: fused operations
+    //
+    //  Intermediate results are twofold, not renormalized: only the
+    //  final result is, so one fast_renorm instead of two or three
+    //
+    //------------------------------------------------------------------
+
+    // Coupled: z0 + z1 = (x0 + x1) * (y0 + y1) + (w0 + w1)
+    template<typename T> inline T pfma(T x0, T x1, T y0, T y1, T w0, T w1, T& z1)
+    {
+        T p0, p1, r0, r1;
+        p0 = tmulp(x0, x1, y0, y1, p1);  // p = x * y
+        r0 = tadd(p0, p1, w0, w1, r1);   // r = p + w
+        return fast_renorm(r0, r1, z1);  // z = r renormalized
+    }
+
+    // Coupled: z0 + z1 = (x0 + x1) * (y0 + y1) - (w0 + w1)
+    template<typename T> inline T pfms(T x0, T x1, T y0, T y1, T w0, T w1, T& z1)
+    {
+        T p0, p1, r0, r1;
+        p0 = tmulp(x0, x1, y0, y1, p1);  // p = x * y
+        r0 = tsub(p0, p1, w0, w1, r1);   // r = p - w
+        return fast_renorm(r0, r1, z1);  // z = r renormalized
+    }
+
+    // Coupled: z0 + z1 = (a0 + a1) * (b0 + b1) + (c0 + c1) * (d0 + d1)
+    template<typename T> inline T pdot2(T a0, T a1, T b0, T b1,
+                                        T c0, T c1, T d0, T d1, T& z1)
+    {
+        T p0, p1, q0, q1, r0, r1;
+        p0 = tmulp(a0, a1, b0, b1, p1);  // p = a * b
+        q0 = tmulp(c0, c1, d0, d1, q1);  // q = c * d
+        r0 = tadd(p0, p1, q0, q1, r1);   // r = p + q
+        return fast_renorm(r0, r1, z1);  // z = r renormalized
+    }
+
+    // Coupled: z0 + z1 = (x0 + x1) + (y0 + y1) + (w0 + w1)
+    template<typename T> inline T psum3(T x0, T x1, T y0, T y1, T w0, T w1, T& z1)
+    {
+        T s0, s1, r0, r1;
+        s0 = tadd(x0, x1, y0, y1, s1);   // s = x + y
+        r0 = tadd(s0, s1, w0, w1, r1);   // r = s + w
+        return fast_renorm(r0, r1, z1);  // z = r renormalized
+    }
+
+} // namespace TFCP_SIMD_ISA
 } // namespace tfcp
 
 //======================================================================
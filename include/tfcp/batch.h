@@ -0,0 +1,193 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_BATCH_H
+#define TFCP_BATCH_H
+//======================================================================
+//
+//  Batch arithmetic over arrays of values and errors, e.g.:
+//
+//    tfcp::batch::padd(n, x0, x1, y0, y1, z0, z1);
+//
+//  computes z0[i] + z1[i] = padd(x0[i] + x1[i], y0[i] + y1[i]) for each
+//  i < n, exactly like the scalar coupled arithmetic
+//
+//  Same for every twofold and coupled operation; suffix tells which
+//  argument is dotted, i.e. has no error array:
+//    1: y is dotted, like tadd1(n, x0, x1, y0, z0, z1)
+//    2: x is dotted, like tadd2(n, x0, y0, y1, z0, z1)
+//    0: both dotted, like tadd0(n, x0, y0, z0, z1)
+//
+//  Alternatively, pass arrays as spans: then n is size of the spans,
+//  which must be equal, e.g.:
+//
+//    tfcp::batch::padd(x0, x1, y0, y1, z0, z1);  // std::vector<double>
+//
+//  Kernels are vectorized for the CPU found at runtime, see dispatch.h
+//
+//  Output may coincide with input: like z0 == x0, z1 == x1; but must
+//  not overlap otherwise
+//
+//======================================================================
+
+#include <tfcp/dispatch.h>
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace tfcp {
+
+    //------------------------------------------------------------------
+    //
+    // Contiguous array, like std::span of C++20: from pointer and size,
+    // or from container like std::vector, std::array, or std::span
+    //
+    //------------------------------------------------------------------
+
+    template<typename T> class span {
+    public:
+        span() : m_data(nullptr), m_size(0) {}
+        span(T* data, size_t size) : m_data(data), m_size(size) {}
+
+        template<typename C, typename = typename std::enable_if<
+            std::is_convertible<decltype(std::declval<C&>().data()), T*>::value>::type>
+        span(C&& c) : m_data(c.data()), m_size(c.size()) {}
+
+        template<size_t N>
+        span(T (&a)[N]) : m_data(a), m_size(N) {}
+
+        T* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+        T& operator [] (size_t i) const { return m_data[i]; }
+
+    private:
+        T* m_data;
+        size_t m_size;
+    };
+
+namespace batch {
+
+    //------------------------------------------------------------------
+    //
+    // Arrays by pointers
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_BATCH4(F, T)                                       \
+    void F(size_t n, const T x0[], const T x1[],                \
+                     const T y0[], const T y1[],                \
+                           T z0[],       T z1[]);
+#define TFCP_BATCH3(F, T)                                       \
+    void F(size_t n, const T a[], const T b[], const T c[],     \
+                           T z0[],       T z1[]);
+#define TFCP_BATCH2(F, T)                                       \
+    void F(size_t n, const T a[], const T b[],                  \
+                           T z0[],       T z1[]);
+#define TFCP_BATCH1(F, T)                                       \
+    void F(size_t n, const T x0[],                              \
+                           T z0[],       T z1[]);
+#define TFCP_BATCH_OP(OP, T)                                    \
+    TFCP_BATCH4(OP, T)                                          \
+    TFCP_BATCH3(OP ## 1, T)                                     \
+    TFCP_BATCH3(OP ## 2, T)                                     \
+    TFCP_BATCH2(OP ## 0, T)
+#define TFCP_BATCH_SQRT(SQRT, T)                                \
+    TFCP_BATCH2(SQRT, T)                                        \
+    TFCP_BATCH1(SQRT ## 0, T)
+#define TFCP_BATCH(T)                                           \
+    TFCP_BATCH_OP(tadd, T)                                      \
+    TFCP_BATCH_OP(tsub, T)                                      \
+    TFCP_BATCH_OP(tmul, T)                                      \
+    TFCP_BATCH_OP(tdiv, T)                                      \
+    TFCP_BATCH_SQRT(tsqrt, T)                                   \
+    TFCP_BATCH_OP(padd, T)                                      \
+    TFCP_BATCH_OP(psub, T)                                      \
+    TFCP_BATCH_OP(pmul, T)                                      \
+    TFCP_BATCH_OP(pdiv, T)                                      \
+    TFCP_BATCH_SQRT(psqrt, T)
+    TFCP_BATCH(double);
+    TFCP_BATCH(float);
+#undef TFCP_BATCH
+#undef TFCP_BATCH_SQRT
+#undef TFCP_BATCH_OP
+#undef TFCP_BATCH1
+#undef TFCP_BATCH2
+#undef TFCP_BATCH3
+#undef TFCP_BATCH4
+
+    //------------------------------------------------------------------
+    //
+    // Arrays by spans: thin inline wrappers
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_BATCH4(F, T)                                                     \
+    inline void F(span<const T> x0, span<const T> x1,                         \
+                  span<const T> y0, span<const T> y1,                         \
+                  span<T> z0, span<T> z1) {                                   \
+        size_t n = z0.size();                                                 \
+        assert(x0.size() == n && x1.size() == n && y0.size() == n &&          \
+               y1.size() == n && z1.size() == n);                             \
+        F(n, x0.data(), x1.data(), y0.data(), y1.data(),                      \
+             z0.data(), z1.data());                                           \
+    }
+#define TFCP_BATCH3(F, T)                                                     \
+    inline void F(span<const T> a, span<const T> b, span<const T> c,          \
+                  span<T> z0, span<T> z1) {                                   \
+        size_t n = z0.size();                                                 \
+        assert(a.size() == n && b.size() == n && c.size() == n &&             \
+               z1.size() == n);                                               \
+        F(n, a.data(), b.data(), c.data(), z0.data(), z1.data());             \
+    }
+#define TFCP_BATCH2(F, T)                                                     \
+    inline void F(span<const T> a, span<const T> b,                           \
+                  span<T> z0, span<T> z1) {                                   \
+        size_t n = z0.size();                                                 \
+        assert(a.size() == n && b.size() == n && z1.size() == n);             \
+        F(n, a.data(), b.data(), z0.data(), z1.data());                       \
+    }
+#define TFCP_BATCH1(F, T)                                                     \
+    inline void F(span<const T> x0, span<T> z0, span<T> z1) {                 \
+        size_t n = z0.size();                                                 \
+        assert(x0.size() == n && z1.size() == n);                             \
+        F(n, x0.data(), z0.data(), z1.data());                                \
+    }
+#define TFCP_BATCH_OP(OP, T)                                    \
+    TFCP_BATCH4(OP, T)                                          \
+    TFCP_BATCH3(OP ## 1, T)                                     \
+    TFCP_BATCH3(OP ## 2, T)                                     \
+    TFCP_BATCH2(OP ## 0, T)
+#define TFCP_BATCH_SQRT(SQRT, T)                                \
+    TFCP_BATCH2(SQRT, T)                                        \
+    TFCP_BATCH1(SQRT ## 0, T)
+#define TFCP_BATCH(T)                                           \
+    TFCP_BATCH_OP(tadd, T)                                      \
+    TFCP_BATCH_OP(tsub, T)                                      \
+    TFCP_BATCH_OP(tmul, T)                                      \
+    TFCP_BATCH_OP(tdiv, T)                                      \
+    TFCP_BATCH_SQRT(tsqrt, T)                                   \
+    TFCP_BATCH_OP(padd, T)                                      \
+    TFCP_BATCH_OP(psub, T)                                      \
+    TFCP_BATCH_OP(pmul, T)                                      \
+    TFCP_BATCH_OP(pdiv, T)                                      \
+    TFCP_BATCH_SQRT(psqrt, T)
+    TFCP_BATCH(double);
+    TFCP_BATCH(float);
+#undef TFCP_BATCH
+#undef TFCP_BATCH_SQRT
+#undef TFCP_BATCH_OP
+#undef TFCP_BATCH1
+#undef TFCP_BATCH2
+#undef TFCP_BATCH3
+#undef TFCP_BATCH4
+
+} // namespace batch
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_BATCH_H
@@ -0,0 +1,54 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_DISPATCH_H
+#define TFCP_DISPATCH_H
+//======================================================================
+//
+//  Runtime selection of CPU-specific kernels in TFCP library
+//
+//  Library compiles batch kernels several times: for SSE2 and for AVX
+//  without FMA (exact products by Dekker-Veltkamp), AVX2 + FMA, and
+//  AVX-512F + FMA; and selects the best one supported by CPU when the
+//  program loads
+//
+//  On other CPUs like ARM, library has only kernels for the portable
+//  backend, named `generic` (see simd.h)
+//
+//  Environment variable TFCP_ISA=sse2|avx|avx2|avx512 may override
+//  that, e.g. to compare performance; unless CPU does not support the
+//  requested ISA
+//
+//  Results are bitwise same for ISAs with FMA, and same for ISAs
+//  without FMA. Between these two groups, error term of division may
+//  differ in last bits: as FMA computes x1 - q0*y1 with one rounding
+//
+//  NB: if TFCP_COMPILED, library calls twofold arithmetic compiled for
+//  same CPU as your code, e.g. with FMA, see twofold.h: so then library
+//  runs only on such CPU, despite the runtime selection of kernels
+//
+//======================================================================
+
+namespace tfcp {
+
+    enum class isa { generic, sse2, avx, avx2, avx512 };
+
+    // Best ISA this CPU supports
+    isa cpu_isa();
+
+    // ISA of kernels currently used by library
+    isa current_isa();
+
+    // Use kernels for given ISA: return false if CPU does not support
+    // NB: not thread-safe versus concurrent calls to batch functions
+    bool select_isa(isa target);
+
+    // Name of ISA, like "avx2"
+    const char* isa_name(isa target);
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_DISPATCH_H
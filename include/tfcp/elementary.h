@@ -0,0 +1,172 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_ELEMENTARY_H
+#define TFCP_ELEMENTARY_H
+//======================================================================
+//
+//  Elementary functions of coupled numbers, e.g.:
+//
+//    coupled<double> y = tfcp::exp(x);
+//
+//  for a single x, or for arrays of n elements, like batch.h:
+//
+//    tfcp::exp(n, x0, x1, z0, z1);  -- z0 + z1 = exp(x0 + x1)
+//
+//  Functions: exp, expm1, log, log1p, pow, sin, cos, tan, and sincos
+//  which computes both sine and cosine for the cost of one; and atan,
+//  atan2, asin, acos, sinh, cosh, tanh
+//
+//  Relative error is few eps^2, if eps is epsilon of T, except pow()
+//  whose relative error is about |y log(x)| eps^2; expm1 and log1p are
+//  accurate relative to result for small argument as well; but if the
+//  result is below min/eps, e.g. exp(x) for x < -672 if double, error
+//  term is subnormal, so absolute error is about denorm_min
+//
+//  Trigonometric functions reduce x by pi/2 with error about eps^3 |x|
+//  by multi-word pi/2, or exactly by Payne-Hanek if x is large; so the
+//  error is few eps^2 relative to result, unless x is close to zero of
+//  the result, where the function is ill-conditioned; for short-vector
+//  forms see elementaryx.h
+//
+//  Inverse functions go by one Newton step from plain atan2() of the
+//  <cmath>, and hyperbolic functions by expm1(|x|) without cancellation,
+//  so their relative error is few eps^2 as well, for any argument
+//
+//  Computed by vector kernels for the ISA selected at runtime, see the
+//  dispatch.h; single x goes by same kernel, so result is the same as
+//  for arrays; arrays split between threads, see reduce.h
+//
+//  Special cases: if result overflows or underflows, or argument is
+//  Inf or NaN, then result is Inf, zero, or NaN same as by <cmath> for
+//  x0 and y0, with zero error; also same as <cmath> pow(x0, y0) if x0
+//  is zero or negative; sin, cos, tan of Inf or NaN is NaN; atan2 of
+//  Inf or zeros is same as <cmath> atan2(y0, x0) with zero error
+//
+//  NB: result may differ in last bits of z1, for the ISA with FMA versus
+//  without, same as coupled arithmetic
+//
+//======================================================================
+
+#include <tfcp/twofold.h>
+
+#include <cmath>
+#include <cstddef>
+
+namespace tfcp {
+
+    coupled<double> exp  (const coupled<double>& x);
+    coupled<double> expm1(const coupled<double>& x);
+    coupled<double> log  (const coupled<double>& x);
+    coupled<double> log1p(const coupled<double>& x);
+    coupled<double> pow  (const coupled<double>& x, const coupled<double>& y);
+    coupled<double> sin  (const coupled<double>& x);
+    coupled<double> cos  (const coupled<double>& x);
+    coupled<double> tan  (const coupled<double>& x);
+    void sincos(const coupled<double>& x, coupled<double>& s, coupled<double>& c);
+    coupled<double> atan (const coupled<double>& x);
+    coupled<double> asin (const coupled<double>& x);
+    coupled<double> acos (const coupled<double>& x);
+    coupled<double> sinh (const coupled<double>& x);
+    coupled<double> cosh (const coupled<double>& x);
+    coupled<double> tanh (const coupled<double>& x);
+    coupled<double> atan2(const coupled<double>& y, const coupled<double>& x);
+
+    coupled<float> exp  (const coupled<float>& x);
+    coupled<float> expm1(const coupled<float>& x);
+    coupled<float> log  (const coupled<float>& x);
+    coupled<float> log1p(const coupled<float>& x);
+    coupled<float> pow  (const coupled<float>& x, const coupled<float>& y);
+    coupled<float> sin  (const coupled<float>& x);
+    coupled<float> cos  (const coupled<float>& x);
+    coupled<float> tan  (const coupled<float>& x);
+    void sincos(const coupled<float>& x, coupled<float>& s, coupled<float>& c);
+    coupled<float> atan (const coupled<float>& x);
+    coupled<float> asin (const coupled<float>& x);
+    coupled<float> acos (const coupled<float>& x);
+    coupled<float> sinh (const coupled<float>& x);
+    coupled<float> cosh (const coupled<float>& x);
+    coupled<float> tanh (const coupled<float>& x);
+    coupled<float> atan2(const coupled<float>& y, const coupled<float>& x);
+
+    // Same names for plain types, like sqrt() in twofold.h
+    inline double exp  (double x) { return std::exp(x); }
+    inline double expm1(double x) { return std::expm1(x); }
+    inline double log  (double x) { return std::log(x); }
+    inline double log1p(double x) { return std::log1p(x); }
+    inline double pow  (double x, double y) { return std::pow(x, y); }
+    inline double sin  (double x) { return std::sin(x); }
+    inline double cos  (double x) { return std::cos(x); }
+    inline double tan  (double x) { return std::tan(x); }
+    inline void sincos(double x, double& s, double& c) { s = std::sin(x); c = std::cos(x); }
+    inline double atan (double x) { return std::atan(x); }
+    inline double asin (double x) { return std::asin(x); }
+    inline double acos (double x) { return std::acos(x); }
+    inline double sinh (double x) { return std::sinh(x); }
+    inline double cosh (double x) { return std::cosh(x); }
+    inline double tanh (double x) { return std::tanh(x); }
+    inline double atan2(double y, double x) { return std::atan2(y, x); }
+
+    inline float exp  (float x) { return std::exp(x); }
+    inline float expm1(float x) { return std::expm1(x); }
+    inline float log  (float x) { return std::log(x); }
+    inline float log1p(float x) { return std::log1p(x); }
+    inline float pow  (float x, float y) { return std::pow(x, y); }
+    inline float sin  (float x) { return std::sin(x); }
+    inline float cos  (float x) { return std::cos(x); }
+    inline float tan  (float x) { return std::tan(x); }
+    inline void sincos(float x, float& s, float& c) { s = std::sin(x); c = std::cos(x); }
+    inline float atan (float x) { return std::atan(x); }
+    inline float asin (float x) { return std::asin(x); }
+    inline float acos (float x) { return std::acos(x); }
+    inline float sinh (float x) { return std::sinh(x); }
+    inline float cosh (float x) { return std::cosh(x); }
+    inline float tanh (float x) { return std::tanh(x); }
+    inline float atan2(float y, float x) { return std::atan2(y, x); }
+
+    void exp  (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void expm1(size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void log  (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void log1p(size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void pow  (size_t n, const double x0[], const double x1[],
+                         const double y0[], const double y1[], double z0[], double z1[]);
+    void sin  (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void cos  (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void tan  (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void sincos(size_t n, const double x0[], const double x1[],
+                double s0[], double s1[], double c0[], double c1[]);
+    void atan (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void asin (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void acos (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void sinh (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void cosh (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void tanh (size_t n, const double x0[], const double x1[], double z0[], double z1[]);
+    void atan2(size_t n, const double y0[], const double y1[],
+                         const double x0[], const double x1[], double z0[], double z1[]);
+
+    void exp  (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void expm1(size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void log  (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void log1p(size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void pow  (size_t n, const float x0[], const float x1[],
+                         const float y0[], const float y1[], float z0[], float z1[]);
+    void sin  (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void cos  (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void tan  (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void sincos(size_t n, const float x0[], const float x1[],
+                float s0[], float s1[], float c0[], float c1[]);
+    void atan (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void asin (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void acos (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void sinh (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void cosh (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void tanh (size_t n, const float x0[], const float x1[], float z0[], float z1[]);
+    void atan2(size_t n, const float y0[], const float y1[],
+                         const float x0[], const float x1[], float z0[], float z1[]);
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_ELEMENTARY_H
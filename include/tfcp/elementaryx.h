@@ -0,0 +1,107 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_ELEMENTARYX_H
+#define TFCP_ELEMENTARYX_H
+//======================================================================
+//
+//  Trigonometric functions of short-vector coupled, see elementary.h:
+//
+//    tfcp::pdoublex y = tfcp::sin(x);
+//    tfcp::sincos(x, s, c);
+//
+//  for pfloatx and pdoublex: sin, cos, tan, and sincos
+//
+//  Inline for the ISA this code is compiled for, see twofoldx.h, so no
+//  runtime dispatch and no call into library: convenient inside loops
+//  that keep their data in short vectors anyway
+//
+//  Accuracy and special cases are same as in elementary.h: positions
+//  with large x, or Inf, or NaN go by scalar code; each position is
+//  same as by elementary.h, if dispatch.h selects same ISA
+//
+//  Being inline for the ISA, functions go to the TFCP_SIMD_ISA namespace
+//  same as twofoldx.h, e.g. as psincos() is not same code with FMA
+//
+//======================================================================
+
+#include <tfcp/elementary.h>
+#include <tfcp/twofoldx.h>
+#include <tfcp/trig.h>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+    // Sine and cosine: all positions at once, then fix positions out of
+    // range of psincos() by scalar code
+    template<typename TX>
+    inline void sincos(const coupled<TX>& x, coupled<TX>& s, coupled<TX>& c)
+    {
+        constexpr int lenx = traitx<TX>::length;
+        TX s1, c0, c1, s0 = psincos(x.value, x.error, s1, c0, c1);
+
+        bool fit = true;
+        for (int l = 0; l < lenx; l++) {
+            fit &= ptrig_fits(getx(x.value, l));
+        }
+        if (!fit) {
+            for (int l = 0; l < lenx; l++) {
+                if (!ptrig_fits(getx(x.value, l))) {
+                    getx(s0, l) = ptrig_special(getx(x.value, l), getx(x.error, l),
+                                                getx(s1, l), getx(c0, l), getx(c1, l));
+                }
+            }
+        }
+
+        s = coupled<TX>(s0, s1);
+        c = coupled<TX>(c0, c1);
+    }
+
+    inline pfloatx sin(const pfloatx& x) {
+        pfloatx s, c;
+        sincos(x, s, c);
+        return s;
+    }
+    inline pdoublex sin(const pdoublex& x) {
+        pdoublex s, c;
+        sincos(x, s, c);
+        return s;
+    }
+
+    inline pfloatx cos(const pfloatx& x) {
+        pfloatx s, c;
+        sincos(x, s, c);
+        return c;
+    }
+    inline pdoublex cos(const pdoublex& x) {
+        pdoublex s, c;
+        sincos(x, s, c);
+        return c;
+    }
+
+    // Positions of Inf or NaN get zero error, same as elementary.h
+    template<typename TX>
+    inline coupled<TX> elementaryx_tan(const coupled<TX>& x)
+    {
+        constexpr int lenx = traitx<TX>::length;
+        coupled<TX> s, c;
+        sincos(x, s, c);
+        TX z1, z0 = pdiv(s.value, s.error, c.value, c.error, z1);
+        for (int l = 0; l < lenx; l++) {
+            if (!std::isfinite(getx(x.value, l))) {
+                getx(z1, l) = 0;
+            }
+        }
+        return coupled<TX>(z0, z1);
+    }
+
+    inline pfloatx  tan(const pfloatx & x) { return elementaryx_tan(x); }
+    inline pdoublex tan(const pdoublex& x) { return elementaryx_tan(x); }
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_ELEMENTARYX_H
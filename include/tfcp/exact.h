@@ -13,7 +13,7 @@
 //
 // Algorithms:
 // - Knuth, Dekker: exact rounding error of a + b
-// - Dekker and Veltkamp: exact a + b without FMA
+// - Dekker and Veltkamp: exact a * b without FMA
 //
 // C++ templates, main scalar types: float, double
 //
@@ -27,6 +27,7 @@
 #include <tfcp/simd.h>
 
 namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
 
     //------------------------------------------------------------------
     //
@@ -130,13 +131,60 @@ namespace tfcp {
     //
 
     // Exact r0 + r1 = x * y
-    template<typename T> inline T pmul0(T x, T y, T& r1)
+    // Requires hardware FMA, else slow (see simd.h)
+    template<typename T> inline T fma_pmul0(T x, T y, T& r1)
     {
         T r0 = x * y;
         r1 = fmsub(x, y, r0);
         return r0;
     }
 
+    //------------------------------------------------------------------
+    //
+    // Backend policy for exact products:
+    // - FMA, if hardware supports
+    // - Dekker-Veltkamp, if TFCP_SIMD_NOFMA (see simd.h)
+    //
+    // Both give exactly same r0 + r1 = x * y, unless x * y overflows or
+    // underflows; Dekker-Veltkamp additionally requires |x|, |y| be not
+    // close to overflow for splitting
+    //
+    //------------------------------------------------------------------
+
+    // Exact r0 + r1 = x * y
+    template<typename T> inline T pmul0(T x, T y, T& r1)
+    {
+    #if defined(TFCP_SIMD_NOFMA)
+        return nofma_pmul0(x, y, r1);
+    #else
+        return fma_pmul0(x, y, r1);
+    #endif
+    }
+
+    // Exact z - x*y, if it is representable and z is close to x*y: like
+    // remainder x - q*y of division q = x/y, or x - r*r of sqrt r
+    template<typename T> inline T exact_fnmadd(T x, T y, T z)
+    {
+    #if defined(TFCP_SIMD_NOFMA)
+        T p0, p1;
+        p0 = nofma_pmul0(x, y, p1);
+        return (z - p0) - p1;  // z - p0 is exact, as z is close to p0
+    #else
+        return fnmadd(x, y, z);
+    #endif
+    }
+
+    // Approximate z - x*y: fused if FMA, or twice rounded otherwise
+    template<typename T> inline T fast_fnmadd(T x, T y, T z)
+    {
+    #if defined(TFCP_SIMD_NOFMA)
+        return z - x * y;
+    #else
+        return fnmadd(x, y, z);
+    #endif
+    }
+
+} // namespace TFCP_SIMD_ISA
 } // namespace tfcp
 
 //======================================================================
@@ -0,0 +1,392 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_EXPLOG_H
+#define TFCP_EXPLOG_H
+//======================================================================
+//
+// Exponent and logarithm in coupled arithmetic, see elementary.h
+//
+// C++ templates, main scalar types: float, double
+//
+// Additionally, short-vector types: floatx, doublex
+//
+// Typical interface like basic.h:
+//   T pexp(T x0, T x1, T& z1);  -- returns z0, so z0 + z1 = exp(x0 + x1)
+//
+// Branch free, so all lanes of short-vector go at once; but only for x
+// within reduced range, see each function: caller must check the range
+// and handle other x apart, like Inf, NaN, or subnormal
+//
+// Exponent: x = k ln2 + r, where |r| <= ln2/2, and ln2 = l0 + l1 + l2
+// so that k l0 is exact, and k l1 is exact by pmul0; then by halvings,
+// exp(r) = (1 + p)^(2^s), where p = expm1(r / 2^s) is Taylor series:
+// leading terms by coupled arithmetic, and tail terms by plain, as the
+// tail is less than eps; then s times p = p (2 + p), which keeps p as
+// accurate relative to itself, so it fits for expm1 as well
+//
+// NB: table of 2^(j/N) would need gather, which SSE2 and AVX do not
+// have; so halvings instead, like in the QD library by Hida et al.
+//
+// Hyperbolic functions by expm1(|x|) with no cancellation: sinh as
+// (m + m / (1 + m)) / 2, and tanh as m / (m + 2) for m = expm1(2|x|),
+// so they are accurate relative to result for small x as well
+//
+// Logarithm: x = 2^e (1 + u), where 1 + u is within [1/sqrt2, sqrt2];
+// then y = log1p(u) approximately by plain arithmetic, and corrected by
+// one Newton step: t = (1 + u) exp(-y) - 1 by coupled expm1, so that
+// log1p(u) = y + t - t^2/2 + t^3/3 within eps^2
+//
+//======================================================================
+
+#include <tfcp/basic.h>
+#include <tfcp/exact.h>
+#include <tfcp/simd.h>
+
+#include <limits>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+    //------------------------------------------------------------------
+    //
+    // Constants by base type
+    //
+    //------------------------------------------------------------------
+
+    template<typename S> struct explog_const {};
+
+    template<> struct explog_const<double> {
+        static constexpr double shift = 6755399441055744.;  // 1.5 * 2^52
+        static constexpr double log2e = 1.4426950408889634;
+        static constexpr double sqrt2 = 1.4142135623730951;
+        static constexpr double clamp = 750;
+
+        // ln2 = l0 + l1 + l2, where l0 has 42 bits
+        static constexpr double ln2_0 = 0.6931471805598903;
+        static constexpr double ln2_1 = 5.497923018708371e-14;
+        static constexpr double ln2_2 = 1.94704509238075e-31;
+
+        // expm1 by Taylor series of this degree for |r| < ln2 / 2^5,
+        // where 1/k! are coupled for k <= lead
+        static constexpr int halvings = 4;
+        static constexpr int degree = 14;
+        static constexpr int lead = 7;
+
+        static double fact0(int k) {
+            static const double c[] = { 1, 1, 0.5,
+                                        0.16666666666666666,
+                                        0.041666666666666664,
+                                        0.008333333333333333,
+                                        0.001388888888888889,
+                                        0.0001984126984126984,
+                                        2.48015873015873e-05,
+                                        2.7557319223985893e-06,
+                                        2.755731922398589e-07,
+                                        2.505210838544172e-08,
+                                        2.08767569878681e-09,
+                                        1.6059043836821613e-10,
+                                        1.1470745597729725e-11 };
+            return c[k];
+        }
+
+        static double fact1(int k) {
+            static const double c[] = { 0, 0, 0,
+                                        9.25185853854297e-18,
+                                        2.3129646346357427e-18,
+                                        1.1564823173178714e-19,
+                                        -5.300543954373577e-20,
+                                        1.7209558293420705e-22 };
+            return c[k];
+        }
+    };
+
+    template<> struct explog_const<float> {
+        static constexpr float shift = 12582912.f;  // 1.5 * 2^23
+        static constexpr float log2e = 1.44269502f;
+        static constexpr float sqrt2 = 1.41421354f;
+        static constexpr float clamp = 110;
+
+        // ln2 = l0 + l1 + l2, where l0 has 16 bits
+        static constexpr float ln2_0 = 0.693145751953125f;
+        static constexpr float ln2_1 = 1.428606765330187e-06f;
+        static constexpr float ln2_2 = 5.497923148104107e-14f;
+
+        static constexpr int halvings = 4;
+        static constexpr int degree = 8;
+        static constexpr int lead = 4;
+
+        static float fact0(int k) {
+            static const float c[] = { 1, 1, 0.5f,
+                                       0.1666666716337204f,
+                                       0.0416666679084301f,
+                                       0.008333333767950535f,
+                                       0.0013888889225199819f,
+                                       0.00019841270113829523f,
+                                       2.4801587642286904e-05f };
+            return c[k];
+        }
+
+        static float fact1(int k) {
+            static const float c[] = { 0, 0, 0,
+                                       -4.967053879312289e-09f,
+                                       -1.2417634698280722e-09f };
+            return c[k];
+        }
+    };
+
+    //------------------------------------------------------------------
+    //
+    // Auxiliary: round to integer, scale by 2^k, and k ln2
+    //
+    //------------------------------------------------------------------
+
+    // Round to nearest integer, if |x| < 2^51 (or 2^22 for float)
+    template<typename T> inline T explog_round(T x)
+    {
+        using S = typename traitx<T>::base;
+        const T c = setallx<T>(explog_const<S>::shift);
+        return (x + c) - c;
+    }
+
+    // x 2^k, for integer k and |k| <= 2044 (or 252 for float): by two
+    // normal factors, so result may be subnormal, rounded just once
+    template<typename T> inline T explog_scale(T x, T k)
+    {
+        using S = typename traitx<T>::base;
+        T k1 = explog_round(k * setallx<T>(S(0.5)));
+        return x * pow2x(k1) * pow2x(k - k1);
+    }
+
+    // z = k ln2, for integer k and |k| <= 2^11 (or 2^8 for float)
+    template<typename T> inline T explog_ln2(T k, T& z1)
+    {
+        using S = typename traitx<T>::base;
+        using C = explog_const<S>;
+        T h1, h0 = pmul0(k, setallx<T>(C::ln2_1), h1);
+        T z0 = padd2(k * setallx<T>(C::ln2_0), h0, h1, z1);
+        return padd1(z0, z1, k * setallx<T>(C::ln2_2), z1);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Exponent
+    //
+    //------------------------------------------------------------------
+
+    // p = exp(x) / 2^k - 1, where k is integer, for |x0| <= 1000 (or 120
+    // for float) so that |k| is within range of explog_scale()
+    template<typename T> inline T pexpm1_reduce(T x0, T x1, T& k, T& p1)
+    {
+        using S = typename traitx<T>::base;
+        using C = explog_const<S>;
+
+        k = explog_round(x0 * setallx<T>(C::log2e));
+
+        // r = x - k ln2: as k l0 is close to x0, their difference is exact
+        // and a + x1 is renormalized, as x1 may exceed ulp of a
+        T a1, a0 = padd0(x0 - k * setallx<T>(C::ln2_0), x1, a1);
+        T b1, b0 = pmul0(k, setallx<T>(C::ln2_1), b1);
+        T r1, r0 = psub(a0, a1, b0, b1, r1);
+        r0 = psub1(r0, r1, k * setallx<T>(C::ln2_2), r1);
+
+        const T h = setallx<T>(S(1) / (1 << C::halvings));
+        r0 = r0 * h;
+        r1 = r1 * h;
+
+        // p = r (1 + r (1/2 + r (1/6 + ...))): tail of terms by plain q
+        T q = setallx<T>(C::fact0(C::degree));
+        for (int j = C::degree - 1; j > C::lead; j--) {
+            q = q * r0 + setallx<T>(C::fact0(j));
+        }
+        T p0 = pmul1(r0, r1, q, p1);
+        for (int j = C::lead; j >= 1; j--) {
+            p0 = padd(p0, p1, setallx<T>(C::fact0(j)), setallx<T>(C::fact1(j)), p1);
+            p0 = pmul(r0, r1, p0, p1, p1);
+        }
+
+        // (1 + p)^2 - 1 = p (2 + p)
+        for (int i = 0; i < C::halvings; i++) {
+            T t1, t0 = padd1(p0, p1, setallx<T>(S(2)), t1);
+            p0 = pmul(p0, p1, t0, t1, p1);
+        }
+        return p0;
+    }
+
+    // exp(x), for -745.13 <= x0 <= 709.78 (or -103.27 and 88.72 for
+    // float): result overflows or underflows beyond
+    template<typename T> inline T pexp(T x0, T x1, T& z1)
+    {
+        using S = typename traitx<T>::base;
+        T k, p1, p0 = pexpm1_reduce(x0, x1, k, p1);
+        T e1, e0 = padd2(setallx<T>(S(1)), p0, p1, e1);
+        z1 = explog_scale(e1, k);
+        return explog_scale(e0, k);
+    }
+
+    // expm1(x), for |x0| <= 708 (or 87 for float), so that 2^k is normal:
+    // then expm1(x) = (2^k - 1) + 2^k p, where 2^k - 1 is exact by a + b
+    template<typename T> inline T pexpm1(T x0, T x1, T& z1)
+    {
+        using S = typename traitx<T>::base;
+        T k, p1, p0 = pexpm1_reduce(x0, x1, k, p1);
+        T c = pow2x(k);
+        T b, a = padd0(c, setallx<T>(S(-1)), b);
+        return padd(a, b, p0 * c, p1 * c, z1);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Logarithm
+    //
+    //------------------------------------------------------------------
+
+    // log1p(u), for 1/sqrt2 - 1 <= u0 <= sqrt2 - 1
+    template<typename T> inline T plog1p_reduced(T u0, T u1, T& z1)
+    {
+        using S = typename traitx<T>::base;
+
+        // Plain y = 2 atanh(f), where f = u / (2 + u), with relative
+        // error below 10^-9: enough, as the Newton step triples digits
+        T f = u0 / (setallx<T>(S(2)) + u0);
+        T g = f * f;
+        T s = setallx<T>(S(1) / 11);
+        for (int j = 4; j >= 0; j--) {
+            s = s * g + setallx<T>(S(1) / (2*j + 1));
+        }
+        T y = setallx<T>(S(2)) * f * s;
+
+        // t = (1 + u) exp(-y) - 1 = u + m + u m, where m = expm1(-y)
+        T m1, m0 = pexpm1(-y, setzerox<T>(), m1);
+        T w1, w0 = pmul(u0, u1, m0, m1, w1);
+        T t1, t0 = padd(u0, u1, m0, m1, t1);
+        t0 = padd(t0, t1, w0, w1, t1);
+
+        // log1p(u) = y + log(1 + t), where t is tiny
+        T d = t0 * t0 * (t0 * setallx<T>(S(1) / 3) - setallx<T>(S(0.5)));
+        T z0 = padd2(y, t0, t1, z1);
+        return padd1(z0, z1, d, z1);
+    }
+
+    // log(c + x), where c is 0 for log, or 1 for log1p, and c + x is
+    // normal within 2^-1022 and 2^1023 (or 2^-126 and 2^127 for float)
+    template<typename T> inline T plog_shifted(T c, T x0, T x1, T& z1)
+    {
+        using S = typename traitx<T>::base;
+        using C = explog_const<S>;
+
+        // c + x = 2^e (1 + u), where u = (x + (c - 2^e)) / 2^e, and c - 2^e
+        // is exact as a + b
+        T w1, w0 = padd2(c, x0, x1, w1);
+        T e = logbx(w0 * setallx<T>(C::sqrt2));
+        T b, a = padd0(c, -pow2x(e), b);
+        T u1, u0 = padd(x0, x1, a, b, u1);
+        u0 = explog_scale(u0, -e);
+        u1 = explog_scale(u1, -e);
+
+        T l1, l0 = plog1p_reduced(u0, u1, l1);
+        T g1, g0 = explog_ln2(e, g1);
+        return padd(g0, g1, l0, l1, z1);
+    }
+
+    template<typename T> inline T plog(T x0, T x1, T& z1)
+    {
+        return plog_shifted(setzerox<T>(), x0, x1, z1);
+    }
+
+    template<typename T> inline T plog1p(T x0, T x1, T& z1)
+    {
+        using S = typename traitx<T>::base;
+        return plog_shifted(setallx<T>(S(1)), x0, x1, z1);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Power
+    //
+    //------------------------------------------------------------------
+
+    // pow(x, y) = exp(y log(x)), for x within range of plog(), and y
+    // finite; if y log(x) is out of range of pexp(), result overflows
+    // or underflows, as y log(x) is clamped so that pexp() does not
+    // go out of range of explog_scale()
+    //
+    // NB: relative error is about |y log(x)| eps^2, as exp() magnifies
+    // the absolute error of its argument
+    template<typename T> inline T ppow(T x0, T x1, T y0, T y1, T& z1)
+    {
+        using S = typename traitx<T>::base;
+        const T lim = setallx<T>(explog_const<S>::clamp);
+        T l1, l0 = plog(x0, x1, l1);
+        T m1, m0 = pmul(y0, y1, l0, l1, m1);
+        m0 = -maxx(-maxx(m0, -lim), -lim);
+        return pexp(m0, m1, z1);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Hyperbolic functions
+    //
+    //------------------------------------------------------------------
+
+    // |x| = a0 + a1, and sign of x0: -1, or 1, or 0 if x0 is zero; for
+    // x0 zero or normal
+    template<typename T> inline T phyper_abs(T x0, T x1, T& a1, T& sign)
+    {
+        using S = typename traitx<T>::base;
+        T a0 = absx(x0);
+        sign = x0 / maxx(a0, setallx<T>(std::numeric_limits<S>::min()));
+        a1 = x1 * sign;
+        return a0;
+    }
+
+    // sinh(x), for |x0| <= 680 (or 78 for float), so that split of m by
+    // Veltkamp's method does not overflow in pdiv()
+    template<typename T> inline T psinh(T x0, T x1, T& z1)
+    {
+        using S = typename traitx<T>::base;
+        T sign, a1, a0 = phyper_abs(x0, x1, a1, sign);
+        T m1, m0 = pexpm1(a0, a1, m1);
+        T e1, e0 = padd1(m0, m1, setallx<T>(S(1)), e1);
+        T q1, q0 = pdiv(m0, m1, e0, e1, q1);
+        T z0 = padd(m0, m1, q0, q1, z1);
+        const T h = setallx<T>(S(0.5)) * sign;
+        z1 = z1 * h;
+        return z0 * h;
+    }
+
+    // cosh(x) = (e + 1/e) / 2, where e = exp(|x|), for |x0| <= 680 (or
+    // 78 for float), same as psinh()
+    template<typename T> inline T pcosh(T x0, T x1, T& z1)
+    {
+        using S = typename traitx<T>::base;
+        T sign, a1, a0 = phyper_abs(x0, x1, a1, sign);
+        T e1, e0 = pexp(a0, a1, e1);
+        T r1, r0 = pdiv2(setallx<T>(S(1)), e0, e1, r1);
+        T z0 = padd(e0, e1, r0, r1, z1);
+        const T h = setallx<T>(S(0.5));
+        z1 = z1 * h;
+        return z0 * h;
+    }
+
+    // tanh(x), for |x0| <= 340 (or 39 for float), so 2x within psinh()
+    // range
+    template<typename T> inline T ptanh(T x0, T x1, T& z1)
+    {
+        using S = typename traitx<T>::base;
+        const T two = setallx<T>(S(2));
+        T sign, a1, a0 = phyper_abs(x0, x1, a1, sign);
+        T m1, m0 = pexpm1(a0 * two, a1 * two, m1);
+        T d1, d0 = padd1(m0, m1, two, d1);
+        T z0 = pdiv(m0, m1, d0, d1, z1);
+        z1 = z1 * sign;
+        return z0 * sign;
+    }
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_EXPLOG_H
@@ -0,0 +1,318 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_FIXED_H
+#define TFCP_FIXED_H
+//======================================================================
+//
+//  Small vectors and matrices of compile-time size, e.g.:
+//
+//    tfcp::mat<3, 3, tfcp::pdouble> a = ...;
+//    tfcp::vec<3, tfcp::pdouble> x = inverse(a) * b;
+//
+//  Element type S is any with arithmetic operators and sqrt(), like T,
+//  twofold<T>, coupled<T>; and same for the short-vectors, see fixedx.h
+//  for batches of independent matrices, one matrix per vector position
+//
+//  Operations:
+//  - vec: u + v, u - v, -u, s * u, u * s, u / s, dot(u, v), cross(u, v)
+//    for 3-vectors, norm(u) by 2-norm, normalize(u) = u / norm(u)
+//  - mat: a + b, a - b, a * b, a * u, s * a, transpose(a), identity(),
+//    det(a) and inverse(a) for 1x1 to 4x4
+//
+//  All loops are unrolled at compile time, so each operation inlines
+//  into straight code over elements, with no loop overhead or indexing
+//
+//  Inverse is by cofactors: adjugate divided by determinant, same as
+//  the Cramer's rule, so it is not pivoted; in coupled arithmetic, its
+//  error is about eps^2 * cond(a) relative, if eps is epsilon of T
+//
+//  Functions are in the TFCP_SIMD_ISA namespace, see simd.h: inlined
+//  arithmetic of S like pdoublex compiles differently per target, and
+//  so do functions over it like inverse(a)
+//
+//======================================================================
+
+#include <tfcp/simd.h>  // TFCP_SIMD_ISA
+
+#include <cmath>
+#include <cstddef>
+
+namespace tfcp {
+
+    //------------------------------------------------------------------
+    //
+    // Types: elements by rows, like a[i][j] is row i, column j
+    //
+    //------------------------------------------------------------------
+
+    template<size_t N, typename S> struct vec {
+        S x[N];
+
+        S& operator [] (size_t i) { return x[i]; }
+        const S& operator [] (size_t i) const { return x[i]; }
+    };
+
+    template<size_t N, size_t M, typename S> struct mat {
+        S x[N][M];
+
+        S* operator [] (size_t i) { return x[i]; }
+        const S* operator [] (size_t i) const { return x[i]; }
+    };
+
+inline namespace TFCP_SIMD_ISA {
+
+    //------------------------------------------------------------------
+    //
+    // Unroll: call f(i) for i = I, ..., N - 1, by recursion of templates;
+    // and fixed_for<N>(f) for i = 0, ..., N - 1
+    //
+    //------------------------------------------------------------------
+
+    template<size_t I, size_t N> struct fixed_unroll {
+        template<typename F> static inline void run(F f) {
+            f(I);
+            fixed_unroll<I + 1, N>::run(f);
+        }
+    };
+
+    template<size_t N> struct fixed_unroll<N, N> {
+        template<typename F> static inline void run(F) {}
+    };
+
+    template<size_t N, typename F> inline void fixed_for(F f) {
+        fixed_unroll<0, N>::run(f);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Vectors
+    //
+    //------------------------------------------------------------------
+
+    template<size_t N, typename S>
+    inline vec<N, S> operator + (const vec<N, S>& u, const vec<N, S>& v) {
+        vec<N, S> w;
+        fixed_for<N>([&](size_t i) { w[i] = u[i] + v[i]; });
+        return w;
+    }
+
+    template<size_t N, typename S>
+    inline vec<N, S> operator - (const vec<N, S>& u, const vec<N, S>& v) {
+        vec<N, S> w;
+        fixed_for<N>([&](size_t i) { w[i] = u[i] - v[i]; });
+        return w;
+    }
+
+    template<size_t N, typename S>
+    inline vec<N, S> operator - (const vec<N, S>& u) {
+        vec<N, S> w;
+        fixed_for<N>([&](size_t i) { w[i] = -u[i]; });
+        return w;
+    }
+
+    template<size_t N, typename S>
+    inline vec<N, S> operator * (const S& s, const vec<N, S>& u) {
+        vec<N, S> w;
+        fixed_for<N>([&](size_t i) { w[i] = s * u[i]; });
+        return w;
+    }
+
+    template<size_t N, typename S>
+    inline vec<N, S> operator * (const vec<N, S>& u, const S& s) {
+        vec<N, S> w;
+        fixed_for<N>([&](size_t i) { w[i] = u[i] * s; });
+        return w;
+    }
+
+    template<size_t N, typename S>
+    inline vec<N, S> operator / (const vec<N, S>& u, const S& s) {
+        vec<N, S> w;
+        fixed_for<N>([&](size_t i) { w[i] = u[i] / s; });
+        return w;
+    }
+
+    template<size_t N, typename S>
+    inline S dot(const vec<N, S>& u, const vec<N, S>& v) {
+        S s = u[0] * v[0];
+        fixed_unroll<1, N>::run([&](size_t i) { s = s + u[i] * v[i]; });
+        return s;
+    }
+
+    template<typename S>
+    inline vec<3, S> cross(const vec<3, S>& u, const vec<3, S>& v) {
+        vec<3, S> w;
+        w[0] = u[1] * v[2] - u[2] * v[1];
+        w[1] = u[2] * v[0] - u[0] * v[2];
+        w[2] = u[0] * v[1] - u[1] * v[0];
+        return w;
+    }
+
+    template<size_t N, typename S>
+    inline S norm(const vec<N, S>& u) {
+        using std::sqrt;
+        return sqrt(dot(u, u));
+    }
+
+    template<size_t N, typename S>
+    inline vec<N, S> normalize(const vec<N, S>& u) {
+        return u / norm(u);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Matrices
+    //
+    //------------------------------------------------------------------
+
+    template<size_t N, typename S>
+    inline mat<N, N, S> identity() {
+        mat<N, N, S> a;
+        fixed_for<N>([&](size_t i) {
+            fixed_for<N>([&](size_t j) { a[i][j] = S(i == j ? 1.0 : 0.0); });
+        });
+        return a;
+    }
+
+    template<size_t N, size_t M, typename S>
+    inline mat<N, M, S> operator + (const mat<N, M, S>& a, const mat<N, M, S>& b) {
+        mat<N, M, S> c;
+        fixed_for<N>([&](size_t i) {
+            fixed_for<M>([&](size_t j) { c[i][j] = a[i][j] + b[i][j]; });
+        });
+        return c;
+    }
+
+    template<size_t N, size_t M, typename S>
+    inline mat<N, M, S> operator - (const mat<N, M, S>& a, const mat<N, M, S>& b) {
+        mat<N, M, S> c;
+        fixed_for<N>([&](size_t i) {
+            fixed_for<M>([&](size_t j) { c[i][j] = a[i][j] - b[i][j]; });
+        });
+        return c;
+    }
+
+    template<size_t N, size_t M, typename S>
+    inline mat<N, M, S> operator * (const S& s, const mat<N, M, S>& a) {
+        mat<N, M, S> c;
+        fixed_for<N>([&](size_t i) {
+            fixed_for<M>([&](size_t j) { c[i][j] = s * a[i][j]; });
+        });
+        return c;
+    }
+
+    template<size_t N, size_t M, typename S>
+    inline mat<M, N, S> transpose(const mat<N, M, S>& a) {
+        mat<M, N, S> c;
+        fixed_for<N>([&](size_t i) {
+            fixed_for<M>([&](size_t j) { c[j][i] = a[i][j]; });
+        });
+        return c;
+    }
+
+    template<size_t N, size_t M, typename S>
+    inline vec<N, S> operator * (const mat<N, M, S>& a, const vec<M, S>& u) {
+        vec<N, S> w;
+        fixed_for<N>([&](size_t i) {
+            S s = a[i][0] * u[0];
+            fixed_unroll<1, M>::run([&](size_t j) { s = s + a[i][j] * u[j]; });
+            w[i] = s;
+        });
+        return w;
+    }
+
+    template<size_t N, size_t K, size_t M, typename S>
+    inline mat<N, M, S> operator * (const mat<N, K, S>& a, const mat<K, M, S>& b) {
+        mat<N, M, S> c;
+        fixed_for<N>([&](size_t i) {
+            fixed_for<M>([&](size_t j) {
+                S s = a[i][0] * b[0][j];
+                fixed_unroll<1, K>::run([&](size_t p) { s = s + a[i][p] * b[p][j]; });
+                c[i][j] = s;
+            });
+        });
+        return c;
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Determinant: explicit for 1x1, 2x2, 3x3; by first row for 4x4
+    //
+    //------------------------------------------------------------------
+
+    template<typename S>
+    inline S det(const mat<1, 1, S>& a) {
+        return a[0][0];
+    }
+
+    template<typename S>
+    inline S det(const mat<2, 2, S>& a) {
+        return a[0][0] * a[1][1] - a[0][1] * a[1][0];
+    }
+
+    template<typename S>
+    inline S det(const mat<3, 3, S>& a) {
+        return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+             - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+             + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    }
+
+    // Submatrix: a without row r and column c
+    template<size_t N, typename S>
+    inline mat<N - 1, N - 1, S> submatrix(const mat<N, N, S>& a, size_t r, size_t c) {
+        mat<N - 1, N - 1, S> m;
+        fixed_for<N - 1>([&](size_t i) {
+            fixed_for<N - 1>([&](size_t j) { m[i][j] = a[i < r ? i : i + 1][j < c ? j : j + 1]; });
+        });
+        return m;
+    }
+
+    template<typename S>
+    inline S det(const mat<4, 4, S>& a) {
+        S s = a[0][0] * det(submatrix(a, 0, 0));
+        s = s - a[0][1] * det(submatrix(a, 0, 1));
+        s = s + a[0][2] * det(submatrix(a, 0, 2));
+        s = s - a[0][3] * det(submatrix(a, 0, 3));
+        return s;
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Inverse: transposed cofactors, times reciprocal of determinant;
+    // which is computed from the same cofactors of the first row
+    //
+    //------------------------------------------------------------------
+
+    template<typename S>
+    inline mat<1, 1, S> inverse(const mat<1, 1, S>& a) {
+        mat<1, 1, S> c;
+        c[0][0] = S(1.0) / a[0][0];
+        return c;
+    }
+
+    template<size_t N, typename S>
+    inline mat<N, N, S> inverse(const mat<N, N, S>& a) {
+        static_assert(2 <= N && N <= 4, "inverse is for 1x1 to 4x4");
+        mat<N, N, S> c;
+        fixed_for<N>([&](size_t i) {
+            fixed_for<N>([&](size_t j) {
+                S m = det(submatrix(a, i, j));
+                c[j][i] = (i + j) % 2 ? -m : m;
+            });
+        });
+        S d = a[0][0] * c[0][0];
+        fixed_unroll<1, N>::run([&](size_t j) { d = d + a[0][j] * c[j][0]; });
+        S r = S(1.0) / d;
+        fixed_for<N>([&](size_t i) {
+            fixed_for<N>([&](size_t j) { c[i][j] = c[i][j] * r; });
+        });
+        return c;
+    }
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_FIXED_H
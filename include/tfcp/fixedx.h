@@ -0,0 +1,98 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_FIXEDX_H
+#define TFCP_FIXEDX_H
+//======================================================================
+//
+//  Batches of small vectors and matrices, see fixed.h: with element of
+//  short-vector type, each position of the vector is one independent
+//  matrix, e.g. for 4 matrices if AVX2, or 8 if AVX-512:
+//
+//    tfcp::mat<3, 3, tfcp::pdoublex> a;
+//    tfcp::loadx(a, p);       // from p[0], ..., p[length - 1]
+//    tfcp::storex(q, inverse(a));
+//
+//  where p and q are arrays of mat<3, 3, pdouble>; same for vec, and
+//  for twofold or coupled of floatx and doublex
+//
+//  Each position of result is exactly same as by fixed.h for scalar
+//  twofold or coupled, as operations are the same
+//
+//  Loading transposes values and errors of each element through small
+//  arrays, so that the vector registers get filled by whole loads
+//
+//  Like twofoldx.h, functions are in the TFCP_SIMD_ISA namespace, as
+//  their code depends on the target, e.g. with or without FMA
+//
+//======================================================================
+
+#include <tfcp/fixed.h>
+#include <tfcp/twofoldx.h>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+    template<size_t N, template<typename> class SHAPE, typename TX, typename T>
+    inline void loadx(vec<N, SHAPE<TX>>& x, const vec<N, SHAPE<T>> p[]) {
+        constexpr int lenx = traitx<TX>::length;
+        fixed_for<N>([&](size_t i) {
+            T v[lenx], e[lenx];
+            for (int l = 0; l < lenx; l++) {
+                v[l] = p[l][i].value;
+                e[l] = p[l][i].error;
+            }
+            x[i] = SHAPE<TX>(loadx<TX>(v), loadx<TX>(e));
+        });
+    }
+
+    template<size_t N, template<typename> class SHAPE, typename TX, typename T>
+    inline void storex(vec<N, SHAPE<T>> p[], const vec<N, SHAPE<TX>>& x) {
+        constexpr int lenx = traitx<TX>::length;
+        fixed_for<N>([&](size_t i) {
+            T v[lenx], e[lenx];
+            storex(v, x[i].value);
+            storex(e, x[i].error);
+            for (int l = 0; l < lenx; l++) {
+                p[l][i] = SHAPE<T>(v[l], e[l]);
+            }
+        });
+    }
+
+    template<size_t N, size_t M, template<typename> class SHAPE, typename TX, typename T>
+    inline void loadx(mat<N, M, SHAPE<TX>>& x, const mat<N, M, SHAPE<T>> p[]) {
+        constexpr int lenx = traitx<TX>::length;
+        fixed_for<N>([&](size_t i) {
+            fixed_for<M>([&](size_t j) {
+                T v[lenx], e[lenx];
+                for (int l = 0; l < lenx; l++) {
+                    v[l] = p[l][i][j].value;
+                    e[l] = p[l][i][j].error;
+                }
+                x[i][j] = SHAPE<TX>(loadx<TX>(v), loadx<TX>(e));
+            });
+        });
+    }
+
+    template<size_t N, size_t M, template<typename> class SHAPE, typename TX, typename T>
+    inline void storex(mat<N, M, SHAPE<T>> p[], const mat<N, M, SHAPE<TX>>& x) {
+        constexpr int lenx = traitx<TX>::length;
+        fixed_for<N>([&](size_t i) {
+            fixed_for<M>([&](size_t j) {
+                T v[lenx], e[lenx];
+                storex(v, x[i][j].value);
+                storex(e, x[i][j].error);
+                for (int l = 0; l < lenx; l++) {
+                    p[l][i][j] = SHAPE<T>(v[l], e[l]);
+                }
+            });
+        });
+    }
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_FIXEDX_H
@@ -0,0 +1,102 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_GEMM_H
+#define TFCP_GEMM_H
+//======================================================================
+//
+//  Matrix product in coupled arithmetic, e.g.:
+//
+//    tfcp::gemm(m, n, k, a0, a1, lda, b0, b1, ldb, c0, c1, ldc);
+//
+//  computes c = a * b, where a is m x k, b is k x n, and c is m x n;
+//  matrices are by rows, each as separate arrays of values and errors
+//  like for batch.h, e.g. a[i][p] is a0[i*lda + p] + a1[i*lda + p]
+//
+//  Each c[i][j] is bitwise same as by the scalar loop:
+//
+//    tfcp::coupled<T> c(0, 0);
+//    for (p = 0; p < k; p++)
+//        c += a[i][p] * b[p][j];
+//
+//  for same ISA as selected by dispatch.h, in particular same FMA; so
+//  result does not depend on the number of threads
+//
+//  Or, for plain double a and b, Ozaki scheme computes c as coupled:
+//
+//    tfcp::gemm_accurate(m, n, k, a, lda, b, ldb, c0, c1, ldc);
+//
+//  It splits rows of a, and columns of b, into slices of about 20 bits
+//  so that their plain products are exact (see "Error-free transformation
+//  of matrix multiplication by using fast routines of matrix
+//  multiplication and its applications" by Ozaki, Ogita, Oishi, and
+//  Rump, Numer. Algorithms 59, 2012), then adds products of slices by
+//  padd, starting from the lowest
+//
+//  So most work runs by plain double matrix products, though several of
+//  them: like 15 if k = 512. Error is like k * eps^2 * (|a| * |b| + M),
+//  where M[i][j] is max |a[i][p]| times max |b[p][j]| over p, unless the
+//  products of slices underflow: so M should be above 2^-800
+//
+//  Alternatively, pass soa_vector of m*k, k*n, and m*n elements, with
+//  dense rows: then lda = k, ldb = n, ldc = n; for gemm_accurate, pass
+//  spans of a and b, and soa_vector of c
+//
+//  Kernel is cache-blocked and vectorized for the CPU found at runtime,
+//  and rows of c split into stripes to compute by several threads, see
+//  set_reduce_threads() in reduce.h
+//
+//  NB: c must not overlap a or b
+//
+//======================================================================
+
+#include <tfcp/soa_vector.h>
+#include <tfcp/twofold.h>
+
+#include <cassert>
+#include <cstddef>
+
+namespace tfcp {
+
+    void gemm(size_t m, size_t n, size_t k,
+              const double a0[], const double a1[], size_t lda,
+              const double b0[], const double b1[], size_t ldb,
+                    double c0[],       double c1[], size_t ldc);
+
+    void gemm(size_t m, size_t n, size_t k,
+              const float  a0[], const float  a1[], size_t lda,
+              const float  b0[], const float  b1[], size_t ldb,
+                    float  c0[],       float  c1[], size_t ldc);
+
+    void gemm_accurate(size_t m, size_t n, size_t k,
+                       const double a[], size_t lda,
+                       const double b[], size_t ldb,
+                             double c0[],   double c1[], size_t ldc);
+
+    inline void gemm_accurate(size_t m, size_t n, size_t k,
+                              span<const double> a, span<const double> b,
+                              soa_vector<coupled<double>>& c)
+    {
+        assert(a.size() == m * k && b.size() == k * n && c.size() == m * n);
+        gemm_accurate(m, n, k, a.data(), k, b.data(), n,
+                      c.values().data(), c.errors().data(), n);
+    }
+
+    template<typename T>
+    inline void gemm(size_t m, size_t n, size_t k,
+                     const soa_vector<coupled<T>>& a,
+                     const soa_vector<coupled<T>>& b,
+                           soa_vector<coupled<T>>& c)
+    {
+        assert(a.size() == m * k && b.size() == k * n && c.size() == m * n);
+        gemm(m, n, k, a.values().data(), a.errors().data(), k,
+                      b.values().data(), b.errors().data(), n,
+                      c.values().data(), c.errors().data(), n);
+    }
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_GEMM_H
@@ -0,0 +1,224 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_LAZY_H
+#define TFCP_LAZY_H
+//======================================================================
+//
+//  Coupled with lazy renormalization, for long chains of arithmetic:
+//
+//    tfcp::lazy_coupled<double> s = 0;
+//    for (...)
+//        s += x[k] * y[k];       -- no renormalizing inside the loop
+//    tfcp::pdouble r = s;        -- renormalized here, once
+//
+//  Each of x + y, x - y, x * y is twofold, by the twofold<T> operators,
+//  so result is unnormalized; and it counts operations done since the
+//  operands were renormalized. Renormalizes only:
+//  - if the counter exceeds lazy_coupled<T>::limit, as the tail then
+//    may overlap the value enough to lose accuracy
+//  - if observed: converted to coupled<T>, compared, or stored
+//  - before dividing, as tdivp assumes the renormalized operands
+//
+//  Renormalizing is by TwoSum, same as converting twofold to coupled:
+//  as after cancelling, the error part may exceed the value part, so
+//  the cheaper fast_renorm would be inexact
+//
+//  T is float, double, or short-vector floatx, doublex; the counter is
+//  same for all vector positions. Converting to coupled<TX> lets you
+//  store or access positions like for coupled<TX>, see twofoldx.h
+//
+//  Multiplying takes the full twofold product, including x1*y1, which
+//  coupled omits; so chain of few operations costs less than same in
+//  coupled, and is about as accurate: error stays within few eps^2 of
+//  magnitudes of the terms, if eps is epsilon of T
+//
+//  NB: result may differ in last bits of error from same computed in
+//  coupled, and cancelling like in coupled x + y cannot be exact if
+//  the tails overlap
+//
+//======================================================================
+
+#include <tfcp/twofoldx.h>
+#include <tfcp/twofold.h>
+
+namespace tfcp {
+
+    template<typename T> struct lazy_coupled {
+    public:
+        // Most operations between renormalizing; each adds about one
+        // rounding of the tail, so about eps^2 relative to the value
+        static constexpr int limit = 8;
+    public:
+        T value, error;  // unnormalized pair: value + error
+        int count;       // operations since renormalized
+    public:
+        lazy_coupled() {}
+        lazy_coupled(T value, T error, int count):
+            value(value), error(error), count(count) {}
+    public:
+        lazy_coupled(const coupled<T>& x): value(x.value), error(x.error), count(0) {}
+        lazy_coupled(T x): value(x), error(error_of(x)), count(0) {}  // zero error
+    public:
+        // Observe, so renormalize
+        operator coupled<T>() const {
+            if (count == 0)
+                return coupled<T>(value, error);
+            const twofold<T> z(value, error);  // const: by constructor
+            return coupled<T>(z);
+        }
+
+        lazy_coupled& renormalize() {
+            if (count > 0) {
+                coupled<T> z = *this;
+                value = z.value;
+                error = z.error;
+                count = 0;
+            }
+            return *this;
+        }
+
+    private:
+        twofold<T> unnormalized() const { return twofold<T>(value, error); }
+
+        // Count operations, renormalize if too many
+        static lazy_coupled counted(const twofold<T>& z, int count) {
+            lazy_coupled r(z.value, z.error, count);
+            if (count > limit)
+                r.renormalize();
+            return r;
+        }
+
+        static int next(const lazy_coupled& x, const lazy_coupled& y) {
+            return (x.count > y.count ? x.count : y.count) + 1;
+        }
+
+    public:
+        //--------------------------------------------------------------
+        // Arithmetic, twofold; with plain T, or coupled<T> as if it
+        // were renormalized lazy_coupled<T>
+        //--------------------------------------------------------------
+
+        friend lazy_coupled operator + (const lazy_coupled& x) { return x; }
+        friend lazy_coupled operator - (const lazy_coupled& x) {
+            return lazy_coupled(-x.value, -x.error, x.count);
+        }
+
+        friend lazy_coupled operator + (const lazy_coupled& x, const lazy_coupled& y) {
+            return counted(x.unnormalized() + y.unnormalized(), next(x, y));
+        }
+        friend lazy_coupled operator + (const lazy_coupled& x, T y) {
+            return counted(x.unnormalized() + y, x.count + 1);
+        }
+        friend lazy_coupled operator + (T x, const lazy_coupled& y) {
+            return counted(x + y.unnormalized(), y.count + 1);
+        }
+
+        friend lazy_coupled operator - (const lazy_coupled& x, const lazy_coupled& y) {
+            return counted(x.unnormalized() - y.unnormalized(), next(x, y));
+        }
+        friend lazy_coupled operator - (const lazy_coupled& x, T y) {
+            return counted(x.unnormalized() - y, x.count + 1);
+        }
+        friend lazy_coupled operator - (T x, const lazy_coupled& y) {
+            return counted(x - y.unnormalized(), y.count + 1);
+        }
+
+        friend lazy_coupled operator * (const lazy_coupled& x, const lazy_coupled& y) {
+            return counted(x.unnormalized() * y.unnormalized(), next(x, y));
+        }
+        friend lazy_coupled operator * (const lazy_coupled& x, T y) {
+            return counted(x.unnormalized() * y, x.count + 1);
+        }
+        friend lazy_coupled operator * (T x, const lazy_coupled& y) {
+            return counted(x * y.unnormalized(), y.count + 1);
+        }
+
+        // Divide renormalized operands, result is renormalized
+        friend lazy_coupled operator / (const lazy_coupled& x, const lazy_coupled& y) {
+            return lazy_coupled(coupled<T>(x) / coupled<T>(y));
+        }
+        friend lazy_coupled operator / (const lazy_coupled& x, T y) {
+            return lazy_coupled(coupled<T>(x) / y);
+        }
+        friend lazy_coupled operator / (T x, const lazy_coupled& y) {
+            return lazy_coupled(x / coupled<T>(y));
+        }
+
+        // Mixed with coupled<T>, which otherwise would be ambiguous as
+        // coupled<T> converts to T too
+#define TFCP_LAZY_COUPLED(OP)                                                \
+        friend lazy_coupled operator OP (const lazy_coupled& x,              \
+                                         const coupled<T>& y) {              \
+            return x OP lazy_coupled(y);                                     \
+        }                                                                    \
+        friend lazy_coupled operator OP (const coupled<T>& x,                \
+                                         const lazy_coupled& y) {            \
+            return lazy_coupled(x) OP y;                                     \
+        }
+        TFCP_LAZY_COUPLED(+);
+        TFCP_LAZY_COUPLED(-);
+        TFCP_LAZY_COUPLED(*);
+        TFCP_LAZY_COUPLED(/);
+#undef TFCP_LAZY_COUPLED
+
+        lazy_coupled& operator += (const lazy_coupled& x) { return *this = *this + x; }
+        lazy_coupled& operator -= (const lazy_coupled& x) { return *this = *this - x; }
+        lazy_coupled& operator *= (const lazy_coupled& x) { return *this = *this * x; }
+        lazy_coupled& operator /= (const lazy_coupled& x) { return *this = *this / x; }
+        lazy_coupled& operator += (const coupled<T>& x) { return *this = *this + x; }
+        lazy_coupled& operator -= (const coupled<T>& x) { return *this = *this - x; }
+        lazy_coupled& operator *= (const coupled<T>& x) { return *this = *this * x; }
+        lazy_coupled& operator /= (const coupled<T>& x) { return *this = *this / x; }
+        lazy_coupled& operator += (T x) { return *this = *this + x; }
+        lazy_coupled& operator -= (T x) { return *this = *this - x; }
+        lazy_coupled& operator *= (T x) { return *this = *this * x; }
+        lazy_coupled& operator /= (T x) { return *this = *this / x; }
+
+        //--------------------------------------------------------------
+        // Comparing, by renormalized coupled<T>; so only for scalar T,
+        // as for short-vectors comparing is not defined
+        //--------------------------------------------------------------
+
+#define TFCP_LAZY_COMPARE(OP)                                                \
+        friend bool operator OP (const lazy_coupled& x, const lazy_coupled& y) { \
+            return coupled<T>(x) OP coupled<T>(y);                           \
+        }                                                                    \
+        friend bool operator OP (const lazy_coupled& x, T y) {               \
+            return coupled<T>(x) OP y;                                       \
+        }                                                                    \
+        friend bool operator OP (T x, const lazy_coupled& y) {               \
+            return x OP coupled<T>(y);                                       \
+        }                                                                    \
+        friend bool operator OP (const lazy_coupled& x, const coupled<T>& y) { \
+            return coupled<T>(x) OP y;                                       \
+        }                                                                    \
+        friend bool operator OP (const coupled<T>& x, const lazy_coupled& y) { \
+            return x OP coupled<T>(y);                                       \
+        }
+        TFCP_LAZY_COMPARE(==);
+        TFCP_LAZY_COMPARE(!=);
+        TFCP_LAZY_COMPARE(>=);
+        TFCP_LAZY_COMPARE(<=);
+        TFCP_LAZY_COMPARE(> );
+        TFCP_LAZY_COMPARE(< );
+#undef TFCP_LAZY_COMPARE
+    };
+
+    //------------------------------------------------------------------
+    //
+    // Define alias types
+    //
+    //------------------------------------------------------------------
+
+    using lfloat   = lazy_coupled<float>;
+    using ldouble  = lazy_coupled<double>;
+    using lfloatx  = lazy_coupled<floatx>;
+    using ldoublex = lazy_coupled<doublex>;
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_LAZY_H
@@ -0,0 +1,59 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_LU_H
+#define TFCP_LU_H
+//======================================================================
+//
+//  Dense linear solver by mixed-precision iterative refinement, e.g.:
+//
+//    int steps = tfcp::solve_refined(n, a, lda, b, x0, x1);
+//
+//  solves a * x = b for x = x0 + x1 as coupled, where a is n x n plain
+//  double by rows: factors a by LU in plain double, then repeats:
+//
+//    r = b - a * x   -- by Dot2 (reduce.h), as if in twice precision
+//    d = a \ r       -- by the LU factors, in plain double
+//    x = x + d       -- by coupled padd
+//
+//  So the O(n^3) work runs in plain double, and only O(n^2) per step
+//  in coupled arithmetic; each step gains about -log10(cond * eps) of
+//  digits, so x gets accurate to about eps^2 * cond if cond * eps is
+//  well below 1 (see "Error bounds from extra-precise iterative
+//  refinement" by Demmel et al., ACM TOMS 32(2), 2006)
+//
+//  Returns the number of steps, or -1 if a is singular in double, or
+//  if refinement does not converge in max_steps: like if cond * eps is
+//  about 1 or more. Converged means that the last d is below eps^2 * x
+//  by max norm; or that d stops decreasing, but is below eps * x, as
+//  then accuracy is limited by the residual
+//
+//  Also, plain LU with partial pivoting, blocked so that most work goes
+//  by matrix products (see gemm.h), and split between threads (see
+//  set_reduce_threads() in reduce.h):
+//
+//    bool ok = tfcp::lu_factor(n, a, lda, piv);  // in place: a = P*L*U
+//    tfcp::lu_solve(n, a, lda, piv, x);          // in place: b into x
+//
+//  lu_factor() returns false if it meets zero pivot
+//
+//======================================================================
+
+#include <cstddef>
+
+namespace tfcp {
+
+    bool lu_factor(size_t n, double a[], size_t lda, size_t piv[]);
+
+    void lu_solve(size_t n, const double lu[], size_t lda, const size_t piv[],
+                  double x[]);
+
+    int solve_refined(size_t n, const double a[], size_t lda, const double b[],
+                      double x0[], double x1[], int max_steps = 20);
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_LU_H
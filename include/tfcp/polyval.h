@@ -0,0 +1,68 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_POLYVAL_H
+#define TFCP_POLYVAL_H
+//======================================================================
+//
+//  Polynomial of plain coefficients at plain x, with coupled result:
+//
+//    coupled<double> p = tfcp::polyval(n, c, x);
+//
+//  is c[0] + c[1] x + ... + c[n - 1] x^(n - 1), or zero if n is zero;
+//  and for m values of x at once, like batch.h:
+//
+//    tfcp::polyval(n, c, m, x, z0, z1);  -- z0[j] + z1[j] = p(x[j])
+//
+//  By compensated Horner: exact transforms of each step, and the sum
+//  of their errors by plain Horner aside; so z0 + z1 is p(x) as if
+//  computed with precision eps^2, if eps is epsilon of T, at the cost
+//  of few plain Horner
+//
+//  polyval_estrin() is same but by Estrin's scheme in coupled arithmetic:
+//  chain of dependent steps is about log2(n) instead of n long, but it
+//  takes about twice more operations; so on arrays, whose vector lanes
+//  keep the pipeline busy anyway, it is slower than Horner; result may
+//  differ in last bits of z1
+//
+//  Error of either is about n^2 eps^2 relative to sum of |c[i] x^i|, so
+//  relative to p(x), unless x is close to a root
+//
+//  Computed by vector kernels for the ISA selected at runtime, see the
+//  dispatch.h, each vector lane for its own x; single x goes by same
+//  kernel, so result is the same as for arrays; arrays split between
+//  threads, see reduce.h
+//
+//  NB: result may differ in last bits of z1, for the ISA with FMA versus
+//  without, same as coupled arithmetic
+//
+//======================================================================
+
+#include <tfcp/twofold.h>
+
+#include <cstddef>
+
+namespace tfcp {
+
+    coupled<double> polyval(size_t n, const double c[], double x);
+    coupled<float>  polyval(size_t n, const float  c[], float  x);
+
+    coupled<double> polyval_estrin(size_t n, const double c[], double x);
+    coupled<float>  polyval_estrin(size_t n, const float  c[], float  x);
+
+    void polyval(size_t n, const double c[], size_t m, const double x[],
+                 double z0[], double z1[]);
+    void polyval(size_t n, const float  c[], size_t m, const float  x[],
+                 float  z0[], float  z1[]);
+
+    void polyval_estrin(size_t n, const double c[], size_t m, const double x[],
+                        double z0[], double z1[]);
+    void polyval_estrin(size_t n, const float  c[], size_t m, const float  x[],
+                        float  z0[], float  z1[]);
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_POLYVAL_H
@@ -0,0 +1,61 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_PREDICATES_H
+#define TFCP_PREDICATES_H
+//======================================================================
+//
+//  Robust geometric predicates, adaptive like Shewchuk's, e.g.:
+//
+//    int s = tfcp::orient2d(a, b, c);
+//
+//  returns exact sign of the determinant, as +1, -1, or 0:
+//
+//    orient2d(a, b, c)     > 0 if a, b, c go counterclockwise
+//    orient3d(a, b, c, d)  > 0 if d is below the plane of a, b, c, where
+//                              a, b, c go counterclockwise seen above
+//    incircle(a, b, c, d)  > 0 if d is inside the circle through a, b, c,
+//                              where a, b, c go counterclockwise
+//
+//  Points are arrays of 2 or 3 double coordinates
+//
+//  First, evaluate the determinant in twofold<double>: value is exactly
+//  the plain double result, and error estimates its rounding; if value
+//  and value + error have same sign, which is what comparison operators
+//  of twofold check, and |value + error| exceeds the bound on the error
+//  of the estimate, then this sign is certain; else, if sign of value
+//  is ambiguous, then evaluate by exact expansion arithmetic
+//
+//  So that typical inputs cost few times plain double arithmetic, and
+//  only nearly degenerate inputs pay for the exact evaluation
+//
+//  Batch variants take n queries, where the k-th query takes point k
+//  of each array, so a[2*k] and a[2*k + 1] for orient2d, and write its
+//  sign into s[k]; queries split between threads, see reduce.h
+//
+//  NB: exact, if no overflow or underflow in the products of coordinate
+//  differences; e.g. if coordinates are less than 2^200 by magnitude,
+//  and differences are either zero or greater than 2^-200
+//
+//======================================================================
+
+#include <cstddef>
+
+namespace tfcp {
+
+    int orient2d(const double a[2], const double b[2], const double c[2]);
+    int orient3d(const double a[3], const double b[3], const double c[3], const double d[3]);
+    int incircle(const double a[2], const double b[2], const double c[2], const double d[2]);
+
+    void orient2d(size_t n, const double a[], const double b[], const double c[], int s[]);
+    void orient3d(size_t n, const double a[], const double b[], const double c[],
+                  const double d[], int s[]);
+    void incircle(size_t n, const double a[], const double b[], const double c[],
+                  const double d[], int s[]);
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_PREDICATES_H
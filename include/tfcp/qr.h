@@ -0,0 +1,65 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_QR_H
+#define TFCP_QR_H
+//======================================================================
+//
+//  Householder QR and least squares in coupled arithmetic, e.g.:
+//
+//    bool ok = tfcp::least_squares(m, n, a0, a1, lda, b0, b1, x0, x1);
+//
+//  finds x of n elements that minimizes |a*x - b|, where a is m x n,
+//  m >= n, of full rank; matrices are by rows, each as separate arrays
+//  of values and errors like for gemm.h; returns false if m < n, or if
+//  R has zero on its diagonal
+//
+//  Error of x is about eps^2 * cond(a) relative, if eps is epsilon of
+//  T: so for double, x keeps about 32 - log10(cond) digits, where the
+//  plain double QR would keep 16 - log10(cond), nothing if cond = 1e16
+//
+//  Also, the QR factorization itself, like LAPACK's dgeqrf:
+//
+//    tfcp::qr_factor(m, n, a0, a1, lda, tau0, tau1);
+//    tfcp::qr_apply_qt(m, n, a0, a1, lda, tau0, tau1, b0, b1);
+//
+//  qr_factor() overwrites a by R in its upper triangle, and vectors of
+//  Householder reflectors H(j) = I - tau[j] * v * v^T below diagonal,
+//  with v[j] = 1 implicitly; so that a = Q*R, Q = H(0)*H(1)*...; and
+//  qr_apply_qt() overwrites b of m elements by Q^T * b
+//
+//  Blocked by compact WY representation (Schreiber and Van Loan, SIAM
+//  J. Sci. Stat. Comput. 10(1), 1989): block of NB reflectors is like
+//  I - V*T*V^T, which applies to trailing columns by three coupled
+//  matrix products, see gemm.h
+//
+//  NB: no scaling against overflow, so |a| must be well below sqrt of
+//  max of T
+//
+//======================================================================
+
+#include <cstddef>
+
+namespace tfcp {
+
+    void qr_factor(size_t m, size_t n, double a0[], double a1[], size_t lda,
+                   double tau0[], double tau1[]);
+    void qr_factor(size_t m, size_t n, float  a0[], float  a1[], size_t lda,
+                   float  tau0[], float  tau1[]);
+
+    void qr_apply_qt(size_t m, size_t n, const double a0[], const double a1[], size_t lda,
+                     const double tau0[], const double tau1[], double b0[], double b1[]);
+    void qr_apply_qt(size_t m, size_t n, const float  a0[], const float  a1[], size_t lda,
+                     const float  tau0[], const float  tau1[], float  b0[], float  b1[]);
+
+    bool least_squares(size_t m, size_t n, const double a0[], const double a1[], size_t lda,
+                       const double b0[], const double b1[], double x0[], double x1[]);
+    bool least_squares(size_t m, size_t n, const float  a0[], const float  a1[], size_t lda,
+                       const float  b0[], const float  b1[], float  x0[], float  x1[]);
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_QR_H
@@ -0,0 +1,107 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_REDUCE_H
+#define TFCP_REDUCE_H
+//======================================================================
+//
+//  Accurate reductions over arrays, e.g.:
+//
+//    tfcp::coupled<double> s = tfcp::sum(n, x);
+//    tfcp::coupled<double> d = tfcp::dot2(n, x, y);
+//    tfcp::coupled<double> r = tfcp::rsum(n, x);
+//
+//  compute sum of x, and dot product of x and y, as if in twice the
+//  working precision, then round into coupled: by Sum2 and Dot2 of
+//  Ogita, Rump, and Oishi (see "Accurate sum and dot product", SIAM
+//  J. Sci. Comput. 26(6), 2005)
+//
+//  So error of d.value + d.error is about eps^2 * cond * |x.y|, where
+//  cond = |x|.|y| / |x.y|, and eps is epsilon of T; thus the d.value
+//  is faithful unless cond is as large as 1/eps. Same for the sum,
+//  where cond = sum|x| / |sum x|
+//
+//  Kernels are vectorized for the CPU found at runtime (dispatch.h),
+//  and long arrays split into chunks to process by several threads.
+//  Result is bitwise same for any ISA and any number of threads; and
+//  rsum() is also same for any order of elements
+//
+//======================================================================
+
+#include <tfcp/batch.h>
+#include <tfcp/twofold.h>
+
+#include <cassert>
+#include <cstddef>
+
+namespace tfcp {
+
+    //------------------------------------------------------------------
+    //
+    // Sum
+    //
+    //------------------------------------------------------------------
+
+    coupled<double> sum(size_t n, const double x[]);
+    coupled<float>  sum(size_t n, const float  x[]);
+
+    inline coupled<double> sum(span<const double> x) { return sum(x.size(), x.data()); }
+    inline coupled<float>  sum(span<const float>  x) { return sum(x.size(), x.data()); }
+
+    //------------------------------------------------------------------
+    //
+    // Reproducible sum, by binned accumulation like ReproBLAS
+    //
+    // Result is bitwise same for any order of x, and so for any ISA and
+    // number of threads: error is about 2^-80 * max|x| relative, while
+    // the sum() above is accurate versus the sum|x|, but its result may
+    // change if reorder x
+    //
+    // If x has Inf or NaN, result is their sum; finite x must be less
+    // than 2^960 by value. For float, result is rounded from double
+    //
+    //------------------------------------------------------------------
+
+    coupled<double> rsum(size_t n, const double x[]);
+    coupled<float>  rsum(size_t n, const float  x[]);
+
+    inline coupled<double> rsum(span<const double> x) { return rsum(x.size(), x.data()); }
+    inline coupled<float>  rsum(span<const float>  x) { return rsum(x.size(), x.data()); }
+
+    //------------------------------------------------------------------
+    //
+    // Dot product
+    //
+    //------------------------------------------------------------------
+
+    coupled<double> dot2(size_t n, const double x[], const double y[]);
+    coupled<float>  dot2(size_t n, const float  x[], const float  y[]);
+
+    inline coupled<double> dot2(span<const double> x, span<const double> y) {
+        assert(x.size() == y.size());
+        return dot2(x.size(), x.data(), y.data());
+    }
+    inline coupled<float> dot2(span<const float> x, span<const float> y) {
+        assert(x.size() == y.size());
+        return dot2(x.size(), x.data(), y.data());
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Threads for reductions and gemm: by default, as many as CPU has
+    //
+    // Set 1 to run in the calling thread only, or 0 to reset default
+    // NB: not thread-safe versus concurrent calls to reductions
+    //
+    //------------------------------------------------------------------
+
+    void set_reduce_threads(int threads);
+
+    int reduce_threads();
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_REDUCE_H
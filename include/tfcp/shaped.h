@@ -0,0 +1,159 @@
+//======================================================================
+// 2014-2015, 2019-2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_SHAPED_H
+#define TFCP_SHAPED_H
+//======================================================================
+//
+// Implementation of arithmetic functions over shaped<T> for twofold.h
+//
+// Thin wrappers over the basic.h templates, e.g.:
+//   tadd(x, y) = tadd(x.value, x.error, y.value, y.error, z.error)
+//
+// Functions are inline by default, so compiler may fuse them into the
+// caller's code; or compiled into tfcp library if TFCP_COMPILED
+//
+// Inline variant goes to TFCP_SIMD_ISA namespace, like basic.h, as the
+// same function compiles differently e.g. with and without FMA
+//
+//======================================================================
+
+#include <tfcp/twofold.h>
+#include <tfcp/basic.h>
+
+namespace tfcp {
+TFCP_ISA_BEGIN
+
+    //------------------------------------------------------------------
+    //
+    //  Renormalize
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_RENORM(T)                                            \
+    TFCP_INLINE shaped<T> renormalize(const shaped<T>& x) {       \
+        T value, error;                                           \
+        value = renormalize(x.value, x.error, error);             \
+        return shaped<T>(value, error);                           \
+    }                                                             \
+    TFCP_INLINE shaped<T> fast_renorm(const shaped<T>& x) {       \
+        T value, error;                                           \
+        value = fast_renorm(x.value, x.error, error);             \
+        return shaped<T>(value, error);                           \
+    }
+    TFCP_RENORM(double);
+    TFCP_RENORM(float);
+#undef TFCP_RENORM
+
+    //------------------------------------------------------------------
+    //
+    //  Square root
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_SQRT(PREFIX, T)                                      \
+    TFCP_INLINE shaped<T> PREFIX ## sqrt(const shaped<T>& x) {    \
+        T value, error;                                           \
+        value = PREFIX ## sqrt(x.value, x.error, error);          \
+        return shaped<T>(value, error);                           \
+    }                                                             \
+    TFCP_INLINE shaped<T> PREFIX ## sqrt(T x) {                   \
+        T value, error;                                           \
+        value = PREFIX ## sqrt0(x, error);                        \
+        return shaped<T>(value, error);                           \
+    }
+    TFCP_SQRT(t, double);
+    TFCP_SQRT(p, double);
+    TFCP_SQRT(t, float);
+    TFCP_SQRT(p, float);
+#undef TFCP_SQRT
+
+    //------------------------------------------------------------------
+    //
+    //  Add, subtract, multiply, divide
+    //
+    //  Suffix of basic.h function tells which argument is dotted:
+    //    1: y is dotted, 2: x is dotted, 0: both are dotted
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_ARITHM_BASE(OP, PREFIX, T)                                          \
+    TFCP_INLINE shaped<T> PREFIX ## OP(const shaped<T>& x, const shaped<T>& y) { \
+        T value, error;                                                          \
+        value = PREFIX ## OP(x.value, x.error, y.value, y.error, error);         \
+        return shaped<T>(value, error);                                          \
+    }                                                                            \
+    TFCP_INLINE shaped<T> PREFIX ## OP(const shaped<T>& x, T y) {                \
+        T value, error;                                                          \
+        value = PREFIX ## OP ## 1(x.value, x.error, y, error);                   \
+        return shaped<T>(value, error);                                          \
+    }                                                                            \
+    TFCP_INLINE shaped<T> PREFIX ## OP(T x, const shaped<T>& y) {                \
+        T value, error;                                                          \
+        value = PREFIX ## OP ## 2(x, y.value, y.error, error);                   \
+        return shaped<T>(value, error);                                          \
+    }                                                                            \
+    TFCP_INLINE shaped<T> PREFIX ## OP(T x, T y) {                               \
+        T value, error;                                                          \
+        value = PREFIX ## OP ## 0(x, y, error);                                  \
+        return shaped<T>(value, error);                                          \
+    }
+    TFCP_ARITHM_BASE(add, t, double);
+    TFCP_ARITHM_BASE(sub, t, double);
+    TFCP_ARITHM_BASE(mul, t, double);
+    TFCP_ARITHM_BASE(div, t, double);
+    TFCP_ARITHM_BASE(add, p, double);
+    TFCP_ARITHM_BASE(sub, p, double);
+    TFCP_ARITHM_BASE(mul, p, double);
+    TFCP_ARITHM_BASE(div, p, double);
+    TFCP_ARITHM_BASE(add, t, float);
+    TFCP_ARITHM_BASE(sub, t, float);
+    TFCP_ARITHM_BASE(mul, t, float);
+    TFCP_ARITHM_BASE(div, t, float);
+    TFCP_ARITHM_BASE(add, p, float);
+    TFCP_ARITHM_BASE(sub, p, float);
+    TFCP_ARITHM_BASE(mul, p, float);
+    TFCP_ARITHM_BASE(div, p, float);
+#undef TFCP_ARITHM_BASE
+
+    //------------------------------------------------------------------
+    //
+    //  Fused: one renormalization, see basic.h
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_FUSED(F, T)                                                         \
+    TFCP_INLINE shaped<T> p ## F(const shaped<T>& x, const shaped<T>& y,         \
+                                 const shaped<T>& w) {                           \
+        T value, error;                                                          \
+        value = p ## F(x.value, x.error, y.value, y.error, w.value, w.error,     \
+                       error);                                                   \
+        return shaped<T>(value, error);                                          \
+    }
+    TFCP_FUSED(fma, double);
+    TFCP_FUSED(fms, double);
+    TFCP_FUSED(sum3, double);
+    TFCP_FUSED(fma, float);
+    TFCP_FUSED(fms, float);
+    TFCP_FUSED(sum3, float);
+#undef TFCP_FUSED
+
+#define TFCP_DOT2(T)                                                             \
+    TFCP_INLINE shaped<T> pdot2(const shaped<T>& a, const shaped<T>& b,          \
+                                const shaped<T>& c, const shaped<T>& d) {        \
+        T value, error;                                                          \
+        value = pdot2(a.value, a.error, b.value, b.error,                        \
+                      c.value, c.error, d.value, d.error, error);                \
+        return shaped<T>(value, error);                                          \
+    }
+    TFCP_DOT2(double);
+    TFCP_DOT2(float);
+#undef TFCP_DOT2
+
+TFCP_ISA_END
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_SHAPED_H
@@ -0,0 +1,1037 @@
+//======================================================================
+// 2019-2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_SIMD_H
+#define TFCP_SIMD_H
+//======================================================================
+//
+// Define short-vector types: floatx, doublex
+//
+// Types naming like floatx refers to the OpenCL-like types, e.g. float4
+//
+// Suffix `x` means that you do not know vector length in advance: as it
+// depends on the short-vector extension supported by CPU and compiler.
+//
+// Determine actual length like following, e.g.:
+//   size_t constexpr floatx_length = sizeof(floatx) / sizeof(float);
+//
+// Or equivalently: traitx<floatx>::length
+//
+//----------------------------------------------------------------------
+//
+// Then, define fmsub(x, y, z) = x*y - z for scalar and vector floats
+//
+// Note that std::fma appears useless for TFCP as our target compilers
+// appear to implement it with software even if hardware supports FMA;
+// either replace fma(x, y, -z) with x*y - z if no hardware support --
+// so that fma(x, y, -x*y) cannot compute the rounding error of x*y
+//
+// Thus we use hardware specific FMA instead of the std::fma(x, y, z)
+//
+//----------------------------------------------------------------------
+//
+// Backends for Intel/AMD processors, selected by compiler options:
+//
+// - AVX + FMA, if compiler enables FMA, e.g.:
+//     cl /arch:AVX2 ...
+//     clang++ -mfma ...
+//
+// - AVX-512F, if you additionally define TFCP_SIMD_AVX512, e.g.:
+//     cl /arch:AVX512 /DTFCP_SIMD_AVX512 ...
+//     clang++ -mavx512f -mfma -DTFCP_SIMD_AVX512 ...
+//
+//   Then floatx/doublex are 16/8 lanes instead of 8/4 with AVX2
+//
+// - AVX without FMA, if compiler enables AVX but not FMA (like older
+//   Intel's Sandy Bridge), or if you define TFCP_SIMD_NOFMA
+//
+// - SSE2 without FMA, otherwise
+//
+// Portable backend for any target of g++/clang++, e.g. ARM or Power:
+//
+// - GCC vector extensions, if TFCP_SIMD_GENERIC, or if target is not
+//   x86; vector width is TFCP_SIMD_WIDTH bytes, by default 64 bytes if
+//   AVX-512F, 32 if AVX, or 16 otherwise; e.g.:
+//     g++ -march=native -DTFCP_SIMD_GENERIC ...
+//
+//   Here fmsub and fnmadd are __builtin_fma per each lane, so compiler
+//   would vectorize them if target supports FMA -- which we assume if
+//   compiler reports __FP_FAST_FMA, else we work like TFCP_SIMD_NOFMA
+//
+// Without FMA, exact.h computes exact products with Dekker-Veltkamp
+// algorithm, vectorized same way as with FMA. The fmsub and fnmadd
+// are still correct here, but slow: as we call std::fma per each lane
+// -- which the C library emulates in software
+//
+// Supported compilers: g++/clang++ for Linux, cl for Windows
+//
+//----------------------------------------------------------------------
+//
+// Same program may combine code compiled for several backends, e.g.
+// the tfcp library selects kernels at runtime by the CPU features
+//
+// To keep such code apart, we define it in the inline namespace named
+// by TFCP_SIMD_ISA: like tfcp::avx2::padd<double> if AVX2, so linker
+// would not mix it up with tfcp::sse2::padd<double> if SSE2
+//
+//======================================================================
+
+#if defined(__GNUC__)
+    // OK: g++ or clang for Linux (or maybe Intel's icc)
+
+    #ifndef TFCP_SIMD_GCC
+    #define TFCP_SIMD_GCC
+    #endif
+
+    // Not x86: only portable backend
+    #if !defined(__x86_64__) && !defined(__i386__)
+        #ifndef TFCP_SIMD_GENERIC
+        #define TFCP_SIMD_GENERIC
+        #endif
+    #endif
+
+    #if defined(TFCP_SIMD_GENERIC)
+        #if defined(TFCP_SIMD_AVX512) || defined(TFCP_SIMD_SSE2)
+            #error TFCP_SIMD_GENERIC excludes other backends!
+        #endif
+        #ifndef TFCP_SIMD_WIDTH
+            #if defined(__AVX512F__)
+                #define TFCP_SIMD_WIDTH 64
+            #elif defined(__AVX__)
+                #define TFCP_SIMD_WIDTH 32
+            #else
+                #define TFCP_SIMD_WIDTH 16
+            #endif
+        #endif
+        #if defined(__FP_FAST_FMA) && defined(__FP_FAST_FMAF) && !defined(TFCP_SIMD_NOFMA)
+            #ifndef TFCP_SIMD_FMA
+            #define TFCP_SIMD_FMA
+            #endif
+        #endif
+    #endif
+
+    #if defined(TFCP_SIMD_AVX512) && !defined(__AVX512F__)
+        #error Please enable AVX-512! (like: g++ -mavx512f -mfma ...)
+    #endif
+
+    #if defined(TFCP_SIMD_AVX512) && !defined(__FMA__)
+        #error Please enable FMA! (like: g++ -mavx512f -mfma ...)
+    #endif
+
+    #if defined(__AVX__) && !defined(TFCP_SIMD_SSE2) && !defined(TFCP_SIMD_GENERIC)
+        #ifndef TFCP_SIMD_AVX
+        #define TFCP_SIMD_AVX
+        #endif
+        #if defined(__FMA__) && !defined(TFCP_SIMD_NOFMA)
+            #ifndef TFCP_SIMD_FMA
+            #define TFCP_SIMD_FMA
+            #endif
+        #endif
+    #endif
+
+#elif defined(_MSC_VER)
+    // OK: cl for Windows (or maybe Intel's icl)
+
+    #ifndef TFCP_SIMD_MSC
+    #define TFCP_SIMD_MSC
+    #endif
+
+    #if defined(TFCP_SIMD_GENERIC)
+        #error TFCP_SIMD_GENERIC requires g++ or clang++!
+    #endif
+
+    #if defined(TFCP_SIMD_AVX512) && !defined(__AVX512F__)
+        #error Please enable AVX-512! (like: cl /arch:AVX512 ...)
+    #endif
+
+    #if defined(__AVX__) && !defined(TFCP_SIMD_SSE2)
+        #ifndef TFCP_SIMD_AVX
+        #define TFCP_SIMD_AVX
+        #endif
+        #if defined(__AVX2__) && !defined(TFCP_SIMD_NOFMA)
+            #ifndef TFCP_SIMD_FMA
+            #define TFCP_SIMD_FMA
+            #endif
+        #endif
+    #endif
+
+#else
+    #error Unsupported compiler!
+#endif
+
+// AVX-512 implies AVX + FMA
+#if defined(TFCP_SIMD_AVX512)
+    #if defined(TFCP_SIMD_NOFMA)
+        #error TFCP_SIMD_NOFMA is not supported with AVX-512!
+    #endif
+    #ifndef TFCP_SIMD_AVX
+    #define TFCP_SIMD_AVX
+    #endif
+    #ifndef TFCP_SIMD_FMA
+    #define TFCP_SIMD_FMA
+    #endif
+#endif
+
+#if !defined(TFCP_SIMD_AVX) && !defined(TFCP_SIMD_GENERIC)
+    #ifndef TFCP_SIMD_SSE2
+    #define TFCP_SIMD_SSE2
+    #endif
+#endif
+
+#if !defined(TFCP_SIMD_FMA)
+    #ifndef TFCP_SIMD_NOFMA
+    #define TFCP_SIMD_NOFMA
+    #endif
+#endif
+
+// Name of inline namespace for this backend
+#if defined(TFCP_SIMD_GENERIC)
+    #define TFCP_SIMD_ISA generic
+#elif defined(TFCP_SIMD_AVX512)
+    #define TFCP_SIMD_ISA avx512
+#elif defined(TFCP_SIMD_AVX) && defined(TFCP_SIMD_FMA)
+    #define TFCP_SIMD_ISA avx2
+#elif defined(TFCP_SIMD_AVX)
+    #define TFCP_SIMD_ISA avx
+#else
+    #define TFCP_SIMD_ISA sse2
+#endif
+
+//----------------------------------------------------------------------
+//
+// Include headers: compiler and hardware specific
+//
+//----------------------------------------------------------------------
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(TFCP_SIMD_GENERIC)
+
+    // vectors by compiler extensions, see floatx and doublex below
+
+#elif defined(TFCP_SIMD_AVX)
+
+    #include <immintrin.h>
+
+#elif defined(TFCP_SIMD_SSE2)
+
+    #include <emmintrin.h>
+
+#else
+    #error Unsupported hardware!
+#endif
+
+//----------------------------------------------------------------------
+//
+// Define floatx/doublex for target compiler and hardware
+//
+//----------------------------------------------------------------------
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+#if defined(TFCP_SIMD_GENERIC)
+
+    typedef float  floatx  __attribute__((vector_size(TFCP_SIMD_WIDTH)));
+    typedef double doublex __attribute__((vector_size(TFCP_SIMD_WIDTH)));
+
+#elif defined(TFCP_SIMD_AVX512)
+
+    #if defined(TFCP_SIMD_GCC)
+
+        typedef float  floatx  __attribute__((vector_size(64)));
+        typedef double doublex __attribute__((vector_size(64)));
+
+    #elif defined(TFCP_SIMD_MSC)
+
+        typedef __m512  floatx;
+        typedef __m512d doublex;
+
+        inline floatx operator + (floatx x, floatx y) { return _mm512_add_ps(x, y); }
+        inline floatx operator - (floatx x, floatx y) { return _mm512_sub_ps(x, y); }
+        inline floatx operator * (floatx x, floatx y) { return _mm512_mul_ps(x, y); }
+        inline floatx operator / (floatx x, floatx y) { return _mm512_div_ps(x, y); }
+
+        inline doublex operator + (doublex x, doublex y) { return _mm512_add_pd(x, y); }
+        inline doublex operator - (doublex x, doublex y) { return _mm512_sub_pd(x, y); }
+        inline doublex operator * (doublex x, doublex y) { return _mm512_mul_pd(x, y); }
+        inline doublex operator / (doublex x, doublex y) { return _mm512_div_pd(x, y); }
+
+        inline floatx  operator - (floatx  x) { return _mm512_sub_ps(_mm512_setzero_ps(), x); }
+        inline doublex operator - (doublex x) { return _mm512_sub_pd(_mm512_setzero_pd(), x); }
+
+    #else
+        #error Unsupported compiler!
+    #endif
+
+#elif defined(TFCP_SIMD_AVX)
+
+    #if defined(TFCP_SIMD_GCC)
+
+        // NB: vector_size(32) implies 32-bytes alignment, and we do
+        // not add aligned(32) as templates like shaped<doublex> would
+        // ignore such attribute anyway (and g++ warns about that)
+        typedef float  floatx  __attribute__((vector_size(32)));
+        typedef double doublex __attribute__((vector_size(32)));
+
+    #elif defined(TFCP_SIMD_MSC)
+
+        typedef __m256  floatx;
+        typedef __m256d doublex;
+
+        inline floatx operator + (floatx x, floatx y) { return _mm256_add_ps(x, y); }
+        inline floatx operator - (floatx x, floatx y) { return _mm256_sub_ps(x, y); }
+        inline floatx operator * (floatx x, floatx y) { return _mm256_mul_ps(x, y); }
+        inline floatx operator / (floatx x, floatx y) { return _mm256_div_ps(x, y); }
+
+        inline doublex operator + (doublex x, doublex y) { return _mm256_add_pd(x, y); }
+        inline doublex operator - (doublex x, doublex y) { return _mm256_sub_pd(x, y); }
+        inline doublex operator * (doublex x, doublex y) { return _mm256_mul_pd(x, y); }
+        inline doublex operator / (doublex x, doublex y) { return _mm256_div_pd(x, y); }
+
+        inline floatx  operator - (floatx  x) { return _mm256_sub_ps(_mm256_setzero_ps(), x); }
+        inline doublex operator - (doublex x) { return _mm256_sub_pd(_mm256_setzero_pd(), x); }
+
+        #if 0
+        inline floatx  operator * (float  x, floatx  y) { return _mm256_mul_ps(_mm256_set1_ps(x), y); }
+        inline doublex operator * (double x, doublex y) { return _mm256_mul_pd(_mm256_set1_pd(x), y); }
+        #endif
+
+    #else
+        #error Unsupported compiler!
+    #endif
+
+#elif defined(TFCP_SIMD_SSE2)
+
+    #if defined(TFCP_SIMD_GCC)
+
+        typedef float  floatx  __attribute__((vector_size(16)));
+        typedef double doublex __attribute__((vector_size(16)));
+
+    #elif defined(TFCP_SIMD_MSC)
+
+        typedef __m128  floatx;
+        typedef __m128d doublex;
+
+        inline floatx operator + (floatx x, floatx y) { return _mm_add_ps(x, y); }
+        inline floatx operator - (floatx x, floatx y) { return _mm_sub_ps(x, y); }
+        inline floatx operator * (floatx x, floatx y) { return _mm_mul_ps(x, y); }
+        inline floatx operator / (floatx x, floatx y) { return _mm_div_ps(x, y); }
+
+        inline doublex operator + (doublex x, doublex y) { return _mm_add_pd(x, y); }
+        inline doublex operator - (doublex x, doublex y) { return _mm_sub_pd(x, y); }
+        inline doublex operator * (doublex x, doublex y) { return _mm_mul_pd(x, y); }
+        inline doublex operator / (doublex x, doublex y) { return _mm_div_pd(x, y); }
+
+        inline floatx  operator - (floatx  x) { return _mm_sub_ps(_mm_setzero_ps(), x); }
+        inline doublex operator - (doublex x) { return _mm_sub_pd(_mm_setzero_pd(), x); }
+
+    #else
+        #error Unsupported compiler!
+    #endif
+
+#else
+    #error Unsupported hardware!
+#endif
+
+    // Set short-vector all values equal to given scalar
+    // NB: template, so can use like setallx<type>(value)
+    template<typename TX, typename T> inline TX setallx(T x);
+#if defined(TFCP_SIMD_GENERIC)
+    // NB: x - 0 equals x, including x = -0
+    template<> inline floatx  setallx(float  x) { return x - floatx{}; }
+    template<> inline doublex setallx(double x) { return x - doublex{}; }
+#elif defined(TFCP_SIMD_AVX512)
+    template<> inline floatx  setallx(float  x) { return _mm512_set1_ps(x); }
+    template<> inline doublex setallx(double x) { return _mm512_set1_pd(x); }
+#elif defined(TFCP_SIMD_AVX)
+    template<> inline floatx  setallx(float  x) { return _mm256_set1_ps(x); }
+    template<> inline doublex setallx(double x) { return _mm256_set1_pd(x); }
+#else
+    template<> inline floatx  setallx(float  x) { return _mm_set1_ps(x); }
+    template<> inline doublex setallx(double x) { return _mm_set1_pd(x); }
+#endif
+    template<> inline float   setallx(float  x) { return x; }
+    template<> inline double  setallx(double x) { return x; }
+
+    // Set short-vector all values equal to zero
+    template<typename TX> inline TX setzerox();
+#if defined(TFCP_SIMD_GENERIC)
+    template<> inline floatx  setzerox() { return floatx{}; }
+    template<> inline doublex setzerox() { return doublex{}; }
+#elif defined(TFCP_SIMD_AVX512)
+    template<> inline floatx  setzerox() { return _mm512_setzero_ps(); }
+    template<> inline doublex setzerox() { return _mm512_setzero_pd(); }
+#elif defined(TFCP_SIMD_AVX)
+    template<> inline floatx  setzerox() { return _mm256_setzero_ps(); }
+    template<> inline doublex setzerox() { return _mm256_setzero_pd(); }
+#else
+    template<> inline floatx  setzerox() { return _mm_setzero_ps(); }
+    template<> inline doublex setzerox() { return _mm_setzero_pd(); }
+#endif
+    template<> inline float   setzerox() { return 0; }
+    template<> inline double  setzerox() { return 0; }
+
+    //------------------------------------------------------------------
+    //
+    // Short-vector traits: base scalar type, vector type, and length
+    //
+    //------------------------------------------------------------------
+
+    template<typename TX> struct traitx {};
+    template<> struct traitx<float> {
+        using base = float;
+        using vector = floatx;
+        static constexpr int length = 1;
+    };
+    template<> struct traitx<floatx> {
+        using base = float;
+        using vector = floatx;
+        static constexpr int length = sizeof(floatx) / sizeof(float);
+    };
+    template<> struct traitx<double> {
+        using base = double;
+        using vector = doublex;
+        static constexpr int length = 1;
+    };
+    template<> struct traitx<doublex> {
+        using base = double;
+        using vector = doublex;
+        static constexpr int length = sizeof(doublex) / sizeof(double);
+    };
+
+    //------------------------------------------------------------------
+    //
+    // Get short-vector i'th position: by reference, or by value
+    //
+    //------------------------------------------------------------------
+
+    inline float& getx(floatx& x, int i) {
+        assert(0 <= i && i < traitx<floatx>::length);
+        return reinterpret_cast<float*>(&x)[i];
+    }
+
+    inline double& getx(doublex& x, int i) {
+        assert(0 <= i && i < traitx<doublex>::length);
+        return reinterpret_cast<double*>(&x)[i];
+    }
+
+    inline float getx(const floatx& x, int i) {
+        assert(0 <= i && i < traitx<floatx>::length);
+        return reinterpret_cast<const float*>(&x)[i];
+    }
+
+    inline double getx(const doublex& x, int i) {
+        assert(0 <= i && i < traitx<doublex>::length);
+        return reinterpret_cast<const double*>(&x)[i];
+    }
+
+    inline float& getx(float& x, int i) {
+        (void)i;  // unused if NDEBUG
+        assert(i == 0);
+        return x;
+    }
+
+    inline double& getx(double& x, int i) {
+        (void)i;  // unused if NDEBUG
+        assert(i == 0);
+        return x;
+    }
+
+    inline float getx(const float& x, int i) {
+        (void)i;  // unused if NDEBUG
+        assert(i == 0);
+        return x;
+    }
+
+    inline double getx(const double& x, int i) {
+        (void)i;  // unused if NDEBUG
+        assert(i == 0);
+        return x;
+    }
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//----------------------------------------------------------------------
+//
+// Load/store short-vector from/to scalar array, maybe unaligned
+//
+//----------------------------------------------------------------------
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+    // NB: template, so can use like loadx<type>(pointer)
+    template<typename TX, typename T> inline TX loadx(const T* p);
+
+#if defined(TFCP_SIMD_GENERIC)
+
+    template<> inline floatx loadx(const float* p) {
+        floatx x;
+        std::memcpy(&x, p, sizeof(x));
+        return x;
+    }
+
+    template<> inline doublex loadx(const double* p) {
+        doublex x;
+        std::memcpy(&x, p, sizeof(x));
+        return x;
+    }
+
+    inline void storex(float * p, floatx  x) { std::memcpy(p, &x, sizeof(x)); }
+    inline void storex(double* p, doublex x) { std::memcpy(p, &x, sizeof(x)); }
+
+#elif defined(TFCP_SIMD_AVX512)
+
+    template<> inline floatx  loadx(const float * p) { return _mm512_loadu_ps(p); }
+    template<> inline doublex loadx(const double* p) { return _mm512_loadu_pd(p); }
+
+    inline void storex(float * p, floatx  x) { _mm512_storeu_ps(p, x); }
+    inline void storex(double* p, doublex x) { _mm512_storeu_pd(p, x); }
+
+#elif defined(TFCP_SIMD_AVX)
+
+    template<> inline floatx  loadx(const float * p) { return _mm256_loadu_ps(p); }
+    template<> inline doublex loadx(const double* p) { return _mm256_loadu_pd(p); }
+
+    inline void storex(float * p, floatx  x) { _mm256_storeu_ps(p, x); }
+    inline void storex(double* p, doublex x) { _mm256_storeu_pd(p, x); }
+
+#elif defined(TFCP_SIMD_SSE2)
+
+    template<> inline floatx  loadx(const float * p) { return _mm_loadu_ps(p); }
+    template<> inline doublex loadx(const double* p) { return _mm_loadu_pd(p); }
+
+    inline void storex(float * p, floatx  x) { _mm_storeu_ps(p, x); }
+    inline void storex(double* p, doublex x) { _mm_storeu_pd(p, x); }
+
+#else
+    #error Unsupported hardware!
+#endif
+
+    template<> inline float   loadx(const float * p) { return *p; }
+    template<> inline double  loadx(const double* p) { return *p; }
+
+    inline void storex(float * p, float   x) { *p = x; }
+    inline void storex(double* p, double  x) { *p = x; }
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//----------------------------------------------------------------------
+//
+// Masked load/store: only first n positions, where 0 <= n <= length
+//
+// Load sets other positions to zero; store does not touch the memory
+// beyond first n elements, so fits for tail of array
+//
+//----------------------------------------------------------------------
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+    // NB: template, so can use like loadx<type>(pointer, n)
+    template<typename TX, typename T> inline TX loadx(const T* p, int n);
+
+#if defined(TFCP_SIMD_AVX512)
+
+    template<> inline floatx loadx(const float* p, int n) {
+        assert(0 <= n && n <= traitx<floatx>::length);
+        return _mm512_maskz_loadu_ps(static_cast<__mmask16>((1u << n) - 1), p);
+    }
+
+    template<> inline doublex loadx(const double* p, int n) {
+        assert(0 <= n && n <= traitx<doublex>::length);
+        return _mm512_maskz_loadu_pd(static_cast<__mmask8>((1u << n) - 1), p);
+    }
+
+    inline void storex(float* p, floatx x, int n) {
+        assert(0 <= n && n <= traitx<floatx>::length);
+        _mm512_mask_storeu_ps(p, static_cast<__mmask16>((1u << n) - 1), x);
+    }
+
+    inline void storex(double* p, doublex x, int n) {
+        assert(0 <= n && n <= traitx<doublex>::length);
+        _mm512_mask_storeu_pd(p, static_cast<__mmask8>((1u << n) - 1), x);
+    }
+
+#elif defined(TFCP_SIMD_AVX)
+
+    // Mask for first n positions: like ones[8 - n ... 16 - n]
+    // NB: AVX has no integer compare for 256-bits, so use table
+    inline __m256i maskx_ps(int n) {
+        static const int ones[16] = { -1, -1, -1, -1, -1, -1, -1, -1,
+                                       0,  0,  0,  0,  0,  0,  0,  0 };
+        assert(0 <= n && n <= 8);
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&ones[8 - n]));
+    }
+
+    inline __m256i maskx_pd(int n) {
+        static const long long ones[8] = { -1, -1, -1, -1, 0, 0, 0, 0 };
+        assert(0 <= n && n <= 4);
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&ones[4 - n]));
+    }
+
+    template<> inline floatx  loadx(const float * p, int n) { return _mm256_maskload_ps(p, maskx_ps(n)); }
+    template<> inline doublex loadx(const double* p, int n) { return _mm256_maskload_pd(p, maskx_pd(n)); }
+
+    inline void storex(float * p, floatx  x, int n) { _mm256_maskstore_ps(p, maskx_ps(n), x); }
+    inline void storex(double* p, doublex x, int n) { _mm256_maskstore_pd(p, maskx_pd(n), x); }
+
+#else
+
+    // SSE2 or generic: no masked load/store, so copy via memory
+    template<> inline floatx loadx(const float* p, int n) {
+        assert(0 <= n && n <= traitx<floatx>::length);
+        float tmp[traitx<floatx>::length] = {};
+        for (int i = 0; i < n; i++)
+            tmp[i] = p[i];
+        return loadx<floatx>(tmp);
+    }
+
+    template<> inline doublex loadx(const double* p, int n) {
+        assert(0 <= n && n <= traitx<doublex>::length);
+        double tmp[traitx<doublex>::length] = {};
+        for (int i = 0; i < n; i++)
+            tmp[i] = p[i];
+        return loadx<doublex>(tmp);
+    }
+
+    inline void storex(float* p, floatx x, int n) {
+        assert(0 <= n && n <= traitx<floatx>::length);
+        for (int i = 0; i < n; i++)
+            p[i] = getx(x, i);
+    }
+
+    inline void storex(double* p, doublex x, int n) {
+        assert(0 <= n && n <= traitx<doublex>::length);
+        for (int i = 0; i < n; i++)
+            p[i] = getx(x, i);
+    }
+
+#endif
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//----------------------------------------------------------------------
+//
+// Square root: hardware specific
+//
+//----------------------------------------------------------------------
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+#if defined(TFCP_SIMD_GENERIC)
+
+    inline float  hw_sqrt(float  x) { return __builtin_sqrtf(x); }
+    inline double hw_sqrt(double x) { return __builtin_sqrt (x); }
+
+    inline floatx hw_sqrt(floatx x) {
+        for (int i = 0; i < traitx<floatx>::length; i++) {
+            x[i] = hw_sqrt(x[i]);
+        }
+        return x;
+    }
+
+    inline doublex hw_sqrt(doublex x) {
+        for (int i = 0; i < traitx<doublex>::length; i++) {
+            x[i] = hw_sqrt(x[i]);
+        }
+        return x;
+    }
+
+#else
+
+#if defined(TFCP_SIMD_AVX512)
+    inline floatx  hw_sqrt(floatx  x) { return _mm512_sqrt_ps(x); }
+    inline doublex hw_sqrt(doublex x) { return _mm512_sqrt_pd(x); }
+#elif defined(TFCP_SIMD_AVX)
+    inline floatx  hw_sqrt(floatx  x) { return _mm256_sqrt_ps(x); }
+    inline doublex hw_sqrt(doublex x) { return _mm256_sqrt_pd(x); }
+#elif defined(TFCP_SIMD_SSE2)
+    inline floatx  hw_sqrt(floatx  x) { return _mm_sqrt_ps(x); }
+    inline doublex hw_sqrt(doublex x) { return _mm_sqrt_pd(x); }
+#else
+    #error Unsupported hardware!
+#endif
+
+    inline float hw_sqrt(float x) {
+        return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x)));
+    }
+
+    inline double hw_sqrt(double x) {
+        __m128d tmp = _mm_set_sd(x);
+        return _mm_cvtsd_f64(_mm_sqrt_sd(tmp, tmp));
+    }
+
+#endif
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//----------------------------------------------------------------------
+//
+// Absolute value and maximum: hardware specific
+//
+// NB: if x or y is NaN, maxx(x, y) may return either of them
+//
+//----------------------------------------------------------------------
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+#if defined(TFCP_SIMD_GENERIC)
+
+    inline floatx  absx(floatx  x) { return x < 0 ? -x : x; }
+    inline doublex absx(doublex x) { return x < 0 ? -x : x; }
+
+    inline floatx  maxx(floatx  x, floatx  y) { return x > y ? x : y; }
+    inline doublex maxx(doublex x, doublex y) { return x > y ? x : y; }
+
+#elif defined(TFCP_SIMD_AVX512)
+
+    inline floatx  absx(floatx  x) { return _mm512_abs_ps(x); }
+    inline doublex absx(doublex x) { return _mm512_abs_pd(x); }
+
+    inline floatx  maxx(floatx  x, floatx  y) { return _mm512_max_ps(x, y); }
+    inline doublex maxx(doublex x, doublex y) { return _mm512_max_pd(x, y); }
+
+#elif defined(TFCP_SIMD_AVX)
+
+    inline floatx  absx(floatx  x) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), x); }
+    inline doublex absx(doublex x) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+
+    inline floatx  maxx(floatx  x, floatx  y) { return _mm256_max_ps(x, y); }
+    inline doublex maxx(doublex x, doublex y) { return _mm256_max_pd(x, y); }
+
+#elif defined(TFCP_SIMD_SSE2)
+
+    inline floatx  absx(floatx  x) { return _mm_andnot_ps(_mm_set1_ps(-0.f), x); }
+    inline doublex absx(doublex x) { return _mm_andnot_pd(_mm_set1_pd(-0.0), x); }
+
+    inline floatx  maxx(floatx  x, floatx  y) { return _mm_max_ps(x, y); }
+    inline doublex maxx(doublex x, doublex y) { return _mm_max_pd(x, y); }
+
+#else
+    #error Unsupported hardware!
+#endif
+
+    inline float  absx(float  x) { return x < 0 ? -x : x; }
+    inline double absx(double x) { return x < 0 ? -x : x; }
+
+    inline float  maxx(float  x, float  y) { return x > y ? x : y; }
+    inline double maxx(double x, double y) { return x > y ? x : y; }
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//----------------------------------------------------------------------
+//
+// Power of 2 and binary exponent: hardware specific
+//
+//   pow2x(k) = 2^k, where k is integer valued, and 2^k is normal, like
+//              -1022 <= k <= 1023 for double
+//   logbx(x) = exponent of x as integer valued, like std::logb(x), for
+//              x normal and finite
+//
+// By bits: 2^k as exponent field k + bias, shifted from the low bits of
+// k + bias + 2^52 (or 2^23 for float); and back, exponent field goes to
+// low bits of 2^52, so subtract 2^52 + bias
+//
+// NB: result is undefined if k or x is out of range
+//
+//----------------------------------------------------------------------
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+    inline float pow2x(float k) {
+        float t = k + (127.f + 8388608.f);
+        uint32_t i;
+        std::memcpy(&i, &t, sizeof(i));
+        i <<= 23;
+        std::memcpy(&t, &i, sizeof(i));
+        return t;
+    }
+
+    inline double pow2x(double k) {
+        double t = k + (1023. + 4503599627370496.);
+        uint64_t i;
+        std::memcpy(&i, &t, sizeof(i));
+        i <<= 52;
+        std::memcpy(&t, &i, sizeof(i));
+        return t;
+    }
+
+    inline float logbx(float x) {
+        uint32_t i;
+        std::memcpy(&i, &x, sizeof(i));
+        i = (i >> 23 & 0xff) | 0x4b000000;  // bits of 2^23
+        std::memcpy(&x, &i, sizeof(i));
+        return x - (127.f + 8388608.f);
+    }
+
+    inline double logbx(double x) {
+        uint64_t i;
+        std::memcpy(&i, &x, sizeof(i));
+        i = (i >> 52 & 0x7ff) | 0x4330000000000000;  // bits of 2^52
+        std::memcpy(&x, &i, sizeof(i));
+        return x - (1023. + 4503599627370496.);
+    }
+
+#if defined(TFCP_SIMD_GENERIC)
+
+    typedef int32_t int32x __attribute__((vector_size(TFCP_SIMD_WIDTH)));
+    typedef int64_t int64x __attribute__((vector_size(TFCP_SIMD_WIDTH)));
+
+    inline floatx pow2x(floatx k) {
+        return (floatx)((int32x)(k + (127.f + 8388608.f)) << 23);
+    }
+
+    inline doublex pow2x(doublex k) {
+        return (doublex)((int64x)(k + (1023. + 4503599627370496.)) << 52);
+    }
+
+    inline floatx logbx(floatx x) {
+        floatx t = (floatx)(((int32x)x >> 23 & 0xff) | 0x4b000000);
+        return t - (127.f + 8388608.f);
+    }
+
+    inline doublex logbx(doublex x) {
+        doublex t = (doublex)(((int64x)x >> 52 & 0x7ff) | 0x4330000000000000);
+        return t - (1023. + 4503599627370496.);
+    }
+
+#elif defined(TFCP_SIMD_AVX512)
+
+    inline floatx  pow2x(floatx  k) { return _mm512_scalef_ps(_mm512_set1_ps(1.f), k); }
+    inline doublex pow2x(doublex k) { return _mm512_scalef_pd(_mm512_set1_pd(1.0), k); }
+
+    inline floatx  logbx(floatx  x) { return _mm512_getexp_ps(x); }
+    inline doublex logbx(doublex x) { return _mm512_getexp_pd(x); }
+
+#elif defined(TFCP_SIMD_AVX)
+
+    // NB: AVX without AVX2 has no integer shift for 256-bits, so shift
+    // by halves of 128-bits
+#if defined(__AVX2__)
+    #define TFCP_SIMD_SHIFT256(OP, X, N) _mm256_ ## OP(X, N)
+#else
+    #define TFCP_SIMD_SHIFT256(OP, X, N) \
+        _mm256_insertf128_si256(_mm256_castsi128_si256( \
+            _mm_ ## OP(_mm256_castsi256_si128(X), N)), \
+            _mm_ ## OP(_mm256_extractf128_si256(X, 1), N), 1)
+#endif
+
+    inline floatx pow2x(floatx k) {
+        __m256i t = _mm256_castps_si256(k + _mm256_set1_ps(127.f + 8388608.f));
+        return _mm256_castsi256_ps(TFCP_SIMD_SHIFT256(slli_epi32, t, 23));
+    }
+
+    inline doublex pow2x(doublex k) {
+        __m256i t = _mm256_castpd_si256(k + _mm256_set1_pd(1023. + 4503599627370496.));
+        return _mm256_castsi256_pd(TFCP_SIMD_SHIFT256(slli_epi64, t, 52));
+    }
+
+    inline floatx logbx(floatx x) {
+        __m256i t = _mm256_castps_si256(absx(x));
+        floatx e = _mm256_castsi256_ps(TFCP_SIMD_SHIFT256(srli_epi32, t, 23));
+        floatx s = _mm256_set1_ps(8388608.f);
+        return _mm256_or_ps(e, s) - _mm256_set1_ps(127.f + 8388608.f);
+    }
+
+    inline doublex logbx(doublex x) {
+        __m256i t = _mm256_castpd_si256(absx(x));
+        doublex e = _mm256_castsi256_pd(TFCP_SIMD_SHIFT256(srli_epi64, t, 52));
+        doublex s = _mm256_set1_pd(4503599627370496.);
+        return _mm256_or_pd(e, s) - _mm256_set1_pd(1023. + 4503599627370496.);
+    }
+
+    #undef TFCP_SIMD_SHIFT256
+
+#elif defined(TFCP_SIMD_SSE2)
+
+    inline floatx pow2x(floatx k) {
+        __m128i t = _mm_castps_si128(k + _mm_set1_ps(127.f + 8388608.f));
+        return _mm_castsi128_ps(_mm_slli_epi32(t, 23));
+    }
+
+    inline doublex pow2x(doublex k) {
+        __m128i t = _mm_castpd_si128(k + _mm_set1_pd(1023. + 4503599627370496.));
+        return _mm_castsi128_pd(_mm_slli_epi64(t, 52));
+    }
+
+    inline floatx logbx(floatx x) {
+        __m128i t = _mm_castps_si128(absx(x));
+        floatx e = _mm_castsi128_ps(_mm_srli_epi32(t, 23));
+        return _mm_or_ps(e, _mm_set1_ps(8388608.f)) - _mm_set1_ps(127.f + 8388608.f);
+    }
+
+    inline doublex logbx(doublex x) {
+        __m128i t = _mm_castpd_si128(absx(x));
+        doublex e = _mm_castsi128_pd(_mm_srli_epi64(t, 52));
+        return _mm_or_pd(e, _mm_set1_pd(4503599627370496.)) - _mm_set1_pd(1023. + 4503599627370496.);
+    }
+
+#else
+    #error Unsupported hardware!
+#endif
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//----------------------------------------------------------------------
+//
+// Define: fmadd(x, y, z) = x*y + z -- correctly rounded
+//         fmsub(x, y, z) = x*y - z
+//
+//----------------------------------------------------------------------
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+#if defined(TFCP_SIMD_GENERIC)
+
+    //
+    // Portable: vectorized by compiler, if target supports FMA
+    //
+
+    inline float  fnmadd(float  x, float  y, float  z) { return __builtin_fmaf(-x, y, z); }
+    inline double fnmadd(double x, double y, double z) { return __builtin_fma (-x, y, z); }
+
+    inline float  fmsub(float  x, float  y, float  z) { return __builtin_fmaf(x, y, -z); }
+    inline double fmsub(double x, double y, double z) { return __builtin_fma (x, y, -z); }
+
+    inline floatx fnmadd(floatx x, floatx y, floatx z) {
+        for (int i = 0; i < traitx<floatx>::length; i++) {
+            z[i] = fnmadd(x[i], y[i], z[i]);
+        }
+        return z;
+    }
+
+    inline doublex fnmadd(doublex x, doublex y, doublex z) {
+        for (int i = 0; i < traitx<doublex>::length; i++) {
+            z[i] = fnmadd(x[i], y[i], z[i]);
+        }
+        return z;
+    }
+
+    inline floatx fmsub(floatx x, floatx y, floatx z) {
+        for (int i = 0; i < traitx<floatx>::length; i++) {
+            z[i] = fmsub(x[i], y[i], z[i]);
+        }
+        return z;
+    }
+
+    inline doublex fmsub(doublex x, doublex y, doublex z) {
+        for (int i = 0; i < traitx<doublex>::length; i++) {
+            z[i] = fmsub(x[i], y[i], z[i]);
+        }
+        return z;
+    }
+
+#elif defined(TFCP_SIMD_FMA)
+
+#if defined(TFCP_SIMD_AVX512)
+    inline floatx  fnmadd(floatx  x, floatx  y, floatx  z) { return _mm512_fnmadd_ps(x, y, z); }
+    inline doublex fnmadd(doublex x, doublex y, doublex z) { return _mm512_fnmadd_pd(x, y, z); }
+
+    inline floatx  fmsub(floatx  x, floatx  y, floatx  z) { return _mm512_fmsub_ps(x, y, z); }
+    inline doublex fmsub(doublex x, doublex y, doublex z) { return _mm512_fmsub_pd(x, y, z); }
+#else
+    inline floatx  fnmadd(floatx  x, floatx  y, floatx  z) { return _mm256_fnmadd_ps(x, y, z); }
+    inline doublex fnmadd(doublex x, doublex y, doublex z) { return _mm256_fnmadd_pd(x, y, z); }
+
+    inline floatx  fmsub(floatx  x, floatx  y, floatx  z) { return _mm256_fmsub_ps(x, y, z); }
+    inline doublex fmsub(doublex x, doublex y, doublex z) { return _mm256_fmsub_pd(x, y, z); }
+#endif
+
+    inline float fnmadd(float x, float y, float z) {
+        __m128 result = _mm_fnmadd_ss(_mm_set_ss(x),
+            _mm_set_ss(y),
+            _mm_set_ss(z));
+        return _mm_cvtss_f32(result);
+    }
+
+    inline double fnmadd(double x, double y, double z) {
+        __m128d result = _mm_fnmadd_sd(_mm_set_sd(x),
+            _mm_set_sd(y),
+            _mm_set_sd(z));
+        return _mm_cvtsd_f64(result);
+    }
+
+    inline float fmsub(float x, float y, float z) {
+        __m128 result = _mm_fmsub_ss(_mm_set_ss(x),
+                                     _mm_set_ss(y),
+                                     _mm_set_ss(z));
+        return _mm_cvtss_f32(result);
+    }
+
+    inline double fmsub(double x, double y, double z) {
+        __m128d result = _mm_fmsub_sd(_mm_set_sd(x),
+                                      _mm_set_sd(y),
+                                      _mm_set_sd(z));
+        return _mm_cvtsd_f64(result);
+    }
+
+#else
+
+    //
+    // No hardware FMA: correctly rounded std::fma per each lane
+    //
+    // NB: exact.h and basic.h do not call these if TFCP_SIMD_NOFMA
+    //
+
+    inline float fnmadd(float x, float y, float z) { return std::fma(-x, y, z); }
+    inline float fmsub (float x, float y, float z) { return std::fma(x, y, -z); }
+
+    inline double fnmadd(double x, double y, double z) { return std::fma(-x, y, z); }
+    inline double fmsub (double x, double y, double z) { return std::fma(x, y, -z); }
+
+    inline floatx fnmadd(floatx x, floatx y, floatx z) {
+        floatx r;
+        for (int i = 0; i < traitx<floatx>::length; i++) {
+            getx(r, i) = fnmadd(getx(x, i), getx(y, i), getx(z, i));
+        }
+        return r;
+    }
+
+    inline floatx fmsub(floatx x, floatx y, floatx z) {
+        floatx r;
+        for (int i = 0; i < traitx<floatx>::length; i++) {
+            getx(r, i) = fmsub(getx(x, i), getx(y, i), getx(z, i));
+        }
+        return r;
+    }
+
+    inline doublex fnmadd(doublex x, doublex y, doublex z) {
+        doublex r;
+        for (int i = 0; i < traitx<doublex>::length; i++) {
+            getx(r, i) = fnmadd(getx(x, i), getx(y, i), getx(z, i));
+        }
+        return r;
+    }
+
+    inline doublex fmsub(doublex x, doublex y, doublex z) {
+        doublex r;
+        for (int i = 0; i < traitx<doublex>::length; i++) {
+            getx(r, i) = fmsub(getx(x, i), getx(y, i), getx(z, i));
+        }
+        return r;
+    }
+
+#endif
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_SIMD_H
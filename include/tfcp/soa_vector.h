@@ -0,0 +1,285 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_SOA_VECTOR_H
+#define TFCP_SOA_VECTOR_H
+//======================================================================
+//
+//  Structure-of-arrays container for twofold/coupled numbers, e.g.:
+//
+//    tfcp::soa_vector<pdouble> x(n), y(n), z(n);
+//
+//  Values and errors are kept in two separate planes, each aligned by
+//  64 bytes, so SIMD kernels load them without permutes, unlike arrays
+//  of twofold<T> where value and error are interleaved
+//
+//  - Element access by proxy: x[i] = y[i] + z[i], x[i].value, ...
+//  - Planes as scalar spans: x.values(), x.errors()
+//  - Planes as short-vector arrays: x.valuesx<doublex>(), etc.
+//  - Array-wide arithmetic: tfcp::batch::padd(x, y, z), ...
+//
+//  Planes are padded up to whole 64 bytes, so the short-vector arrays
+//  have no tail; padding positions hold unspecified values
+//
+//======================================================================
+
+#include <tfcp/batch.h>
+#include <tfcp/twofold.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace tfcp {
+
+    //------------------------------------------------------------------
+    //
+    //  Aligned memory: by OS functions, as C++14 has no aligned new
+    //
+    //------------------------------------------------------------------
+
+    inline void* aligned_allocate(size_t bytes, size_t alignment) {
+    #if defined(_WIN32)
+        void* p = _aligned_malloc(bytes, alignment);
+    #else
+        void* p = nullptr;
+        if (posix_memalign(&p, alignment, bytes) != 0)
+            p = nullptr;
+    #endif
+        if (p == nullptr)
+            throw std::bad_alloc();
+        return p;
+    }
+
+    inline void aligned_deallocate(void* p) {
+    #if defined(_WIN32)
+        _aligned_free(p);
+    #else
+        std::free(p);
+    #endif
+    }
+
+    template<typename P> struct soa_traits;
+    template<typename T> struct soa_traits<twofold<T>> { using scalar = T; };
+    template<typename T> struct soa_traits<coupled<T>> { using scalar = T; };
+
+    //------------------------------------------------------------------
+    //
+    //  Reference to i'th element: looks like twofold/coupled P, with
+    //  value and error members, but these refer into the planes
+    //
+    //------------------------------------------------------------------
+
+    template<typename P> struct soa_reference {
+    public:
+        using T = typename soa_traits<P>::scalar;
+        T& value;
+        T& error;
+    public:
+        soa_reference(T& v, T& e) : value(v), error(e) {}
+        soa_reference(const soa_reference& x) = default;
+    public:
+        operator P() const { return P(value, error); }
+    public:
+        soa_reference& operator = (const P& x) {
+            value = x.value;
+            error = x.error;
+            return *this;
+        }
+        soa_reference& operator = (const soa_reference& x) {
+            return *this = static_cast<P>(x);
+        }
+    public:
+        template<typename S> soa_reference& operator += (const S& x) { P t = *this; t += x; return *this = t; }
+        template<typename S> soa_reference& operator -= (const S& x) { P t = *this; t -= x; return *this = t; }
+        template<typename S> soa_reference& operator *= (const S& x) { P t = *this; t *= x; return *this = t; }
+        template<typename S> soa_reference& operator /= (const S& x) { P t = *this; t /= x; return *this = t; }
+    };
+
+    template<typename P> inline typename soa_traits<P>::scalar value_of(const soa_reference<P>& x) { return x.value; }
+    template<typename P> inline typename soa_traits<P>::scalar error_of(const soa_reference<P>& x) { return x.error; }
+
+    //------------------------------------------------------------------
+    //
+    //  Container: P is twofold<T> or coupled<T>, T is float or double
+    //
+    //------------------------------------------------------------------
+
+    template<typename P> class soa_vector {
+    public:
+        using T = typename soa_traits<P>::scalar;
+        using value_type = P;
+        using reference = soa_reference<P>;
+        static constexpr size_t alignment = 64;  // bytes
+    public:
+        soa_vector() : m_data(nullptr), m_size(0), m_capacity(0) {}
+        explicit soa_vector(size_t n) : soa_vector() { resize(n); }
+        soa_vector(size_t n, const P& x) : soa_vector() { resize(n, x); }
+        soa_vector(std::initializer_list<P> list) : soa_vector() {
+            reserve(list.size());
+            for (const P& x : list) {
+                push_back(x);
+            }
+        }
+        soa_vector(const soa_vector& x) : soa_vector() { *this = x; }
+        soa_vector(soa_vector&& x) noexcept : soa_vector() { swap(x); }
+       ~soa_vector() { deallocate(m_data); }
+    public:
+        soa_vector& operator = (const soa_vector& x) {
+            if (this != &x) {
+                resize(0);
+                reserve(x.m_size);
+                std::copy(x.m_data, x.m_data + x.m_size, values().data());
+                std::copy(x.m_data + x.m_capacity, x.m_data + x.m_capacity + x.m_size, errors().data());
+                m_size = x.m_size;
+            }
+            return *this;
+        }
+        soa_vector& operator = (soa_vector&& x) noexcept {
+            swap(x);
+            return *this;
+        }
+        void swap(soa_vector& x) noexcept {
+            std::swap(m_data, x.m_data);
+            std::swap(m_size, x.m_size);
+            std::swap(m_capacity, x.m_capacity);
+        }
+    public:
+        size_t size() const { return m_size; }
+        size_t capacity() const { return m_capacity; }
+        bool empty() const { return m_size == 0; }
+    public:
+        void reserve(size_t n) {
+            if (n <= m_capacity) {
+                return;
+            }
+            size_t c = padded(n);
+            T* data = allocate(2 * c);
+            std::fill(data, data + 2 * c, T(0));
+            std::copy(m_data, m_data + m_size, data);
+            std::copy(m_data + m_capacity, m_data + m_capacity + m_size, data + c);
+            deallocate(m_data);
+            m_data = data;
+            m_capacity = c;
+        }
+        void resize(size_t n, const P& x = P(0, 0)) {
+            if (n > m_capacity) {
+                reserve(std::max(n, 2 * m_capacity));
+            }
+            for (size_t i = m_size; i < n; i++) {
+                m_data[i] = x.value;
+                m_data[m_capacity + i] = x.error;
+            }
+            m_size = n;
+        }
+        void push_back(const P& x) {
+            resize(m_size + 1, x);
+        }
+        void clear() { m_size = 0; }
+    public:
+        reference operator [] (size_t i) {
+            assert(i < m_size);
+            return reference(m_data[i], m_data[m_capacity + i]);
+        }
+        P operator [] (size_t i) const {
+            assert(i < m_size);
+            return P(m_data[i], m_data[m_capacity + i]);
+        }
+    public:
+        // Planes of values and errors as scalar arrays
+        span<T> values() { return span<T>(m_data, m_size); }
+        span<T> errors() { return span<T>(m_data + m_capacity, m_size); }
+        span<const T> values() const { return span<const T>(m_data, m_size); }
+        span<const T> errors() const { return span<const T>(m_data + m_capacity, m_size); }
+    public:
+        //
+        // Planes as arrays of short vectors TX like doublex, with sizex()
+        // elements each, so loop like:
+        //
+        //   for (size_t k = 0; k < z.sizex<doublex>(); k++)
+        //       z0[k] = padd(x0[k], x1[k], y0[k], y1[k], z1[k]);
+        //
+        // calls basic.h templates directly on the aligned planes
+        //
+        template<typename TX> size_t sizex() const {
+            check<TX>();
+            return (m_size * sizeof(T) + sizeof(TX) - 1) / sizeof(TX);
+        }
+        template<typename TX> TX* valuesx() { check<TX>(); return reinterpret_cast<TX*>(m_data); }
+        template<typename TX> TX* errorsx() { check<TX>(); return reinterpret_cast<TX*>(m_data + m_capacity); }
+        template<typename TX> const TX* valuesx() const { check<TX>(); return reinterpret_cast<const TX*>(m_data); }
+        template<typename TX> const TX* errorsx() const { check<TX>(); return reinterpret_cast<const TX*>(m_data + m_capacity); }
+    private:
+        template<typename TX> static void check() {
+            static_assert(sizeof(TX) % sizeof(T) == 0, "TX must be vector of T");
+            static_assert(alignment % sizeof(TX) == 0, "TX must fit alignment");
+        }
+        static size_t padded(size_t n) {
+            constexpr size_t k = alignment / sizeof(T);
+            return (n + k - 1) / k * k;
+        }
+        static T* allocate(size_t n) {
+            return static_cast<T*>(aligned_allocate(n * sizeof(T), alignment));
+        }
+        static void deallocate(T* p) {
+            if (p != nullptr) {
+                aligned_deallocate(p);
+            }
+        }
+    private:
+        T* m_data;          // values, then errors at m_data + m_capacity
+        size_t m_size;
+        size_t m_capacity;  // multiple of alignment / sizeof(T)
+    };
+
+namespace batch {
+
+    //------------------------------------------------------------------
+    //
+    //  Array-wide arithmetic over soa_vector, see batch.h; sizes of all
+    //  the vectors must be equal, output may coincide with input
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_BATCH_SOA_OP(F, SHAPE)                                           \
+    template<typename T>                                                      \
+    inline void F(const soa_vector<SHAPE<T>>& x,                              \
+                  const soa_vector<SHAPE<T>>& y,                              \
+                        soa_vector<SHAPE<T>>& z) {                            \
+        F(x.values(), x.errors(), y.values(), y.errors(),                     \
+          z.values(), z.errors());                                            \
+    }
+#define TFCP_BATCH_SOA_SQRT(F, SHAPE)                                         \
+    template<typename T>                                                      \
+    inline void F(const soa_vector<SHAPE<T>>& x,                              \
+                        soa_vector<SHAPE<T>>& z) {                            \
+        F(x.values(), x.errors(), z.values(), z.errors());                    \
+    }
+    TFCP_BATCH_SOA_OP(tadd, twofold);
+    TFCP_BATCH_SOA_OP(tsub, twofold);
+    TFCP_BATCH_SOA_OP(tmul, twofold);
+    TFCP_BATCH_SOA_OP(tdiv, twofold);
+    TFCP_BATCH_SOA_SQRT(tsqrt, twofold);
+    TFCP_BATCH_SOA_OP(padd, coupled);
+    TFCP_BATCH_SOA_OP(psub, coupled);
+    TFCP_BATCH_SOA_OP(pmul, coupled);
+    TFCP_BATCH_SOA_OP(pdiv, coupled);
+    TFCP_BATCH_SOA_SQRT(psqrt, coupled);
+#undef TFCP_BATCH_SOA_SQRT
+#undef TFCP_BATCH_SOA_OP
+
+} // namespace batch
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_SOA_VECTOR_H
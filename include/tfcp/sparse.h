@@ -0,0 +1,91 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_SPARSE_H
+#define TFCP_SPARSE_H
+//======================================================================
+//
+//  Sparse matrix by compressed rows (CSR), and its product by vector
+//  with coupled accumulation, e.g.:
+//
+//    tfcp::csr_matrix<double> a = ...;
+//    tfcp::spmv(a, x, y0, y1);
+//
+//  computes y = a * x, where a and x are plain T, and each row goes by
+//  Dot2 (see reduce.h) into coupled y0 + y1: so y0 is faithful unless
+//  the row is ill-conditioned as 1/eps
+//
+//  Row i has nonzeros val[k] at columns col[k] for ptr[i] <= k < ptr[i
+//  + 1]; order of columns in a row does not matter
+//
+//  Rows split into stripes of about same number of nonzeros to compute
+//  by several threads, see set_reduce_threads() in reduce.h; result is
+//  bitwise same for any ISA and any number of threads
+//
+//  Also, Krylov solvers for a * x = b, where a is square:
+//
+//    int iters = tfcp::cg(a, b, x, tol, max_iter);        // a is SPD
+//    int iters = tfcp::bicgstab(a, b, x, tol, max_iter);  // any a
+//
+//  which start from x given, and stop if |b - a * x| <= tol * |b| by
+//  2-norm; return the number of iterations, or -1 if not converged in
+//  max_iter, or if BiCGStab breaks down
+//
+//  Solvers use spmv() above, and dot2() for inner products: so roundoff
+//  in the recurrences is less, which keeps convergence closer to exact
+//  arithmetic on stiff systems; vectors are plain T. Before returning,
+//  residual is recomputed as b - a * x, and if it is still above tol,
+//  the iteration continues from it (residual replacement)
+//
+//======================================================================
+
+#include <tfcp/soa_vector.h>
+#include <tfcp/twofold.h>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace tfcp {
+
+    template<typename T> struct csr_matrix {
+        size_t rows = 0;
+        size_t cols = 0;
+        std::vector<size_t> ptr;  // rows + 1 offsets into col and val
+        std::vector<size_t> col;
+        std::vector<T> val;
+    };
+
+    void spmv(const csr_matrix<double>& a, const double x[], double y0[], double y1[]);
+    void spmv(const csr_matrix<float> & a, const float  x[], float  y0[], float  y1[]);
+
+    inline void spmv(const csr_matrix<double>& a, span<const double> x,
+                     soa_vector<coupled<double>>& y)
+    {
+        assert(x.size() == a.cols && y.size() == a.rows);
+        spmv(a, x.data(), y.values().data(), y.errors().data());
+    }
+
+    inline void spmv(const csr_matrix<float>& a, span<const float> x,
+                     soa_vector<coupled<float>>& y)
+    {
+        assert(x.size() == a.cols && y.size() == a.rows);
+        spmv(a, x.data(), y.values().data(), y.errors().data());
+    }
+
+    int cg(const csr_matrix<double>& a, const double b[], double x[],
+           double tol, int max_iter);
+    int cg(const csr_matrix<float> & a, const float  b[], float  x[],
+           float  tol, int max_iter);
+
+    int bicgstab(const csr_matrix<double>& a, const double b[], double x[],
+                 double tol, int max_iter);
+    int bicgstab(const csr_matrix<float> & a, const float  b[], float  x[],
+                 float  tol, int max_iter);
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_SPARSE_H
@@ -0,0 +1,52 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_TRIDIAG_H
+#define TFCP_TRIDIAG_H
+//======================================================================
+//
+//  Batch of independent tridiagonal systems, solved by Thomas algorithm
+//  in coupled arithmetic, e.g.:
+//
+//    tfcp::tridiag_solve(n, batch, a, b, c, d, x0, x1);
+//
+//  solves each system s < batch of n equations, for i < n:
+//
+//    a[i] * x[i - 1] + b[i] * x[i] + c[i] * x[i + 1] = d[i]
+//
+//  where a[0] and c[n - 1] are ignored; inputs are plain T, and x is
+//  coupled x0 + x1
+//
+//  Arrays are interleaved by systems: element i of system s is at the
+//  index i*batch + s; so that each vector lane takes one system, and
+//  elimination goes by contiguous vector loads of several systems at
+//  once, by pmul/psub/pdiv of basic.h; batch splits between threads,
+//  see set_reduce_threads() in reduce.h
+//
+//  Error of x is about n eps^2 relative, if eps is epsilon of T: as
+//  Thomas algorithm is stable if a system is diagonally dominant, or
+//  symmetric positive definite; no pivoting, so other systems might
+//  meet zero or tiny pivot, and get Inf or NaN
+//
+//  Result is same for any number of threads; but may differ in last
+//  bits of x1 for the ISA with FMA versus without
+//
+//======================================================================
+
+#include <cstddef>
+
+namespace tfcp {
+
+    void tridiag_solve(size_t n, size_t batch,
+                       const double a[], const double b[], const double c[],
+                       const double d[], double x0[], double x1[]);
+    void tridiag_solve(size_t n, size_t batch,
+                       const float  a[], const float  b[], const float  c[],
+                       const float  d[], float  x0[], float  x1[]);
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_TRIDIAG_H
@@ -0,0 +1,596 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_TRIG_H
+#define TFCP_TRIG_H
+//======================================================================
+//
+// Sine, cosine, and tangent in coupled arithmetic, see elementary.h
+//
+// C++ templates, main scalar types: float, double
+//
+// Additionally, short-vector types: floatx, doublex
+//
+// Typical interface like basic.h:
+//   T psin(T x0, T x1, T& z1);  -- returns z0, so z0 + z1 = sin(x0 + x1)
+//
+// Branch free for |x0| <= trig_const<S>::range, so all lanes of short
+// vector go at once; other x go by ptrig_special() by scalar, which is
+// slower, but handles any x: huge, or Inf, or NaN
+//
+// Reduction by Cody-Waite: x = k pi/2 + r, where |r| <= pi/4, and pi/2
+// is sum of four words p0 + p1 + p2 + p3; each k pj is exact by pmul0,
+// and x0 - k p0 has no rounding as k p0 is close to x0; so r has error
+// of about eps^3 |x|, which is within eps^2 |sin(x)| unless x is close
+// to a multiple of pi/2, where sin(x) is ill-conditioned anyway
+//
+// Reduction by Payne-Hanek for larger x: x 2/pi = k + f by exact dot
+// of 24-bit chunks of x with 24-bit chunks of 2/pi, so fraction f has
+// more than 150 bits even if x is very close to a multiple of pi/2
+//
+// Then sin(r) = r P(r^2) and cos(r) = Q(r^2) by Taylor series, leading
+// terms by coupled arithmetic and tail terms by plain; and result is
+// chosen by k mod 4 without branches, by multiplying by 0 and 1
+//
+// Inverse functions by one Newton step from plain seed t by <cmath>,
+// one position at a time as there is no vector atan2: with coupled s
+// and c = sin(t) and cos(t), atan2(y, x) = t + atan(d), where
+// d = (y c - x s) / (x c + y s) is about eps, so atan(d) = d within
+// eps^3; the numerator cancels, so it needs coupled arithmetic, but
+// then plain division is enough; asin and acos go by atan2 with the
+// sqrt((1 - x)(1 + x)), which has no cancellation error
+//
+//======================================================================
+
+#include <tfcp/basic.h>
+#include <tfcp/exact.h>
+#include <tfcp/explog.h>
+#include <tfcp/simd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+    //------------------------------------------------------------------
+    //
+    // Constants by base type
+    //
+    //------------------------------------------------------------------
+
+    template<typename S> struct trig_const {};
+
+    template<> struct trig_const<double> {
+        static constexpr double two_over_pi = 0.6366197723675814;
+
+        // pi/2 = p0 + p1 + p2 + p3
+        static constexpr double pio2_0 = 1.5707963267948966;
+        static constexpr double pio2_1 = 6.123233995736766e-17;
+        static constexpr double pio2_2 = -1.4973849048591698e-33;
+        static constexpr double pio2_3 = 5.562271104316826e-50;
+
+        // Cody-Waite reduction for |x0| up to this
+        static constexpr double range = 1e6;
+
+        // sin(r) / r and cos(r) by series in r^2 of this degree, where
+        // coefficients are coupled for j < lead
+        static constexpr int degree = 13;
+        static constexpr int lead = 9;
+
+        // (-1)^j / (2j + 1)!
+        static double sin0(int j) {
+            static const double c[] = { 1,
+                                        -0.16666666666666666,
+                                        0.008333333333333333,
+                                        -0.0001984126984126984,
+                                        2.7557319223985893e-06,
+                                        -2.505210838544172e-08,
+                                        1.6059043836821613e-10,
+                                        -7.647163731819816e-13,
+                                        2.8114572543455206e-15,
+                                        -8.22063524662433e-18,
+                                        1.9572941063391263e-20,
+                                        -3.868170170630684e-23,
+                                        6.446950284384474e-26,
+                                        -9.183689863795546e-29 };
+            return c[j];
+        }
+
+        static double sin1(int j) {
+            static const double c[] = { 0,
+                                        -9.25185853854297e-18,
+                                        1.1564823173178714e-19,
+                                        -1.7209558293420705e-22,
+                                        -1.858393274046472e-22,
+                                        1.448814070935912e-24,
+                                        1.2585294588752098e-26,
+                                        -7.03872877733453e-30,
+                                        1.6508842730861433e-31 };
+            return c[j];
+        }
+
+        // (-1)^j / (2j)!
+        static double cos0(int j) {
+            static const double c[] = { 1,
+                                        -0.5,
+                                        0.041666666666666664,
+                                        -0.001388888888888889,
+                                        2.48015873015873e-05,
+                                        -2.755731922398589e-07,
+                                        2.08767569878681e-09,
+                                        -1.1470745597729725e-11,
+                                        4.779477332387385e-14,
+                                        -1.5619206968586225e-16,
+                                        4.110317623312165e-19,
+                                        -8.896791392450574e-22,
+                                        1.6117375710961184e-24,
+                                        -2.4795962632247976e-27 };
+            return c[j];
+        }
+
+        static double cos1(int j) {
+            static const double c[] = { 0,
+                                        0,
+                                        2.3129646346357427e-18,
+                                        5.300543954373577e-20,
+                                        2.1511947866775882e-23,
+                                        -2.3767714622250297e-23,
+                                        -1.20734505911326e-25,
+                                        -2.0655512752830745e-28,
+                                        4.399205485834081e-31 };
+            return c[j];
+        }
+    };
+
+    template<> struct trig_const<float> {
+        static constexpr float two_over_pi = 0.6366197466850281f;
+
+        static constexpr float pio2_0 = 1.5707963705062866f;
+        static constexpr float pio2_1 = -4.371138828673793e-08f;
+        static constexpr float pio2_2 = -1.7151245100058819e-15f;
+        static constexpr float pio2_3 = 1.056299898220315e-23f;
+
+        static constexpr float range = 1e4f;
+
+        static constexpr int degree = 8;
+        static constexpr int lead = 6;
+
+        static float sin0(int j) {
+            static const float c[] = { 1,
+                                       -0.1666666716337204f,
+                                       0.008333333767950535f,
+                                       -0.00019841270113829523f,
+                                       2.7557318844628753e-06f,
+                                       -2.5052107943679403e-08f,
+                                       1.6059044372074283e-10f,
+                                       -7.647163609812713e-13f,
+                                       2.8114573589663704e-15f };
+            return c[j];
+        }
+
+        static float sin1(int j) {
+            static const float c[] = { 0,
+                                       4.967053879312289e-09f,
+                                       -4.34617203337595e-10f,
+                                       2.725596874933456e-12f,
+                                       3.793571224297229e-14f,
+                                       -4.4176230446483665e-16f };
+            return c[j];
+        }
+
+        static float cos0(int j) {
+            static const float c[] = { 1,
+                                       -0.5f,
+                                       0.0416666679084301f,
+                                       -0.0013888889225199819f,
+                                       2.4801587642286904e-05f,
+                                       -2.755731998149713e-07f,
+                                       2.0876755879584152e-09f,
+                                       -1.147074536050896e-11f,
+                                       4.7794772561329454e-14f };
+            return c[j];
+        }
+
+        static float cos1(int j) {
+            static const float c[] = { 0,
+                                       0,
+                                       -1.2417634698280722e-09f,
+                                       3.3631094437103215e-11f,
+                                       -3.40699609366682e-13f,
+                                       7.575112209051195e-15f };
+            return c[j];
+        }
+    };
+
+    //------------------------------------------------------------------
+    //
+    // Auxiliary: reduction, series, and quadrant
+    //
+    //------------------------------------------------------------------
+
+    // r = x - k pi/2, where k is integer, for |x0| <= range
+    template<typename T> inline T ptrig_reduce(T x0, T x1, T& k, T& r1)
+    {
+        using S = typename traitx<T>::base;
+        using C = trig_const<S>;
+
+        k = explog_round(x0 * setallx<T>(C::two_over_pi));
+
+        // x - k p0 = (x0 - h0) - l0 + x1, where k p0 = h0 + l0 exactly,
+        // and x0 - h0 is exact, as h0 is close to x0
+        T l0, h0 = pmul0(k, setallx<T>(C::pio2_0), l0);
+        T a1, a0 = padd0(x0 - h0, -l0, a1);
+        a0 = padd1(a0, a1, x1, a1);
+
+        T b1, b0 = pmul0(k, setallx<T>(C::pio2_1), b1);
+        a0 = psub(a0, a1, b0, b1, a1);
+        T c1, c0 = pmul0(k, setallx<T>(C::pio2_2), c1);
+        a0 = psub(a0, a1, c0, c1, a1);
+        return psub1(a0, a1, k * setallx<T>(C::pio2_3), r1);
+    }
+
+    // Series in s = r^2 with coefficients c0(j) + c1(j): tail by plain
+    // Horner, and lead terms by coupled
+    template<typename T, typename S>
+    inline T ptrig_series(T s0, T s1, S (*c0)(int), S (*c1)(int), T& p1)
+    {
+        using C = trig_const<S>;
+        T q = setallx<T>(c0(C::degree));
+        for (int j = C::degree - 1; j >= C::lead; j--) {
+            q = q * s0 + setallx<T>(c0(j));
+        }
+        T p0 = pmul1(s0, s1, q, p1);
+        for (int j = C::lead - 1; j >= 1; j--) {
+            p0 = padd(p0, p1, setallx<T>(c0(j)), setallx<T>(c1(j)), p1);
+            p0 = pmul(s0, s1, p0, p1, p1);
+        }
+        return padd1(p0, p1, setallx<T>(S(1)), p1);
+    }
+
+    // floor(m / 2) for integer m: as (m - 1/2) / 2 is never half-integer
+    template<typename T> inline T ptrig_half(T m)
+    {
+        using S = typename traitx<T>::base;
+        return explog_round((m - setallx<T>(S(0.5))) * setallx<T>(S(0.5)));
+    }
+
+    // 1 if m is even, or -1 if odd, for integer m
+    template<typename T> inline T ptrig_sign(T m)
+    {
+        using S = typename traitx<T>::base;
+        T odd = m - setallx<T>(S(2)) * ptrig_half(m);
+        return setallx<T>(S(1)) - setallx<T>(S(2)) * odd;
+    }
+
+    // sin(x) and cos(x), where x = k pi/2 + r, for integer k and |r| <=
+    // pi/4; any k mod 4 goes without branches: if k is odd, then sine
+    // and cosine of r are swapped; and signs change with k/2, (k + 1)/2
+    template<typename T> inline T ptrig_core(T r0, T r1, T k, T& s1, T& c0, T& c1)
+    {
+        using S = typename traitx<T>::base;
+        using C = trig_const<S>;
+
+        T u1, u0 = pmul(r0, r1, r0, r1, u1);
+        T p1, p0 = ptrig_series(u0, u1, C::sin0, C::sin1, p1);
+        T q1, q0 = ptrig_series(u0, u1, C::cos0, C::cos1, q1);
+        p0 = pmul(r0, r1, p0, p1, p1);
+
+        T odd = k - setallx<T>(S(2)) * ptrig_half(k);
+        T even = setallx<T>(S(1)) - odd;
+        T sgn_s = ptrig_sign(ptrig_half(k));
+        T sgn_c = ptrig_sign(ptrig_half(k + setallx<T>(S(1))));
+
+        s1 = sgn_s * (even * p1 + odd * q1);
+        c0 = sgn_c * (even * q0 + odd * p0);
+        c1 = sgn_c * (even * q1 + odd * p1);
+        return sgn_s * (even * p0 + odd * q0);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Sine and cosine, for |x0| <= range
+    //
+    //------------------------------------------------------------------
+
+    template<typename T> inline T psincos(T x0, T x1, T& s1, T& c0, T& c1)
+    {
+        T k, r1, r0 = ptrig_reduce(x0, x1, k, r1);
+        return ptrig_core(r0, r1, k, s1, c0, c1);
+    }
+
+    template<typename T> inline T psin(T x0, T x1, T& z1)
+    {
+        T c0, c1;
+        return psincos(x0, x1, z1, c0, c1);
+    }
+
+    template<typename T> inline T pcos(T x0, T x1, T& z1)
+    {
+        T s1, c0;
+        psincos(x0, x1, s1, c0, z1);
+        return c0;
+    }
+
+    // NB: if cos(x) underflows or overflows, tangent is Inf or zero
+    template<typename T> inline T ptan(T x0, T x1, T& z1)
+    {
+        T s1, c0, c1, s0 = psincos(x0, x1, s1, c0, c1);
+        return pdiv(s0, s1, c0, c1, z1);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Inverse functions, for x0 and y0 within [10^-100, 10^100] or zero,
+    // but not both zero (or 10^-8 and 10^8 for float), so that products
+    // and their errors neither overflow nor underflow
+    //
+    //------------------------------------------------------------------
+
+    // Plain atan2(y, x) by <cmath> in each position
+    template<typename T> inline T ptrig_seed(T y, T x)
+    {
+        constexpr int lenx = traitx<T>::length;
+        T t = setzerox<T>();
+        for (int l = 0; l < lenx; l++) {
+            getx(t, l) = std::atan2(getx(y, l), getx(x, l));
+        }
+        return t;
+    }
+
+    // atan2(y, x) by Newton step from seed t, where |t| <= pi
+    template<typename T> inline T ptrig_newton(T y0, T y1, T x0, T x1, T t, T& z1)
+    {
+        T s1, c0, c1, s0 = psincos(t, setzerox<T>(), s1, c0, c1);
+        T a1, a0 = pmul(y0, y1, c0, c1, a1);
+        T b1, b0 = pmul(x0, x1, s0, s1, b1);
+        T n1, n0 = psub(a0, a1, b0, b1, n1);
+        T d = n0 / (x0 * c0 + y0 * s0);
+        return padd0(t, d, z1);
+    }
+
+    template<typename T> inline T patan2(T y0, T y1, T x0, T x1, T& z1)
+    {
+        return ptrig_newton(y0, y1, x0, x1, ptrig_seed(y0, x0), z1);
+    }
+
+    template<typename T> inline T patan(T x0, T x1, T& z1)
+    {
+        using S = typename traitx<T>::base;
+        const T one = setallx<T>(S(1));
+        return ptrig_newton(x0, x1, one, setzerox<T>(), ptrig_seed(x0, one), z1);
+    }
+
+    // sqrt(1 - x^2) = sqrt((1 - x)(1 + x)), for |x| <= 1
+    template<typename T> inline T ptrig_cosine(T x0, T x1, T& w1)
+    {
+        using S = typename traitx<T>::base;
+        const T one = setallx<T>(S(1));
+        T a1, a0 = psub2(one, x0, x1, a1);
+        T b1, b0 = padd2(one, x0, x1, b1);
+        T w0 = pmul(a0, a1, b0, b1, w1);
+        return psqrt(w0, w1, w1);
+    }
+
+    // asin(x), for |x| < 1
+    template<typename T> inline T pasin(T x0, T x1, T& z1)
+    {
+        T w1, w0 = ptrig_cosine(x0, x1, w1);
+        return patan2(x0, x1, w0, w1, z1);
+    }
+
+    // acos(x), for |x| < 1
+    template<typename T> inline T pacos(T x0, T x1, T& z1)
+    {
+        T w1, w0 = ptrig_cosine(x0, x1, w1);
+        return patan2(w0, w1, x0, x1, z1);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Any x by scalar code: Payne-Hanek for large x
+    //
+    //------------------------------------------------------------------
+
+    inline bool ptrig_fits(double x0) { return std::fabs(x0) <= trig_const<double>::range; }
+    inline bool ptrig_fits(float  x0) { return std::fabs(x0) <= trig_const<float>::range; }
+
+    // x 2/pi = k + f, where |f| <= 1/2: returns r = f pi/2, and k mod 4,
+    // for finite x0 and x1
+    inline double ptrig_reduce_large(double x0, double x1, double& k, double& r1)
+    {
+        // 2/pi by 24-bit chunks: 2/pi = sum of bits[j] 2^-24(j+1)
+        static const std::int64_t bits[] = {
+            0xA2F983, 0x6E4E44, 0x1529FC, 0x2757D1, 0xF534DD, 0xC0DB62,
+            0x95993C, 0x439041, 0xFE5163, 0xABDEBB, 0xC561B7, 0x246E3A,
+            0x424DD2, 0xE00649, 0x2EEA09, 0xD1921C, 0xFE1DEB, 0x1CB129,
+            0xA73EE8, 0x8235F5, 0x2EBB44, 0x84E99C, 0x7026B4, 0x5F7E41,
+            0x3991D6, 0x398353, 0x39F49C, 0x845F8B, 0xBDF928, 0x3B1FF8,
+            0x97FFDE, 0x05980F, 0xEF2F11, 0x8B5A0A, 0x6D1F6D, 0x367ECF,
+            0x27CB09, 0xB74F46, 0x3F669E, 0x5FEA2D, 0x7527BA, 0xC7EBE5,
+            0xF17B3D, 0x0739F7, 0x8A5292, 0xEA6BFB, 0x5FB11F, 0x8D5D08,
+            0x560330, 0x46FC7B, 0x6BABF0, 0xCFBC20, 0x9AF436, 0x1DA9E3,
+            0x91615E, 0xE61B08, 0x659985, 0x5F14A0, 0x68408D, 0xFFD880 };
+        constexpr int nbits = sizeof(bits) / sizeof(bits[0]);
+
+        // acc[i] is coefficient of 2^-24i: integer part i = 0, and fraction
+        // by 24-bit chunks; higher parts are multiples of 8, so not needed
+        constexpr int frac = 9;
+        constexpr std::int64_t mask = (1 << 24) - 1;
+        std::int64_t acc[frac + 1] = {};
+
+        const double parts[] = { x0, x1 };
+        for (double x : parts) {
+            if (x == 0)
+                continue;
+
+            // |x| = m 2^(24q + e), where m has 53 bits, 0 <= e < 24
+            int e;
+            double m = std::frexp(std::fabs(x), &e);
+            auto mi = static_cast<std::int64_t>(std::ldexp(m, 53));
+            e -= 53;
+            int q = (e >= 0 ? e : e - 23) / 24;
+            e -= 24 * q;
+
+            // m 2^e by 24-bit chunks: sum of chunk[c] 2^24c
+            std::int64_t chunk[4] = { ((mi & mask) << e) & mask,
+                                      (mi >> (24 - e)) & mask,
+                                      (mi >> (48 - e)) & mask,
+                                      e > 8 ? mi >> (72 - e) : 0 };
+            std::int64_t sign = x < 0 ? -1 : 1;
+
+            // chunk[c] bits[j] goes to 2^24(q + c - j - 1)
+            for (int c = 0; c < 4; c++) {
+                for (int i = 0; i <= frac; i++) {
+                    int j = q + c - 1 + i;
+                    if (j >= 0 && j < nbits) {
+                        acc[i] += sign * chunk[c] * bits[j];
+                    }
+                }
+            }
+        }
+
+        // Carry, so that each fraction chunk is within [0, 2^24)
+        for (int i = frac; i > 0; i--) {
+            std::int64_t carry = acc[i] >> 24;
+            acc[i] -= carry * (std::int64_t(1) << 24);  // carry may be negative
+            acc[i - 1] += carry;
+        }
+
+        // If fraction >= 1/2: f = -(1 - fraction) and k + 1
+        std::int64_t n = acc[0];
+        double sign = 1;
+        if (acc[1] >> 23) {
+            n += 1;
+            sign = -1;
+            for (int i = 1; i <= frac; i++) {
+                acc[i] = mask - acc[i];
+            }
+            for (int i = frac; i > 0 && ++acc[i] > mask; i--) {
+                acc[i] = 0;
+            }
+        }
+        k = static_cast<double>(n & 3);
+
+        double f1 = 0, f0 = 0;
+        for (int i = 1; i <= frac; i++) {
+            f0 = padd1(f0, f1, std::ldexp(static_cast<double>(acc[i]), -24 * i), f1);
+        }
+
+        using C = trig_const<double>;
+        return pmul(sign * f0, sign * f1, C::pio2_0, C::pio2_1, r1);
+    }
+
+    // sin(x) and cos(x) for any x: NaN with zero error if x is Inf or NaN
+    inline double ptrig_special(double x0, double x1, double& s1, double& c0, double& c1)
+    {
+        if (!std::isfinite(x0)) {
+            s1 = c1 = 0;
+            return c0 = x0 - x0;
+        }
+        if (ptrig_fits(x0)) {
+            return psincos(x0, x1, s1, c0, c1);
+        }
+        double k, r1, r0 = ptrig_reduce_large(x0, x1, k, r1);
+        return ptrig_core(r0, r1, k, s1, c0, c1);
+    }
+
+    // Coupled double rounded to coupled float: zero error if Inf or NaN
+    inline float ptrig_round(double z0, double z1, float& f1)
+    {
+        auto f0 = static_cast<float>(z0 + z1);
+        f1 = std::isfinite(f0) ? static_cast<float>((z0 - f0) + z1) : 0;
+        return f0;
+    }
+
+    // Float by double, as double is accurate enough for float coupled
+    inline float ptrig_special(float x0, float x1, float& s1, float& c0, float& c1)
+    {
+        double t1, d0, d1, t0 = ptrig_special(static_cast<double>(x0),
+                                              static_cast<double>(x1), t1, d0, d1);
+        c0 = ptrig_round(d0, d1, c1);
+        return ptrig_round(t0, t1, s1);
+    }
+
+    // Range of patan2() for x0 and y0
+    inline bool patan2_fits(double x0) {
+        double a = std::fabs(x0);
+        return (a >= 1e-100 && a <= 1e100) || x0 == 0;
+    }
+    inline bool patan2_fits(float x0) {
+        float a = std::fabs(x0);
+        return (a >= 1e-8f && a <= 1e8f) || x0 == 0;
+    }
+
+    // atan2(y, x) for any y and x: if ratio of y and x is extreme, then
+    // y/x, or +-pi/2 - x/y, or +-pi + y/x; else scaled so that larger
+    // of them is about 1; Inf, NaN, or both zero by <cmath>
+    inline double patan2_special(double y0, double y1, double x0, double x1, double& z1)
+    {
+        using C = trig_const<double>;
+        double ax = std::fabs(x0), ay = std::fabs(y0);
+        if (!std::isfinite(ax) || !std::isfinite(ay) || (ax == 0 && ay == 0)) {
+            z1 = 0;
+            return std::atan2(y0, x0);
+        }
+        // Scale so that pdiv() does not overflow
+        int e = std::ilogb(std::fmax(ax, ay));
+        y0 = std::ldexp(y0, -e), y1 = std::ldexp(y1, -e);
+        x0 = std::ldexp(x0, -e), x1 = std::ldexp(x1, -e);
+        double pio2_0 = std::copysign(C::pio2_0, y0);
+        double pio2_1 = std::copysign(C::pio2_1, y0);
+        if (ay < 1e-100 * ax) {
+            double q1, q0 = pdiv(y0, y1, x0, x1, q1);
+            if (x0 > 0) {
+                z1 = q1;
+                return q0;
+            }
+            return padd(2 * pio2_0, 2 * pio2_1, q0, q1, z1);
+        }
+        if (ax < 1e-100 * ay) {
+            double q1, q0 = pdiv(x0, x1, y0, y1, q1);
+            return psub(pio2_0, pio2_1, q0, q1, z1);
+        }
+        return patan2(y0, y1, x0, x1, z1);
+    }
+
+    inline float patan2_special(float y0, float y1, float x0, float x1, float& z1)
+    {
+        if (!std::isfinite(x0) || !std::isfinite(y0) || (x0 == 0 && y0 == 0)) {
+            z1 = 0;
+            return std::atan2(y0, x0);
+        }
+        double t1, t0 = patan2_special(static_cast<double>(y0), static_cast<double>(y1),
+                                       static_cast<double>(x0), static_cast<double>(x1), t1);
+        return ptrig_round(t0, t1, z1);
+    }
+
+    // asin(x) and acos(x) for any x: by atan2 if |x| < 1; else exact
+    // for x = +-1, or NaN
+    template<typename T> inline T pasin_special(bool cosine, T x0, T x1, T& z1)
+    {
+        using C = trig_const<T>;
+        T a = std::fabs(x0);
+        if (a < 1 || (a == 1 && x0 * x1 < 0)) {
+            T w1, w0 = ptrig_cosine(x0, x1, w1);
+            return cosine ? patan2_special(w0, w1, x0, x1, z1)
+                          : patan2_special(x0, x1, w0, w1, z1);
+        }
+        if (a == 1 && x1 == 0) {
+            // asin is +-pi/2, acos is 0 or pi
+            T h = cosine ? 1 - x0 : x0;
+            z1 = h * C::pio2_1;
+            return h * C::pio2_0;
+        }
+        z1 = 0;
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_TRIG_H
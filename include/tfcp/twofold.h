@@ -12,6 +12,7 @@
 //  - Defines `twofold` and `coupled` types
 //  - Arithmetic functions like z = tadd(x, y)
 //  - Math functions like sqrt(x), isnan(x), ...
+//  - Fused coupled functions like fma(x, y, w), dot2(a, b, c, d), ...
 //  - Operators over twofolds: -x, x + y, x < y, ...
 //  - Converting twofold to string, and printing
 //
@@ -23,6 +24,10 @@
 
 #include <cmath>
 
+#if !defined(TFCP_COMPILED)
+#include <tfcp/simd.h>  // TFCP_SIMD_ISA
+#endif
+
 namespace tfcp {
 
     // Assume T is scalar: float, double
@@ -114,11 +119,38 @@ namespace tfcp {
     //
     //  Arithmetic functions: tadd, tsub, tmul, tdiv, tsqrt, renormalize
     //
+    //  These are inline by default, see implementation in <tfcp/shaped.h>
+    //  So compiler can fuse them into the caller's loop like plain double
+    //
+    //  Define TFCP_COMPILED to call them from the tfcp library instead,
+    //  e.g. if you build your program with link-time optimization (LTO)
+    //
+    //  NB: library compiles them with same options as your code, e.g.
+    //  with FMA; and its functions like lu() call them if TFCP_COMPILED,
+    //  so then the library runs only on CPU that has FMA
+    //
+    //  Inline functions and the operators over them are compiled for the
+    //  target of each translation unit, like tfcp library with baseline
+    //  and user code with FMA: so they go to the inline namespace named
+    //  by TFCP_SIMD_ISA, same as basic.h, to keep linker off mixing them
+    //
     //------------------------------------------------------------------
 
+#if defined(TFCP_COMPILED)
+    #define TFCP_INLINE
+    #define TFCP_ISA_BEGIN
+    #define TFCP_ISA_END
+#else
+    #define TFCP_INLINE inline
+    #define TFCP_ISA_BEGIN inline namespace TFCP_SIMD_ISA {
+    #define TFCP_ISA_END   }
+#endif
+
+TFCP_ISA_BEGIN
+
 #define TFCP_RENORM(T) \
-    shaped<T> renormalize(const shaped<T>& x); \
-    shaped<T> fast_renorm(const shaped<T>& x); \
+    TFCP_INLINE shaped<T> renormalize(const shaped<T>& x); \
+    TFCP_INLINE shaped<T> fast_renorm(const shaped<T>& x); \
     inline T renormalize(T x) { return x; } \
     inline T fast_renorm(T x) { return x; }
     TFCP_RENORM(double);
@@ -126,8 +158,8 @@ namespace tfcp {
 #undef TFCP_RENORM
 
 #define TFCP_SQRT(PREFIX, T) \
-    shaped<T> PREFIX ## sqrt(const shaped<T>& x); \
-    shaped<T> PREFIX ## sqrt(             T   x);
+    TFCP_INLINE shaped<T> PREFIX ## sqrt(const shaped<T>& x); \
+    TFCP_INLINE shaped<T> PREFIX ## sqrt(             T   x);
     TFCP_SQRT(t, double);
     TFCP_SQRT(p, double);
     TFCP_SQRT(t, float);
@@ -135,10 +167,10 @@ namespace tfcp {
 #undef TFCP_SQRT
 
 #define TFCP_ARITHM_BASE(OP, PREFIX, T) \
-    shaped<T> PREFIX ## OP(const shaped<T>& x, const shaped<T>& y); \
-    shaped<T> PREFIX ## OP(const shaped<T>& x,              T   y); \
-    shaped<T> PREFIX ## OP(             T   x, const shaped<T>& y); \
-    shaped<T> PREFIX ## OP(             T   x,              T   y);
+    TFCP_INLINE shaped<T> PREFIX ## OP(const shaped<T>& x, const shaped<T>& y); \
+    TFCP_INLINE shaped<T> PREFIX ## OP(const shaped<T>& x,              T   y); \
+    TFCP_INLINE shaped<T> PREFIX ## OP(             T   x, const shaped<T>& y); \
+    TFCP_INLINE shaped<T> PREFIX ## OP(             T   x,              T   y);
     TFCP_ARITHM_BASE(add, t, double);
     TFCP_ARITHM_BASE(sub, t, double);
     TFCP_ARITHM_BASE(mul, t, double);
@@ -157,6 +189,19 @@ namespace tfcp {
     TFCP_ARITHM_BASE(div, p, float);
 #undef TFCP_ARITHM_BASE
 
+    // Fused coupled: x*y + w, x*y - w, a*b + c*d, x + y + w
+#define TFCP_FUSED(T) \
+    TFCP_INLINE shaped<T> pfma (const shaped<T>& x, const shaped<T>& y, const shaped<T>& w); \
+    TFCP_INLINE shaped<T> pfms (const shaped<T>& x, const shaped<T>& y, const shaped<T>& w); \
+    TFCP_INLINE shaped<T> psum3(const shaped<T>& x, const shaped<T>& y, const shaped<T>& w); \
+    TFCP_INLINE shaped<T> pdot2(const shaped<T>& a, const shaped<T>& b, \
+                                const shaped<T>& c, const shaped<T>& d);
+    TFCP_FUSED(double);
+    TFCP_FUSED(float);
+#undef TFCP_FUSED
+
+TFCP_ISA_END
+
     //------------------------------------------------------------------
     //
     //  Type-and-shape conversions
@@ -190,6 +235,26 @@ namespace tfcp {
     //
     //------------------------------------------------------------------
 
+    //
+    // Renormalize for the conversions below: these are not in the
+    // TFCP_SIMD_ISA namespace, so must not call the shaped.h wrappers
+    // Just adds, so same result in any backend
+    //
+
+    template<typename T> inline shaped<T> renorm_cast(const shaped<T>& x) {
+        T r0 = x.value + x.error;  // any x: TwoSum
+        T yt = r0 - x.value;
+        T xt = r0 - yt;
+        T r1 = (x.error - yt) + (x.value - xt);
+        return shaped<T>(r0, r1);
+    }
+
+    template<typename T> inline shaped<T> fast_renorm_cast(const shaped<T>& x) {
+        T r0 = x.value + x.error;  // if |value| >= |error|: FastTwoSum
+        T r1 = x.error - (r0 - x.value);
+        return shaped<T>(r0, r1);
+    }
+
     //
     // Get dotted by twofold/coupled
     //
@@ -249,7 +314,7 @@ namespace tfcp {
     template<> inline shaped<float>  tbyp(const shaped<double>& x) { return tbyt<float, double>(x); }
     template<> inline shaped<double> tbyp(const shaped<float> & x) {
         shaped<double> t(x.value, x.error);  // expand
-        return fast_renorm(t);
+        return fast_renorm_cast(t);
     }
 
     //
@@ -260,24 +325,24 @@ namespace tfcp {
     template<> inline shaped<float>  pbyp(const shaped<float> & x) { return x; }
     template<> inline shaped<double> pbyp(const shaped<float> & x) {
         shaped<double> t(x.value, x.error);  // expand
-        return fast_renorm(t);
+        return fast_renorm_cast(t);
     }
     template<> inline shaped<float>  pbyp(const shaped<double>& x) {
         float value = static_cast<float>(x.value);          // round to nearest-even
         float error = static_cast<float>(x.value - value);  // exact, if enough bits
               error = static_cast<float>(x.error + error);
         shaped<float> t(value, error);
-        return fast_renorm(t);
+        return fast_renorm_cast(t);
     }
 
-    template<> inline shaped<double> pbyt(const shaped<double>& x) { return renormalize(x); }
-    template<> inline shaped<float>  pbyt(const shaped<float> & x) { return renormalize(x); }
+    template<> inline shaped<double> pbyt(const shaped<double>& x) { return renorm_cast(x); }
+    template<> inline shaped<float>  pbyt(const shaped<float> & x) { return renorm_cast(x); }
     template<> inline shaped<double> pbyt(const shaped<float> & x) {
         shaped<double> t(x.value, x.error);  // expand
-        return renormalize(t);
+        return renorm_cast(t);
     }
     template<> inline shaped<float>  pbyt(const shaped<double>& x) {
-        shaped<double> t = renormalize(x);
+        shaped<double> t = renorm_cast(x);
         return pbyp<float, double>(t);
     }
 
@@ -311,33 +376,7 @@ namespace tfcp {
         operator         float ();
         operator twofold<float>();
         operator coupled<float>();
-    public:
-        twofold& operator += (double x);
-        twofold& operator -= (double x);
-        twofold& operator *= (double x);
-        twofold& operator /= (double x);
-        twofold& operator += (float x);
-        twofold& operator -= (float x);
-        twofold& operator *= (float x);
-        twofold& operator /= (float x);
-    public:
-        twofold& operator += (const twofold<double>& x);
-        twofold& operator -= (const twofold<double>& x);
-        twofold& operator *= (const twofold<double>& x);
-        twofold& operator /= (const twofold<double>& x);
-        twofold& operator += (const twofold<float> & x);
-        twofold& operator -= (const twofold<float> & x);
-        twofold& operator *= (const twofold<float> & x);
-        twofold& operator /= (const twofold<float> & x);
-    public:
-        twofold& operator += (const coupled<double>& x);
-        twofold& operator -= (const coupled<double>& x);
-        twofold& operator *= (const coupled<double>& x);
-        twofold& operator /= (const coupled<double>& x);
-        twofold& operator += (const coupled<float> & x);
-        twofold& operator -= (const coupled<float> & x);
-        twofold& operator *= (const coupled<float> & x);
-        twofold& operator /= (const coupled<float> & x);
+        // operators +=, -=, *=, /= are not members, see below
     };
 
     template<typename T> struct coupled: public shaped<T> {
@@ -358,33 +397,7 @@ namespace tfcp {
         operator         float ();
         operator twofold<float>();
         operator coupled<float>();
-    public:
-        coupled& operator += (double x);
-        coupled& operator -= (double x);
-        coupled& operator *= (double x);
-        coupled& operator /= (double x);
-        coupled& operator += (float x);
-        coupled& operator -= (float x);
-        coupled& operator *= (float x);
-        coupled& operator /= (float x);
-    public:
-        coupled& operator += (const coupled<double>& x);
-        coupled& operator -= (const coupled<double>& x);
-        coupled& operator *= (const coupled<double>& x);
-        coupled& operator /= (const coupled<double>& x);
-        coupled& operator += (const coupled<float> & x);
-        coupled& operator -= (const coupled<float> & x);
-        coupled& operator *= (const coupled<float> & x);
-        coupled& operator /= (const coupled<float> & x);
-    public:
-        coupled& operator += (const twofold<double>& x);
-        coupled& operator -= (const twofold<double>& x);
-        coupled& operator *= (const twofold<double>& x);
-        coupled& operator /= (const twofold<double>& x);
-        coupled& operator += (const twofold<float> & x);
-        coupled& operator -= (const twofold<float> & x);
-        coupled& operator *= (const twofold<float> & x);
-        coupled& operator /= (const twofold<float> & x);
+        // operators +=, -=, *=, /= are not members, see below
     };
 
     //------------------------------------------------------------------
@@ -419,6 +432,21 @@ namespace tfcp {
     inline coupled<double> pbys(const shaped<double>& x) { return coupled<double>(x.value, x.error); }
     inline coupled<float>  pbys(const shaped<float> & x) { return coupled<float> (x.value, x.error); }
 
+    //
+    // Thrown by comparing twofolds, see below
+    //
+
+    struct twofold_exception {};
+
+    //------------------------------------------------------------------
+    //
+    //  Functions and operators over the shaped.h wrappers: compiled per
+    //  target, as the wrappers are, so in the TFCP_SIMD_ISA namespace
+    //
+    //------------------------------------------------------------------
+
+TFCP_ISA_BEGIN
+
     //------------------------------------------------------------------
     //
     //  Arithmetic operations: +, -, *, /, sqrt
@@ -432,6 +460,35 @@ namespace tfcp {
     inline double sqrt(double x) { return std::sqrt(x); }
     inline float  sqrt(float  x) { return std::sqrt(x); }
 
+    //------------------------------------------------------------------
+    //
+    //  Fused operations: fma, fms, dot2, sum3
+    //
+    //  Same as x*y + w, x*y - w, a*b + c*d, x + y + w by operators, but
+    //  renormalize only the result, so cheaper; error is about the same
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_FUSED(T) \
+    inline coupled<T> fma(const coupled<T>& x, const coupled<T>& y, const coupled<T>& w) { \
+        return pbys(pfma(x, y, w)); \
+    } \
+    inline coupled<T> fms(const coupled<T>& x, const coupled<T>& y, const coupled<T>& w) { \
+        return pbys(pfms(x, y, w)); \
+    } \
+    inline coupled<T> sum3(const coupled<T>& x, const coupled<T>& y, const coupled<T>& w) { \
+        return pbys(psum3(x, y, w)); \
+    } \
+    inline coupled<T> dot2(const coupled<T>& a, const coupled<T>& b, \
+                           const coupled<T>& c, const coupled<T>& d) { \
+        return pbys(pdot2(a, b, c, d)); \
+    }
+    TFCP_FUSED(double);
+    TFCP_FUSED(float);
+#undef TFCP_FUSED
+    inline double fma(double x, double y, double w) { return std::fma(x, y, w); }
+    inline float  fma(float  x, float  y, float  w) { return std::fma(x, y, w); }
+
 #define TFCP_ARITHM_SAME_TYPE(OP, F, PREFIX, SHAPE, T) \
     inline SHAPE<T> operator OP(const SHAPE<T>& x, const SHAPE<T>& y) { return PREFIX ## bys(PREFIX ## F(x, y)); } \
     inline SHAPE<T> operator OP(const SHAPE<T>& x,             T   y) { return PREFIX ## bys(PREFIX ## F(x, y)); } \
@@ -515,12 +572,17 @@ namespace tfcp {
     //
     //  Arithmetic operators: +=, -=, *=, /=
     //
+    //  NB: these are not members of twofold and coupled since version
+    //  with TFCP_SIMD_ISA: a member would be the same symbol for every
+    //  target, though its code depends on the target; so pointers like
+    //  &coupled<double>::operator+= no longer compile, see README.md
+    //
     //------------------------------------------------------------------
 
 #define TFCP_ARITHM_SELF(OP, SHAPE, S) \
-    template<typename T> inline SHAPE<T>& SHAPE<T>::operator OP##=(              S   x) { return *this = *this OP x; } \
-    template<typename T> inline SHAPE<T>& SHAPE<T>::operator OP##=(const twofold<S>& x) { return *this = *this OP x; } \
-    template<typename T> inline SHAPE<T>& SHAPE<T>::operator OP##=(const coupled<S>& x) { return *this = *this OP x; }
+    template<typename T> inline SHAPE<T>& operator OP##=(SHAPE<T>& z,               S   x) { z.init(SHAPE<T>(z OP x)); return z; } \
+    template<typename T> inline SHAPE<T>& operator OP##=(SHAPE<T>& z, const twofold<S>& x) { z.init(SHAPE<T>(z OP x)); return z; } \
+    template<typename T> inline SHAPE<T>& operator OP##=(SHAPE<T>& z, const coupled<S>& x) { z.init(SHAPE<T>(z OP x)); return z; }
     TFCP_ARITHM_SELF(+, twofold, double);
     TFCP_ARITHM_SELF(-, twofold, double);
     TFCP_ARITHM_SELF(*, twofold, double);
@@ -612,11 +674,9 @@ namespace tfcp {
 
     //
     // Comparing twofolds may result in `undefined`
-    // In such case, the comparing operation throws
+    // In such case, the comparing operation throws twofold_exception
     //
 
-    struct twofold_exception {};
-
 #define TFCP_COMPARE_TWOFOLD(OP, T, S)                                   \
     inline bool operator OP (const twofold<T>& x, const twofold<S>& y) { \
         if (x.value OP y.value) {                                        \
@@ -731,6 +791,8 @@ namespace tfcp {
     TFCP_COMPARE_CROSS_SHAPE_VAR_TYPES(<);
 #undef TFCP_COMPARE_CROSS_SHAPE_VAR_TYPES
 
+TFCP_ISA_END
+
     //------------------------------------------------------------------
     //
     //  Printing, converting to string
@@ -749,5 +811,15 @@ namespace tfcp {
 
 }  // namespace tfcp
 
+//----------------------------------------------------------------------
+//
+//  Inline implementation of arithmetic functions, unless TFCP_COMPILED
+//
+//----------------------------------------------------------------------
+
+#if !defined(TFCP_COMPILED)
+#include <tfcp/shaped.h>
+#endif
+
 //======================================================================
 #endif  // TWOFOLD_H
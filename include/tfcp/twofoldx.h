@@ -0,0 +1,360 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TWOFOLDX_H
+#define TWOFOLDX_H
+//======================================================================
+//
+//  C++ interface to TFCP library: short-vector twofold and coupled
+//
+//  - Defines twofold<floatx>, twofold<doublex>, and coupled<...>
+//  - Operators over short-vectors: -x, x + y, x += y, sqrt(x), ...
+//  - Fused coupled operations: fma(x, y, w), dot2(a, b, c, d), ...
+//  - Loading/storing from/to scalar arrays, access to i'th position
+//
+//  Position i of twofold<doublex> is twofold<double>, etc.
+//
+//  Comparing is not defined, as it would result in a vector of bools
+//
+//======================================================================
+
+#include <tfcp/twofold.h>
+#include <tfcp/basic.h>
+#include <tfcp/simd.h>
+
+#include <iostream>
+
+namespace tfcp {
+
+    //------------------------------------------------------------------
+    //
+    // Define alias types:
+    // - twofold: tfloatx, tdoublex
+    // - coupled: pfloatx, pdoublex
+    //
+    // Twofold aliases degrade to floatx/doublex if Release build
+    //
+    //------------------------------------------------------------------
+
+    using pfloatx  = coupled<floatx>;
+    using pdoublex = coupled<doublex>;
+
+#ifndef NDEBUG
+    using tfloatx  = twofold<floatx>;
+    using tdoublex = twofold<doublex>;
+#else
+    using tfloatx  = floatx;
+    using tdoublex = doublex;
+#endif
+
+    //------------------------------------------------------------------
+    //
+    //  Functions and operators over short-vectors are compiled for the
+    //  target of each translation unit: e.g. with -mavx and -mavx2 -mfma
+    //  doublex is same type, but pmul() is not same code; so put them in
+    //  the TFCP_SIMD_ISA namespace, same as basic.h, even if TFCP_COMPILED
+    //
+    //------------------------------------------------------------------
+
+inline namespace TFCP_SIMD_ISA {
+
+    //------------------------------------------------------------------
+    //
+    //  Shape-agnostic access to value and error, see twofold.h
+    //
+    //------------------------------------------------------------------
+
+    inline floatx  value_of(const shaped<floatx> & x) { return x.value; }
+    inline floatx  error_of(const shaped<floatx> & x) { return x.error; }
+    inline doublex value_of(const shaped<doublex>& x) { return x.value; }
+    inline doublex error_of(const shaped<doublex>& x) { return x.error; }
+
+    // If dotted x, e.g. if tdoublex with NDEBUG
+    inline floatx  value_of(floatx  x) { return x; }
+    inline floatx  error_of(floatx    ) { return setzerox<floatx>(); }
+    inline doublex value_of(doublex x) { return x; }
+    inline doublex error_of(doublex   ) { return setzerox<doublex>(); }
+
+} // namespace TFCP_SIMD_ISA
+
+    //------------------------------------------------------------------
+    //
+    // Define short-vector twofold/coupled structures
+    //
+    // Scalar T, twofold<T>, coupled<T> broadcast to all positions
+    //
+    // Specializations of twofold and coupled, so not in TFCP_SIMD_ISA:
+    // members only broadcast and add, same code for any target; and the
+    // operators +=, -=, *=, /= are not members, see below
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_TWOFOLDX(TX, T)                                                 \
+    template<> struct twofold<TX>: public shaped<TX> {                       \
+    public:                                                                  \
+        twofold() {}                                                         \
+        twofold(TX value, TX error) { shaped<TX>::init(value, error); }      \
+    public:                                                                  \
+        twofold(              TX   x) { init(x, setzerox<TX>()); }           \
+        twofold(const coupled<TX>& x);                                       \
+    public:                                                                  \
+        twofold(              T    x) { init(setallx<TX>(x),                 \
+                                             setzerox<TX>()); }              \
+        twofold(const twofold<T> & x) { init(setallx<TX>(x.value),           \
+                                             setallx<TX>(x.error)); }        \
+        twofold(const coupled<T> & x) { init(setallx<TX>(x.value),           \
+                                             setallx<TX>(x.error)); }        \
+    };                                                                       \
+                                                                             \
+    template<> struct coupled<TX>: public shaped<TX> {                       \
+    public:                                                                  \
+        coupled() {}                                                         \
+        coupled(TX value, TX error) { shaped<TX>::init(value, error); }      \
+    public:                                                                  \
+        coupled(              TX   x) { init(x, setzerox<TX>()); }           \
+        coupled(const twofold<TX>& x);                                       \
+    public:                                                                  \
+        coupled(              T    x) { init(setallx<TX>(x),                 \
+                                             setzerox<TX>()); }              \
+        coupled(const twofold<T> & x) {                                      \
+            coupled<T> p(x);                                                 \
+            init(setallx<TX>(p.value), setallx<TX>(p.error));                \
+        }                                                                    \
+        coupled(const coupled<T> & x) { init(setallx<TX>(x.value),           \
+                                             setallx<TX>(x.error)); }        \
+    };                                                                       \
+                                                                             \
+    inline twofold<TX>::twofold(const coupled<TX>& x) {                      \
+        init(x.value, x.error);                                              \
+    }                                                                        \
+    inline coupled<TX>::coupled(const twofold<TX>& x) {                      \
+        init(renorm_cast(x));                                                \
+    }
+    TFCP_TWOFOLDX(floatx, float);
+    TFCP_TWOFOLDX(doublex, double);
+#undef TFCP_TWOFOLDX
+
+inline namespace TFCP_SIMD_ISA {
+
+    //------------------------------------------------------------------
+    //
+    //  Arithmetic operations: +, -, *, /, sqrt
+    //
+    //  Suffix of basic.h function tells which argument is dotted:
+    //    1: y is dotted, 2: x is dotted
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_ARITHMX(OP, F, PREFIX, SHAPE, TX, T)                            \
+    inline SHAPE<TX> operator OP(const SHAPE<TX>& x, const SHAPE<TX>& y) {   \
+        TX z0, z1;                                                           \
+        z0 = PREFIX ## F(x.value, x.error, y.value, y.error, z1);            \
+        return SHAPE<TX>(z0, z1);                                            \
+    }                                                                        \
+    inline SHAPE<TX> operator OP(const SHAPE<TX>& x, TX y) {                 \
+        TX z0, z1;                                                           \
+        z0 = PREFIX ## F ## 1(x.value, x.error, y, z1);                      \
+        return SHAPE<TX>(z0, z1);                                            \
+    }                                                                        \
+    inline SHAPE<TX> operator OP(TX x, const SHAPE<TX>& y) {                 \
+        TX z0, z1;                                                           \
+        z0 = PREFIX ## F ## 2(x, y.value, y.error, z1);                      \
+        return SHAPE<TX>(z0, z1);                                            \
+    }                                                                        \
+    inline SHAPE<TX> operator OP(const SHAPE<TX>& x, T y) {                  \
+        return x OP setallx<TX>(y);                                          \
+    }                                                                        \
+    inline SHAPE<TX> operator OP(T x, const SHAPE<TX>& y) {                  \
+        return setallx<TX>(x) OP y;                                          \
+    }
+    TFCP_ARITHMX(+, add, t, twofold, floatx, float);
+    TFCP_ARITHMX(-, sub, t, twofold, floatx, float);
+    TFCP_ARITHMX(*, mul, t, twofold, floatx, float);
+    TFCP_ARITHMX(/, div, t, twofold, floatx, float);
+    TFCP_ARITHMX(+, add, p, coupled, floatx, float);
+    TFCP_ARITHMX(-, sub, p, coupled, floatx, float);
+    TFCP_ARITHMX(*, mul, p, coupled, floatx, float);
+    TFCP_ARITHMX(/, div, p, coupled, floatx, float);
+    TFCP_ARITHMX(+, add, t, twofold, doublex, double);
+    TFCP_ARITHMX(-, sub, t, twofold, doublex, double);
+    TFCP_ARITHMX(*, mul, t, twofold, doublex, double);
+    TFCP_ARITHMX(/, div, t, twofold, doublex, double);
+    TFCP_ARITHMX(+, add, p, coupled, doublex, double);
+    TFCP_ARITHMX(-, sub, p, coupled, doublex, double);
+    TFCP_ARITHMX(*, mul, p, coupled, doublex, double);
+    TFCP_ARITHMX(/, div, p, coupled, doublex, double);
+#undef TFCP_ARITHMX
+
+#define TFCP_SQRTX(PREFIX, SHAPE, TX)                                        \
+    inline SHAPE<TX> sqrt(const SHAPE<TX>& x) {                              \
+        TX z0, z1;                                                           \
+        z0 = PREFIX ## sqrt(x.value, x.error, z1);                           \
+        return SHAPE<TX>(z0, z1);                                            \
+    }
+    TFCP_SQRTX(t, twofold, floatx);
+    TFCP_SQRTX(p, coupled, floatx);
+    TFCP_SQRTX(t, twofold, doublex);
+    TFCP_SQRTX(p, coupled, doublex);
+#undef TFCP_SQRTX
+
+    //------------------------------------------------------------------
+    //
+    //  Fused operations: fma, fms, dot2, sum3, see twofold.h
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_FUSEDX(TX)                                                      \
+    inline coupled<TX> fma(const coupled<TX>& x, const coupled<TX>& y,       \
+                           const coupled<TX>& w) {                           \
+        TX z0, z1;                                                           \
+        z0 = pfma(x.value, x.error, y.value, y.error, w.value, w.error, z1); \
+        return coupled<TX>(z0, z1);                                          \
+    }                                                                        \
+    inline coupled<TX> fms(const coupled<TX>& x, const coupled<TX>& y,       \
+                           const coupled<TX>& w) {                           \
+        TX z0, z1;                                                           \
+        z0 = pfms(x.value, x.error, y.value, y.error, w.value, w.error, z1); \
+        return coupled<TX>(z0, z1);                                          \
+    }                                                                        \
+    inline coupled<TX> sum3(const coupled<TX>& x, const coupled<TX>& y,      \
+                            const coupled<TX>& w) {                          \
+        TX z0, z1;                                                           \
+        z0 = psum3(x.value, x.error, y.value, y.error,                       \
+                   w.value, w.error, z1);                                    \
+        return coupled<TX>(z0, z1);                                          \
+    }                                                                        \
+    inline coupled<TX> dot2(const coupled<TX>& a, const coupled<TX>& b,      \
+                            const coupled<TX>& c, const coupled<TX>& d) {    \
+        TX z0, z1;                                                           \
+        z0 = pdot2(a.value, a.error, b.value, b.error,                       \
+                   c.value, c.error, d.value, d.error, z1);                  \
+        return coupled<TX>(z0, z1);                                          \
+    }
+    TFCP_FUSEDX(floatx);
+    TFCP_FUSEDX(doublex);
+#undef TFCP_FUSEDX
+
+    //------------------------------------------------------------------
+    //
+    //  Arithmetic operators: +=, -=, *=, /=, and unary + and -
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_ARITHMX_SELF(OP, SHAPE, TX, T)                                                         \
+    inline SHAPE<TX>& operator OP##=(SHAPE<TX>& z, const SHAPE<TX>& x) { z.init(z OP x); return z; } \
+    inline SHAPE<TX>& operator OP##=(SHAPE<TX>& z,              TX  x) { z.init(z OP x); return z; } \
+    inline SHAPE<TX>& operator OP##=(SHAPE<TX>& z,              T   x) { z.init(z OP x); return z; }
+    TFCP_ARITHMX_SELF(+, twofold, floatx, float);
+    TFCP_ARITHMX_SELF(-, twofold, floatx, float);
+    TFCP_ARITHMX_SELF(*, twofold, floatx, float);
+    TFCP_ARITHMX_SELF(/, twofold, floatx, float);
+    TFCP_ARITHMX_SELF(+, coupled, floatx, float);
+    TFCP_ARITHMX_SELF(-, coupled, floatx, float);
+    TFCP_ARITHMX_SELF(*, coupled, floatx, float);
+    TFCP_ARITHMX_SELF(/, coupled, floatx, float);
+    TFCP_ARITHMX_SELF(+, twofold, doublex, double);
+    TFCP_ARITHMX_SELF(-, twofold, doublex, double);
+    TFCP_ARITHMX_SELF(*, twofold, doublex, double);
+    TFCP_ARITHMX_SELF(/, twofold, doublex, double);
+    TFCP_ARITHMX_SELF(+, coupled, doublex, double);
+    TFCP_ARITHMX_SELF(-, coupled, doublex, double);
+    TFCP_ARITHMX_SELF(*, coupled, doublex, double);
+    TFCP_ARITHMX_SELF(/, coupled, doublex, double);
+#undef TFCP_ARITHMX_SELF
+
+    inline twofold<floatx>  operator + (const twofold<floatx> & x) { return x; }
+    inline coupled<floatx>  operator + (const coupled<floatx> & x) { return x; }
+    inline twofold<doublex> operator + (const twofold<doublex>& x) { return x; }
+    inline coupled<doublex> operator + (const coupled<doublex>& x) { return x; }
+
+    inline twofold<floatx>  operator - (const twofold<floatx> & x) { return twofold<floatx> (-x.value, -x.error); }
+    inline coupled<floatx>  operator - (const coupled<floatx> & x) { return coupled<floatx> (-x.value, -x.error); }
+    inline twofold<doublex> operator - (const twofold<doublex>& x) { return twofold<doublex>(-x.value, -x.error); }
+    inline coupled<doublex> operator - (const coupled<doublex>& x) { return coupled<doublex>(-x.value, -x.error); }
+
+    //------------------------------------------------------------------
+    //
+    //  Access to i'th position: like getx(x, i) and setx(x, i, value)
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_GETX(SHAPE, TX, T)                                              \
+    inline SHAPE<T> getx(const SHAPE<TX>& x, int i) {                        \
+        return SHAPE<T>(getx(x.value, i), getx(x.error, i));                 \
+    }                                                                        \
+    inline void setx(SHAPE<TX>& x, int i, const SHAPE<T>& y) {               \
+        getx(x.value, i) = y.value;                                          \
+        getx(x.error, i) = y.error;                                          \
+    }
+    TFCP_GETX(twofold, floatx, float);
+    TFCP_GETX(coupled, floatx, float);
+    TFCP_GETX(twofold, doublex, double);
+    TFCP_GETX(coupled, doublex, double);
+#undef TFCP_GETX
+
+    //------------------------------------------------------------------
+    //
+    //  Load/store from/to scalar arrays, maybe unaligned
+    //
+    //  - Array of twofold<T> or coupled<T>, e.g.:
+    //      tdoublex x = loadx<tdoublex>(pointer);
+    //  - Separate arrays of values and errors, e.g.:
+    //      tdoublex x = loadx<tdoublex>(values, errors);
+    //
+    //------------------------------------------------------------------
+
+    // NB: template, so can use like loadx<type>(values, errors)
+    template<typename SX, typename T> inline SX loadx(const T* value, const T* error);
+
+#define TFCP_LOADX(SHAPE, TX, T)                                             \
+    template<> inline SHAPE<TX> loadx(const SHAPE<T>* p) {                   \
+        SHAPE<TX> x;                                                         \
+        for (int i = 0; i < traitx<TX>::length; i++) {                       \
+            setx(x, i, p[i]);                                                \
+        }                                                                    \
+        return x;                                                            \
+    }                                                                        \
+    template<> inline SHAPE<TX> loadx(const T* value, const T* error) {      \
+        return SHAPE<TX>(loadx<TX>(value), loadx<TX>(error));                \
+    }                                                                        \
+    inline void storex(SHAPE<T>* p, const SHAPE<TX>& x) {                    \
+        for (int i = 0; i < traitx<TX>::length; i++) {                       \
+            p[i].init(getx(x, i));                                           \
+        }                                                                    \
+    }                                                                        \
+    inline void storex(T* value, T* error, const SHAPE<TX>& x) {             \
+        storex(value, x.value);                                              \
+        storex(error, x.error);                                              \
+    }
+    TFCP_LOADX(twofold, floatx, float);
+    TFCP_LOADX(coupled, floatx, float);
+    TFCP_LOADX(twofold, doublex, double);
+    TFCP_LOADX(coupled, doublex, double);
+#undef TFCP_LOADX
+
+    //------------------------------------------------------------------
+    //
+    //  Printing: like {x0[e0], x1[e1], ...}
+    //
+    //------------------------------------------------------------------
+
+#define TFCP_PRINTX(TX)                                                      \
+    inline std::ostream& operator << (std::ostream& out, const shaped<TX>& x) { \
+        out << "{";                                                          \
+        for (int i = 0; i < traitx<TX>::length; i++) {                       \
+            out << (i > 0 ? ", " : "")                                       \
+                << getx(x.value, i) << "[" << getx(x.error, i) << "]";       \
+        }                                                                    \
+        return out << "}";                                                   \
+    }
+    TFCP_PRINTX(floatx);
+    TFCP_PRINTX(doublex);
+#undef TFCP_PRINTX
+
+} // namespace TFCP_SIMD_ISA
+}  // namespace tfcp
+
+//======================================================================
+#endif  // TWOFOLDX_H
@@ -0,0 +1,136 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_BINNED_H
+#define TFCP_BINNED_H
+//======================================================================
+//
+// Binned accumulator for reproducible summation, see reduce.h
+//
+// Like ReproBLAS by Demmel, Ahrens, and Nguyen: exponent range splits
+// into bins of W bits, where bin j has unit u(j) = 2^(j*W + E0), and
+// every x splits into slices, each slice is a multiple of u(j):
+//
+//   q(j) = x rounded to multiple of u(j) by (x + S) - S,
+//          where S = 1.5 * 2^52 * u(j) -- then x -= q(j)
+//
+// Bin j sums slices exactly, so the order does not matter; and slices
+// of x do not depend on which bin we start slicing from, if from high
+// enough -- so binned sum is same for any partition of the array
+//
+// We keep only the K top bins, counting from the bin of max |x|: thus
+// result is sum of x rounded to multiple of u(top - K + 1), which is
+// about 2^-(K*W) relative to max |x|
+//
+// Each bin is c + a: a sums the slices, and c keeps carries from a as
+// multiples of u(j + 1), so that a never overflows its exact range
+//
+// Internally, use double arithmetic for both float and double inputs
+//
+// Inf and NaN inputs go into separate plain sum, which does not depend
+// on order either; and finite inputs must be less than 2^960 by value
+//
+// NB: this header must not depend on simd.h, same as kernels.h; the
+// arithmetic here is exact and so same for any ISA
+//
+//======================================================================
+
+#include <cmath>
+
+namespace tfcp {
+
+    struct binned {
+        static constexpr int W = 40;      // bits per bin
+        static constexpr int K = 3;       // bins to keep
+        static constexpr int E0 = -1074;  // unit of bin 0: least subnormal
+        static constexpr int J = 50;      // highest bin: then |x| < 2^965
+
+        // Slice up to this many x into one accumulator, then add it to
+        // the bin by binned_add(): so that it does not lose exactness
+        static constexpr int slices = 1 << 10;
+
+        int top;         // top bin, or -1 if empty
+        double c[K];     // c[k] + a[k] is sum of bin top - k
+        double a[K];
+        double special;  // sum of Inf and NaN inputs
+    };
+
+    // Unit of bin j
+    inline double binned_unit(int j) {
+        return std::ldexp(1.0, j * binned::W + binned::E0);
+    }
+
+    // Slicing constant S of bin j
+    inline double binned_shift(int j) {
+        return 1.5 * std::ldexp(1.0, j * binned::W + binned::E0 + 52);
+    }
+
+    // Bin for max |x|: least j such that m < 2^(W - 1) * u(j)
+    inline int binned_bin(double m) {
+        if (!(m > 0))
+            return 0;
+        if (!(m < std::ldexp(1.0, binned::J * binned::W + binned::E0 + binned::W - 1)))
+            return binned::J;  // Inf or NaN, see binned::special
+        int e;
+        std::frexp(m, &e);     // m < 2^e
+        int j = (e - (binned::W - 1) - binned::E0 + binned::W - 1) / binned::W;
+        return j > 0 ? j : 0;
+    }
+
+    inline void binned_init(binned& s) {
+        s.top = -1;
+        s.special = 0;
+        for (int k = 0; k < binned::K; k++) {
+            s.c[k] = 0;
+            s.a[k] = 0;
+        }
+    }
+
+    // Let top bin be at least j: drop lower bins if need
+    inline void binned_raise(binned& s, int j) {
+        if (j <= s.top)
+            return;
+        int shift = s.top < 0 ? binned::K : j - s.top;
+        for (int k = binned::K - 1; k >= 0; k--) {
+            bool keep = k - shift >= 0;
+            s.c[k] = keep ? s.c[k - shift] : 0;
+            s.a[k] = keep ? s.a[k - shift] : 0;
+        }
+        s.top = j;
+    }
+
+    // Add v to bin j, where v is sum of at most `slices` slices of bin j
+    // NB: ignore v if bin j is below the bins we keep
+    inline void binned_add(binned& s, int j, double v) {
+        int k = s.top - j;
+        if (j < 0 || k < 0 || k >= binned::K)
+            return;
+        double a = s.a[k] + v;              // exact: |a| < 2^53 u(j)
+        double shift = binned_shift(j + 1);
+        double h = (a + shift) - shift;     // multiple of u(j + 1)
+        s.a[k] = a - h;
+        s.c[k] = s.c[k] + h;                // exact: |c| < 2^53 u(j + 1)
+    }
+
+    // Add t into s
+    inline void binned_merge(binned& s, const binned& t) {
+        s.special = s.special + t.special;
+        if (t.top < 0)
+            return;
+        binned_raise(s, t.top);
+        for (int k = 0; k < binned::K; k++) {
+            int j = t.top - k;
+            int i = s.top - j;
+            if (i < 0 || i >= binned::K)
+                continue;
+            s.c[i] = s.c[i] + t.c[k];       // exact, see binned_add()
+            binned_add(s, j, t.a[k]);
+        }
+    }
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_BINNED_H
@@ -0,0 +1,155 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_KERNELS_H
+#define TFCP_KERNELS_H
+//======================================================================
+//
+// Table of batch kernels compiled for one ISA, see dispatch.h
+//
+// Sources under src/tfcp/kernels are compiled once per each ISA, and
+// each copy defines its own table, like kernels_avx2()
+//
+// NB: this header must not depend on simd.h, as dispatcher and batch
+// functions are compiled for baseline CPU, without AVX
+//
+//======================================================================
+
+#include <tfcp/binned.h>
+
+#include <cstddef>
+
+//----------------------------------------------------------------------
+//
+// List of kernels: K4(F) if F has 4 inputs like tadd(x0, x1, y0, y1),
+// K3(F) if 3 inputs like tadd1(x0, x1, y0), etc.
+//
+// Same as the basic.h templates, except p*0 are exact transforms from
+// exact.h: padd0, psub0, pmul0
+//
+//----------------------------------------------------------------------
+
+#define TFCP_KERNELS_LIST(K4, K3, K2, K1)                               \
+    K4(tadd) K3(tadd1) K3(tadd2) K2(tadd0)                              \
+    K4(tsub) K3(tsub1) K3(tsub2) K2(tsub0)                              \
+    K4(tmul) K3(tmul1) K3(tmul2) K2(tmul0)                              \
+    K4(tdiv) K3(tdiv1) K3(tdiv2) K2(tdiv0)                              \
+    K2(tsqrt) K1(tsqrt0)                                                \
+    K4(padd) K3(padd1) K3(padd2) K2(padd0)                              \
+    K4(psub) K3(psub1) K3(psub2) K2(psub0)                              \
+    K4(pmul) K3(pmul1) K3(pmul2) K2(pmul0)                              \
+    K4(pdiv) K3(pdiv1) K3(pdiv2) K2(pdiv0)                              \
+    K2(psqrt) K1(psqrt0)
+
+namespace tfcp {
+
+    template<typename T> struct kernels_of {
+        using kernel4 = void (*)(size_t n, const T a[], const T b[],
+                                           const T c[], const T d[],
+                                                 T z0[],      T z1[]);
+        using kernel3 = void (*)(size_t n, const T a[], const T b[],
+                                           const T c[],
+                                                 T z0[],      T z1[]);
+        using kernel2 = void (*)(size_t n, const T a[], const T b[],
+                                                 T z0[],      T z1[]);
+        using kernel1 = void (*)(size_t n, const T a[],
+                                                 T z0[],      T z1[]);
+    #define TFCP_FIELD4(F) kernel4 F;
+    #define TFCP_FIELD3(F) kernel3 F;
+    #define TFCP_FIELD2(F) kernel2 F;
+    #define TFCP_FIELD1(F) kernel1 F;
+        TFCP_KERNELS_LIST(TFCP_FIELD4, TFCP_FIELD3, TFCP_FIELD2, TFCP_FIELD1)
+    #undef TFCP_FIELD1
+    #undef TFCP_FIELD2
+    #undef TFCP_FIELD3
+    #undef TFCP_FIELD4
+
+        // Reductions, see reduce.h: z0 + z1 is result for n elements
+        using reduce1 = void (*)(size_t n, const T a[],
+                                                 T& z0,       T& z1);
+        using reduce2 = void (*)(size_t n, const T a[], const T b[],
+                                                 T& z0,       T& z1);
+        reduce1 sum2;
+        reduce2 dot2;
+
+        // Reproducible sum, see binned.h: add n elements into z
+        using reduceb = void (*)(size_t n, const T a[], binned& z);
+        reduceb rsum;
+
+        // Matrix product, see gemm.h: z = a * b, by rows of m x k, etc.
+        using product = void (*)(size_t m, size_t n, size_t k,
+                                 const T a0[], const T a1[], size_t lda,
+                                 const T b0[], const T b1[], size_t ldb,
+                                       T z0[],       T z1[], size_t ldz);
+        product gemm;
+
+        // Plain matrix product z = a * b, for the Ozaki scheme in gemm.h
+        using product0 = void (*)(size_t m, size_t n, size_t k,
+                                  const T a[], size_t lda,
+                                  const T b[], size_t ldb,
+                                        T z[], size_t ldz);
+        product0 gemm0;
+
+        // Sparse product, see sparse.h: z = a * x for rows of CSR matrix
+        using sparse = void (*)(size_t rows, const size_t ptr[],
+                                const size_t col[], const T val[],
+                                const T x[], T z0[], T z1[]);
+        sparse spmv;
+
+        // Tridiagonal systems, see tridiag.h: m systems interleaved by ld
+        using tridiag = void (*)(size_t n, size_t m, size_t ld,
+                                 const T a[], const T b[], const T c[],
+                                 const T d[], T x0[], T x1[]);
+        tridiag thomas;
+
+        // Elementary functions, see elementary.h: z = f(x0 + x1), and
+        // z = pow(x0 + x1, y0 + y1)
+        kernel2 exp, expm1, log, log1p;
+        kernel4 pow;
+
+        // Trigonometric functions, see elementary.h: z = f(x0 + x1), and
+        // sincos: s = sin(x0 + x1), c = cos(x0 + x1)
+        kernel2 sin, cos, tan;
+        using kernel2x2 = void (*)(size_t n, const T a[], const T b[],
+                                   T s0[], T s1[], T c0[], T c1[]);
+        kernel2x2 sincos;
+
+        // Inverse and hyperbolic functions, see elementary.h: z = f(x0 + x1),
+        // and z = atan2(y0 + y1, x0 + x1) with y first
+        kernel2 atan, asin, acos, sinh, cosh, tanh;
+        kernel4 atan2;
+
+        // Polynomials, see polyval.h: z = c[0] + c[1] x + ... + c[n - 1]
+        // x^(n - 1) for each of m values of x
+        using polynomial = void (*)(size_t n, const T c[], size_t m,
+                                    const T x[], T z0[], T z1[]);
+        polynomial horner, estrin;
+    };
+
+    struct kernels {
+        kernels_of<float>  f;
+        kernels_of<double> d;
+    };
+
+    // Name of table for ISA, e.g. TFCP_KERNELS(avx2) is kernels_avx2
+    #define TFCP_KERNELS(ISA) TFCP_KERNELS_(ISA)
+    #define TFCP_KERNELS_(ISA) kernels_ ## ISA
+
+    // x86 only
+    const kernels& kernels_sse2();
+    const kernels& kernels_avx();
+    const kernels& kernels_avx2();
+    const kernels& kernels_avx512();
+
+    // Not x86
+    const kernels& kernels_generic();
+
+    // Table for ISA currently selected, see dispatch.h
+    const kernels& current_kernels();
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_KERNELS_H
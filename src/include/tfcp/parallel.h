@@ -0,0 +1,75 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_PARALLEL_H
+#define TFCP_PARALLEL_H
+//======================================================================
+//
+// Run work(c) for each chunk c < chunks by several threads: each of
+// them takes contiguous range of chunks, as many threads as set by
+// set_reduce_threads(), see reduce.h
+//
+// NB: result must not depend on which thread runs which chunk
+//
+// While serial_chunks object lives, for_chunks() called by same thread
+// runs all chunks by this thread: same chunks, so same result; e.g. for
+// solvers that repeat short reductions, see sparse.cpp
+//
+//======================================================================
+
+#include <tfcp/reduce.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace tfcp {
+
+    class serial_chunks {
+    public:
+        explicit serial_chunks(bool serial = true) : saved(flag()) {
+            flag() = saved || serial;
+        }
+        ~serial_chunks() { flag() = saved; }
+        serial_chunks(const serial_chunks&) = delete;
+        serial_chunks& operator = (const serial_chunks&) = delete;
+    public:
+        static bool& flag() {
+            static thread_local bool serial = false;
+            return serial;
+        }
+    private:
+        bool saved;
+    };
+
+    template<typename F>
+    void for_chunks(size_t chunks, F work)
+    {
+        auto range = [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; c++) {
+                work(c);
+            }
+        };
+
+        size_t nt = serial_chunks::flag() ? 1 :
+                    std::min(static_cast<size_t>(reduce_threads()), chunks);
+        if (nt <= 1) {
+            range(0, chunks);
+        } else {
+            std::vector<std::thread> pool;
+            for (size_t t = 1; t < nt; t++) {
+                pool.emplace_back(range, chunks * t / nt, chunks * (t + 1) / nt);
+            }
+            range(0, chunks / nt);
+            for (auto& thread : pool) {
+                thread.join();
+            }
+        }
+    }
+
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_PARALLEL_H
@@ -0,0 +1,136 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TFCP_POLY_H
+#define TFCP_POLY_H
+//======================================================================
+//
+// Polynomials with plain coefficients at plain x, coupled result:
+//
+//   p(x) = c[0] + c[1] x + ... + c[n - 1] x^(n - 1)
+//
+// C++ templates for float and double, and for short vectors of them,
+// with coefficients always scalar, same for all lanes
+//
+// Horner: compensated, after Graillat, Langlois, Louvet (2005), so the
+// rounding errors of each step are kept by exact transforms: pmul0 and
+// padd0; and summed by plain Horner aside, which is cheap as they are
+// small; z0 + z1 is p(x) as if computed with precision eps^2
+//
+// Estrin: coefficients in pairs c[2i] + c[2i + 1] x, then pairs of the
+// pairs by x^2, then by x^4, etc. in coupled arithmetic: the terms of
+// each level are independent, unlike the steps of Horner; blocks of 32
+// coefficients by Estrin, so it needs no scratch memory, then Horner
+// over blocks by x^32 in coupled arithmetic
+//
+// Error of either is about n^2 eps^2 relative to sum of |c[i] x^i|; so
+// relative to p(x), if it is not close to a root
+//
+//======================================================================
+
+#include <tfcp/basic.h>
+#include <tfcp/exact.h>
+#include <tfcp/simd.h>
+
+#include <cstddef>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+    //------------------------------------------------------------------
+    //
+    // Compensated Horner
+    //
+    //------------------------------------------------------------------
+
+    template<typename T, typename S> inline T phorner(size_t n, const S c[], T x, T& z1)
+    {
+        if (n == 0) {
+            z1 = setzerox<T>();
+            return setzerox<T>();
+        }
+        T s = setallx<T>(c[n - 1]);
+        T e = setzerox<T>();
+        for (size_t i = n - 1; i-- > 0;) {
+            T p1, p0 = pmul0(s, x, p1);               // s x exactly
+            T s1;
+            s = padd0(p0, setallx<T>(c[i]), s1);      // s x + c[i] exactly
+            e = e * x + (p1 + s1);                    // errors by plain Horner
+        }
+        // Not fast_renorm(), as e may exceed s near a root
+        return padd0(s, e, z1);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Estrin in coupled arithmetic
+    //
+    //------------------------------------------------------------------
+
+    constexpr size_t estrin_block = 32;
+
+    // Block of n <= 32 coefficients, given x^(2^k) as x0[k] + x1[k]
+    template<typename T, typename S>
+    inline T pestrin_block(size_t n, const S c[], const T x0[], const T x1[], T& z1)
+    {
+        T q0[estrin_block / 2], q1[estrin_block / 2];
+        size_t m = (n + 1) / 2;
+        for (size_t i = 0; i < m; i++) {
+            if (2*i + 1 < n) {
+                T p1, p0 = pmul0(setallx<T>(c[2*i + 1]), x0[0], p1);
+                q0[i] = padd1(p0, p1, setallx<T>(c[2*i]), q1[i]);
+            } else {
+                q0[i] = setallx<T>(c[2*i]);
+                q1[i] = setzerox<T>();
+            }
+        }
+        for (int k = 1; m > 1; k++) {
+            for (size_t i = 0; 2*i + 1 < m; i++) {
+                T h1, h0 = pmul(q0[2*i + 1], q1[2*i + 1], x0[k], x1[k], h1);
+                q0[i] = padd(q0[2*i], q1[2*i], h0, h1, q1[i]);
+            }
+            if (m % 2) {
+                q0[m / 2] = q0[m - 1];
+                q1[m / 2] = q1[m - 1];
+            }
+            m = (m + 1) / 2;
+        }
+        z1 = q1[0];
+        return q0[0];
+    }
+
+    template<typename T, typename S> inline T pestrin(size_t n, const S c[], T x, T& z1)
+    {
+        if (n == 0) {
+            z1 = setzerox<T>();
+            return setzerox<T>();
+        }
+
+        // Powers x^(2^k) as needed, up to x^32
+        T x0[6], x1[6];
+        x0[0] = x;
+        x1[0] = setzerox<T>();
+        for (int k = 1; k < 6 && (size_t(1) << k) < n; k++) {
+            x0[k] = k == 1 ? pmul0(x, x, x1[k])
+                           : pmul(x0[k - 1], x1[k - 1], x0[k - 1], x1[k - 1], x1[k]);
+        }
+
+        // Top block may be partial, then Horner over blocks by x^32
+        size_t b = (n - 1) / estrin_block;
+        T r1, r0 = pestrin_block(n - b * estrin_block, c + b * estrin_block, x0, x1, r1);
+        while (b-- > 0) {
+            T q1, q0 = pestrin_block(estrin_block, c + b * estrin_block, x0, x1, q1);
+            T h1, h0 = pmul(r0, r1, x0[5], x1[5], h1);
+            r0 = padd(q0, q1, h0, h1, r1);
+        }
+        z1 = r1;
+        return r0;
+    }
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
+
+//======================================================================
+#endif // TFCP_POLY_H
@@ -0,0 +1,73 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Batch arithmetic, see <tfcp/batch.h>
+//
+// Forward each call to the kernel for the ISA selected at runtime
+//
+
+#include <tfcp/batch.h>
+#include <tfcp/kernels.h>
+
+namespace tfcp {
+namespace batch {
+
+    template<typename T> const kernels_of<T>& current();
+    template<> const kernels_of<float>&  current() { return current_kernels().f; }
+    template<> const kernels_of<double>& current() { return current_kernels().d; }
+
+#define TFCP_BATCH4(F, T)                                           \
+    void F(size_t n, const T x0[], const T x1[],                    \
+                     const T y0[], const T y1[],                    \
+                           T z0[],       T z1[])                    \
+    {                                                               \
+        current<T>().F(n, x0, x1, y0, y1, z0, z1);                  \
+    }
+#define TFCP_BATCH3(F, T)                                           \
+    void F(size_t n, const T a[], const T b[], const T c[],         \
+                           T z0[],       T z1[])                    \
+    {                                                               \
+        current<T>().F(n, a, b, c, z0, z1);                         \
+    }
+#define TFCP_BATCH2(F, T)                                           \
+    void F(size_t n, const T a[], const T b[],                      \
+                           T z0[],       T z1[])                    \
+    {                                                               \
+        current<T>().F(n, a, b, z0, z1);                            \
+    }
+#define TFCP_BATCH1(F, T)                                           \
+    void F(size_t n, const T x0[],                                  \
+                           T z0[],       T z1[])                    \
+    {                                                               \
+        current<T>().F(n, x0, z0, z1);                              \
+    }
+#define TFCP_BATCH_DOUBLE4(F) TFCP_BATCH4(F, double)
+#define TFCP_BATCH_DOUBLE3(F) TFCP_BATCH3(F, double)
+#define TFCP_BATCH_DOUBLE2(F) TFCP_BATCH2(F, double)
+#define TFCP_BATCH_DOUBLE1(F) TFCP_BATCH1(F, double)
+#define TFCP_BATCH_FLOAT4(F)  TFCP_BATCH4(F, float)
+#define TFCP_BATCH_FLOAT3(F)  TFCP_BATCH3(F, float)
+#define TFCP_BATCH_FLOAT2(F)  TFCP_BATCH2(F, float)
+#define TFCP_BATCH_FLOAT1(F)  TFCP_BATCH1(F, float)
+    TFCP_KERNELS_LIST(TFCP_BATCH_DOUBLE4, TFCP_BATCH_DOUBLE3,
+                      TFCP_BATCH_DOUBLE2, TFCP_BATCH_DOUBLE1)
+    TFCP_KERNELS_LIST(TFCP_BATCH_FLOAT4, TFCP_BATCH_FLOAT3,
+                      TFCP_BATCH_FLOAT2, TFCP_BATCH_FLOAT1)
+#undef TFCP_BATCH_FLOAT1
+#undef TFCP_BATCH_FLOAT2
+#undef TFCP_BATCH_FLOAT3
+#undef TFCP_BATCH_FLOAT4
+#undef TFCP_BATCH_DOUBLE1
+#undef TFCP_BATCH_DOUBLE2
+#undef TFCP_BATCH_DOUBLE3
+#undef TFCP_BATCH_DOUBLE4
+#undef TFCP_BATCH1
+#undef TFCP_BATCH2
+#undef TFCP_BATCH3
+#undef TFCP_BATCH4
+
+} // namespace batch
+} // namespace tfcp
@@ -0,0 +1,200 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Runtime selection of kernels by CPU features, see <tfcp/dispatch.h>
+//
+// NB: compile this file for baseline CPU, as it must run on any CPU
+//
+
+#include <tfcp/dispatch.h>
+#include <tfcp/kernels.h>
+
+#include <atomic>
+#include <initializer_list>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define TFCP_DISPATCH_X86
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace tfcp {
+namespace {
+
+    //------------------------------------------------------------------
+    //
+    // Detect CPU features
+    //
+    //------------------------------------------------------------------
+
+#if !defined(TFCP_DISPATCH_X86)
+
+    isa detect_isa()
+    {
+        return isa::generic;
+    }
+
+#elif defined(__GNUC__)
+
+    isa detect_isa()
+    {
+        __builtin_cpu_init();
+        bool fma = __builtin_cpu_supports("fma");
+        if (fma && __builtin_cpu_supports("avx512f"))
+            return isa::avx512;
+        if (fma && __builtin_cpu_supports("avx2"))
+            return isa::avx2;
+        if (__builtin_cpu_supports("avx"))
+            return isa::avx;
+        return isa::sse2;
+    }
+
+#elif defined(_MSC_VER)
+
+    isa detect_isa()
+    {
+        int info[4];
+        __cpuid(info, 0);
+        int nids = info[0];
+
+        __cpuid(info, 1);
+        bool fma     = (info[2] & (1 << 12)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx     = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx)
+            return isa::sse2;
+
+        // OS must save YMM (and ZMM, opmask) registers
+        unsigned long long xcr0 = _xgetbv(0);
+        if ((xcr0 & 0x06) != 0x06)
+            return isa::sse2;
+        if (!fma || nids < 7)
+            return isa::avx;
+
+        __cpuidex(info, 7, 0);
+        bool avx2    = (info[1] & (1 << 5)) != 0;
+        bool avx512f = (info[1] & (1 << 16)) != 0;
+        if (avx512f && (xcr0 & 0xE6) == 0xE6)
+            return isa::avx512;
+        if (avx2)
+            return isa::avx2;
+        return isa::avx;
+    }
+
+#else
+    #error Unsupported compiler!
+#endif
+
+    //------------------------------------------------------------------
+    //
+    // Selected kernels: initialized when program loads, or lazily if
+    // called from other static initializers before that
+    //
+    //------------------------------------------------------------------
+
+    std::atomic<int> selected(-1);
+
+    const kernels& kernels_for(isa target)
+    {
+    #if defined(TFCP_DISPATCH_X86)
+        switch (target) {
+        case isa::avx512: return kernels_avx512();
+        case isa::avx2:   return kernels_avx2();
+        case isa::avx:    return kernels_avx();
+        default:          return kernels_sse2();
+        }
+    #else
+        return kernels_generic();
+    #endif
+    }
+
+    // If library has kernels for target, and CPU supports them
+    bool supported(isa target)
+    {
+    #if defined(TFCP_DISPATCH_X86)
+        return target != isa::generic && target <= cpu_isa();
+    #else
+        return target == isa::generic;
+    #endif
+    }
+
+    // Best ISA, or TFCP_ISA environment variable if CPU supports it
+    isa default_isa()
+    {
+        isa best = cpu_isa();
+        const char* env = std::getenv("TFCP_ISA");
+        if (env == nullptr)
+            return best;
+        for (isa target : { isa::generic, isa::sse2, isa::avx, isa::avx2, isa::avx512 }) {
+            if (std::strcmp(env, isa_name(target)) == 0 && supported(target))
+                return target;
+        }
+        return best;
+    }
+
+    isa selected_isa()
+    {
+        int s = selected.load(std::memory_order_acquire);
+        if (s < 0) {
+            s = static_cast<int>(default_isa());
+            selected.store(s, std::memory_order_release);
+        }
+        return static_cast<isa>(s);
+    }
+
+    struct initializer {
+        initializer() { selected_isa(); }
+    } init;
+
+} // namespace
+
+    //------------------------------------------------------------------
+    //
+    // Public interface
+    //
+    //------------------------------------------------------------------
+
+    isa cpu_isa()
+    {
+        static const isa best = detect_isa();
+        return best;
+    }
+
+    isa current_isa()
+    {
+        return selected_isa();
+    }
+
+    bool select_isa(isa target)
+    {
+        if (!supported(target))
+            return false;
+        selected.store(static_cast<int>(target), std::memory_order_release);
+        return true;
+    }
+
+    const char* isa_name(isa target)
+    {
+        switch (target) {
+        case isa::generic: return "generic";
+        case isa::sse2:    return "sse2";
+        case isa::avx:     return "avx";
+        case isa::avx2:    return "avx2";
+        case isa::avx512:  return "avx512";
+        }
+        return "unknown";
+    }
+
+    const kernels& current_kernels()
+    {
+        return kernels_for(selected_isa());
+    }
+
+} // namespace tfcp
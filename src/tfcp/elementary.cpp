@@ -0,0 +1,150 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Elementary functions, see <tfcp/elementary.h>
+//
+// Split arrays into chunks of fixed length, compute each chunk by the
+// kernel for the ISA selected at runtime; single x goes by same kernel
+// with n = 1, which computes it by scalars same way as vector lanes
+//
+// NB: compile this file for baseline CPU, same as batch.cpp
+//
+
+#include <tfcp/elementary.h>
+#include <tfcp/kernels.h>
+#include <tfcp/parallel.h>
+
+#include <algorithm>
+
+namespace tfcp {
+namespace {
+
+    // Elements per chunk: functions take tens of nanoseconds each
+    constexpr size_t chunk = 1024;
+
+    template<typename T, typename K, typename... P>
+    void apply(K kernel, size_t n, T z0[], T z1[], const P*... x)
+    {
+        size_t chunks = (n + chunk - 1) / chunk;
+        for_chunks(chunks, [&](size_t c) {
+            size_t i = c * chunk;
+            size_t m = std::min(chunk, n - i);
+            kernel(m, (x + i)..., z0 + i, z1 + i);
+        });
+    }
+
+    template<typename T, typename K>
+    coupled<T> unary(K kernel, const coupled<T>& x)
+    {
+        T z0, z1;
+        kernel(1, &x.value, &x.error, &z0, &z1);
+        return coupled<T>(z0, z1);
+    }
+
+    template<typename T, typename K>
+    coupled<T> binary(K kernel, const coupled<T>& x, const coupled<T>& y)
+    {
+        T z0, z1;
+        kernel(1, &x.value, &x.error, &y.value, &y.error, &z0, &z1);
+        return coupled<T>(z0, z1);
+    }
+
+    template<typename T, typename K>
+    void apply_sincos(K kernel, size_t n, const T x0[], const T x1[],
+                      T s0[], T s1[], T c0[], T c1[])
+    {
+        size_t chunks = (n + chunk - 1) / chunk;
+        for_chunks(chunks, [&](size_t c) {
+            size_t i = c * chunk;
+            size_t m = std::min(chunk, n - i);
+            kernel(m, x0 + i, x1 + i, s0 + i, s1 + i, c0 + i, c1 + i);
+        });
+    }
+
+} // namespace
+
+#define TFCP_ELEMENTARY(T, K)                                                       \
+    coupled<T> exp  (const coupled<T>& x) { return unary(current_kernels().K.exp,   x); } \
+    coupled<T> expm1(const coupled<T>& x) { return unary(current_kernels().K.expm1, x); } \
+    coupled<T> log  (const coupled<T>& x) { return unary(current_kernels().K.log,   x); } \
+    coupled<T> log1p(const coupled<T>& x) { return unary(current_kernels().K.log1p, x); } \
+    coupled<T> pow  (const coupled<T>& x, const coupled<T>& y) {                     \
+        return binary(current_kernels().K.pow, x, y);                               \
+    }                                                                               \
+    void exp  (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.exp, n, z0, z1, x0, x1);                          \
+    }                                                                               \
+    void expm1(size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.expm1, n, z0, z1, x0, x1);                        \
+    }                                                                               \
+    void log  (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.log, n, z0, z1, x0, x1);                          \
+    }                                                                               \
+    void log1p(size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.log1p, n, z0, z1, x0, x1);                        \
+    }                                                                               \
+    void pow  (size_t n, const T x0[], const T x1[],                                \
+                         const T y0[], const T y1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.pow, n, z0, z1, x0, x1, y0, y1);                  \
+    }                                                                               \
+    coupled<T> sin  (const coupled<T>& x) { return unary(current_kernels().K.sin,   x); } \
+    coupled<T> cos  (const coupled<T>& x) { return unary(current_kernels().K.cos,   x); } \
+    coupled<T> tan  (const coupled<T>& x) { return unary(current_kernels().K.tan,   x); } \
+    void sincos(const coupled<T>& x, coupled<T>& s, coupled<T>& c) {                \
+        T s0, s1, c0, c1;                                                           \
+        current_kernels().K.sincos(1, &x.value, &x.error, &s0, &s1, &c0, &c1);      \
+        s = coupled<T>(s0, s1);                                                     \
+        c = coupled<T>(c0, c1);                                                     \
+    }                                                                               \
+    void sin  (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.sin, n, z0, z1, x0, x1);                          \
+    }                                                                               \
+    void cos  (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.cos, n, z0, z1, x0, x1);                          \
+    }                                                                               \
+    void tan  (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.tan, n, z0, z1, x0, x1);                          \
+    }                                                                               \
+    void sincos(size_t n, const T x0[], const T x1[],                               \
+                T s0[], T s1[], T c0[], T c1[]) {                                   \
+        apply_sincos(current_kernels().K.sincos, n, x0, x1, s0, s1, c0, c1);        \
+    }                                                                               \
+    coupled<T> atan (const coupled<T>& x) { return unary(current_kernels().K.atan,  x); } \
+    coupled<T> asin (const coupled<T>& x) { return unary(current_kernels().K.asin,  x); } \
+    coupled<T> acos (const coupled<T>& x) { return unary(current_kernels().K.acos,  x); } \
+    coupled<T> sinh (const coupled<T>& x) { return unary(current_kernels().K.sinh,  x); } \
+    coupled<T> cosh (const coupled<T>& x) { return unary(current_kernels().K.cosh,  x); } \
+    coupled<T> tanh (const coupled<T>& x) { return unary(current_kernels().K.tanh,  x); } \
+    coupled<T> atan2(const coupled<T>& y, const coupled<T>& x) {                     \
+        return binary(current_kernels().K.atan2, y, x);                             \
+    }                                                                               \
+    void atan (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.atan, n, z0, z1, x0, x1);                         \
+    }                                                                               \
+    void asin (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.asin, n, z0, z1, x0, x1);                         \
+    }                                                                               \
+    void acos (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.acos, n, z0, z1, x0, x1);                         \
+    }                                                                               \
+    void sinh (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.sinh, n, z0, z1, x0, x1);                         \
+    }                                                                               \
+    void cosh (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.cosh, n, z0, z1, x0, x1);                         \
+    }                                                                               \
+    void tanh (size_t n, const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.tanh, n, z0, z1, x0, x1);                         \
+    }                                                                               \
+    void atan2(size_t n, const T y0[], const T y1[],                                \
+                         const T x0[], const T x1[], T z0[], T z1[]) {              \
+        apply(current_kernels().K.atan2, n, z0, z1, y0, y1, x0, x1);                \
+    }
+    TFCP_ELEMENTARY(double, d)
+    TFCP_ELEMENTARY(float, f)
+#undef TFCP_ELEMENTARY
+
+} // namespace tfcp
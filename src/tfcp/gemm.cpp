@@ -0,0 +1,183 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Coupled matrix product, see <tfcp/gemm.h>
+//
+// Split rows of c into stripes, and compute each stripe by kernel for
+// the ISA selected at runtime: each thread packs its own panels of b,
+// which costs about k*n versus m*n*k/threads operations of the product
+//
+// Ozaki scheme for gemm_accurate(): split a by rows, and b by columns,
+// into slices of few bits, so that plain products of slices are exact;
+// then add these products into coupled c by padd, lower slices first
+//
+// NB: compile this file for baseline CPU, same as batch.cpp
+//
+
+#include <tfcp/gemm.h>
+#include <tfcp/kernels.h>
+#include <tfcp/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace tfcp {
+namespace {
+
+    // Least rows per stripe, so that packing b pays off
+    constexpr size_t stripe = 64;
+
+    template<typename T, typename K>
+    void product(K kernel, size_t m, size_t n, size_t k,
+                 const T a0[], const T a1[], size_t lda,
+                 const T b0[], const T b1[], size_t ldb,
+                       T c0[],       T c1[], size_t ldc)
+    {
+        size_t stripes = std::min((m + stripe - 1) / stripe,
+                                  static_cast<size_t>(reduce_threads()));
+        for_chunks(stripes, [&](size_t s) {
+            size_t first = m * s / stripes;
+            size_t last = m * (s + 1) / stripes;
+            kernel(last - first, n, k, &a0[first*lda], &a1[first*lda], lda,
+                                       b0, b1, ldb,
+                                       &c0[first*ldc], &c1[first*ldc], ldc);
+        });
+    }
+
+    // Bits per slice, so that sum of k products of slices is exact:
+    // each product takes 2*rho bits, and sum takes log2(k) more
+    int slice_bits(size_t k)
+    {
+        int log2k = 0;
+        while ((size_t(1) << log2k) < k)
+            log2k++;
+        return (std::numeric_limits<double>::digits - log2k) / 2;
+    }
+
+    // Slices to take: enough for twice the double precision
+    size_t slice_levels(int rho)
+    {
+        return (2 * std::numeric_limits<double>::digits + rho - 1) / rho;
+    }
+
+    // Split rows x cols matrix x into at most levels slices s[l], each
+    // dense rows x cols, and return the number of slices: scale by max of
+    // each row if by_rows, else by max of each column
+    //
+    // If 2^(tau - 1) <= max|x| < 2^tau for row or column, then its slice
+    // l is multiple of u = 2^(tau - rho*(l + 1)), and is less than 2^rho
+    // * u by value: (x + S) - S rounds x to multiple of u if S = 1.5 *
+    // 2^52 * u
+    size_t split(size_t rows, size_t cols, const double x[], size_t ldx,
+                 bool by_rows, int rho, size_t levels, std::vector<double>& s)
+    {
+        size_t size = rows * cols;
+        s.resize(levels * size);
+
+        std::vector<double> r(size);
+        std::vector<double> mu(by_rows ? rows : cols, 0.0);
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                double& m = mu[by_rows ? i : j];
+                r[i*cols + j] = x[i*ldx + j];
+                m = std::max(m, std::fabs(r[i*cols + j]));
+            }
+        }
+
+        std::vector<int> tau(mu.size());
+        for (size_t v = 0; v < mu.size(); v++) {
+            std::frexp(mu[v], &tau[v]);  // mu < 2^tau
+        }
+
+        std::vector<double> shift(mu.size());
+        size_t l = 0;
+        for (bool nonzero = true; nonzero && l < levels; l++) {
+            for (size_t v = 0; v < mu.size(); v++) {
+                shift[v] = std::ldexp(1.5, tau[v] - rho * int(l + 1) + 52);
+            }
+            nonzero = false;
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < cols; j++) {
+                    double sh = shift[by_rows ? i : j];
+                    double q = (r[i*cols + j] + sh) - sh;
+                    r[i*cols + j] = r[i*cols + j] - q;
+                    s[l*size + i*cols + j] = q;
+                    nonzero = nonzero || r[i*cols + j] != 0;
+                }
+            }
+        }
+        return l;
+    }
+
+} // namespace
+
+    void gemm(size_t m, size_t n, size_t k,
+              const double a0[], const double a1[], size_t lda,
+              const double b0[], const double b1[], size_t ldb,
+                    double c0[],       double c1[], size_t ldc)
+    {
+        product(current_kernels().d.gemm, m, n, k, a0, a1, lda, b0, b1, ldb, c0, c1, ldc);
+    }
+
+    void gemm(size_t m, size_t n, size_t k,
+              const float  a0[], const float  a1[], size_t lda,
+              const float  b0[], const float  b1[], size_t ldb,
+                    float  c0[],       float  c1[], size_t ldc)
+    {
+        product(current_kernels().f.gemm, m, n, k, a0, a1, lda, b0, b1, ldb, c0, c1, ldc);
+    }
+
+    void gemm_accurate(size_t m, size_t n, size_t k,
+                       const double a[], size_t lda,
+                       const double b[], size_t ldb,
+                             double c0[],   double c1[], size_t ldc)
+    {
+        const auto& kernels = current_kernels().d;
+
+        int rho = slice_bits(k);
+        size_t levels = slice_levels(rho);
+
+        // Slices of b by columns, dense k x n: shared by all stripes
+        std::vector<double> sb;
+        size_t nb = split(k, n, b, ldb, false, rho, levels, sb);
+
+        size_t stripes = std::min((m + stripe - 1) / stripe,
+                                  static_cast<size_t>(reduce_threads()));
+        for_chunks(stripes, [&](size_t s) {
+            size_t first = m * s / stripes;
+            size_t rows = m * (s + 1) / stripes - first;
+
+            std::vector<double> sa;
+            size_t na = split(rows, k, &a[first*lda], lda, true, rho, levels, sa);
+
+            double* z0 = &c0[first*ldc];
+            double* z1 = &c1[first*ldc];
+            for (size_t i = 0; i < rows; i++) {
+                std::fill(&z0[i*ldc], &z0[i*ldc] + n, 0.0);
+                std::fill(&z1[i*ldc], &z1[i*ldc] + n, 0.0);
+            }
+
+            // Products by levels, from lower to upper: each is exact
+            std::vector<double> t(rows * n);
+            for (size_t level = levels; level-- > 0;) {
+                for (size_t i = 0; i < na && i <= level; i++) {
+                    size_t j = level - i;
+                    if (j >= nb)
+                        continue;
+                    kernels.gemm0(rows, n, k, &sa[i*rows*k], k,
+                                              &sb[j*n*k], n, t.data(), n);
+                    for (size_t r = 0; r < rows; r++) {
+                        kernels.padd1(n, &z0[r*ldc], &z1[r*ldc], &t[r*n],
+                                         &z0[r*ldc], &z1[r*ldc]);
+                    }
+                }
+            }
+        });
+    }
+
+} // namespace tfcp
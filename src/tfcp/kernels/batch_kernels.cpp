@@ -0,0 +1,199 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Batch kernels: strip-mined loops over the basic.h templates
+//
+// This file is compiled once per each ISA (see src/tfcp/CMakeLists.txt)
+// so the inline namespace TFCP_SIMD_ISA keeps the copies apart, and the
+// table of kernels gets name like kernels_avx2()
+//
+
+#include <tfcp/simd.h>
+#include <tfcp/basic.h>
+#include <tfcp/kernels.h>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+
+    // See reduce_kernels.cpp
+    template<typename T> void reduce_sum2(size_t n, const T a[], T& z0, T& z1);
+    template<typename T> void reduce_dot2(size_t n, const T a[], const T b[],
+                                          T& z0, T& z1);
+    template<typename T> void reduce_rsum(size_t n, const T a[], binned& z);
+
+    // See gemm_kernels.cpp
+    template<typename T> void gemm_blocked(size_t m, size_t n, size_t k,
+                                           const T a0[], const T a1[], size_t lda,
+                                           const T b0[], const T b1[], size_t ldb,
+                                                 T z0[],       T z1[], size_t ldz);
+    template<typename T> void gemm_plain(size_t m, size_t n, size_t k,
+                                         const T a[], size_t lda,
+                                         const T b[], size_t ldb,
+                                               T z[], size_t ldz);
+
+    // See sparse_kernels.cpp
+    template<typename T> void sparse_spmv(size_t rows, const size_t ptr[],
+                                          const size_t col[], const T val[],
+                                          const T x[], T z0[], T z1[]);
+
+    // See tridiag_kernels.cpp
+    template<typename T> void tridiag_thomas(size_t n, size_t m, size_t ld,
+                                             const T a[], const T b[], const T c[],
+                                             const T d[], T x0[], T x1[]);
+
+    // See poly_kernels.cpp
+    template<typename T> void poly_horner(size_t n, const T c[], size_t m,
+                                          const T x[], T z0[], T z1[]);
+    template<typename T> void poly_estrin(size_t n, const T c[], size_t m,
+                                          const T x[], T z0[], T z1[]);
+
+    // See elementary_kernels.cpp
+    template<typename T> void elementary_exp(size_t n, const T x0[], const T x1[],
+                                             T z0[], T z1[]);
+    template<typename T> void elementary_expm1(size_t n, const T x0[], const T x1[],
+                                               T z0[], T z1[]);
+    template<typename T> void elementary_log(size_t n, const T x0[], const T x1[],
+                                             T z0[], T z1[]);
+    template<typename T> void elementary_log1p(size_t n, const T x0[], const T x1[],
+                                               T z0[], T z1[]);
+    template<typename T> void elementary_pow(size_t n, const T x0[], const T x1[],
+                                             const T y0[], const T y1[], T z0[], T z1[]);
+    template<typename T> void elementary_sin(size_t n, const T x0[], const T x1[],
+                                             T z0[], T z1[]);
+    template<typename T> void elementary_cos(size_t n, const T x0[], const T x1[],
+                                             T z0[], T z1[]);
+    template<typename T> void elementary_tan(size_t n, const T x0[], const T x1[],
+                                             T z0[], T z1[]);
+    template<typename T> void elementary_sincos(size_t n, const T x0[], const T x1[],
+                                                T s0[], T s1[], T c0[], T c1[]);
+    template<typename T> void elementary_atan(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[]);
+    template<typename T> void elementary_asin(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[]);
+    template<typename T> void elementary_acos(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[]);
+    template<typename T> void elementary_sinh(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[]);
+    template<typename T> void elementary_cosh(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[]);
+    template<typename T> void elementary_tanh(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[]);
+    template<typename T> void elementary_atan2(size_t n, const T y0[], const T y1[],
+                                               const T x0[], const T x1[], T z0[], T z1[]);
+
+namespace {
+
+    //------------------------------------------------------------------
+    //
+    // Main loop over short vectors, then the tail by masked load/store
+    //
+    // Tail computes same operation over short vector, so its result is
+    // exactly same as if we compute by scalars
+    //
+    //------------------------------------------------------------------
+
+    template<typename T, typename F, typename... P>
+    inline void apply(F f, size_t n, T z0[], T z1[], const P*... x)
+    {
+        using TX = typename traitx<T>::vector;
+        constexpr size_t lenx = traitx<TX>::length;
+        size_t i = 0;
+        for (; i + lenx <= n; i += lenx) {
+            TX r0, r1;
+            r0 = f(loadx<TX>(&x[i])..., r1);
+            storex(&z0[i], r0);
+            storex(&z1[i], r1);
+        }
+        if (i < n) {
+            int m = static_cast<int>(n - i);
+            TX r0, r1;
+            r0 = f(loadx<TX>(&x[i], m)..., r1);
+            storex(&z0[i], r0, m);
+            storex(&z1[i], r1, m);
+        }
+    }
+
+#define TFCP_KERNEL4(F)                                                       \
+    template<typename T>                                                      \
+    void batch_ ## F(size_t n, const T a[], const T b[],                      \
+                               const T c[], const T d[], T z0[], T z1[])      \
+    {                                                                         \
+        apply([](auto a, auto b, auto c, auto d, auto& z1) {                  \
+                  return F(a, b, c, d, z1); }, n, z0, z1, a, b, c, d);        \
+    }
+#define TFCP_KERNEL3(F)                                                       \
+    template<typename T>                                                      \
+    void batch_ ## F(size_t n, const T a[], const T b[],                      \
+                               const T c[], T z0[], T z1[])                   \
+    {                                                                         \
+        apply([](auto a, auto b, auto c, auto& z1) {                          \
+                  return F(a, b, c, z1); }, n, z0, z1, a, b, c);              \
+    }
+#define TFCP_KERNEL2(F)                                                       \
+    template<typename T>                                                      \
+    void batch_ ## F(size_t n, const T a[], const T b[], T z0[], T z1[])      \
+    {                                                                         \
+        apply([](auto a, auto b, auto& z1) {                                  \
+                  return F(a, b, z1); }, n, z0, z1, a, b);                    \
+    }
+#define TFCP_KERNEL1(F)                                                       \
+    template<typename T>                                                      \
+    void batch_ ## F(size_t n, const T a[], T z0[], T z1[])                   \
+    {                                                                         \
+        apply([](auto a, auto& z1) {                                          \
+                  return F(a, z1); }, n, z0, z1, a);                          \
+    }
+    TFCP_KERNELS_LIST(TFCP_KERNEL4, TFCP_KERNEL3, TFCP_KERNEL2, TFCP_KERNEL1)
+#undef TFCP_KERNEL1
+#undef TFCP_KERNEL2
+#undef TFCP_KERNEL3
+#undef TFCP_KERNEL4
+
+    template<typename T> kernels_of<T> make_kernels()
+    {
+        kernels_of<T> k;
+    #define TFCP_SET(F) k.F = batch_ ## F<T>;
+        TFCP_KERNELS_LIST(TFCP_SET, TFCP_SET, TFCP_SET, TFCP_SET)
+    #undef TFCP_SET
+        k.sum2 = reduce_sum2<T>;
+        k.dot2 = reduce_dot2<T>;
+        k.rsum = reduce_rsum<T>;
+        k.gemm = gemm_blocked<T>;
+        k.gemm0 = gemm_plain<T>;
+        k.spmv = sparse_spmv<T>;
+        k.thomas = tridiag_thomas<T>;
+        k.horner = poly_horner<T>;
+        k.estrin = poly_estrin<T>;
+        k.exp = elementary_exp<T>;
+        k.expm1 = elementary_expm1<T>;
+        k.log = elementary_log<T>;
+        k.log1p = elementary_log1p<T>;
+        k.pow = elementary_pow<T>;
+        k.sin = elementary_sin<T>;
+        k.cos = elementary_cos<T>;
+        k.tan = elementary_tan<T>;
+        k.sincos = elementary_sincos<T>;
+        k.atan = elementary_atan<T>;
+        k.atan2 = elementary_atan2<T>;
+        k.asin = elementary_asin<T>;
+        k.acos = elementary_acos<T>;
+        k.sinh = elementary_sinh<T>;
+        k.cosh = elementary_cosh<T>;
+        k.tanh = elementary_tanh<T>;
+        return k;
+    }
+
+} // namespace
+} // namespace TFCP_SIMD_ISA
+
+    const kernels& TFCP_KERNELS(TFCP_SIMD_ISA)()
+    {
+        static const kernels k = { make_kernels<float>(),
+                                   make_kernels<double>() };
+        return k;
+    }
+
+} // namespace tfcp
@@ -0,0 +1,556 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Elementary function kernels: loops over short vectors by templates
+// of explog.h and trig.h, see elementary.h
+//
+// Same as batch_kernels.cpp, this file is compiled once per each ISA
+//
+// Templates compute all lanes at once, but only for the reduced range
+// of arguments; so then check each lane, and recompute lanes out of the
+// range by scalar code with branches: like Inf, NaN, or overflow
+//
+// Check before store, as z may be same array as x
+//
+
+#include <tfcp/simd.h>
+#include <tfcp/basic.h>
+#include <tfcp/explog.h>
+#include <tfcp/trig.h>
+
+#include <cmath>
+#include <limits>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+namespace {
+
+    //------------------------------------------------------------------
+    //
+    // Ranges by base type, see explog.h
+    //
+    //------------------------------------------------------------------
+
+    template<typename T> struct range {};
+
+    template<> struct range<double> {
+        static constexpr double expm1 = 708;     // so 2^k is normal
+        static constexpr double exp_hi = 709.78;  // exp overflows above
+        static constexpr double exp_lo = -745.13; // exp underflows below
+        static constexpr double hyper = 680;     // so expm1 * 2^27 is finite
+        static constexpr double tanh = 340;      // so 2x within hyper
+        static constexpr double tiny = 1e-140;   // f(x) = x below
+    };
+
+    template<> struct range<float> {
+        static constexpr float expm1 = 87;
+        static constexpr float exp_hi = 88.72f;
+        static constexpr float exp_lo = -103.27f;
+        static constexpr float hyper = 78;
+        static constexpr float tanh = 39;
+        static constexpr float tiny = 1e-15f;
+    };
+
+    // Range of plog()
+    template<typename T> bool log_fits(T x0)
+    {
+        return x0 >= std::numeric_limits<T>::min() &&
+               x0 <= std::numeric_limits<T>::max() / 2;
+    }
+
+    // Within range of psinh() and ptanh(): zero, or not tiny
+    template<typename T> bool hyper_fits(T x0, T hi)
+    {
+        T a = std::fabs(x0);
+        return (a >= range<T>::tiny && a <= hi) || x0 == 0;
+    }
+
+    // sinh(|x|) and cosh(|x|) beyond range of psinh() and pcosh(): as
+    // e * (e / 2) for e = exp(|x| / 2), which does not overflow before
+    // the result does, while exp(-|x|) is below eps^2
+    template<typename T> T hyper_large(T a0, T a1, T& z1)
+    {
+        z1 = 0;
+        if (a0 / 2 > range<T>::exp_hi)
+            return std::numeric_limits<T>::infinity();
+        T e1, e0 = pexp(a0 / 2, a1 / 2, e1);
+        T z0 = pmul(e0, e1, e0 / 2, e1 / 2, z1);
+        if (std::isfinite(z0))
+            return z0;
+        z1 = 0;
+        return std::numeric_limits<T>::infinity();
+    }
+
+    // Result is normal, and not near subnormal, so z1 makes sense
+    template<typename T> bool result_fits(T z0)
+    {
+        using L = std::numeric_limits<T>;
+        T z = std::fabs(z0);
+        return z >= L::min() / L::epsilon() && z <= L::max();
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Functions: core for short vectors, check for scalars, and special
+    // cases by scalars
+    //
+    //------------------------------------------------------------------
+
+    template<typename T> struct exp_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return pexp(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T z0) {
+            return std::fabs(x0) <= range<T>::hyper && result_fits(z0);
+        }
+        // NB: if result is below min/eps, z1 is subnormal, so its error
+        // is about denorm_min absolute, not few eps^2 relative
+        static T special(T x0, T x1, T& z1) {
+            if (x0 >= range<T>::exp_lo && x0 <= range<T>::exp_hi)
+                return pexp(x0, x1, z1);
+            z1 = 0;
+            return std::exp(x0);
+        }
+    };
+
+    template<typename T> struct expm1_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return pexpm1(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return std::fabs(x0) <= range<T>::hyper;
+        }
+        // NB: if x is large, 1 is less than error of exp(x)
+        static T special(T x0, T x1, T& z1) {
+            if (x0 > 0)
+                return exp_op<T>::special(x0, x1, z1);
+            if (x0 < 0) {
+                z1 = std::exp(x0);
+                return -1;
+            }
+            z1 = 0;
+            return x0;  // NaN
+        }
+    };
+
+    template<typename T> struct log_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return plog(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return log_fits(x0);
+        }
+        // If subnormal or huge: log(x) = log(x / 2^e) + e ln2
+        static T special(T x0, T x1, T& z1) {
+            if (x0 > 0 && x0 <= std::numeric_limits<T>::max()) {
+                int e;
+                T m0 = std::frexp(x0, &e);
+                T m1 = std::ldexp(x1, -e);
+                T l1, l0 = plog(m0, m1, l1);
+                T g1, g0 = explog_ln2(static_cast<T>(e), g1);
+                return padd(g0, g1, l0, l1, z1);
+            }
+            z1 = 0;
+            return std::log(x0);
+        }
+    };
+
+    template<typename T> struct log1p_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return plog1p(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return x0 > -1 && x0 <= std::numeric_limits<T>::max() / 4;
+        }
+        // NB: if x is huge, 1 is less than error of x
+        static T special(T x0, T x1, T& z1) {
+            if (x0 > 0)
+                return log_op<T>::special(x0, x1, z1);
+            z1 = 0;
+            return std::log1p(x0);
+        }
+    };
+
+    template<typename T> struct pow_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX y0, TX y1, TX& z1) {
+            return ppow(x0, x1, y0, y1, z1);
+        }
+        static bool fits(T x0, T, T y0, T, T z0) {
+            return log_fits(x0) && std::fabs(y0) <= std::numeric_limits<T>::max() &&
+                   result_fits(z0);
+        }
+        static T special(T x0, T, T y0, T, T& z1) {
+            z1 = 0;
+            return std::pow(x0, y0);
+        }
+    };
+
+    template<typename T> struct sin_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return psin(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return ptrig_fits(x0);
+        }
+        static T special(T x0, T x1, T& z1) {
+            T c0, c1;
+            return ptrig_special(x0, x1, z1, c0, c1);
+        }
+    };
+
+    template<typename T> struct cos_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return pcos(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return ptrig_fits(x0);
+        }
+        static T special(T x0, T x1, T& z1) {
+            T s1, c0;
+            ptrig_special(x0, x1, s1, c0, z1);
+            return c0;
+        }
+    };
+
+    template<typename T> struct tan_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return ptan(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return ptrig_fits(x0);
+        }
+        static T special(T x0, T x1, T& z1) {
+            T s1, c0, c1, s0 = ptrig_special(x0, x1, s1, c0, c1);
+            if (!std::isfinite(x0)) {
+                z1 = 0;
+                return s0;  // NaN
+            }
+            return pdiv(s0, s1, c0, c1, z1);
+        }
+    };
+
+    template<typename T> struct atan_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return patan(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return patan2_fits(x0);
+        }
+        static T special(T x0, T x1, T& z1) {
+            return patan2_special(x0, x1, T(1), T(0), z1);
+        }
+    };
+
+    template<typename T> struct atan2_op {
+        template<typename TX> static TX core(TX y0, TX y1, TX x0, TX x1, TX& z1) {
+            return patan2(y0, y1, x0, x1, z1);
+        }
+        static bool fits(T y0, T, T x0, T, T) {
+            return patan2_fits(y0) && patan2_fits(x0) && (y0 != 0 || x0 != 0);
+        }
+        static T special(T y0, T y1, T x0, T x1, T& z1) {
+            return patan2_special(y0, y1, x0, x1, z1);
+        }
+    };
+
+    template<typename T> struct asin_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return pasin(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return std::fabs(x0) < 1 && patan2_fits(x0);
+        }
+        static T special(T x0, T x1, T& z1) {
+            return pasin_special(false, x0, x1, z1);
+        }
+    };
+
+    template<typename T> struct acos_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return pacos(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return std::fabs(x0) < 1 && patan2_fits(x0);
+        }
+        static T special(T x0, T x1, T& z1) {
+            return pasin_special(true, x0, x1, z1);
+        }
+    };
+
+    template<typename T> struct sinh_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return psinh(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return hyper_fits(x0, range<T>::hyper);
+        }
+        static T special(T x0, T x1, T& z1) {
+            if (std::fabs(x0) < range<T>::tiny) {
+                z1 = x1;
+                return x0;
+            }
+            if (std::isfinite(x0)) {
+                T sign, a1, a0 = phyper_abs(x0, x1, a1, sign);
+                T z0 = hyper_large(a0, a1, z1);
+                z1 *= sign;
+                return z0 * sign;
+            }
+            z1 = 0;
+            return std::sinh(x0);
+        }
+    };
+
+    template<typename T> struct cosh_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return pcosh(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return std::fabs(x0) <= range<T>::hyper;
+        }
+        static T special(T x0, T x1, T& z1) {
+            if (std::isfinite(x0)) {
+                T sign, a1, a0 = phyper_abs(x0, x1, a1, sign);
+                return hyper_large(a0, a1, z1);
+            }
+            z1 = 0;
+            return std::cosh(x0);
+        }
+    };
+
+    template<typename T> struct tanh_op {
+        template<typename TX> static TX core(TX x0, TX x1, TX& z1) {
+            return ptanh(x0, x1, z1);
+        }
+        static bool fits(T x0, T, T) {
+            return hyper_fits(x0, range<T>::tanh);
+        }
+        // If x is large: tanh(x) = 1 - 2 exp(-2|x|) within eps^2
+        static T special(T x0, T x1, T& z1) {
+            if (std::fabs(x0) < range<T>::tiny) {
+                z1 = x1;
+                return x0;
+            }
+            if (std::isfinite(x0)) {
+                T sign = x0 > 0 ? 1 : -1;
+                z1 = -2 * sign * std::exp(-2 * std::fabs(x0));
+                return sign;
+            }
+            z1 = 0;
+            return std::tanh(x0);
+        }
+    };
+
+    //------------------------------------------------------------------
+    //
+    // Loop over short vectors, with tail by scalars: as masked vector
+    // would cost same as full, which matters for single x
+    //
+    // Scalars go by same templates and same operations as vector lanes,
+    // so result is the same as if computed by vector
+    //
+    //------------------------------------------------------------------
+
+    template<typename Op, typename T, typename... P>
+    void apply(size_t n, T z0[], T z1[], const P*... x)
+    {
+        using TX = typename traitx<T>::vector;
+        constexpr int lenx = traitx<TX>::length;
+        size_t i = 0;
+        for (; i + lenx <= n; i += lenx) {
+            TX r1, r0 = Op::core(loadx<TX>(&x[i])..., r1);
+
+            bool fit = true;
+            for (int l = 0; l < lenx; l++) {
+                fit &= Op::fits(x[i + l]..., getx(r0, l));
+            }
+            if (!fit) {
+                for (int l = 0; l < lenx; l++) {
+                    if (!Op::fits(x[i + l]..., getx(r0, l))) {
+                        getx(r0, l) = Op::special(x[i + l]..., getx(r1, l));
+                    }
+                }
+            }
+
+            storex(&z0[i], r0);
+            storex(&z1[i], r1);
+        }
+        for (; i < n; i++) {
+            T r1, r0 = Op::core(x[i]..., r1);
+            if (!Op::fits(x[i]..., r0)) {
+                r0 = Op::special(x[i]..., r1);
+            }
+            z0[i] = r0;
+            z1[i] = r1;
+        }
+    }
+
+    // Same for sine and cosine at once
+    template<typename T>
+    void apply_sincos(size_t n, const T x0[], const T x1[],
+                      T s0[], T s1[], T c0[], T c1[])
+    {
+        using TX = typename traitx<T>::vector;
+        constexpr int lenx = traitx<TX>::length;
+        size_t i = 0;
+        for (; i + lenx <= n; i += lenx) {
+            TX t1, d0, d1, t0 = psincos(loadx<TX>(&x0[i]), loadx<TX>(&x1[i]), t1, d0, d1);
+
+            bool fit = true;
+            for (int l = 0; l < lenx; l++) {
+                fit &= ptrig_fits(x0[i + l]);
+            }
+            if (!fit) {
+                for (int l = 0; l < lenx; l++) {
+                    if (!ptrig_fits(x0[i + l])) {
+                        getx(t0, l) = ptrig_special(x0[i + l], x1[i + l], getx(t1, l),
+                                                    getx(d0, l), getx(d1, l));
+                    }
+                }
+            }
+
+            storex(&s0[i], t0);
+            storex(&s1[i], t1);
+            storex(&c0[i], d0);
+            storex(&c1[i], d1);
+        }
+        for (; i < n; i++) {
+            T t1, d0, d1, t0;
+            if (ptrig_fits(x0[i])) {
+                t0 = psincos(x0[i], x1[i], t1, d0, d1);
+            } else {
+                t0 = ptrig_special(x0[i], x1[i], t1, d0, d1);
+            }
+            s0[i] = t0;
+            s1[i] = t1;
+            c0[i] = d0;
+            c1[i] = d1;
+        }
+    }
+
+} // namespace
+
+    template<typename T> void elementary_exp(size_t n, const T x0[], const T x1[],
+                                             T z0[], T z1[])
+    {
+        apply<exp_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_expm1(size_t n, const T x0[], const T x1[],
+                                               T z0[], T z1[])
+    {
+        apply<expm1_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_log(size_t n, const T x0[], const T x1[],
+                                             T z0[], T z1[])
+    {
+        apply<log_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_log1p(size_t n, const T x0[], const T x1[],
+                                               T z0[], T z1[])
+    {
+        apply<log1p_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_pow(size_t n, const T x0[], const T x1[],
+                                             const T y0[], const T y1[], T z0[], T z1[])
+    {
+        apply<pow_op<T>>(n, z0, z1, x0, x1, y0, y1);
+    }
+
+    template<typename T> void elementary_sin(size_t n, const T x0[], const T x1[],
+                                             T z0[], T z1[])
+    {
+        apply<sin_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_cos(size_t n, const T x0[], const T x1[],
+                                             T z0[], T z1[])
+    {
+        apply<cos_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_tan(size_t n, const T x0[], const T x1[],
+                                             T z0[], T z1[])
+    {
+        apply<tan_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_sincos(size_t n, const T x0[], const T x1[],
+                                                T s0[], T s1[], T c0[], T c1[])
+    {
+        apply_sincos(n, x0, x1, s0, s1, c0, c1);
+    }
+
+    template<typename T> void elementary_atan(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[])
+    {
+        apply<atan_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_asin(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[])
+    {
+        apply<asin_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_acos(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[])
+    {
+        apply<acos_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_sinh(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[])
+    {
+        apply<sinh_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_cosh(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[])
+    {
+        apply<cosh_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_tanh(size_t n, const T x0[], const T x1[],
+                                              T z0[], T z1[])
+    {
+        apply<tanh_op<T>>(n, z0, z1, x0, x1);
+    }
+
+    template<typename T> void elementary_atan2(size_t n, const T y0[], const T y1[],
+                                               const T x0[], const T x1[], T z0[], T z1[])
+    {
+        apply<atan2_op<T>>(n, z0, z1, y0, y1, x0, x1);
+    }
+
+#define TFCP_ELEMENTARY(T)                                                            \
+    template void elementary_exp  (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_expm1(size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_log  (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_log1p(size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_pow  (size_t n, const T x0[], const T x1[],                  \
+                                   const T y0[], const T y1[], T z0[], T z1[]);           \
+    template void elementary_sin  (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_cos  (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_tan  (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_sincos(size_t n, const T x0[], const T x1[],                 \
+                                    T s0[], T s1[], T c0[], T c1[]);                      \
+    template void elementary_atan (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_asin (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_acos (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_sinh (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_cosh (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_tanh (size_t n, const T x0[], const T x1[], T z0[], T z1[]); \
+    template void elementary_atan2(size_t n, const T y0[], const T y1[],                  \
+                                   const T x0[], const T x1[], T z0[], T z1[]);
+    TFCP_ELEMENTARY(float)
+    TFCP_ELEMENTARY(double)
+#undef TFCP_ELEMENTARY
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
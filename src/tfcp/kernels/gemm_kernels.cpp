@@ -0,0 +1,296 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Matrix product kernels: z = a * b by coupled pmul and padd, and the
+// plain z = a * b for the Ozaki scheme, see gemm.h
+//
+// Same as batch_kernels.cpp, this file is compiled once per each ISA
+//
+// Blocking like GotoBLAS: for each KC x NC panel of b, pack it so that
+// every NR columns go contiguously by rows; then for each MC x KC block
+// of a, pack it so that every MR rows go by columns; then microkernel
+// updates MR x NR tile of z by KC steps of rank-1 update in registers
+//
+// Values and errors go in separate packed planes, so microkernel loads
+// them as vectors directly; tiles at edges are padded with zeros
+//
+// Each element of z gets same sequence of operations as by the scalar
+// loop like z += a[i][p] * b[p][j] for p = 0, 1, ..., k - 1, with z = 0
+// initially: so result does not depend on blocking, nor on threads
+//
+
+#include <tfcp/simd.h>
+#include <tfcp/basic.h>
+
+#include <vector>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+namespace {
+
+    // Cache blocks: MC x KC block of a for L2, and KC x NC panel of b;
+    // KC x NR panel of b for L1 is defined by tile
+    constexpr size_t MC = 96;  // multiple of MR
+    constexpr size_t NC = 512;
+
+    // Coupled register tile: MR rows by NV vectors
+    struct coupled_tile {
+        static constexpr size_t MR = 4;
+        static constexpr size_t NV = 2;
+        static constexpr size_t KC = 128;
+        static constexpr size_t planes = 2;
+
+        // Tile t += a panel * b panel, where t is MR x NR by rows of ldt
+        template<typename T>
+        static void micro(size_t kc, const T* const a[], const T* const b[],
+                                           T* const t[], size_t ldt)
+        {
+            using TX = typename traitx<T>::vector;
+            constexpr size_t lenx = traitx<TX>::length;
+            constexpr size_t NR = NV * lenx;
+
+            TX z0[MR][NV], z1[MR][NV];
+            for (size_t i = 0; i < MR; i++) {
+                for (size_t v = 0; v < NV; v++) {
+                    z0[i][v] = loadx<TX>(&t[0][i*ldt + v*lenx]);
+                    z1[i][v] = loadx<TX>(&t[1][i*ldt + v*lenx]);
+                }
+            }
+
+            for (size_t p = 0; p < kc; p++) {
+                TX y0[NV], y1[NV];
+                for (size_t v = 0; v < NV; v++) {
+                    y0[v] = loadx<TX>(&b[0][p*NR + v*lenx]);
+                    y1[v] = loadx<TX>(&b[1][p*NR + v*lenx]);
+                }
+                for (size_t i = 0; i < MR; i++) {
+                    TX x0 = setallx<TX>(a[0][p*MR + i]);
+                    TX x1 = setallx<TX>(a[1][p*MR + i]);
+                    for (size_t v = 0; v < NV; v++) {
+                        TX w0, w1;
+                        w0 = pmul(x0, x1, y0[v], y1[v], w1);
+                        z0[i][v] = padd(z0[i][v], z1[i][v], w0, w1, z1[i][v]);
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < MR; i++) {
+                for (size_t v = 0; v < NV; v++) {
+                    storex(&t[0][i*ldt + v*lenx], z0[i][v]);
+                    storex(&t[1][i*ldt + v*lenx], z1[i][v]);
+                }
+            }
+        }
+    };
+
+    // Plain register tile: larger, as takes one register per element
+    // NB: by FMA if hardware has it, so rounding depends on ISA
+    struct plain_tile {
+    #if defined(TFCP_SIMD_AVX512)
+        static constexpr size_t MR = 8;  // 24 of 32 registers
+        static constexpr size_t NV = 3;
+    #else
+        static constexpr size_t MR = 6;  // 12 of 16 registers
+        static constexpr size_t NV = 2;
+    #endif
+        static constexpr size_t KC = 256;
+        static constexpr size_t planes = 1;
+
+        template<typename T>
+        static void micro(size_t kc, const T* const a[], const T* const b[],
+                                           T* const t[], size_t ldt)
+        {
+            using TX = typename traitx<T>::vector;
+            constexpr size_t lenx = traitx<TX>::length;
+            constexpr size_t NR = NV * lenx;
+
+            // With FMA, keep z = -t, so that fnmadd adds products
+        #if defined(TFCP_SIMD_FMA)
+            const TX sign = setallx<TX>(T(-1));
+        #else
+            const TX sign = setallx<TX>(T(1));
+        #endif
+
+            TX z[MR][NV];
+            for (size_t i = 0; i < MR; i++) {
+                for (size_t v = 0; v < NV; v++) {
+                    z[i][v] = sign * loadx<TX>(&t[0][i*ldt + v*lenx]);
+                }
+            }
+
+            for (size_t p = 0; p < kc; p++) {
+                TX y[NV];
+                for (size_t v = 0; v < NV; v++) {
+                    y[v] = loadx<TX>(&b[0][p*NR + v*lenx]);
+                }
+                for (size_t i = 0; i < MR; i++) {
+                    TX x = setallx<TX>(a[0][p*MR + i]);
+                    for (size_t v = 0; v < NV; v++) {
+                    #if defined(TFCP_SIMD_FMA)
+                        z[i][v] = fnmadd(x, y[v], z[i][v]);
+                    #else
+                        z[i][v] = z[i][v] + x * y[v];
+                    #endif
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < MR; i++) {
+                for (size_t v = 0; v < NV; v++) {
+                    storex(&t[0][i*ldt + v*lenx], sign * z[i][v]);
+                }
+            }
+        }
+    };
+
+    // Pack mc x kc block of a: by MR rows, each by columns
+    template<size_t MR, typename T>
+    void pack_a(size_t mc, size_t kc, const T a[], size_t lda, T p[])
+    {
+        for (size_t ir = 0; ir < mc; ir += MR) {
+            for (size_t q = 0; q < kc; q++) {
+                for (size_t i = 0; i < MR; i++) {
+                    *p++ = ir + i < mc ? a[(ir + i)*lda + q] : 0;
+                }
+            }
+        }
+    }
+
+    // Pack kc x nc panel of b: by NR columns, each by rows
+    template<size_t NR, typename T>
+    void pack_b(size_t kc, size_t nc, const T b[], size_t ldb, T p[])
+    {
+        for (size_t jr = 0; jr < nc; jr += NR) {
+            for (size_t q = 0; q < kc; q++) {
+                for (size_t j = 0; j < NR; j++) {
+                    *p++ = jr + j < nc ? b[q*ldb + jr + j] : 0;
+                }
+            }
+        }
+    }
+
+    // Blocked z = a * b for Tile, each matrix by its planes
+    template<typename Tile, typename T>
+    void blocked(size_t m, size_t n, size_t k,
+                 const T* const a[], size_t lda,
+                 const T* const b[], size_t ldb,
+                       T* const z[], size_t ldz)
+    {
+        using TX = typename traitx<T>::vector;
+        constexpr size_t MR = Tile::MR;
+        constexpr size_t NR = Tile::NV * traitx<TX>::length;
+        constexpr size_t P = Tile::planes;
+
+        for (size_t l = 0; l < P; l++) {
+            for (size_t i = 0; i < m; i++) {
+                for (size_t j = 0; j < n; j++) {
+                    z[l][i*ldz + j] = 0;
+                }
+            }
+        }
+
+        // NB: MC must be multiple of MR, so block of a has no padding
+        constexpr size_t KC = Tile::KC;
+        static_assert(MC % MR == 0, "a block must fit register tiles");
+        std::vector<T> pa(P * MC * KC), pb(P * (NC + NR) * KC);
+        T t[P][MR * NR];
+
+        for (size_t jc = 0; jc < n; jc += NC) {
+            size_t nc = n - jc < NC ? n - jc : NC;
+            for (size_t pc = 0; pc < k; pc += KC) {
+                size_t kc = k - pc < KC ? k - pc : KC;
+                for (size_t l = 0; l < P; l++) {
+                    pack_b<NR>(kc, nc, &b[l][pc*ldb + jc], ldb, &pb[l * (NC + NR) * KC]);
+                }
+                for (size_t ic = 0; ic < m; ic += MC) {
+                    size_t mc = m - ic < MC ? m - ic : MC;
+                    for (size_t l = 0; l < P; l++) {
+                        pack_a<MR>(mc, kc, &a[l][ic*lda + pc], lda, &pa[l * MC * KC]);
+                    }
+                    for (size_t jr = 0; jr < nc; jr += NR) {
+                        size_t nr = nc - jr < NR ? nc - jr : NR;
+                        for (size_t ir = 0; ir < mc; ir += MR) {
+                            size_t mr = mc - ir < MR ? mc - ir : MR;
+                            const T* ap[P];
+                            const T* bp[P];
+                            T* c[P];
+                            for (size_t l = 0; l < P; l++) {
+                                ap[l] = &pa[l * MC * KC + ir*kc];
+                                bp[l] = &pb[l * (NC + NR) * KC + jr*kc];
+                                c[l] = &z[l][(ic + ir)*ldz + jc + jr];
+                            }
+
+                            // Full tile in place, or edge tile by copy
+                            if (mr == MR && nr == NR) {
+                                Tile::micro(kc, ap, bp, c, ldz);
+                                continue;
+                            }
+                            T* tp[P];
+                            for (size_t l = 0; l < P; l++) {
+                                tp[l] = t[l];
+                                for (size_t i = 0; i < MR; i++) {
+                                    for (size_t j = 0; j < NR; j++) {
+                                        bool in = i < mr && j < nr;
+                                        t[l][i*NR + j] = in ? c[l][i*ldz + j] : 0;
+                                    }
+                                }
+                            }
+                            Tile::micro(kc, ap, bp, tp, NR);
+                            for (size_t l = 0; l < P; l++) {
+                                for (size_t i = 0; i < mr; i++) {
+                                    for (size_t j = 0; j < nr; j++) {
+                                        c[l][i*ldz + j] = t[l][i*NR + j];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+} // namespace
+
+    template<typename T> void gemm_blocked(size_t m, size_t n, size_t k,
+                                           const T a0[], const T a1[], size_t lda,
+                                           const T b0[], const T b1[], size_t ldb,
+                                                 T z0[],       T z1[], size_t ldz)
+    {
+        const T* const a[] = { a0, a1 };
+        const T* const b[] = { b0, b1 };
+        T* const z[] = { z0, z1 };
+        blocked<coupled_tile>(m, n, k, a, lda, b, ldb, z, ldz);
+    }
+
+    template<typename T> void gemm_plain(size_t m, size_t n, size_t k,
+                                         const T a[], size_t lda,
+                                         const T b[], size_t ldb,
+                                               T z[], size_t ldz)
+    {
+        blocked<plain_tile>(m, n, k, &a, lda, &b, ldb, &z, ldz);
+    }
+
+    template void gemm_blocked(size_t m, size_t n, size_t k,
+                               const float  a0[], const float  a1[], size_t lda,
+                               const float  b0[], const float  b1[], size_t ldb,
+                                     float  z0[],       float  z1[], size_t ldz);
+    template void gemm_blocked(size_t m, size_t n, size_t k,
+                               const double a0[], const double a1[], size_t lda,
+                               const double b0[], const double b1[], size_t ldb,
+                                     double z0[],       double z1[], size_t ldz);
+
+    template void gemm_plain(size_t m, size_t n, size_t k,
+                             const float  a[], size_t lda,
+                             const float  b[], size_t ldb,
+                                   float  z[], size_t ldz);
+    template void gemm_plain(size_t m, size_t n, size_t k,
+                             const double a[], size_t lda,
+                             const double b[], size_t ldb,
+                                   double z[], size_t ldz);
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
@@ -0,0 +1,66 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Polynomial kernels: loops over short vectors of x by templates of
+// poly.h, see polyval.h
+//
+// Same as batch_kernels.cpp, this file is compiled once per each ISA
+//
+// Each vector lane takes its own x, with same coefficients; tail goes
+// by scalars with same operations, so result does not depend on the
+// position of x in array. Load x before store, as z0 may be same as x
+//
+
+#include <tfcp/simd.h>
+#include <tfcp/poly.h>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+namespace {
+
+    template<typename T, typename F>
+    void apply(size_t m, const T x[], T z0[], T z1[], F f)
+    {
+        using TX = typename traitx<T>::vector;
+        constexpr size_t lenx = traitx<TX>::length;
+        size_t i = 0;
+        for (; i + lenx <= m; i += lenx) {
+            TX r1, r0 = f(loadx<TX>(&x[i]), r1);
+            storex(&z0[i], r0);
+            storex(&z1[i], r1);
+        }
+        for (; i < m; i++) {
+            T r1, r0 = f(x[i], r1);
+            z0[i] = r0;
+            z1[i] = r1;
+        }
+    }
+
+} // namespace
+
+    template<typename T> void poly_horner(size_t n, const T c[], size_t m,
+                                          const T x[], T z0[], T z1[])
+    {
+        apply(m, x, z0, z1, [=](auto t, auto& r1) { return phorner(n, c, t, r1); });
+    }
+
+    template<typename T> void poly_estrin(size_t n, const T c[], size_t m,
+                                          const T x[], T z0[], T z1[])
+    {
+        apply(m, x, z0, z1, [=](auto t, auto& r1) { return pestrin(n, c, t, r1); });
+    }
+
+    template void poly_horner(size_t n, const float  c[], size_t m,
+                              const float  x[], float  z0[], float  z1[]);
+    template void poly_horner(size_t n, const double c[], size_t m,
+                              const double x[], double z0[], double z1[]);
+    template void poly_estrin(size_t n, const float  c[], size_t m,
+                              const float  x[], float  z0[], float  z1[]);
+    template void poly_estrin(size_t n, const double c[], size_t m,
+                              const double x[], double z0[], double z1[]);
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
@@ -0,0 +1,249 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Reduction kernels: Sum2 and Dot2 by Ogita, Rump, and Oishi
+//
+// Same as batch_kernels.cpp, this file is compiled once per each ISA
+//
+// To make result same for any ISA, we accumulate by virtual lanes: the
+// element i goes into the lane i % lanes, where number of lanes does
+// not depend on the vector length; so AVX-512 takes 4 accumulators of
+// doublex for 32 lanes, AVX2 takes 8 accumulators, etc. Additionally,
+// several accumulators hide latency of the dependent additions
+//
+// Then we add lanes in their order by coupled padd, which is exact up
+// to the final renormalization
+//
+// Binned reproducible sum (see binned.h) slices blocks of elements by
+// vectors of doubles: it does not need virtual lanes, as it adds only
+// exact slices, in any order
+//
+
+#include <tfcp/simd.h>
+#include <tfcp/basic.h>
+#include <tfcp/binned.h>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+namespace {
+
+    // Number of virtual lanes: 256 bytes, like 32 doubles
+    template<typename T> constexpr size_t lanes() { return 256 / sizeof(T); }
+
+    // Sum2 step: p + s += x, where p + s is unevaluated sum
+    template<typename T> inline void sum2_step(T& p, T& s, T x)
+    {
+        T q;
+        p = padd0(p, x, q);  // p + x = p' + q exactly
+        s = s + q;
+    }
+
+    // Dot2 step: p + s += x*y
+    template<typename T> inline void dot2_step(T& p, T& s, T x, T y)
+    {
+        T h, r, q;
+        h = pmul0(x, y, r);  // x*y = h + r exactly
+        p = padd0(p, h, q);  // p + h = p' + q exactly
+        s = s + (q + r);
+    }
+
+    // Run step over n elements of arrays x..., return z0 + z1
+    template<typename T, typename F, typename... P>
+    inline void reduce(F step, size_t n, T& z0, T& z1, const P*... x)
+    {
+        using TX = typename traitx<T>::vector;
+        constexpr size_t lenx = traitx<TX>::length;
+        constexpr size_t m = lanes<T>() / lenx;
+        static_assert(lanes<T>() % lenx == 0, "vector must fit lanes");
+
+        TX p[m], s[m];
+        for (size_t j = 0; j < m; j++) {
+            p[j] = setzerox<TX>();
+            s[j] = setzerox<TX>();
+        }
+
+        size_t i = 0;
+        for (; i + lanes<T>() <= n; i += lanes<T>()) {
+            for (size_t j = 0; j < m; j++) {
+                step(p[j], s[j], loadx<TX>(&x[i + j*lenx])...);
+            }
+        }
+
+        // Tail: masked lanes add zeros, so same as if we skip them
+        for (size_t j = 0; j < m && i + j*lenx < n; j++) {
+            size_t k = i + j*lenx;
+            int t = static_cast<int>(n - k < lenx ? n - k : lenx);
+            step(p[j], s[j], loadx<TX>(&x[k], t)...);
+        }
+
+        // Add lanes in order
+        T pl[lanes<T>()], sl[lanes<T>()];
+        for (size_t j = 0; j < m; j++) {
+            storex(&pl[j*lenx], p[j]);
+            storex(&sl[j*lenx], s[j]);
+        }
+        T r0 = 0, r1 = 0;
+        for (size_t l = 0; l < lanes<T>(); l++) {
+            T u0, u1;
+            u0 = renormalize(pl[l], sl[l], u1);
+            r0 = padd(r0, r1, u0, u1, r1);
+        }
+
+        z0 = r0;
+        z1 = r1;
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Binned sum: see binned.h
+    //
+    //------------------------------------------------------------------
+
+    // Elements per block: no more than binned::slices per accumulator
+    constexpr size_t block = binned::slices;
+
+    // Add block of n <= block elements into z
+    inline void rsum_block(size_t n, const double x[], binned& z)
+    {
+        using TX = doublex;
+        constexpr size_t lenx = traitx<TX>::length;
+
+        // Max |x|, and x - x which is NaN if x is Inf or NaN
+        TX m = setzerox<TX>(), e = setzerox<TX>();
+        size_t i = 0;
+        for (; i + lenx <= n; i += lenx) {
+            TX v = loadx<TX>(&x[i]);
+            m = maxx(m, absx(v));
+            e = e + (v - v);
+        }
+        if (i < n) {
+            TX v = loadx<TX>(&x[i], static_cast<int>(n - i));
+            m = maxx(m, absx(v));
+            e = e + (v - v);
+        }
+
+        double mm = 0, ee = 0;
+        for (size_t l = 0; l < lenx; l++) {
+            mm = maxx(mm, getx(m, l));
+            ee = ee + getx(e, l);
+        }
+
+        // Rare case: add Inf and NaN separately, and slice the others
+        double y[block];
+        if (ee != 0) {
+            mm = 0;
+            for (size_t k = 0; k < n; k++) {
+                double v = x[k];
+                if (v - v != 0) {
+                    z.special = z.special + v;
+                    y[k] = 0;
+                } else {
+                    y[k] = v;
+                    mm = maxx(mm, absx(v));
+                }
+            }
+            x = y;
+        }
+
+        if (mm == 0)
+            return;
+
+        int b = binned_bin(mm);
+        binned_raise(z, b);
+
+        // Slice x into bins b, b - 1, b - 2
+        static_assert(binned::K == 3, "unroll for K bins");
+        TX s0 = setallx<TX>(binned_shift(b));
+        TX s1 = setallx<TX>(binned_shift(b - 1));
+        TX s2 = setallx<TX>(binned_shift(b - 2));
+        TX a0 = setzerox<TX>(), a1 = setzerox<TX>(), a2 = setzerox<TX>();
+
+        auto slice = [&](TX v) {
+            TX q;
+            q = (v + s0) - s0; v = v - q; a0 = a0 + q;
+            q = (v + s1) - s1; v = v - q; a1 = a1 + q;
+            q = (v + s2) - s2;            a2 = a2 + q;
+        };
+
+        for (i = 0; i + lenx <= n; i += lenx) {
+            slice(loadx<TX>(&x[i]));
+        }
+        if (i < n) {
+            slice(loadx<TX>(&x[i], static_cast<int>(n - i)));
+        }
+
+        // Sum of lanes is exact: at most binned::slices slices in total
+        double r0 = 0, r1 = 0, r2 = 0;
+        for (size_t l = 0; l < lenx; l++) {
+            r0 = r0 + getx(a0, l);
+            r1 = r1 + getx(a1, l);
+            r2 = r2 + getx(a2, l);
+        }
+        binned_add(z, b, r0);
+        binned_add(z, b - 1, r1);
+        binned_add(z, b - 2, r2);
+    }
+
+    inline void rsum(size_t n, const double a[], binned& z)
+    {
+        for (size_t i = 0; i < n; i += block) {
+            rsum_block(n - i < block ? n - i : block, &a[i], z);
+        }
+    }
+
+    // NB: float converts to double exactly; loop of constant length for
+    // full blocks, so that compiler vectorizes conversion
+    inline void rsum(size_t n, const float a[], binned& z)
+    {
+        double x[block];
+        size_t i = 0;
+        for (; i + block <= n; i += block) {
+            for (size_t k = 0; k < block; k++) {
+                x[k] = a[i + k];
+            }
+            rsum_block(block, x, z);
+        }
+        if (i < n) {
+            for (size_t k = 0; k < n - i; k++) {
+                x[k] = a[i + k];
+            }
+            rsum_block(n - i, x, z);
+        }
+    }
+
+} // namespace
+
+    template<typename T> void reduce_sum2(size_t n, const T a[], T& z0, T& z1)
+    {
+        reduce([](auto& p, auto& s, auto x) { sum2_step(p, s, x); },
+               n, z0, z1, a);
+    }
+
+    template<typename T> void reduce_dot2(size_t n, const T a[], const T b[],
+                                          T& z0, T& z1)
+    {
+        reduce([](auto& p, auto& s, auto x, auto y) { dot2_step(p, s, x, y); },
+               n, z0, z1, a, b);
+    }
+
+    template<typename T> void reduce_rsum(size_t n, const T a[], binned& z)
+    {
+        rsum(n, a, z);
+    }
+
+    template void reduce_sum2(size_t n, const float  a[], float&  z0, float&  z1);
+    template void reduce_sum2(size_t n, const double a[], double& z0, double& z1);
+
+    template void reduce_dot2(size_t n, const float  a[], const float  b[],
+                              float&  z0, float&  z1);
+    template void reduce_dot2(size_t n, const double a[], const double b[],
+                              double& z0, double& z1);
+
+    template void reduce_rsum(size_t n, const float  a[], binned& z);
+    template void reduce_rsum(size_t n, const double a[], binned& z);
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
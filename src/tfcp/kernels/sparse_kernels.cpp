@@ -0,0 +1,62 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Sparse kernels: y = a * x by rows of CSR matrix, see sparse.h
+//
+// Same as batch_kernels.cpp, this file is compiled once per each ISA
+//
+// Each row goes by scalar Dot2 steps like dot2_step() of reduce_kernels
+// .cpp, as gathering x into vectors costs more than it saves; but two
+// Dot2 chains interleave over even and odd nonzeros, which hides the
+// latency of the exact transforms. These are exact, with or without
+// FMA, so result is same for any ISA
+//
+
+#include <tfcp/simd.h>
+#include <tfcp/exact.h>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+namespace {
+
+    template<typename T> inline void dot2_step(T& p, T& s, T x, T y)
+    {
+        T h, r, q;
+        h = pmul0(x, y, r);
+        p = padd0(p, h, q);
+        s = s + (q + r);
+    }
+
+} // namespace
+
+    template<typename T> void sparse_spmv(size_t rows, const size_t ptr[],
+                                          const size_t col[], const T val[],
+                                          const T x[], T z0[], T z1[])
+    {
+        for (size_t i = 0; i < rows; i++) {
+            T p0 = 0, s0 = 0, p1 = 0, s1 = 0;
+            size_t k = ptr[i], end = ptr[i + 1];
+            for (; k + 2 <= end; k += 2) {
+                dot2_step(p0, s0, val[k], x[col[k]]);
+                dot2_step(p1, s1, val[k + 1], x[col[k + 1]]);
+            }
+            if (k < end) {
+                dot2_step(p0, s0, val[k], x[col[k]]);
+            }
+            T q, p = padd0(p0, p1, q);
+            z0[i] = renormalize(p, (s0 + s1) + q, z1[i]);
+        }
+    }
+
+    template void sparse_spmv(size_t rows, const size_t ptr[],
+                              const size_t col[], const float  val[],
+                              const float  x[], float  z0[], float  z1[]);
+    template void sparse_spmv(size_t rows, const size_t ptr[],
+                              const size_t col[], const double val[],
+                              const double x[], double z0[], double z1[]);
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
@@ -0,0 +1,121 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Tridiagonal kernel: Thomas algorithm over batch of systems, each in
+// its own vector lane, see tridiag.h
+//
+// Same as batch_kernels.cpp, this file is compiled once per each ISA
+//
+// Forward sweep keeps c'[i] = c[i] / m[i] in scratch, and d'[i] in x,
+// where m[i] = b[i] - a[i] c'[i - 1] is the pivot; then back sweep is
+// x[i] = d'[i] - c'[i] x[i + 1], in place. Both sweeps go by rows over
+// all systems given, each row by vectors; last vector of systems goes
+// by masked loads and stores
+//
+
+#include <tfcp/simd.h>
+#include <tfcp/basic.h>
+
+#include <vector>
+
+namespace tfcp {
+inline namespace TFCP_SIMD_ISA {
+namespace {
+
+    template<typename TX, typename T>
+    inline TX load(const T* p, int t)
+    {
+        return t < static_cast<int>(traitx<TX>::length) ? loadx<TX>(p, t) : loadx<TX>(p);
+    }
+
+    template<typename T, typename TX>
+    inline void store(T* p, TX x, int t)
+    {
+        if (t < static_cast<int>(traitx<TX>::length))
+            storex(p, x, t);
+        else
+            storex(p, x);
+    }
+
+} // namespace
+
+    // Systems s < m, each of n equations, interleaved by ld
+    template<typename T> void tridiag_thomas(size_t n, size_t m, size_t ld,
+                                             const T a[], const T b[], const T c[],
+                                             const T d[], T x0[], T x1[])
+    {
+        using TX = typename traitx<T>::vector;
+        constexpr size_t lenx = traitx<TX>::length;
+
+        if (n == 0)
+            return;
+
+        // Scratch c' by rows of m, rounded up to vectors
+        size_t ldc = (m + lenx - 1) / lenx * lenx;
+        std::vector<T> cp(2 * n * ldc);
+        T* cp0 = cp.data();
+        T* cp1 = cp.data() + n * ldc;
+
+        // Forward sweep, row by row over all systems: so that loads go
+        // by contiguous m elements, rather than by stride of ld
+        for (size_t i = 0; i < n; i++) {
+            for (size_t s = 0; s < m; s += lenx) {
+                int t = static_cast<int>(m - s < lenx ? m - s : lenx);
+                size_t k = i*ld + s;
+                size_t j = i*ldc + s;
+                TX u0, u1, v0, v1;
+                if (i == 0) {
+                    // c'[0] = c[0] / b[0], d'[0] = d[0] / b[0]
+                    TX b0 = load<TX>(&b[k], t);
+                    u0 = pdiv0(load<TX>(&c[k], t), b0, u1);
+                    v0 = pdiv0(load<TX>(&d[k], t), b0, v1);
+                } else {
+                    TX ai = load<TX>(&a[k], t);
+                    TX w0, w1, m0, m1;
+                    u0 = loadx<TX>(&cp0[j - ldc]);
+                    u1 = loadx<TX>(&cp1[j - ldc]);
+                    v0 = load<TX>(&x0[k - ld], t);
+                    v1 = load<TX>(&x1[k - ld], t);
+                    w0 = pmul2(ai, u0, u1, w1);                    // a c'[i - 1]
+                    m0 = psub2(load<TX>(&b[k], t), w0, w1, m1);    // pivot
+                    u0 = pdiv2(load<TX>(&c[k], t), m0, m1, u1);    // c'[i]
+                    w0 = pmul2(ai, v0, v1, w1);                    // a d'[i - 1]
+                    w0 = psub2(load<TX>(&d[k], t), w0, w1, w1);
+                    v0 = pdiv(w0, w1, m0, m1, v1);                 // d'[i]
+                }
+                storex(&cp0[j], u0);
+                storex(&cp1[j], u1);
+                store(&x0[k], v0, t);
+                store(&x1[k], v1, t);
+            }
+        }
+
+        // Back sweep: x[i] = d'[i] - c'[i] x[i + 1]
+        for (size_t i = n - 1; i-- > 0;) {
+            for (size_t s = 0; s < m; s += lenx) {
+                int t = static_cast<int>(m - s < lenx ? m - s : lenx);
+                size_t k = i*ld + s;
+                size_t j = i*ldc + s;
+                TX w0, w1, v0, v1;
+                v0 = load<TX>(&x0[k + ld], t);
+                v1 = load<TX>(&x1[k + ld], t);
+                w0 = pmul(loadx<TX>(&cp0[j]), loadx<TX>(&cp1[j]), v0, v1, w1);
+                v0 = psub(load<TX>(&x0[k], t), load<TX>(&x1[k], t), w0, w1, v1);
+                store(&x0[k], v0, t);
+                store(&x1[k], v1, t);
+            }
+        }
+    }
+
+    template void tridiag_thomas(size_t n, size_t m, size_t ld,
+                                 const float  a[], const float  b[], const float  c[],
+                                 const float  d[], float  x0[], float  x1[]);
+    template void tridiag_thomas(size_t n, size_t m, size_t ld,
+                                 const double a[], const double b[], const double c[],
+                                 const double d[], double x0[], double x1[]);
+
+} // namespace TFCP_SIMD_ISA
+} // namespace tfcp
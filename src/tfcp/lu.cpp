@@ -0,0 +1,183 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// LU and iterative refinement, see <tfcp/lu.h>
+//
+// Blocked right-looking LU like LAPACK's dgetrf: factor panel of NB
+// columns by rows operations, solve for NB rows of U to the right, and
+// update trailing matrix by the plain gemm kernel (gemm_kernels.cpp),
+// with rows split into stripes between threads
+//
+// NB: compile this file for baseline CPU, same as batch.cpp
+//
+
+#include <tfcp/lu.h>
+#include <tfcp/batch.h>
+#include <tfcp/kernels.h>
+#include <tfcp/parallel.h>
+#include <tfcp/reduce.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace tfcp {
+namespace {
+
+    // Panel width
+    constexpr size_t NB = 64;
+
+    // Least rows per stripe of trailing update
+    constexpr size_t stripe = 64;
+
+    // Columns per step of trailing update: so product of stripe goes
+    // into scratch of stripe rows by NC, not of whole trailing matrix
+    constexpr size_t NC = 512;
+
+    // Max norm
+    double norm(size_t n, const double x[])
+    {
+        double s = 0;
+        for (size_t i = 0; i < n; i++)
+            s = std::max(s, std::fabs(x[i]));
+        return s;
+    }
+
+} // namespace
+
+    bool lu_factor(size_t n, double a[], size_t lda, size_t piv[])
+    {
+        const auto& kernels = current_kernels().d;
+
+        for (size_t j0 = 0; j0 < n; j0 += NB) {
+            size_t jb = std::min(NB, n - j0);
+            size_t j1 = j0 + jb;
+
+            // Panel: columns j0..j1, with row swaps across whole rows
+            for (size_t j = j0; j < j1; j++) {
+                size_t p = j;
+                for (size_t i = j + 1; i < n; i++) {
+                    if (std::fabs(a[i*lda + j]) > std::fabs(a[p*lda + j]))
+                        p = i;
+                }
+                piv[j] = p;
+                if (a[p*lda + j] == 0)
+                    return false;
+                if (p != j) {
+                    std::swap_ranges(&a[j*lda], &a[j*lda] + n, &a[p*lda]);
+                }
+                for (size_t i = j + 1; i < n; i++) {
+                    double l = a[i*lda + j] = a[i*lda + j] / a[j*lda + j];
+                    for (size_t c = j + 1; c < j1; c++) {
+                        a[i*lda + c] = a[i*lda + c] - l * a[j*lda + c];
+                    }
+                }
+            }
+
+            if (j1 == n)
+                break;
+
+            // Rows j0..j1 of U to the right: L11 * U12 = A12
+            for (size_t j = j0; j < j1; j++) {
+                for (size_t i = j + 1; i < j1; i++) {
+                    double l = a[i*lda + j];
+                    for (size_t c = j1; c < n; c++) {
+                        a[i*lda + c] = a[i*lda + c] - l * a[j*lda + c];
+                    }
+                }
+            }
+
+            // Trailing: A22 -= L21 * U12
+            size_t m = n - j1;
+            size_t stripes = std::min((m + stripe - 1) / stripe,
+                                      static_cast<size_t>(reduce_threads()));
+            for_chunks(stripes, [&](size_t s) {
+                size_t first = m * s / stripes;
+                size_t last = m * (s + 1) / stripes;
+                size_t rows = last - first;
+                size_t ldt = std::min(m, NC);
+                std::vector<double> t(rows * ldt);
+                for (size_t c0 = 0; c0 < m; c0 += NC) {
+                    size_t nc = std::min(NC, m - c0);
+                    kernels.gemm0(rows, nc, jb, &a[(j1 + first)*lda + j0], lda,
+                                                &a[j0*lda + j1 + c0], lda,
+                                                t.data(), ldt);
+                    for (size_t i = 0; i < rows; i++) {
+                        double* r = &a[(j1 + first + i)*lda + j1 + c0];
+                        for (size_t c = 0; c < nc; c++) {
+                            r[c] = r[c] - t[i*ldt + c];
+                        }
+                    }
+                }
+            });
+        }
+        return true;
+    }
+
+    void lu_solve(size_t n, const double lu[], size_t lda, const size_t piv[],
+                  double x[])
+    {
+        for (size_t j = 0; j < n; j++) {
+            std::swap(x[j], x[piv[j]]);
+        }
+        for (size_t i = 0; i < n; i++) {
+            double s = x[i];
+            for (size_t j = 0; j < i; j++)
+                s = s - lu[i*lda + j] * x[j];
+            x[i] = s;
+        }
+        for (size_t i = n; i-- > 0;) {
+            double s = x[i];
+            for (size_t j = i + 1; j < n; j++)
+                s = s - lu[i*lda + j] * x[j];
+            x[i] = s / lu[i*lda + i];
+        }
+    }
+
+    int solve_refined(size_t n, const double a[], size_t lda, const double b[],
+                      double x0[], double x1[], int max_steps)
+    {
+        const double eps = std::numeric_limits<double>::epsilon();
+
+        std::vector<double> lu(n * n);
+        std::vector<size_t> piv(n);
+        for (size_t i = 0; i < n; i++) {
+            std::copy(&a[i*lda], &a[i*lda] + n, &lu[i*n]);
+        }
+        if (!lu_factor(n, lu.data(), n, piv.data()))
+            return -1;
+
+        std::copy(b, b + n, x0);
+        std::fill(x1, x1 + n, 0.0);
+        lu_solve(n, lu.data(), n, piv.data(), x0);
+
+        std::vector<double> d(n);
+        double last = std::numeric_limits<double>::infinity();
+        for (int step = 1; step <= max_steps; step++) {
+            // d = b - a * x, rounded to double
+            for (size_t i = 0; i < n; i++) {
+                coupled<double> r(b[i], 0);
+                r -= dot2(n, &a[i*lda], x0);
+                r -= dot2(n, &a[i*lda], x1);
+                d[i] = r.value;
+            }
+            lu_solve(n, lu.data(), n, piv.data(), d.data());
+            batch::padd1(n, x0, x1, d.data(), x0, x1);
+
+            double dnorm = norm(n, d.data());
+            double xnorm = norm(n, x0);
+            if (dnorm <= eps * eps * xnorm)
+                return step;
+            if (dnorm > last / 2)
+                return dnorm <= eps * xnorm ? step : -1;
+            last = dnorm;
+        }
+        return -1;
+    }
+
+} // namespace tfcp
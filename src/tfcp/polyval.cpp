@@ -0,0 +1,67 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Polynomials, see <tfcp/polyval.h>
+//
+// Split values of x into chunks of fixed length, compute each chunk by
+// the kernel for the ISA selected at runtime; single x goes by same
+// kernel with m = 1
+//
+// NB: compile this file for baseline CPU, same as batch.cpp
+//
+
+#include <tfcp/polyval.h>
+#include <tfcp/kernels.h>
+#include <tfcp/parallel.h>
+
+#include <algorithm>
+
+namespace tfcp {
+namespace {
+
+    // Values per chunk: multiple of any vector length
+    constexpr size_t chunk = 1024;
+
+    template<typename T, typename K>
+    void apply(K kernel, size_t n, const T c[], size_t m, const T x[], T z0[], T z1[])
+    {
+        size_t chunks = (m + chunk - 1) / chunk;
+        for_chunks(chunks, [&](size_t k) {
+            size_t i = k * chunk;
+            size_t l = std::min(chunk, m - i);
+            kernel(n, c, l, x + i, z0 + i, z1 + i);
+        });
+    }
+
+    template<typename T, typename K>
+    coupled<T> single(K kernel, size_t n, const T c[], T x)
+    {
+        T z0, z1;
+        kernel(n, c, 1, &x, &z0, &z1);
+        return coupled<T>(z0, z1);
+    }
+
+} // namespace
+
+#define TFCP_POLYVAL(T, K)                                                          \
+    coupled<T> polyval(size_t n, const T c[], T x) {                                \
+        return single(current_kernels().K.horner, n, c, x);                         \
+    }                                                                               \
+    coupled<T> polyval_estrin(size_t n, const T c[], T x) {                         \
+        return single(current_kernels().K.estrin, n, c, x);                         \
+    }                                                                               \
+    void polyval(size_t n, const T c[], size_t m, const T x[], T z0[], T z1[]) {    \
+        apply(current_kernels().K.horner, n, c, m, x, z0, z1);                      \
+    }                                                                               \
+    void polyval_estrin(size_t n, const T c[], size_t m, const T x[],               \
+                        T z0[], T z1[]) {                                           \
+        apply(current_kernels().K.estrin, n, c, m, x, z0, z1);                      \
+    }
+    TFCP_POLYVAL(double, d)
+    TFCP_POLYVAL(float, f)
+#undef TFCP_POLYVAL
+
+} // namespace tfcp
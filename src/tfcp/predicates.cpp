@@ -0,0 +1,312 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Adaptive geometric predicates, see <tfcp/predicates.h>
+//
+// Filter by twofold<double>: the estimate value + error differs from
+// the exact determinant by few eps^2 times the permanent, which is the
+// determinant with products of absolute values; so sign is certain if
+// |value + error| exceeds such bound, with some margin for rounding of
+// the permanent itself
+//
+// Exact evaluation by expansions like Shewchuk's: a sum of doubles,
+// nonoverlapping and increasing by magnitude, without zero components
+// except for the zero expansion; so sign is the sign of the last one
+//
+// NB: compile this file for baseline CPU, same as batch.cpp
+//
+
+#include <tfcp/predicates.h>
+#include <tfcp/parallel.h>
+#include <tfcp/twofold.h>
+#include <tfcp/exact.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace tfcp {
+namespace {
+
+    //------------------------------------------------------------------
+    //
+    // Expansion arithmetic
+    //
+    //------------------------------------------------------------------
+
+    using expansion = std::vector<double>;
+
+    // Exact a - b
+    expansion difference(double a, double b)
+    {
+        double r;
+        double s = psub0(a, b, r);
+        if (r != 0)
+            return { r, s };
+        return { s };
+    }
+
+    // Exact e + f: merge components by magnitude, and sum them in this
+    // order, like fast_expansion_sum_zeroelim by Shewchuk
+    expansion operator + (const expansion& e, const expansion& f)
+    {
+        expansion h;
+        h.reserve(e.size() + f.size());
+
+        size_t i = 0, j = 0;
+        auto next = [&]() {
+            if (j == f.size() || (i < e.size() && std::fabs(e[i]) < std::fabs(f[j])))
+                return e[i++];
+            return f[j++];
+        };
+
+        double r;
+        double q = next();
+        q = fast_padd0(next(), q, r);
+        if (r != 0)
+            h.push_back(r);
+        while (i < e.size() || j < f.size()) {
+            q = padd0(q, next(), r);
+            if (r != 0)
+                h.push_back(r);
+        }
+        if (q != 0 || h.empty())
+            h.push_back(q);
+        return h;
+    }
+
+    expansion operator - (const expansion& e)
+    {
+        expansion h(e);
+        for (double& x : h)
+            x = -x;
+        return h;
+    }
+
+    expansion operator - (const expansion& e, const expansion& f)
+    {
+        return e + (-f);
+    }
+
+    // Exact e * b, like scale_expansion_zeroelim by Shewchuk
+    expansion operator * (const expansion& e, double b)
+    {
+        expansion h;
+        h.reserve(2 * e.size());
+
+        double r;
+        double q = pmul0(e[0], b, r);
+        if (r != 0)
+            h.push_back(r);
+        for (size_t i = 1; i < e.size(); i++) {
+            double p0, p1 = pmul0(e[i], b, p0);
+            double s = padd0(q, p0, r);
+            if (r != 0)
+                h.push_back(r);
+            q = fast_padd0(p1, s, r);
+            if (r != 0)
+                h.push_back(r);
+        }
+        if (q != 0 || h.empty())
+            h.push_back(q);
+        return h;
+    }
+
+    expansion operator * (const expansion& e, const expansion& f)
+    {
+        expansion h = e * f[0];
+        for (size_t j = 1; j < f.size(); j++)
+            h = h + e * f[j];
+        return h;
+    }
+
+    int sign_of(const expansion& e)
+    {
+        double top = e.back();
+        return top > 0 ? 1 : top < 0 ? -1 : 0;
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Twofold filter
+    //
+    //------------------------------------------------------------------
+
+    constexpr int ambiguous = 2;
+
+    constexpr double eps = std::numeric_limits<double>::epsilon() / 2;
+
+    // Bounds on |exact - (value + error)| relative to permanent, with
+    // margin about twice versus same kind of bounds by Shewchuk
+    constexpr double orient2d_bound = 16 * eps * eps;
+    constexpr double orient3d_bound = 64 * eps * eps;
+    constexpr double incircle_bound = 96 * eps * eps;
+
+    // Sign of det if certain, else ambiguous: which includes the case
+    // if comparison of twofold throws, as value and value + error have
+    // different signs
+    int filter(const twofold<double>& det, double bound)
+    {
+        try {
+            if (det > 0.0 || det < 0.0) {
+                coupled<double> p(det);
+                if (std::fabs(p.value) > bound)
+                    return p.value > 0 ? 1 : -1;
+            }
+        } catch (const twofold_exception&) {
+            // escalate to exact
+        }
+        return ambiguous;
+    }
+
+    twofold<double> tdiff(double a, double b)
+    {
+        return twofold<double>(a) - b;
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Predicates
+    //
+    //------------------------------------------------------------------
+
+    int orient2d_exact(const double a[], const double b[], const double c[])
+    {
+        expansion acx = difference(a[0], c[0]), acy = difference(a[1], c[1]);
+        expansion bcx = difference(b[0], c[0]), bcy = difference(b[1], c[1]);
+        return sign_of(acx * bcy - acy * bcx);
+    }
+
+    int orient2d_adapt(const double a[], const double b[], const double c[])
+    {
+        twofold<double> acx = tdiff(a[0], c[0]), acy = tdiff(a[1], c[1]);
+        twofold<double> bcx = tdiff(b[0], c[0]), bcy = tdiff(b[1], c[1]);
+        twofold<double> det = acx * bcy - acy * bcx;
+
+        double perm = std::fabs(acx.value * bcy.value) + std::fabs(acy.value * bcx.value);
+        int s = filter(det, orient2d_bound * perm);
+        return s != ambiguous ? s : orient2d_exact(a, b, c);
+    }
+
+    int orient3d_exact(const double a[], const double b[], const double c[], const double d[])
+    {
+        expansion adx = difference(a[0], d[0]), ady = difference(a[1], d[1]), adz = difference(a[2], d[2]);
+        expansion bdx = difference(b[0], d[0]), bdy = difference(b[1], d[1]), bdz = difference(b[2], d[2]);
+        expansion cdx = difference(c[0], d[0]), cdy = difference(c[1], d[1]), cdz = difference(c[2], d[2]);
+        return sign_of(adz * (bdx * cdy - cdx * bdy) +
+                       bdz * (cdx * ady - adx * cdy) +
+                       cdz * (adx * bdy - bdx * ady));
+    }
+
+    int orient3d_adapt(const double a[], const double b[], const double c[], const double d[])
+    {
+        twofold<double> adx = tdiff(a[0], d[0]), ady = tdiff(a[1], d[1]), adz = tdiff(a[2], d[2]);
+        twofold<double> bdx = tdiff(b[0], d[0]), bdy = tdiff(b[1], d[1]), bdz = tdiff(b[2], d[2]);
+        twofold<double> cdx = tdiff(c[0], d[0]), cdy = tdiff(c[1], d[1]), cdz = tdiff(c[2], d[2]);
+        twofold<double> det = adz * (bdx * cdy - cdx * bdy) +
+                              bdz * (cdx * ady - adx * cdy) +
+                              cdz * (adx * bdy - bdx * ady);
+
+        double perm = (std::fabs(bdx.value * cdy.value) + std::fabs(cdx.value * bdy.value)) * std::fabs(adz.value) +
+                      (std::fabs(cdx.value * ady.value) + std::fabs(adx.value * cdy.value)) * std::fabs(bdz.value) +
+                      (std::fabs(adx.value * bdy.value) + std::fabs(bdx.value * ady.value)) * std::fabs(cdz.value);
+        int s = filter(det, orient3d_bound * perm);
+        return s != ambiguous ? s : orient3d_exact(a, b, c, d);
+    }
+
+    int incircle_exact(const double a[], const double b[], const double c[], const double d[])
+    {
+        expansion adx = difference(a[0], d[0]), ady = difference(a[1], d[1]);
+        expansion bdx = difference(b[0], d[0]), bdy = difference(b[1], d[1]);
+        expansion cdx = difference(c[0], d[0]), cdy = difference(c[1], d[1]);
+        expansion alift = adx * adx + ady * ady;
+        expansion blift = bdx * bdx + bdy * bdy;
+        expansion clift = cdx * cdx + cdy * cdy;
+        return sign_of(alift * (bdx * cdy - cdx * bdy) +
+                       blift * (cdx * ady - adx * cdy) +
+                       clift * (adx * bdy - bdx * ady));
+    }
+
+    int incircle_adapt(const double a[], const double b[], const double c[], const double d[])
+    {
+        twofold<double> adx = tdiff(a[0], d[0]), ady = tdiff(a[1], d[1]);
+        twofold<double> bdx = tdiff(b[0], d[0]), bdy = tdiff(b[1], d[1]);
+        twofold<double> cdx = tdiff(c[0], d[0]), cdy = tdiff(c[1], d[1]);
+        twofold<double> alift = adx * adx + ady * ady;
+        twofold<double> blift = bdx * bdx + bdy * bdy;
+        twofold<double> clift = cdx * cdx + cdy * cdy;
+        twofold<double> det = alift * (bdx * cdy - cdx * bdy) +
+                              blift * (cdx * ady - adx * cdy) +
+                              clift * (adx * bdy - bdx * ady);
+
+        double perm = (std::fabs(bdx.value * cdy.value) + std::fabs(cdx.value * bdy.value)) * alift.value +
+                      (std::fabs(cdx.value * ady.value) + std::fabs(adx.value * cdy.value)) * blift.value +
+                      (std::fabs(adx.value * bdy.value) + std::fabs(bdx.value * ady.value)) * clift.value;
+        int s = filter(det, incircle_bound * perm);
+        return s != ambiguous ? s : incircle_exact(a, b, c, d);
+    }
+
+    //------------------------------------------------------------------
+    //
+    // Batches: split queries into chunks, each chunk by one thread
+    //
+    //------------------------------------------------------------------
+
+    constexpr size_t chunk = 4096;
+
+    template<typename F>
+    void queries(size_t n, F query)
+    {
+        size_t chunks = (n + chunk - 1) / chunk;
+        for_chunks(chunks, [&](size_t c) {
+            size_t end = std::min(n, (c + 1) * chunk);
+            for (size_t k = c * chunk; k < end; k++)
+                query(k);
+        });
+    }
+
+} // namespace
+
+    int orient2d(const double a[2], const double b[2], const double c[2])
+    {
+        return orient2d_adapt(a, b, c);
+    }
+
+    int orient3d(const double a[3], const double b[3], const double c[3], const double d[3])
+    {
+        return orient3d_adapt(a, b, c, d);
+    }
+
+    int incircle(const double a[2], const double b[2], const double c[2], const double d[2])
+    {
+        return incircle_adapt(a, b, c, d);
+    }
+
+    void orient2d(size_t n, const double a[], const double b[], const double c[], int s[])
+    {
+        queries(n, [&](size_t k) {
+            s[k] = orient2d_adapt(&a[2*k], &b[2*k], &c[2*k]);
+        });
+    }
+
+    void orient3d(size_t n, const double a[], const double b[], const double c[],
+                  const double d[], int s[])
+    {
+        queries(n, [&](size_t k) {
+            s[k] = orient3d_adapt(&a[3*k], &b[3*k], &c[3*k], &d[3*k]);
+        });
+    }
+
+    void incircle(size_t n, const double a[], const double b[], const double c[],
+                  const double d[], int s[])
+    {
+        queries(n, [&](size_t k) {
+            s[k] = incircle_adapt(&a[2*k], &b[2*k], &c[2*k], &d[2*k]);
+        });
+    }
+
+} // namespace tfcp
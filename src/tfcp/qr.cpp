@@ -0,0 +1,279 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Householder QR and least squares, see <tfcp/qr.h>
+//
+// Blocked like LAPACK's dgeqrf: factor panel of NB columns by reflectors
+// one by one, form T of the block like dlarft, so that the block is
+// I - V*T*V^T, and update the trailing columns by coupled gemm:
+//
+//   W = V^T * A2,  W = T^T * W,  A2 = A2 - V * W
+//
+// Matrix products split between threads inside gemm, see gemm.cpp
+//
+// NB: compile this file for baseline CPU, same as batch.cpp
+//
+
+#include <tfcp/qr.h>
+#include <tfcp/batch.h>
+#include <tfcp/gemm.h>
+#include <tfcp/twofold.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace tfcp {
+namespace {
+
+    // Panel width
+    constexpr size_t NB = 32;
+
+    // Coupled matrix by value and error planes
+    template<typename T> struct planes {
+        T* v;
+        T* e;
+        size_t ld;
+
+        coupled<T> get(size_t i, size_t j) const {
+            return coupled<T>(v[i*ld + j], e[i*ld + j]);
+        }
+        void set(size_t i, size_t j, const coupled<T>& x) const {
+            v[i*ld + j] = x.value;
+            e[i*ld + j] = x.error;
+        }
+    };
+
+    // Reflector for column j, rows j..m, like dlarfg: overwrite a[j][j]
+    // by beta, and rows below by v; return tau, or 0 if H = I
+    template<typename T>
+    coupled<T> reflector(size_t m, const planes<T>& a, size_t j)
+    {
+        coupled<T> s(0, 0);
+        for (size_t i = j + 1; i < m; i++) {
+            coupled<T> x = a.get(i, j);
+            s += x * x;
+        }
+        if (s.value == 0)
+            return coupled<T>(0, 0);
+
+        coupled<T> alpha = a.get(j, j);
+        coupled<T> beta = sqrt(alpha * alpha + s);
+        if (alpha.value > 0)
+            beta = -beta;
+
+        coupled<T> tau = (beta - alpha) / beta;
+        coupled<T> scale = alpha - beta;
+        for (size_t i = j + 1; i < m; i++) {
+            a.set(i, j, a.get(i, j) / scale);
+        }
+        a.set(j, j, beta);
+        return tau;
+    }
+
+    // Apply H = I - tau * v * v^T of column j to columns c0..c1
+    template<typename T>
+    void reflect(size_t m, const planes<T>& a, size_t j, const coupled<T>& tau,
+                 size_t c0, size_t c1)
+    {
+        if (tau.value == 0)
+            return;
+        for (size_t c = c0; c < c1; c++) {
+            coupled<T> w = a.get(j, c);
+            for (size_t i = j + 1; i < m; i++) {
+                w += a.get(i, j) * a.get(i, c);
+            }
+            w *= tau;
+            a.set(j, c, a.get(j, c) - w);
+            for (size_t i = j + 1; i < m; i++) {
+                a.set(i, c, a.get(i, c) - w * a.get(i, j));
+            }
+        }
+    }
+
+    template<typename T>
+    void factor(size_t m, size_t n, T a0[], T a1[], size_t lda, T tau0[], T tau1[])
+    {
+        const planes<T> a = { a0, a1, lda };
+        size_t k = std::min(m, n);
+
+        // V and V^T, T^T, and products: all by dense rows
+        std::vector<T> v[2], vt[2], tt[2], w[2], y[2];
+
+        for (size_t j0 = 0; j0 < k; j0 += NB) {
+            size_t jb = std::min(NB, k - j0);
+            size_t j1 = j0 + jb;
+
+            // Panel: columns j0..j1
+            for (size_t j = j0; j < j1; j++) {
+                coupled<T> tau = reflector(m, a, j);
+                tau0[j] = tau.value;
+                tau1[j] = tau.error;
+                reflect(m, a, j, tau, j + 1, j1);
+            }
+
+            if (j1 == n)
+                break;
+
+            size_t l = m - j0;   // rows of V
+            size_t nc = n - j1;  // trailing columns
+            for (size_t p = 0; p < 2; p++) {
+                v[p].assign(l * jb, 0);
+                vt[p].assign(jb * l, 0);
+                tt[p].assign(jb * jb, 0);
+                w[p].resize(jb * nc);
+                y[p].resize(l * nc);
+            }
+            const planes<T> pv = { v[0].data(), v[1].data(), jb };
+            const planes<T> pvt = { vt[0].data(), vt[1].data(), l };
+            const planes<T> ptt = { tt[0].data(), tt[1].data(), jb };
+
+            // V: unit lower trapezoidal, from reflectors below diagonal
+            for (size_t i = 0; i < l; i++) {
+                for (size_t r = 0; r < jb && r <= i; r++) {
+                    coupled<T> x = i == r ? coupled<T>(1, 0) : a.get(j0 + i, j0 + r);
+                    pv.set(i, r, x);
+                    pvt.set(r, i, x);
+                }
+            }
+
+            // T like dlarft, forward and columnwise; keep it transposed:
+            // T[0..r][r] = -tau[r] * T[0..r][0..r] * V[:][0..r]^T * v[r]
+            for (size_t r = 0; r < jb; r++) {
+                coupled<T> tau(tau0[j0 + r], tau1[j0 + r]);
+                std::vector<coupled<T>> z(r, coupled<T>(0, 0));
+                for (size_t q = 0; q < r; q++) {
+                    for (size_t i = r; i < l; i++) {
+                        z[q] += pv.get(i, q) * pv.get(i, r);
+                    }
+                }
+                for (size_t q = 0; q < r; q++) {
+                    coupled<T> s(0, 0);
+                    for (size_t p = q; p < r; p++) {
+                        s += ptt.get(p, q) * z[p];
+                    }
+                    ptt.set(r, q, -(tau * s));
+                }
+                ptt.set(r, r, tau);
+            }
+
+            // A2 -= V * T^T * V^T * A2
+            T* a2[2] = { &a0[j0*lda + j1], &a1[j0*lda + j1] };
+            gemm(jb, nc, l, vt[0].data(), vt[1].data(), l,
+                            a2[0], a2[1], lda,
+                            w[0].data(), w[1].data(), nc);
+            gemm(jb, nc, jb, tt[0].data(), tt[1].data(), jb,
+                             w[0].data(), w[1].data(), nc,
+                             y[0].data(), y[1].data(), nc);
+            std::copy(y[0].begin(), y[0].begin() + jb * nc, w[0].begin());
+            std::copy(y[1].begin(), y[1].begin() + jb * nc, w[1].begin());
+            gemm(l, nc, jb, v[0].data(), v[1].data(), jb,
+                            w[0].data(), w[1].data(), nc,
+                            y[0].data(), y[1].data(), nc);
+            for (size_t i = 0; i < l; i++) {
+                T* r0 = &a2[0][i*lda];
+                T* r1 = &a2[1][i*lda];
+                batch::psub(nc, r0, r1, &y[0][i*nc], &y[1][i*nc], r0, r1);
+            }
+        }
+    }
+
+    template<typename T>
+    void apply_qt(size_t m, size_t n, const T a0[], const T a1[], size_t lda,
+                  const T tau0[], const T tau1[], T b0[], T b1[])
+    {
+        const planes<T> a = { const_cast<T*>(a0), const_cast<T*>(a1), lda };
+        const planes<T> b = { b0, b1, 1 };
+        size_t k = std::min(m, n);
+        for (size_t j = 0; j < k; j++) {
+            coupled<T> tau(tau0[j], tau1[j]);
+            if (tau.value == 0)
+                continue;
+            coupled<T> w = b.get(j, 0);
+            for (size_t i = j + 1; i < m; i++) {
+                w += a.get(i, j) * b.get(i, 0);
+            }
+            w *= tau;
+            b.set(j, 0, b.get(j, 0) - w);
+            for (size_t i = j + 1; i < m; i++) {
+                b.set(i, 0, b.get(i, 0) - w * a.get(i, j));
+            }
+        }
+    }
+
+    template<typename T>
+    bool solve(size_t m, size_t n, const T a0[], const T a1[], size_t lda,
+               const T b0[], const T b1[], T x0[], T x1[])
+    {
+        if (m < n)
+            return false;
+
+        std::vector<T> r0(m * n), r1(m * n), tau0(n), tau1(n);
+        for (size_t i = 0; i < m; i++) {
+            std::copy(&a0[i*lda], &a0[i*lda] + n, &r0[i*n]);
+            std::copy(&a1[i*lda], &a1[i*lda] + n, &r1[i*n]);
+        }
+        factor(m, n, r0.data(), r1.data(), n, tau0.data(), tau1.data());
+
+        std::vector<T> c0(b0, b0 + m), c1(b1, b1 + m);
+        apply_qt(m, n, r0.data(), r1.data(), n, tau0.data(), tau1.data(),
+                 c0.data(), c1.data());
+
+        // Back substitution: R * x = top n elements of Q^T * b
+        const planes<T> r = { r0.data(), r1.data(), n };
+        for (size_t i = n; i-- > 0;) {
+            coupled<T> d = r.get(i, i);
+            if (d.value == 0)
+                return false;
+            coupled<T> s(c0[i], c1[i]);
+            for (size_t j = i + 1; j < n; j++) {
+                s -= r.get(i, j) * coupled<T>(x0[j], x1[j]);
+            }
+            s /= d;
+            x0[i] = s.value;
+            x1[i] = s.error;
+        }
+        return true;
+    }
+
+} // namespace
+
+    void qr_factor(size_t m, size_t n, double a0[], double a1[], size_t lda,
+                   double tau0[], double tau1[])
+    {
+        factor(m, n, a0, a1, lda, tau0, tau1);
+    }
+
+    void qr_factor(size_t m, size_t n, float a0[], float a1[], size_t lda,
+                   float tau0[], float tau1[])
+    {
+        factor(m, n, a0, a1, lda, tau0, tau1);
+    }
+
+    void qr_apply_qt(size_t m, size_t n, const double a0[], const double a1[], size_t lda,
+                     const double tau0[], const double tau1[], double b0[], double b1[])
+    {
+        apply_qt(m, n, a0, a1, lda, tau0, tau1, b0, b1);
+    }
+
+    void qr_apply_qt(size_t m, size_t n, const float a0[], const float a1[], size_t lda,
+                     const float tau0[], const float tau1[], float b0[], float b1[])
+    {
+        apply_qt(m, n, a0, a1, lda, tau0, tau1, b0, b1);
+    }
+
+    bool least_squares(size_t m, size_t n, const double a0[], const double a1[], size_t lda,
+                       const double b0[], const double b1[], double x0[], double x1[])
+    {
+        return solve(m, n, a0, a1, lda, b0, b1, x0, x1);
+    }
+
+    bool least_squares(size_t m, size_t n, const float a0[], const float a1[], size_t lda,
+                       const float b0[], const float b1[], float x0[], float x1[])
+    {
+        return solve(m, n, a0, a1, lda, b0, b1, x0, x1);
+    }
+
+} // namespace tfcp
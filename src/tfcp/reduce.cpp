@@ -0,0 +1,149 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Accurate reductions, see <tfcp/reduce.h>
+//
+// Split array into chunks of fixed length, reduce each chunk by kernel
+// for the ISA selected at runtime, then add partial results in order
+// of chunks by coupled padd: so result does not depend on the number
+// of threads
+//
+// Binned sum (rsum) merges chunks exactly, see binned.h
+//
+// NB: compile this file for baseline CPU, same as batch.cpp
+//
+
+#include <tfcp/reduce.h>
+#include <tfcp/kernels.h>
+#include <tfcp/parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace tfcp {
+namespace {
+
+    // Elements per chunk: must be multiple of kernel's lanes
+    constexpr size_t chunk = 1 << 15;
+
+    std::atomic<int> threads_setting(0);
+
+    // NB: query once, as it may be slow like reading /sys on Linux
+    int default_threads()
+    {
+        static const int threads = [] {
+            unsigned n = std::thread::hardware_concurrency();
+            return n > 0 ? static_cast<int>(n) : 1;
+        }();
+        return threads;
+    }
+
+    // Partial result of each chunk: p + s
+    template<typename T> struct partial {
+        T p, s;
+    };
+
+    // K is kernel like sum2 that reduces n elements into z0 + z1
+    template<typename T, typename K, typename... P>
+    coupled<T> reduce(K kernel, size_t n, const P*... x)
+    {
+        size_t chunks = (n + chunk - 1) / chunk;
+        std::vector<partial<T>> parts(chunks > 0 ? chunks : 1, { 0, 0 });
+
+        for_chunks(chunks, [&](size_t c) {
+            size_t i = c * chunk;
+            size_t m = std::min(chunk, n - i);
+            kernel(m, (x + i)..., parts[c].p, parts[c].s);
+        });
+
+        coupled<T> r(0, 0);
+        for (const auto& part : parts) {
+            r += coupled<T>(part.p, part.s);
+        }
+        return r;
+    }
+
+    // Binned sum by kernel: merge of binned sums is exact, so chunks
+    // may go in any order; but keep the same chunks anyway
+    template<typename T, typename K>
+    coupled<T> reduce_binned(K kernel, size_t n, const T x[])
+    {
+        size_t chunks = (n + chunk - 1) / chunk;
+        std::vector<binned> parts(chunks);
+
+        for_chunks(chunks, [&](size_t c) {
+            size_t i = c * chunk;
+            size_t m = std::min(chunk, n - i);
+            binned_init(parts[c]);
+            kernel(m, x + i, parts[c]);
+        });
+
+        binned z;
+        binned_init(z);
+        for (const auto& part : parts) {
+            binned_merge(z, part);
+        }
+
+        if (z.special != 0) {
+            return coupled<T>(static_cast<T>(z.special), 0);
+        }
+
+        // Bin is exactly c + a, but c and a depend on order of inputs:
+        // so first make it canonical as exact coupled sum, then add the
+        // bins from lower to upper
+        coupled<double> r(0, 0);
+        for (int k = binned::K - 1; k >= 0; k--) {
+            r += coupled<double>(z.c[k], 0) + z.a[k];
+        }
+        return static_cast<coupled<T>>(static_cast<const coupled<double>&>(r));
+    }
+
+} // namespace
+
+    coupled<double> sum(size_t n, const double x[])
+    {
+        return reduce<double>(current_kernels().d.sum2, n, x);
+    }
+
+    coupled<float> sum(size_t n, const float x[])
+    {
+        return reduce<float>(current_kernels().f.sum2, n, x);
+    }
+
+    coupled<double> dot2(size_t n, const double x[], const double y[])
+    {
+        return reduce<double>(current_kernels().d.dot2, n, x, y);
+    }
+
+    coupled<float> dot2(size_t n, const float x[], const float y[])
+    {
+        return reduce<float>(current_kernels().f.dot2, n, x, y);
+    }
+
+    coupled<double> rsum(size_t n, const double x[])
+    {
+        return reduce_binned(current_kernels().d.rsum, n, x);
+    }
+
+    coupled<float> rsum(size_t n, const float x[])
+    {
+        return reduce_binned(current_kernels().f.rsum, n, x);
+    }
+
+    void set_reduce_threads(int threads)
+    {
+        threads_setting.store(threads > 0 ? threads : 0);
+    }
+
+    int reduce_threads()
+    {
+        int threads = threads_setting.load();
+        return threads > 0 ? threads : default_threads();
+    }
+
+} // namespace tfcp
@@ -0,0 +1,231 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Sparse product and Krylov solvers, see <tfcp/sparse.h>
+//
+// Rows split into stripes by count of nonzeros, so that each stripe
+// takes about same time; stripes run by threads, each row by kernel for
+// the ISA selected at runtime, see sparse_kernels.cpp
+//
+// NB: compile this file for baseline CPU, same as batch.cpp
+//
+
+#include <tfcp/sparse.h>
+#include <tfcp/kernels.h>
+#include <tfcp/parallel.h>
+#include <tfcp/reduce.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace tfcp {
+namespace {
+
+    // Nonzeros per stripe, about
+    constexpr size_t stripe = 1 << 14;
+
+    // Solvers run serially below this count of nonzeros and unknowns:
+    // each iteration is spmv and several dot2, and starting threads for
+    // each of them would take longer than the work itself
+    constexpr size_t serial_size = 1 << 18;
+
+    // K is kernel like spmv, for rows of a
+    template<typename T, typename K>
+    void product(K kernel, const csr_matrix<T>& a, const T x[], T y0[], T y1[])
+    {
+        if (a.ptr.empty())
+            return;  // default-constructed, so no rows
+
+        size_t nnz = a.ptr[a.rows];
+        size_t stripes = std::min(a.rows, (nnz + stripe - 1) / stripe);
+
+        // Stripe s is rows first..last, where first is the least row
+        // starting at or after s-th part of nonzeros
+        auto row = [&](size_t s) {
+            size_t k = nnz * s / stripes;
+            return static_cast<size_t>(std::lower_bound(a.ptr.begin(), a.ptr.begin() + a.rows,
+                                                        k) - a.ptr.begin());
+        };
+
+        if (stripes <= 1) {
+            kernel(a.rows, a.ptr.data(), a.col.data(), a.val.data(), x, y0, y1);
+            return;
+        }
+        for_chunks(stripes, [&](size_t s) {
+            size_t first = row(s);
+            size_t last = s + 1 < stripes ? row(s + 1) : a.rows;
+            kernel(last - first, &a.ptr[first], a.col.data(), a.val.data(), x,
+                   &y0[first], &y1[first]);
+        });
+    }
+
+    template<typename T>
+    bool solve_serially(const csr_matrix<T>& a)
+    {
+        return a.ptr.empty() || a.ptr[a.rows] + a.rows < serial_size;
+    }
+
+    template<typename T>
+    T norm(size_t n, const T x[])
+    {
+        return std::sqrt(dot2(n, x, x).value);
+    }
+
+    // r = b - a * x, rounded from coupled
+    template<typename T, typename K>
+    void residual(K kernel, const csr_matrix<T>& a, const T b[], const T x[],
+                  T r[], std::vector<T>& t)
+    {
+        size_t n = a.rows;
+        t.resize(n);
+        product(kernel, a, x, r, t.data());
+        for (size_t i = 0; i < n; i++) {
+            coupled<T> d(b[i], 0);
+            d -= coupled<T>(r[i], t[i]);
+            r[i] = d.value;
+        }
+    }
+
+    // y = a * x, rounded from coupled
+    template<typename T, typename K>
+    void apply(K kernel, const csr_matrix<T>& a, const T x[], T y[], std::vector<T>& t)
+    {
+        t.resize(a.rows);
+        product(kernel, a, x, y, t.data());
+    }
+
+    template<typename T, typename K>
+    int solve_cg(K kernel, const csr_matrix<T>& a, const T b[], T x[],
+                 T tol, int max_iter)
+    {
+        serial_chunks serial(solve_serially(a));
+        size_t n = a.rows;
+        std::vector<T> r(n), p(n), q(n), t;
+
+        T limit = tol * norm(n, b);
+        residual(kernel, a, b, x, r.data(), t);
+        if (norm(n, r.data()) <= limit)
+            return 0;
+
+        std::copy(r.begin(), r.end(), p.begin());
+        T rr = dot2(n, r.data(), r.data()).value;
+        for (int iter = 1; iter <= max_iter; iter++) {
+            apply(kernel, a, p.data(), q.data(), t);
+            T pq = dot2(n, p.data(), q.data()).value;
+            if (!(pq > 0))
+                return -1;  // a is not positive definite
+            T alpha = rr / pq;
+            for (size_t i = 0; i < n; i++) {
+                x[i] = x[i] + alpha * p[i];
+                r[i] = r[i] - alpha * q[i];
+            }
+
+            T rr_next = dot2(n, r.data(), r.data()).value;
+            if (std::sqrt(rr_next) <= limit) {
+                residual(kernel, a, b, x, r.data(), t);
+                rr_next = dot2(n, r.data(), r.data()).value;
+                if (std::sqrt(rr_next) <= limit)
+                    return iter;
+            }
+
+            T beta = rr_next / rr;
+            for (size_t i = 0; i < n; i++) {
+                p[i] = r[i] + beta * p[i];
+            }
+            rr = rr_next;
+        }
+        return -1;
+    }
+
+    template<typename T, typename K>
+    int solve_bicgstab(K kernel, const csr_matrix<T>& a, const T b[], T x[],
+                       T tol, int max_iter)
+    {
+        serial_chunks serial(solve_serially(a));
+        size_t n = a.rows;
+        std::vector<T> r(n), r0(n), p(n, 0), v(n, 0), s(n), w(n), t;
+
+        T limit = tol * norm(n, b);
+        residual(kernel, a, b, x, r.data(), t);
+        if (norm(n, r.data()) <= limit)
+            return 0;
+
+        std::copy(r.begin(), r.end(), r0.begin());
+        T rho = 1, alpha = 1, omega = 1;
+        for (int iter = 1; iter <= max_iter; iter++) {
+            T rho_next = dot2(n, r0.data(), r.data()).value;
+            if (rho_next == 0 || omega == 0)
+                return -1;  // breakdown
+            T beta = (rho_next / rho) * (alpha / omega);
+            for (size_t i = 0; i < n; i++) {
+                p[i] = r[i] + beta * (p[i] - omega * v[i]);
+            }
+
+            apply(kernel, a, p.data(), v.data(), t);
+            T r0v = dot2(n, r0.data(), v.data()).value;
+            if (r0v == 0)
+                return -1;
+            alpha = rho_next / r0v;
+            for (size_t i = 0; i < n; i++) {
+                s[i] = r[i] - alpha * v[i];
+            }
+
+            apply(kernel, a, s.data(), w.data(), t);
+            T ww = dot2(n, w.data(), w.data()).value;
+            omega = ww > 0 ? dot2(n, w.data(), s.data()).value / ww : 0;
+            for (size_t i = 0; i < n; i++) {
+                x[i] = x[i] + alpha * p[i] + omega * s[i];
+                r[i] = s[i] - omega * w[i];
+            }
+
+            if (norm(n, r.data()) <= limit) {
+                residual(kernel, a, b, x, r.data(), t);
+                if (norm(n, r.data()) <= limit)
+                    return iter;
+            }
+            rho = rho_next;
+        }
+        return -1;
+    }
+
+} // namespace
+
+    void spmv(const csr_matrix<double>& a, const double x[], double y0[], double y1[])
+    {
+        product(current_kernels().d.spmv, a, x, y0, y1);
+    }
+
+    void spmv(const csr_matrix<float>& a, const float x[], float y0[], float y1[])
+    {
+        product(current_kernels().f.spmv, a, x, y0, y1);
+    }
+
+    int cg(const csr_matrix<double>& a, const double b[], double x[],
+           double tol, int max_iter)
+    {
+        return solve_cg(current_kernels().d.spmv, a, b, x, tol, max_iter);
+    }
+
+    int cg(const csr_matrix<float>& a, const float b[], float x[],
+           float tol, int max_iter)
+    {
+        return solve_cg(current_kernels().f.spmv, a, b, x, tol, max_iter);
+    }
+
+    int bicgstab(const csr_matrix<double>& a, const double b[], double x[],
+                 double tol, int max_iter)
+    {
+        return solve_bicgstab(current_kernels().d.spmv, a, b, x, tol, max_iter);
+    }
+
+    int bicgstab(const csr_matrix<float>& a, const float b[], float x[],
+                 float tol, int max_iter)
+    {
+        return solve_bicgstab(current_kernels().f.spmv, a, b, x, tol, max_iter);
+    }
+
+} // namespace tfcp
@@ -0,0 +1,56 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+//
+// Batched tridiagonal solver, see <tfcp/tridiag.h>
+//
+// Split systems into chunks of fixed count, solve each chunk by kernel
+// for the ISA selected at runtime: systems are independent, so result
+// does not depend on the number of threads
+//
+// NB: compile this file for baseline CPU, same as batch.cpp
+//
+
+#include <tfcp/tridiag.h>
+#include <tfcp/kernels.h>
+#include <tfcp/parallel.h>
+
+#include <algorithm>
+
+namespace tfcp {
+namespace {
+
+    // Systems per chunk: multiple of any vector length
+    constexpr size_t chunk = 256;
+
+    template<typename T, typename K>
+    void solve(K kernel, size_t n, size_t batch,
+               const T a[], const T b[], const T c[], const T d[], T x0[], T x1[])
+    {
+        size_t chunks = (batch + chunk - 1) / chunk;
+        for_chunks(chunks, [&](size_t k) {
+            size_t s = k * chunk;
+            size_t m = std::min(chunk, batch - s);
+            kernel(n, m, batch, a + s, b + s, c + s, d + s, x0 + s, x1 + s);
+        });
+    }
+
+} // namespace
+
+    void tridiag_solve(size_t n, size_t batch,
+                       const double a[], const double b[], const double c[],
+                       const double d[], double x0[], double x1[])
+    {
+        solve(current_kernels().d.thomas, n, batch, a, b, c, d, x0, x1);
+    }
+
+    void tridiag_solve(size_t n, size_t batch,
+                       const float a[], const float b[], const float c[],
+                       const float d[], float x0[], float x1[])
+    {
+        solve(current_kernels().f.thomas, n, batch, a, b, c, d, x0, x1);
+    }
+
+} // namespace tfcp
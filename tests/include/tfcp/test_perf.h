@@ -0,0 +1,73 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TEST_PERF_H
+#define TEST_PERF_H
+//======================================================================
+//
+// Timing for perf tests: best of several runs of f(), per element of
+// the work it does; if f() returns a value, keep it in sink, so that
+// compiler would not drop the computation
+//
+//======================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <type_traits>
+
+namespace tfcp_test {
+
+    template<typename F>
+    inline void run_kept(F& f, std::true_type /* returns void */) { f(); }
+
+    template<typename F>
+    inline void run_kept(F& f, std::false_type) {
+        volatile double sink = f();
+        (void)sink;  // read back, so not unused
+    }
+
+    // Nanoseconds per element, best of several runs; keep result in sink
+    template<typename F>
+    inline double measure(size_t n, F f, int runs = 5)
+    {
+        using is_void = typename std::is_void<decltype(f())>::type;
+        double best = 1e30;
+        for (int run = 0; run < runs; run++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            run_kept(f, is_void());
+            auto stop = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+            best = std::min(best, ns / n);
+        }
+        return best;
+    }
+
+    // Same, if f() is short so call it repeat times per run
+    template<typename F>
+    inline double measure_repeat(size_t n, int repeat, F f)
+    {
+        return measure(n * repeat, [&]() {
+            for (int r = 0; r < repeat; r++) {
+                f();
+                // do not let compiler hoist f() out of this loop
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            }
+        });
+    }
+
+    // Milliseconds per call of f(), best of several runs
+    template<typename F>
+    inline double measure_ms(F f, int runs = 3)
+    {
+        return measure(1, f, runs) / 1e6;
+    }
+
+} // namespace tfcp_test
+
+//======================================================================
+#endif // TEST_PERF_H
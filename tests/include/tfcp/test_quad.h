@@ -0,0 +1,224 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#ifndef TEST_QUAD_H
+#define TEST_QUAD_H
+//======================================================================
+//
+// Reference elementary functions in __float128, for tests and perf;
+// computed by Taylor series and Newton steps from <cmath> seeds, as no
+// libquadmath here; relative error is about 2^-110, so good reference
+// for coupled<double> whose error is about 2^-104
+//
+// Argument is x + dx, not rounded to __float128: as x0 + x1 of coupled
+// may need more bits, e.g. 1 + 2^-80 for log, or 700 + 2^-60 for exp
+//
+// Defined only if compiler supports __float128: check TFCP_TEST_QUAD
+//
+//======================================================================
+
+#if defined(__SIZEOF_FLOAT128__)
+#define TFCP_TEST_QUAD
+
+#include <cmath>
+
+namespace tfcp_test {
+
+    using quad = __float128;
+
+    inline quad fabs_quad(quad x) { return x < 0 ? -x : x; }
+
+    // 2^k for k in range of double exponent, including subnormal
+    inline quad ldexp_quad(quad x, int k)
+    {
+        int k1 = k / 2;
+        return x * std::ldexp(1.0, k1) * std::ldexp(1.0, k - k1);
+    }
+
+    // Sum of Taylor series: x^k / k! for k >= first
+    inline quad taylor_quad(quad x, int first)
+    {
+        quad term = 1, sum = 0;
+        for (int k = 1; k < first; k++)
+            term = term * x / k;
+        for (int k = first; k < 100; k++) {
+            term = term * x / k;
+            sum += term;
+            if (fabs_quad(term) <= fabs_quad(sum) * 1e-36)
+                break;
+        }
+        return sum;
+    }
+
+    // ln2 by three parts, first two with 40 bits, so k * ln2 is exact
+    // by first two parts for |k| < 2^12; different split than library
+    constexpr double ln2_a = 0.6931471805592082;
+    constexpr double ln2_b = 7.371002565161996e-13;
+    constexpr double ln2_c = 5.8029889835956905e-25;
+
+    inline quad exp_quad(quad x, quad dx = 0)
+    {
+        double k = std::nearbyint(static_cast<double>(x) / ln2_a);
+        quad r = x - k * static_cast<quad>(ln2_a)
+                   - k * static_cast<quad>(ln2_b)
+                   - k * static_cast<quad>(ln2_c) + dx;
+        return ldexp_quad(1 + taylor_quad(r, 1), static_cast<int>(k));
+    }
+
+    inline quad expm1_quad(quad x, quad dx = 0)
+    {
+        if (fabs_quad(x) < 0.5)
+            return taylor_quad(x + dx, 1);
+        return exp_quad(x, dx) - 1;
+    }
+
+    inline quad log_quad(quad x, quad dx = 0);
+
+    // Newton steps: y += t - t^2/2, where t = (1 + x) exp(-y) - 1
+    inline quad log1p_quad(quad x, quad dx = 0)
+    {
+        if (x < -0.5 || x > 1)
+            return log_quad(1 + x, dx);
+        x += dx;
+        quad y = std::log1p(static_cast<double>(x));
+        for (int step = 0; step < 2; step++) {
+            quad m = expm1_quad(-y);
+            quad t = x + m + x * m;
+            y += t - t * t / 2;
+        }
+        return y;
+    }
+
+    // Newton steps: y += t - t^2/2, where t = x exp(-y) - 1
+    inline quad log_quad(quad x, quad dx)
+    {
+        if (x >= 0.5 && x <= 2)
+            return log1p_quad(x - 1, dx);
+        x += dx;
+        quad y = std::log(static_cast<double>(x));
+        for (int step = 0; step < 2; step++) {
+            quad t = x * exp_quad(-y) - 1;
+            y += t - t * t / 2;
+        }
+        return y;
+    }
+
+    inline quad pow_quad(quad x, quad y)
+    {
+        return exp_quad(y * log_quad(x));
+    }
+
+    // pi/2 by four words of 70 bits, each word is sum of two doubles;
+    // so k * word is exact for |k| < 2^40
+    constexpr double pio2_ab[4][2] = {
+        { 1.5707963267948966, 6.123201175701337e-17 },
+        { 3.2820035428735005e-22, 6.819144322137715e-39 },
+        { -1.520291958845133e-43, 2.5463314467029476e-60 },
+        { -2.5650587247459237e-65, -1.572611015817417e-81 } };
+
+    // Sine and cosine of x + dx, for |x| < 2^40: x + dx = k pi/2 + r,
+    // where x - k word0 is exact, and then Taylor series for r
+    inline void sincos_quad(quad x, quad dx, quad& s, quad& c)
+    {
+        double k = std::nearbyint(static_cast<double>(x + dx) / pio2_ab[0][0]);
+        quad r = x;
+        for (int i = 0; i < 4; i++) {
+            r -= k * (static_cast<quad>(pio2_ab[i][0]) + pio2_ab[i][1]);
+            if (i == 0)
+                r += dx;
+        }
+
+        quad r2 = r * r, ts = r, tc = 1, s0 = r, c0 = 1;
+        for (int j = 1; j < 40; j++) {
+            tc = -tc * r2 / ((2 * j - 1) * (2 * j));
+            ts = -ts * r2 / ((2 * j) * (2 * j + 1));
+            c0 += tc;
+            s0 += ts;
+        }
+
+        // Quadrant by k mod 4
+        int q = static_cast<int>(k - 4 * std::floor(k / 4));
+        quad sq[4] = { s0, c0, -s0, -c0 };
+        s = sq[q];
+        c = sq[(q + 1) % 4];
+    }
+
+    // Newton steps from <cmath> seed
+    inline quad sqrt_quad(quad x)
+    {
+        if (x == 0)
+            return 0;
+        quad y = std::sqrt(static_cast<double>(x));
+        for (int step = 0; step < 2; step++)
+            y = (y + x / y) / 2;
+        return y;
+    }
+
+    // Newton steps: t += atan(d), where d = (y c - x s) / (x c + y s),
+    // for s, c = sin(t), cos(t); and atan(d) = d - d^3/3 as d is tiny
+    inline quad atan2_quad(quad y, quad x)
+    {
+        quad t = std::atan2(static_cast<double>(y), static_cast<double>(x));
+        for (int step = 0; step < 2; step++) {
+            quad s, c;
+            sincos_quad(t, 0, s, c);
+            quad d = (y * c - x * s) / (x * c + y * s);
+            t += d - d * d * d / 3;
+        }
+        return t;
+    }
+
+    inline quad atan_quad(quad x, quad dx = 0)
+    {
+        return atan2_quad(x + dx, 1);
+    }
+
+    // Keep dx apart for 1 - x, as x + dx may not fit quad near 1
+    inline quad cosine_quad(quad x, quad dx)
+    {
+        return sqrt_quad(((1 - x) - dx) * ((1 + x) + dx));
+    }
+
+    inline quad asin_quad(quad x, quad dx = 0)
+    {
+        return atan2_quad(x + dx, cosine_quad(x, dx));
+    }
+
+    inline quad acos_quad(quad x, quad dx = 0)
+    {
+        return atan2_quad(cosine_quad(x, dx), x + dx);
+    }
+
+    // Hyperbolic functions by m = expm1(|x|), without cancellation
+    inline quad sinh_quad(quad x, quad dx = 0)
+    {
+        if (x < 0)
+            return -sinh_quad(-x, -dx);
+        quad m = expm1_quad(x, dx);
+        return (m + m / (1 + m)) / 2;
+    }
+
+    inline quad cosh_quad(quad x, quad dx = 0)
+    {
+        if (x < 0)
+            return cosh_quad(-x, -dx);
+        quad e = exp_quad(x, dx);
+        return (e + 1 / e) / 2;
+    }
+
+    inline quad tanh_quad(quad x, quad dx = 0)
+    {
+        if (x < 0)
+            return -tanh_quad(-x, -dx);
+        quad m = expm1_quad(2 * x, 2 * dx);
+        return m / (m + 2);
+    }
+
+} // namespace tfcp_test
+
+#endif // __SIZEOF_FLOAT128__
+
+//======================================================================
+#endif // TEST_QUAD_H
@@ -7,55 +7,24 @@
 #define TEST_UTILS_H
 //======================================================================
 
+#include <tfcp/dispatch.h>
 #include <tfcp/simd.h>
 
-#include <cassert>
-
-namespace tfcp {
-
-    //------------------------------------------------------------------
-    //
-    // Type traits for short-vectors: floax, doublex
-    //
-    //------------------------------------------------------------------
-
-    template<typename TX> struct traitx {};
-    template<> struct traitx<float>   { using base = float; };
-    template<> struct traitx<floatx>  { using base = float; };
-    template<> struct traitx<double>  { using base = double; };
-    template<> struct traitx<doublex> { using base = double; };
-
-    //------------------------------------------------------------------
-    //
-    // Get short-vertor i'th position (by reference)
-    //
-    //------------------------------------------------------------------
-
-    inline float& getx(floatx& x, int i) {
-        static constexpr int length = sizeof(floatx) / sizeof(float);
-        (void)length;  // maybe unused, if Release build
-        assert(0 <= i && i < length);
-        return reinterpret_cast<float*>(&x)[i];
-    }
-
-    inline double& getx(doublex& x, int i) {
-        static constexpr int length = sizeof(doublex) / sizeof(double);
-        (void)length;  // maybe unused, if Release build
-        assert(0 <= i && i < length);
-        return reinterpret_cast<double*>(&x)[i];
-    }
-
-    inline float& getx(float& x, int i) {
-        assert(i == 0);
-        return x;
+#include <string>
+
+//
+// Select batch kernels by ISA name like "avx2" for tests parametrized
+// by it; return false if CPU does not support such ISA
+//
+inline bool select_isa_by_name(const std::string& name)
+{
+    using tfcp::isa;
+    for (isa target : { isa::generic, isa::sse2, isa::avx, isa::avx2, isa::avx512 }) {
+        if (name == tfcp::isa_name(target))
+            return tfcp::select_isa(target);
     }
-
-    inline double& getx(double& x, int i) {
-        assert(i == 0);
-        return x;
-    }
-
-} // namespace tfcp
+    return false;
+}
 
 //======================================================================
 #endif // TEST_UTILS_H
@@ -0,0 +1,134 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/batch.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+//----------------------------------------------------------------------
+//
+// Batch kernels versus loop over the coupled operators of twofold.h
+//
+// Prints nanoseconds per element, and speedup of batch over the loop
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using   OpName = std::string;
+
+using Params = typename std::tuple<TypeName, OpName>;
+
+class TestPerfBatch : public TestWithParam<Params> {
+protected:
+
+    // B is batch function, and S is scalar coupled operation
+    template<typename T, typename B, typename S>
+    static void test_case(const char type[], const char op[], B b, S s)
+    {
+        static constexpr size_t n = 4096;  // fits L1/L2 cache
+        static constexpr int repeat = 2000;
+
+        std::mt19937 gen;
+        std::uniform_real_distribution<T> dis(1, 2);
+
+        std::vector<T> x0(n), x1(n), y0(n), y1(n), z0(n), z1(n);
+        std::vector<coupled<T>> x(n), y(n), z(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            x0[i] = dis(gen);
+            x1[i] = dis(gen) * x0[i] / 100000000;
+            y0[i] = dis(gen);
+            y1[i] = dis(gen) * y0[i] / 100000000;
+            x[i] = coupled<T>(x0[i], x1[i]);
+            y[i] = coupled<T>(y0[i], y1[i]);
+        }
+
+        double ns_loop = measure_repeat(n, repeat, [&]() {
+            for (size_t i = 0; i < n; i++)
+                z[i] = s(x[i], y[i]);
+        });
+
+        double ns_batch = measure_repeat(n, repeat, [&]() {
+            b(n, x0.data(), x1.data(), y0.data(), y1.data(),
+                 z0.data(), z1.data());
+        });
+
+        printf("PERF: type=%s op=%s isa=%s loop ns/elem=%.3f batch ns/elem=%.3f speedup=%.2fx\n",
+               type, op, isa_name(current_isa()), ns_loop, ns_batch, ns_loop / ns_batch);
+    }
+};
+
+TEST_P(TestPerfBatch, perf) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto op    = std::get<1>(param);
+
+#define OP_CASE(T, F, OP)                                                      \
+    if (op == #F) {                                                            \
+        test_case<T>(#T, #F,                                                   \
+            [](size_t n, const T* x0, const T* x1, const T* y0, const T* y1,   \
+                         T* z0, T* z1) { batch::F(n, x0, x1, y0, y1, z0, z1); }, \
+            [](const coupled<T>& x, const coupled<T>& y) { return x OP y; });  \
+        return;                                                                \
+    }
+
+#define SQRT_CASE(T, F)                                                        \
+    if (op == #F) {                                                            \
+        test_case<T>(#T, #F,                                                   \
+            [](size_t n, const T* x0, const T* x1, const T* y0, const T* y1,   \
+                         T* z0, T* z1) { batch::F(n, x0, x1, z0, z1); },       \
+            [](const coupled<T>& x, const coupled<T>& y) { return sqrt(x); }); \
+        return;                                                                \
+    }
+
+#define TYPE_CASE(T)                        \
+    if (type == #T) {                       \
+        OP_CASE(T, padd, +);                \
+        OP_CASE(T, pmul, *);                \
+        OP_CASE(T, pdiv, /);                \
+        SQRT_CASE(T, psqrt);                \
+        FAIL() << "unknown op: " << op;     \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+#undef SQRT_CASE
+#undef OP_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndOps, TestPerfBatch,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("padd",
+                                        "pmul",
+                                        "pdiv",
+                                        "psqrt")));
@@ -0,0 +1,209 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/elementary.h>
+#include <tfcp/reduce.h>
+
+#include <tfcp/test_quad.h>
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+using FunctionName = std::string;
+
+//----------------------------------------------------------------------
+//
+// Elementary functions of coupled<double> versus plain <cmath> double,
+// and versus __float128 by test_quad.h, for x0 + x1 with random x0:
+// coupled arrays by 1 thread and by default threads, and single calls
+//
+// Prints nanoseconds per element; quad=-1 if no __float128
+//
+//----------------------------------------------------------------------
+
+class TestPerfElementary : public TestWithParam<FunctionName> {
+protected:
+
+    // Reference in __float128 for x0 + x1 and y0 + y1, or -1 if none
+    static double quad_ref(const std::string& name, size_t n,
+                           const double x0[], const double x1[],
+                           const double y0[], const double y1[])
+    {
+    #if defined(TFCP_TEST_QUAD)
+        using tfcp_test::quad;
+        return measure(n, [&]() {
+            quad sum = 0;
+            for (size_t k = 0; k < n; k++)
+            {
+                if (name == "exp")
+                    sum += tfcp_test::exp_quad(x0[k], x1[k]);
+                else if (name == "log")
+                    sum += tfcp_test::log_quad(x0[k], x1[k]);
+                else if (name == "sin" || name == "tan") {
+                    quad s, c;
+                    tfcp_test::sincos_quad(x0[k], x1[k], s, c);
+                    sum += name == "sin" ? s : s / c;
+                }
+                else if (name == "atan2")
+                    sum += tfcp_test::atan2_quad(static_cast<quad>(x0[k]) + x1[k],
+                                                 static_cast<quad>(y0[k]) + y1[k]);
+                else if (name == "asin")
+                    sum += tfcp_test::asin_quad(x0[k], x1[k]);
+                else if (name == "tanh")
+                    sum += tfcp_test::tanh_quad(x0[k], x1[k]);
+                else
+                    sum += tfcp_test::pow_quad(static_cast<quad>(x0[k]) + x1[k],
+                                               static_cast<quad>(y0[k]) + y1[k]);
+            }
+            return static_cast<double>(sum);
+        });
+    #else
+        return -1;
+    #endif
+    }
+
+    template<typename B, typename S, typename P>
+    static void test_case(const std::string& name, double lo, double hi,
+                          B batch, S single, P plain)
+    {
+        static constexpr size_t n = 1 << 20;
+
+        std::mt19937 gen;
+        std::uniform_real_distribution<double> dis(lo, hi), tail(-1e-17, 1e-17);
+        std::uniform_real_distribution<double> power(-4, 4);
+
+        std::vector<double> x0(n), x1(n), y0(n), y1(n), z0(n), z1(n);
+        for (size_t k = 0; k < n; k++)
+        {
+            x0[k] = dis(gen);
+            x1[k] = x0[k] * tail(gen);
+            y0[k] = power(gen);
+            y1[k] = y0[k] * tail(gen);
+        }
+
+        double ns_plain = measure(n, [&]() {
+            double sum = 0;
+            for (size_t k = 0; k < n; k++)
+                sum += plain(x0[k], y0[k]);
+            return sum;
+        });
+
+        double ns_single = measure(n, [&]() {
+            double sum = 0;
+            for (size_t k = 0; k < n; k++)
+                sum += single(coupled<double>(x0[k], x1[k]),
+                              coupled<double>(y0[k], y1[k])).value;
+            return sum;
+        });
+
+        set_reduce_threads(1);
+        double ns_batch1 = measure(n, [&]() {
+            batch(n, x0.data(), x1.data(), y0.data(), y1.data(), z0.data(), z1.data());
+            return z0[n / 2];
+        });
+
+        set_reduce_threads(0);
+        double ns_batch = measure(n, [&]() {
+            batch(n, x0.data(), x1.data(), y0.data(), y1.data(), z0.data(), z1.data());
+            return z0[n / 2];
+        });
+
+        // Fewer elements, as much slower
+        double ns_quad = quad_ref(name, n / 16, x0.data(), x1.data(), y0.data(), y1.data());
+
+        printf("PERF: function=%s ns/element: plain=%.2f coupled: single=%.2f "
+               "batch(threads=1)=%.2f batch(threads=%d)=%.2f quad=%.2f\n",
+               name.c_str(), ns_plain, ns_single, ns_batch1, reduce_threads(),
+               ns_batch, ns_quad);
+    }
+};
+
+TEST_P(TestPerfElementary, perf) {
+    auto name = GetParam();
+
+    using cref = const coupled<double>&;
+    using cptr = const double*;
+
+    if (name == "exp") {
+        test_case(name, -700, 700,
+            [](size_t n, cptr x0, cptr x1, cptr, cptr, double* z0, double* z1) {
+                tfcp::exp(n, x0, x1, z0, z1); },
+            [](cref x, cref) { return tfcp::exp(x); },
+            [](double x, double) { return std::exp(x); });
+    } else if (name == "log") {
+        test_case(name, 1e-3, 1e3,
+            [](size_t n, cptr x0, cptr x1, cptr, cptr, double* z0, double* z1) {
+                tfcp::log(n, x0, x1, z0, z1); },
+            [](cref x, cref) { return tfcp::log(x); },
+            [](double x, double) { return std::log(x); });
+    } else if (name == "pow") {
+        test_case(name, 1e-3, 1e3,
+            [](size_t n, cptr x0, cptr x1, cptr y0, cptr y1, double* z0, double* z1) {
+                tfcp::pow(n, x0, x1, y0, y1, z0, z1); },
+            [](cref x, cref y) { return tfcp::pow(x, y); },
+            [](double x, double y) { return std::pow(x, y); });
+    } else if (name == "sin") {
+        test_case(name, -1e3, 1e3,
+            [](size_t n, cptr x0, cptr x1, cptr, cptr, double* z0, double* z1) {
+                tfcp::sin(n, x0, x1, z0, z1); },
+            [](cref x, cref) { return tfcp::sin(x); },
+            [](double x, double) { return std::sin(x); });
+    } else if (name == "tan") {
+        test_case(name, -1e3, 1e3,
+            [](size_t n, cptr x0, cptr x1, cptr, cptr, double* z0, double* z1) {
+                tfcp::tan(n, x0, x1, z0, z1); },
+            [](cref x, cref) { return tfcp::tan(x); },
+            [](double x, double) { return std::tan(x); });
+    } else if (name == "atan2") {
+        test_case(name, -1e3, 1e3,
+            [](size_t n, cptr y0, cptr y1, cptr x0, cptr x1, double* z0, double* z1) {
+                tfcp::atan2(n, y0, y1, x0, x1, z0, z1); },
+            [](cref y, cref x) { return tfcp::atan2(y, x); },
+            [](double y, double x) { return std::atan2(y, x); });
+    } else if (name == "asin") {
+        test_case(name, -1, 1,
+            [](size_t n, cptr x0, cptr x1, cptr, cptr, double* z0, double* z1) {
+                tfcp::asin(n, x0, x1, z0, z1); },
+            [](cref x, cref) { return tfcp::asin(x); },
+            [](double x, double) { return std::asin(x); });
+    } else if (name == "tanh") {
+        test_case(name, -20, 20,
+            [](size_t n, cptr x0, cptr x1, cptr, cptr, double* z0, double* z1) {
+                tfcp::tanh(n, x0, x1, z0, z1); },
+            [](cref x, cref) { return tfcp::tanh(x); },
+            [](double x, double) { return std::tanh(x); });
+    } else {
+        FAIL() << "unknown function: " << name;
+    }
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(functions, TestPerfElementary,
+                         Values("exp",
+                                "log",
+                                "pow",
+                                "sin",
+                                "tan",
+                                "atan2",
+                                "asin",
+                                "tanh"));
@@ -0,0 +1,125 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/fixedx.h>
+#include <tfcp/fixed.h>
+#include <tfcp/twofold.h>
+#include <tfcp/simd.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+// Gauss-Jordan inverse of n x n by rows, for size known at runtime
+template<typename S>
+void inverse_dynamic(size_t n, const S a[], S c[])
+{
+    S t[4 * 8];
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            t[i*2*n + j] = a[i*n + j];
+            t[i*2*n + n + j] = S(i == j ? 1.0 : 0.0);
+        }
+    }
+    for (size_t p = 0; p < n; p++)
+    {
+        S r = S(1.0) / t[p*2*n + p];
+        for (size_t j = 0; j < 2*n; j++)
+            t[p*2*n + j] = t[p*2*n + j] * r;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (i == p)
+                continue;
+            S f = t[i*2*n + p];
+            for (size_t j = 0; j < 2*n; j++)
+                t[i*2*n + j] = t[i*2*n + j] - f * t[p*2*n + j];
+        }
+    }
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+            c[i*n + j] = t[i*2*n + n + j];
+}
+
+//----------------------------------------------------------------------
+//
+// Inverse of 3x3: fixed.h over double, coupled<double>, and batches of
+// coupled<doublex>; versus Gauss-Jordan for size given at runtime
+//
+// Prints nanoseconds per matrix
+//
+//----------------------------------------------------------------------
+
+TEST(TestPerfFixed, perf) {
+    static constexpr size_t n = 1 << 16;
+    static constexpr int lenx = traitx<doublex>::length;
+
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dis(-1, 1);
+
+    std::vector<mat<3, 3, double>> a(n), c(n);
+    std::vector<mat<3, 3, pdouble>> p(n), q(n);
+    for (size_t k = 0; k < n; k++)
+    {
+        for (size_t i = 0; i < 3; i++)
+        {
+            for (size_t j = 0; j < 3; j++)
+            {
+                a[k][i][j] = dis(gen) + (i == j ? 3 : 0);
+                p[k][i][j] = pdouble(a[k][i][j], 0);
+            }
+        }
+    }
+
+    double ns_plain = measure(n, [&]() {
+        for (size_t k = 0; k < n; k++)
+            c[k] = inverse(a[k]);
+        return c[n / 2][1][1];
+    });
+
+    double ns_dynamic = measure(n, [&]() {
+        for (size_t k = 0; k < n; k++)
+            inverse_dynamic(3, &p[k][0][0], &q[k][0][0]);
+        return q[n / 2][1][1].value;
+    });
+
+    double ns_coupled = measure(n, [&]() {
+        for (size_t k = 0; k < n; k++)
+            q[k] = inverse(p[k]);
+        return q[n / 2][1][1].value;
+    });
+
+    double ns_batch = measure(n, [&]() {
+        for (size_t k = 0; k < n; k += lenx)
+        {
+            mat<3, 3, pdoublex> x;
+            loadx(x, &p[k]);
+            storex(&q[k], inverse(x));
+        }
+        return q[n / 2][1][1].value;
+    });
+
+    printf("PERF: 3x3 inverse ns/matrix: plain=%.1f coupled-dynamic=%.1f "
+           "coupled=%.1f coupled-batch(x%d)=%.1f\n",
+           ns_plain, ns_dynamic, ns_coupled, lenx, ns_batch);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
@@ -0,0 +1,113 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/twofoldx.h>
+#include <tfcp/twofold.h>
+#include <tfcp/simd.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+//----------------------------------------------------------------------
+//
+// Fused coupled operations versus same by operators, in update loops
+// over short vectors of pdoublex, like:
+//
+//   w = fma(x, y, w)  versus  w = x * y + w
+//
+// Arrays fit L1/L2 cache; prints nanoseconds per element, and speedup
+//
+//----------------------------------------------------------------------
+
+using OpName = std::string;
+
+class TestPerfFused : public TestWithParam<OpName> {
+protected:
+
+    // Nanoseconds per element of update loop by f
+    template<typename F>
+    static double measure_loop(F f)
+    {
+        static constexpr size_t n = 2048;
+        static constexpr int repeat = 4000;
+        using TX = doublex;
+        constexpr size_t lenx = traitx<TX>::length;
+
+        std::mt19937 gen;
+        std::uniform_real_distribution<double> dis(1, 2);
+
+        std::vector<double> a0[4], a1[4];
+        for (int k = 0; k < 4; k++)
+        {
+            a0[k].resize(n);
+            a1[k].resize(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                a0[k][i] = dis(gen);
+                a1[k][i] = dis(gen) * a0[k][i] / 100000000000000000.;
+            }
+        }
+
+        return measure_repeat(n, repeat, [&]() {
+            for (size_t i = 0; i < n; i += lenx) {
+                pdoublex x = loadx<pdoublex>(&a0[0][i], &a1[0][i]);
+                pdoublex y = loadx<pdoublex>(&a0[1][i], &a1[1][i]);
+                pdoublex w = loadx<pdoublex>(&a0[2][i], &a1[2][i]);
+                pdoublex d = loadx<pdoublex>(&a0[3][i], &a1[3][i]);
+                storex(&a0[2][i], &a1[2][i], f(x, y, w, d));
+            }
+        });
+    }
+};
+
+TEST_P(TestPerfFused, perf) {
+    auto op = GetParam();
+
+    using S = const pdoublex&;
+
+#define OP_CASE(F, FUSED, PLAIN)                                               \
+    if (op == #F) {                                                            \
+        double ns_plain = measure_loop([](S x, S y, S w, S d) { return PLAIN; }); \
+        double ns_fused = measure_loop([](S x, S y, S w, S d) { return FUSED; }); \
+        printf("PERF: op=%s lanes=%d ns/elem: operators=%.3f fused=%.3f "      \
+               "speedup=%.2fx\n", #F, int(traitx<doublex>::length),            \
+               ns_plain, ns_fused, ns_plain / ns_fused);                       \
+        return;                                                                \
+    }
+
+    OP_CASE(fma, fma(x, y, w), x * y + w);
+    OP_CASE(fms, fms(x, y, w), x * y - w);
+    OP_CASE(sum3, sum3(x, y, w), x + y + w);
+    OP_CASE(dot2, dot2(x, y, w, d), x * y + w * d);
+
+#undef OP_CASE
+
+    FAIL() << "unknown op: " << op;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(ops, TestPerfFused,
+                         Values("fma",
+                                "fms",
+                                "sum3",
+                                "dot2"));
@@ -0,0 +1,155 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/gemm.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/kernels.h>
+#include <tfcp/reduce.h>
+#include <tfcp/soa_vector.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+using TypeName = std::string;
+
+//----------------------------------------------------------------------
+//
+// Coupled gemm versus scalar triple loop by coupled operators, for the
+// square matrices n x n
+//
+// Prints nanoseconds per multiply-add, by one thread and by all threads
+//
+//----------------------------------------------------------------------
+
+class TestPerfGemm : public TestWithParam<TypeName> {
+protected:
+
+    template<typename T>
+    static void test_case(const char type[])
+    {
+        static constexpr size_t n = 512;
+
+        std::mt19937 gen;
+        std::uniform_real_distribution<T> dis(-1, 1);
+
+        soa_vector<coupled<T>> a(n * n), b(n * n), c(n * n);
+        for (size_t i = 0; i < n * n; i++)
+        {
+            a[i] = coupled<T>(dis(gen), 0);
+            b[i] = coupled<T>(dis(gen), 0);
+        }
+
+        std::vector<coupled<T>> x(n * n), y(n * n), z(n * n);
+        for (size_t i = 0; i < n * n; i++)
+        {
+            x[i] = a[i];
+            y[i] = b[i];
+        }
+
+        double ns_loop = measure(n * n * n, [&]() {
+            for (size_t i = 0; i < n; i++)
+                for (size_t j = 0; j < n; j++)
+                {
+                    coupled<T> s(0, 0);
+                    for (size_t p = 0; p < n; p++)
+                        s += x[i*n + p] * y[p*n + j];
+                    z[i*n + j] = s;
+                }
+        }, 3);
+
+        set_reduce_threads(1);
+        double ns_gemm = measure(n * n * n, [&]() { gemm(n, n, n, a, b, c); }, 3);
+
+        set_reduce_threads(0);
+        double ns_gemm_mt = measure(n * n * n, [&]() { gemm(n, n, n, a, b, c); }, 3);
+
+        printf("PERF: type=%s isa=%s n=%d ns/madd: loop=%.3f gemm=%.3f gemm(threads=%d)=%.3f speedup=%.1f\n",
+               type, isa_name(current_isa()), (int)n, ns_loop, ns_gemm,
+               reduce_threads(), ns_gemm_mt, ns_loop / ns_gemm);
+    }
+};
+
+TEST_P(TestPerfGemm, perf) {
+    auto type = GetParam();
+
+#define TYPE_CASE(T)            \
+    if (type == #T) {           \
+        test_case<T>(#T);       \
+        return;                 \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+//
+// Ozaki scheme gemm_accurate versus coupled gemm of same plain double
+// input, and versus one plain double product by the same kernel
+//
+// Prints nanoseconds per multiply-add, by one thread
+//
+//----------------------------------------------------------------------
+
+TEST(TestPerfGemmAccurate, perf) {
+    static constexpr size_t n = 512;
+
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dis(-1, 1);
+
+    std::vector<double> a(n * n), b(n * n), zero(n * n, 0), z(n * n);
+    for (size_t i = 0; i < n * n; i++)
+    {
+        a[i] = dis(gen);
+        b[i] = dis(gen);
+    }
+    soa_vector<coupled<double>> c(n * n);
+
+    set_reduce_threads(1);
+
+    double ns_plain = measure(n * n * n, [&]() {
+        current_kernels().d.gemm0(n, n, n, a.data(), n, b.data(), n, z.data(), n);
+    }, 3);
+
+    double ns_gemm = measure(n * n * n, [&]() {
+        gemm(n, n, n, a.data(), zero.data(), n, b.data(), zero.data(), n,
+             c.values().data(), c.errors().data(), n);
+    }, 3);
+
+    double ns_accurate = measure(n * n * n, [&]() { gemm_accurate(n, n, n, a, b, c); }, 3);
+
+    set_reduce_threads(0);
+
+    printf("PERF: type=double isa=%s n=%d ns/madd: plain=%.3f gemm=%.3f gemm_accurate=%.3f\n",
+           isa_name(current_isa()), (int)n, ns_plain, ns_gemm, ns_accurate);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(types, TestPerfGemm,
+                         Values("float",
+                                "double"));
@@ -0,0 +1,128 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/lazy.h>
+#include <tfcp/twofoldx.h>
+#include <tfcp/twofold.h>
+#include <tfcp/simd.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+//----------------------------------------------------------------------
+//
+// lazy_coupled versus coupled, for long chains of operations over
+// arrays, which fit L1/L2 cache:
+// - dot:    s += x[k] * y[k], accumulating coupled x and y
+// - horner: p = p * t + x[k], for plain t
+//
+// Each by scalar double, and by short-vector doublex; prints ns per
+// element, and speedup
+//
+//----------------------------------------------------------------------
+
+using ChainOp = std::string;
+
+class TestPerfLazy : public TestWithParam<ChainOp> {
+protected:
+
+    // Chain over n elements, repeated; S is arithmetic, C is coupled
+    template<typename S, typename C, typename P>
+    static double run(const std::string& op, size_t n, int repeat,
+                      const double x0[], const double x1[],
+                      const double y0[], const double y1[], P t)
+    {
+        using TX = decltype(C::value);
+        constexpr size_t lenx = traitx<TX>::length;
+        bool dot = op == "dot";
+        double sum = 0;
+        for (int r = 0; r < repeat; r++)
+        {
+            S s = C(0.);
+            for (size_t k = 0; k < n; k += lenx)
+            {
+                C x(loadx<TX>(&x0[k]), loadx<TX>(&x1[k]));
+                if (dot) {
+                    C y(loadx<TX>(&y0[k]), loadx<TX>(&y1[k]));
+                    s += S(x) * S(y);
+                } else {
+                    s = s * t + x;
+                }
+            }
+            C z = s;
+            sum += getx(z.value, 0);
+        }
+        return sum;
+    }
+};
+
+TEST_P(TestPerfLazy, perf) {
+    static constexpr size_t n = 2048;
+    static constexpr int repeat = 2000;
+    auto op = GetParam();
+
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dis(1, 2);
+
+    std::vector<double> x0(n), x1(n), y0(n), y1(n);
+    for (size_t k = 0; k < n; k++)
+    {
+        x0[k] = dis(gen);
+        y0[k] = dis(gen);
+        x1[k] = x0[k] * dis(gen) / 100000000000000000.;
+        y1[k] = y0[k] * dis(gen) / 100000000000000000.;
+    }
+
+    double t = 0.5;
+    doublex tx = setallx<doublex>(t);
+
+    auto ns = [&](double (*f)(const std::string&, size_t, int, const double*,
+                              const double*, const double*, const double*,
+                              double)) {
+        return measure(n * repeat, [&]() {
+            return f(op, n, repeat, x0.data(), x1.data(), y0.data(), y1.data(), t);
+        });
+    };
+    auto nsx = [&](double (*f)(const std::string&, size_t, int, const double*,
+                               const double*, const double*, const double*,
+                               doublex)) {
+        return measure(n * repeat, [&]() {
+            return f(op, n, repeat, x0.data(), x1.data(), y0.data(), y1.data(), tx);
+        });
+    };
+
+    double ns_coupled  =  ns(run<pdouble,  pdouble,  double>);
+    double ns_lazy     =  ns(run<ldouble,  pdouble,  double>);
+    double ns_coupledx = nsx(run<pdoublex, pdoublex, doublex>);
+    double ns_lazyx    = nsx(run<ldoublex, pdoublex, doublex>);
+
+    printf("PERF: op=%s ns/elem: double: coupled=%.3f lazy=%.3f speedup=%.2fx "
+           "doublex: coupled=%.3f lazy=%.3f speedup=%.2fx\n", op.c_str(),
+           ns_coupled, ns_lazy, ns_coupled / ns_lazy,
+           ns_coupledx, ns_lazyx, ns_coupledx / ns_lazyx);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(ops, TestPerfLazy,
+                         Values("dot",
+                                "horner"));
@@ -0,0 +1,107 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/lu.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+// Gaussian elimination with partial pivoting in long double
+void solve_long(size_t n, std::vector<long double> a, std::vector<long double>& x)
+{
+    for (size_t j = 0; j < n; j++)
+    {
+        size_t p = j;
+        for (size_t i = j + 1; i < n; i++)
+            if (std::fabs(a[i*n + j]) > std::fabs(a[p*n + j]))
+                p = i;
+        std::swap_ranges(&a[j*n], &a[j*n] + n, &a[p*n]);
+        std::swap(x[j], x[p]);
+        for (size_t i = j + 1; i < n; i++)
+        {
+            long double l = a[i*n + j] / a[j*n + j];
+            for (size_t c = j + 1; c < n; c++)
+                a[i*n + c] -= l * a[j*n + c];
+            x[i] -= l * x[j];
+        }
+    }
+    for (size_t i = n; i-- > 0;)
+    {
+        long double s = x[i];
+        for (size_t j = i + 1; j < n; j++)
+            s -= a[i*n + j] * x[j];
+        x[i] = s / a[i*n + i];
+    }
+}
+
+//----------------------------------------------------------------------
+//
+// solve_refined() versus plain double LU alone, and versus Gaussian
+// elimination in long double
+//
+// Prints milliseconds, by one thread
+//
+//----------------------------------------------------------------------
+
+TEST(TestPerfLu, perf) {
+    static constexpr size_t n = 1024;
+
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dis(-1, 1);
+
+    std::vector<double> a(n * n), b(n), x0(n), x1(n);
+    for (size_t i = 0; i < n * n; i++)
+        a[i] = dis(gen);
+    for (size_t i = 0; i < n; i++)
+        b[i] = dis(gen);
+
+    set_reduce_threads(1);
+
+    std::vector<double> lu(n * n);
+    std::vector<size_t> piv(n);
+    double ms_lu = measure_ms([&]() {
+        lu = a;
+        lu_factor(n, lu.data(), n, piv.data());
+    });
+
+    int steps = 0;
+    double ms_refined = measure_ms([&]() {
+        steps = solve_refined(n, a.data(), n, b.data(), x0.data(), x1.data());
+    });
+
+    std::vector<long double> al(a.begin(), a.end()), xl;
+    double ms_long = measure_ms([&]() {
+        xl.assign(b.begin(), b.end());
+        solve_long(n, al, xl);
+    });
+
+    set_reduce_threads(0);
+
+    printf("PERF: isa=%s n=%d ms: lu=%.1f refined=%.1f (steps=%d) long=%.1f\n",
+           isa_name(current_isa()), (int)n, ms_lu, ms_refined, steps, ms_long);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
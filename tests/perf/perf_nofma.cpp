@@ -0,0 +1,148 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/batch.h>
+#include <tfcp/dispatch.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+//----------------------------------------------------------------------
+//
+// Cost of exact products without FMA: Dekker-Veltkamp versus FMA
+//
+// Compare batch kernels for same vector width: AVX (no FMA) versus AVX2
+// (with FMA); and SSE2 (no FMA, half width) for the reference
+//
+// Prints nanoseconds per element, and slowdown versus AVX2
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using   OpName = std::string;
+
+using Params = typename std::tuple<TypeName, OpName>;
+
+class TestPerfNofma : public TestWithParam<Params> {
+protected:
+
+    // Nanoseconds per element of batch function b
+    template<typename T, typename B>
+    static double measure_batch(B b)
+    {
+        static constexpr size_t n = 4096;  // fits L1/L2 cache
+        static constexpr int repeat = 2000;
+
+        std::mt19937 gen;
+        std::uniform_real_distribution<T> dis(1, 2);
+
+        std::vector<T> x0(n), x1(n), y0(n), y1(n), z0(n), z1(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            x0[i] = dis(gen);
+            x1[i] = dis(gen) * x0[i] / 100000000;
+            y0[i] = dis(gen);
+            y1[i] = dis(gen) * y0[i] / 100000000;
+        }
+
+        return measure_repeat(n, repeat, [&]() {
+            b(n, x0.data(), x1.data(), y0.data(), y1.data(),
+                 z0.data(), z1.data());
+        });
+    }
+
+    template<typename T, typename B>
+    static void test_case(const char type[], const char op[], B b)
+    {
+        isa saved = current_isa();
+
+        double base = 0;
+        if (select_isa(isa::avx2))
+            base = measure_batch<T>(b);
+
+        for (isa target : { isa::sse2, isa::avx, isa::avx2, isa::avx512 })
+        {
+            if (!select_isa(target))
+                continue;
+            double ns = measure_batch<T>(b);
+            if (base > 0)
+                printf("PERF: type=%s op=%s isa=%-6s ns/elem=%.3f vs_avx2=%.2fx\n",
+                       type, op, isa_name(target), ns, ns / base);
+            else
+                printf("PERF: type=%s op=%s isa=%-6s ns/elem=%.3f\n",
+                       type, op, isa_name(target), ns);
+        }
+
+        select_isa(saved);
+    }
+};
+
+TEST_P(TestPerfNofma, perf) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto op    = std::get<1>(param);
+
+#define OP_CASE(T, F)                                                          \
+    if (op == #F) {                                                            \
+        test_case<T>(#T, #F,                                                   \
+            [](size_t n, const T* x0, const T* x1, const T* y0, const T* y1,   \
+                         T* z0, T* z1) { batch::F(n, x0, x1, y0, y1, z0, z1); }); \
+        return;                                                                \
+    }
+
+#define SQRT_CASE(T, F)                                                        \
+    if (op == #F) {                                                            \
+        test_case<T>(#T, #F,                                                   \
+            [](size_t n, const T* x0, const T* x1, const T* y0, const T* y1,   \
+                         T* z0, T* z1) { batch::F(n, x0, x1, z0, z1); });      \
+        return;                                                                \
+    }
+
+#define TYPE_CASE(T)                        \
+    if (type == #T) {                       \
+        OP_CASE(T, tmul);                   \
+        OP_CASE(T, pmul);                   \
+        OP_CASE(T, pdiv);                   \
+        SQRT_CASE(T, psqrt);                \
+        FAIL() << "unknown op: " << op;     \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+#undef SQRT_CASE
+#undef OP_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndOps, TestPerfNofma,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("tmul",
+                                        "pmul",
+                                        "pdiv",
+                                        "psqrt")));
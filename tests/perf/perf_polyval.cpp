@@ -0,0 +1,141 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/polyval.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_quad.h>
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+//----------------------------------------------------------------------
+//
+// polyval() and polyval_estrin() versus plain Horner in double, Horner
+// by coupled<double> operators, and Horner in __float128, for the same
+// polynomials of several degrees at many x
+//
+// Prints nanoseconds per x; quad=-1 if no __float128
+//
+//----------------------------------------------------------------------
+
+using Degree = int;
+
+class TestPerfPolyval : public TestWithParam<Degree> {};
+
+TEST_P(TestPerfPolyval, perf) {
+    static constexpr size_t m = 1 << 20;
+    size_t n = GetParam() + 1;
+
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dis(-1, 1);
+
+    std::vector<double> c(n), x(m), z0(m), z1(m);
+    for (auto& ci : c)
+        ci = dis(gen);
+    for (auto& xk : x)
+        xk = dis(gen);
+
+    double ns_plain = measure(m, [&]() {
+        double sum = 0;
+        for (size_t k = 0; k < m; k++)
+        {
+            double p = c[n - 1];
+            for (size_t i = n - 1; i-- > 0;)
+                p = p * x[k] + c[i];
+            sum += p;
+        }
+        return sum;
+    });
+
+    double ns_coupled = measure(m, [&]() {
+        double sum = 0;
+        for (size_t k = 0; k < m; k++)
+        {
+            coupled<double> p(c[n - 1]);
+            for (size_t i = n - 1; i-- > 0;)
+                p = p * x[k] + c[i];
+            sum += p.value;
+        }
+        return sum;
+    });
+
+    double ns_single = measure(m, [&]() {
+        double sum = 0;
+        for (size_t k = 0; k < m; k++)
+            sum += polyval(n, c.data(), x[k]).value;
+        return sum;
+    });
+
+    double ns_single_estrin = measure(m, [&]() {
+        double sum = 0;
+        for (size_t k = 0; k < m; k++)
+            sum += polyval_estrin(n, c.data(), x[k]).value;
+        return sum;
+    });
+
+    set_reduce_threads(1);
+    double ns_horner = measure(m, [&]() {
+        polyval(n, c.data(), m, x.data(), z0.data(), z1.data());
+        return z0[m / 2];
+    });
+    double ns_estrin = measure(m, [&]() {
+        polyval_estrin(n, c.data(), m, x.data(), z0.data(), z1.data());
+        return z0[m / 2];
+    });
+
+    set_reduce_threads(0);
+    double ns_horner_mt = measure(m, [&]() {
+        polyval(n, c.data(), m, x.data(), z0.data(), z1.data());
+        return z0[m / 2];
+    });
+
+#if defined(TFCP_TEST_QUAD)
+    // Fewer elements, as much slower
+    using tfcp_test::quad;
+    double ns_quad = measure(m / 16, [&]() {
+        quad sum = 0;
+        for (size_t k = 0; k < m / 16; k++)
+        {
+            quad p = c[n - 1];
+            for (size_t i = n - 1; i-- > 0;)
+                p = p * x[k] + c[i];
+            sum += p;
+        }
+        return static_cast<double>(sum);
+    });
+#else
+    double ns_quad = -1;
+#endif
+
+    printf("PERF: isa=%s degree=%d ns/x: plain=%.2f coupled=%.2f single: horner=%.2f "
+           "estrin=%.2f batch: horner=%.2f estrin=%.2f horner(threads=%d)=%.2f "
+           "quad=%.2f\n", isa_name(current_isa()), (int)n - 1, ns_plain, ns_coupled,
+           ns_single, ns_single_estrin, ns_horner, ns_estrin, reduce_threads(),
+           ns_horner_mt, ns_quad);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(degrees, TestPerfPolyval,
+                         Values(4, 8, 16, 32));
@@ -0,0 +1,126 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/predicates.h>
+#include <tfcp/reduce.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+using PredicateName = std::string;
+
+//----------------------------------------------------------------------
+//
+// Adaptive orient2d and incircle versus plain double, which may return
+// wrong sign: by random points, where twofold filter decides all; and
+// by points of a small grid, where most queries are degenerate, so go
+// to the exact evaluation
+//
+// Prints nanoseconds per query
+//
+//----------------------------------------------------------------------
+
+double plain_orient2d(const double a[], const double b[], const double c[])
+{
+    return (a[0] - c[0]) * (b[1] - c[1]) - (a[1] - c[1]) * (b[0] - c[0]);
+}
+
+double plain_incircle(const double a[], const double b[], const double c[], const double d[])
+{
+    double adx = a[0] - d[0], ady = a[1] - d[1];
+    double bdx = b[0] - d[0], bdy = b[1] - d[1];
+    double cdx = c[0] - d[0], cdy = c[1] - d[1];
+    return (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy) +
+           (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy) +
+           (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+}
+
+class TestPerfPredicates : public TestWithParam<PredicateName> {
+protected:
+
+    static void test_case(const char name[], bool grid)
+    {
+        static constexpr size_t n = 1 << 20;
+
+        std::mt19937 gen;
+        std::uniform_real_distribution<double> dis(-1, 1);
+        std::uniform_int_distribution<int> cell(0, 3);
+
+        std::vector<double> p[4];
+        for (auto& v : p)
+        {
+            v.resize(2 * n);
+            for (auto& x : v)
+                x = grid ? 0.125 * cell(gen) : dis(gen);
+        }
+        std::vector<int> s(n);
+
+        bool incircle_case = std::string(name) == "incircle";
+
+        double ns_plain = measure(n, [&]() {
+            int sum = 0;
+            for (size_t k = 0; k < n; k++)
+            {
+                double det = incircle_case ?
+                    plain_incircle(&p[0][2*k], &p[1][2*k], &p[2][2*k], &p[3][2*k]) :
+                    plain_orient2d(&p[0][2*k], &p[1][2*k], &p[2][2*k]);
+                sum += det > 0 ? 1 : det < 0 ? -1 : 0;
+            }
+            return double(sum);
+        });
+
+        double ns_adapt = measure(n, [&]() {
+            int sum = 0;
+            for (size_t k = 0; k < n; k++)
+            {
+                sum += incircle_case ?
+                    incircle(&p[0][2*k], &p[1][2*k], &p[2][2*k], &p[3][2*k]) :
+                    orient2d(&p[0][2*k], &p[1][2*k], &p[2][2*k]);
+            }
+            return double(sum);
+        });
+
+        set_reduce_threads(0);
+        double ns_batch = measure(n, [&]() {
+            if (incircle_case)
+                incircle(n, p[0].data(), p[1].data(), p[2].data(), p[3].data(), s.data());
+            else
+                orient2d(n, p[0].data(), p[1].data(), p[2].data(), s.data());
+            return double(s[n / 2]);
+        });
+
+        printf("PERF: predicate=%s points=%s ns/query: plain=%.2f adaptive=%.2f batch(threads=%d)=%.2f\n",
+               name, grid ? "grid" : "random", ns_plain, ns_adapt, reduce_threads(), ns_batch);
+    }
+};
+
+TEST_P(TestPerfPredicates, perf) {
+    auto name = GetParam();
+    test_case(name.c_str(), false);
+    test_case(name.c_str(), true);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(predicates, TestPerfPredicates,
+                         Values("orient2d",
+                                "incircle"));
@@ -0,0 +1,143 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/qr.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+#if defined(__SIZEOF_FLOAT128__)
+
+using quad = __float128;
+
+// Square root by Newton steps from double, as no libquadmath here
+quad sqrt_quad(quad x)
+{
+    quad y = std::sqrt(static_cast<double>(x));
+    if (y == 0)
+        return y;
+    y = (y + x / y) / 2;
+    y = (y + x / y) / 2;
+    return y;
+}
+
+// Unblocked Householder least squares in __float128, m >= n
+void least_squares_quad(size_t m, size_t n, std::vector<quad> a, std::vector<quad> b,
+                        std::vector<quad>& x)
+{
+    for (size_t j = 0; j < n; j++)
+    {
+        quad s = 0;
+        for (size_t i = j + 1; i < m; i++)
+            s += a[i*n + j] * a[i*n + j];
+        if (s == 0)
+            continue;
+        quad alpha = a[j*n + j];
+        quad beta = sqrt_quad(alpha * alpha + s);
+        if (alpha > 0)
+            beta = -beta;
+        quad tau = (beta - alpha) / beta;
+        quad scale = alpha - beta;
+        for (size_t i = j + 1; i < m; i++)
+            a[i*n + j] /= scale;
+        a[j*n + j] = beta;
+
+        for (size_t c = j + 1; c <= n; c++)
+        {
+            quad* col = c < n ? &a[c] : b.data();
+            size_t ld = c < n ? n : 1;
+            quad w = col[j*ld];
+            for (size_t i = j + 1; i < m; i++)
+                w += a[i*n + j] * col[i*ld];
+            w *= tau;
+            col[j*ld] -= w;
+            for (size_t i = j + 1; i < m; i++)
+                col[i*ld] -= w * a[i*n + j];
+        }
+    }
+    x.resize(n);
+    for (size_t i = n; i-- > 0;)
+    {
+        quad s = b[i];
+        for (size_t j = i + 1; j < n; j++)
+            s -= a[i*n + j] * x[j];
+        x[i] = s / a[i*n + i];
+    }
+}
+
+#endif
+
+//----------------------------------------------------------------------
+//
+// least_squares() in coupled double versus unblocked Householder in
+// __float128 (if compiler has it), which is software emulated
+//
+// Prints milliseconds, by one thread and by all threads
+//
+//----------------------------------------------------------------------
+
+TEST(TestPerfQr, perf) {
+    static constexpr size_t m = 768;
+    static constexpr size_t n = 256;
+
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dis(-1, 1);
+
+    std::vector<double> a0(m * n), a1(m * n, 0), b0(m), b1(m, 0), x0(n), x1(n);
+    for (size_t i = 0; i < m * n; i++)
+        a0[i] = dis(gen);
+    for (size_t i = 0; i < m; i++)
+        b0[i] = dis(gen);
+
+    auto solve = [&]() {
+        least_squares(m, n, a0.data(), a1.data(), n, b0.data(), b1.data(),
+                      x0.data(), x1.data());
+    };
+
+    set_reduce_threads(1);
+    double ms_coupled = measure_ms(solve);
+
+    set_reduce_threads(0);
+    double ms_coupled_mt = measure_ms(solve);
+
+#if defined(__SIZEOF_FLOAT128__)
+    std::vector<quad> aq(a0.begin(), a0.end()), bq(b0.begin(), b0.end()), xq;
+    double ms_quad = measure_ms([&]() { least_squares_quad(m, n, aq, bq, xq); });
+
+    double diff = 0;
+    for (size_t j = 0; j < n; j++)
+        diff = std::max(diff, std::fabs(static_cast<double>(xq[j] - x0[j] - x1[j])));
+
+    printf("PERF: isa=%s m=%d n=%d ms: coupled=%.1f coupled(threads=%d)=%.1f quad=%.1f (diff=%.1e)\n",
+           isa_name(current_isa()), (int)m, (int)n, ms_coupled, reduce_threads(),
+           ms_coupled_mt, ms_quad, diff);
+#else
+    printf("PERF: isa=%s m=%d n=%d ms: coupled=%.1f coupled(threads=%d)=%.1f quad=n/a\n",
+           isa_name(current_isa()), (int)m, (int)n, ms_coupled, reduce_threads(),
+           ms_coupled_mt);
+#endif
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
@@ -0,0 +1,200 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/reduce.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+using TypeName = std::string;
+
+//----------------------------------------------------------------------
+//
+// Sum2 versus loops: plain T, and coupled<T> operator +=; and versus
+// the reproducible rsum
+//
+// Prints gigabytes per second, versus bandwidth of memcpy (which reads
+// and writes, so counts twice the bytes)
+//
+//----------------------------------------------------------------------
+
+class TestPerfReduceSum : public TestWithParam<TypeName> {
+protected:
+
+    template<typename T>
+    static void test_case(const char type[])
+    {
+        static constexpr size_t n = 1 << 25;
+
+        std::mt19937 gen;
+        std::uniform_real_distribution<T> dis(-1, 1);
+
+        std::vector<T> x(n), y(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] = dis(gen);
+        }
+
+        double ns_copy = measure(n, [&]() {
+            std::memcpy(y.data(), x.data(), n * sizeof(T));
+            return double(y[n / 2]);
+        });
+
+        double ns_plain = measure(n, [&]() {
+            T s = 0;
+            for (size_t i = 0; i < n; i++)
+                s += x[i];
+            return double(s);
+        });
+
+        double ns_coupled = measure(n, [&]() {
+            coupled<T> s(0, 0);
+            for (size_t i = 0; i < n; i++)
+                s += x[i];
+            return double(s.value);
+        });
+
+        set_reduce_threads(1);
+        double ns_sum = measure(n, [&]() { return double(sum(x).value); });
+
+        double ns_rsum = measure(n, [&]() { return double(rsum(x).value); });
+
+        set_reduce_threads(0);
+        double ns_sum_mt = measure(n, [&]() { return double(sum(x).value); });
+        double ns_rsum_mt = measure(n, [&]() { return double(rsum(x).value); });
+
+        // bytes per nanosecond is gigabytes per second
+        double bytes = sizeof(T);
+        printf("PERF: type=%s isa=%s GB/s: memcpy=%.2f plain=%.2f coupled=%.2f sum=%.2f rsum=%.2f\n",
+               type, isa_name(current_isa()), 2 * bytes / ns_copy, bytes / ns_plain,
+               bytes / ns_coupled, bytes / ns_sum, bytes / ns_rsum);
+        printf("PERF: type=%s isa=%s GB/s: sum(threads=%d)=%.2f rsum(threads=%d)=%.2f\n",
+               type, isa_name(current_isa()), reduce_threads(), bytes / ns_sum_mt,
+               reduce_threads(), bytes / ns_rsum_mt);
+    }
+};
+
+TEST_P(TestPerfReduceSum, perf) {
+    auto type = GetParam();
+
+#define TYPE_CASE(T)            \
+    if (type == #T) {           \
+        test_case<T>(#T);       \
+        return;                 \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+//
+// Dot2 versus loops: plain T, long double, and coupled<T> operators
+//
+// Prints nanoseconds per element, by one thread and by all threads
+//
+//----------------------------------------------------------------------
+
+class TestPerfReduceDot : public TestWithParam<TypeName> {
+protected:
+
+    template<typename T>
+    static void test_case(const char type[])
+    {
+        static constexpr size_t n = 1 << 24;
+
+        std::mt19937 gen;
+        std::uniform_real_distribution<T> dis(-1, 1);
+
+        std::vector<T> x(n), y(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] = dis(gen);
+            y[i] = dis(gen);
+        }
+
+        double ns_plain = measure(n, [&]() {
+            T s = 0;
+            for (size_t i = 0; i < n; i++)
+                s += x[i] * y[i];
+            return double(s);
+        });
+
+        double ns_long = measure(n, [&]() {
+            long double s = 0;
+            for (size_t i = 0; i < n; i++)
+                s += (long double)x[i] * y[i];
+            return double(s);
+        });
+
+        double ns_coupled = measure(n, [&]() {
+            coupled<T> s(0, 0);
+            for (size_t i = 0; i < n; i++)
+                s += coupled<T>(x[i], 0) * y[i];
+            return double(s.value);
+        });
+
+        set_reduce_threads(1);
+        double ns_dot2 = measure(n, [&]() { return double(dot2(x, y).value); });
+
+        set_reduce_threads(0);
+        double ns_dot2_mt = measure(n, [&]() { return double(dot2(x, y).value); });
+
+        printf("PERF: type=%s isa=%s ns/elem: plain=%.3f long=%.3f coupled=%.3f dot2=%.3f dot2(threads=%d)=%.3f\n",
+               type, isa_name(current_isa()), ns_plain, ns_long, ns_coupled,
+               ns_dot2, reduce_threads(), ns_dot2_mt);
+    }
+};
+
+TEST_P(TestPerfReduceDot, perf) {
+    auto type = GetParam();
+
+#define TYPE_CASE(T)            \
+    if (type == #T) {           \
+        test_case<T>(#T);       \
+        return;                 \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(types, TestPerfReduceSum,
+                         Values("float",
+                                "double"));
+
+INSTANTIATE_TEST_SUITE_P(types, TestPerfReduceDot,
+                         Values("float",
+                                "double"));
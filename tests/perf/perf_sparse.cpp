@@ -0,0 +1,183 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/sparse.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+// 2D diffusion by 5-point stencil on g x g grid, with coefficient that
+// jumps by 1e4 between checkerboard cells of 8 x 8
+csr_matrix<double> grid(size_t g)
+{
+    csr_matrix<double> a;
+    a.rows = a.cols = g * g;
+    a.ptr.push_back(0);
+    auto coef = [&](size_t i, size_t j) {
+        return ((i / 8 + j / 8) % 2) ? 1e4 : 1.0;
+    };
+    for (size_t i = 0; i < g; i++)
+    {
+        for (size_t j = 0; j < g; j++)
+        {
+            double diag = 0;
+            const size_t ni[] = { i - 1, i + 1, i, i };
+            const size_t nj[] = { j, j, j - 1, j + 1 };
+            for (int k = 0; k < 4; k++)
+            {
+                bool in = ni[k] < g && nj[k] < g;
+                double w = (coef(i, j) + (in ? coef(ni[k], nj[k]) : coef(i, j))) / 2;
+                diag += w;
+                if (in)
+                {
+                    a.col.push_back(ni[k]*g + nj[k]);
+                    a.val.push_back(-w);
+                }
+            }
+            a.col.push_back(i*g + j);
+            a.val.push_back(diag);
+            a.ptr.push_back(a.col.size());
+        }
+    }
+    return a;
+}
+
+void spmv_plain(const csr_matrix<double>& a, const double x[], double y[])
+{
+    for (size_t i = 0; i < a.rows; i++)
+    {
+        double s = 0;
+        for (size_t k = a.ptr[i]; k < a.ptr[i + 1]; k++)
+            s += a.val[k] * x[a.col[k]];
+        y[i] = s;
+    }
+}
+
+// Textbook CG in plain double, same stopping rule as cg()
+int cg_plain(const csr_matrix<double>& a, const double b[], double x[],
+             double tol, int max_iter)
+{
+    size_t n = a.rows;
+    std::vector<double> r(n), p(n), q(n);
+    auto dot = [&](const double u[], const double v[]) {
+        double s = 0;
+        for (size_t i = 0; i < n; i++)
+            s += u[i] * v[i];
+        return s;
+    };
+    double limit = tol * std::sqrt(dot(b, b));
+    spmv_plain(a, x, q.data());
+    for (size_t i = 0; i < n; i++)
+        p[i] = r[i] = b[i] - q[i];
+    double rr = dot(r.data(), r.data());
+    for (int iter = 1; iter <= max_iter; iter++)
+    {
+        spmv_plain(a, p.data(), q.data());
+        double alpha = rr / dot(p.data(), q.data());
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+        }
+        double rr_next = dot(r.data(), r.data());
+        if (std::sqrt(rr_next) <= limit)
+            return iter;
+        for (size_t i = 0; i < n; i++)
+            p[i] = r[i] + rr_next / rr * p[i];
+        rr = rr_next;
+    }
+    return -1;
+}
+
+// True residual |b - a*x| / |b| by coupled arithmetic
+double residual(const csr_matrix<double>& a, const double b[], const double x[])
+{
+    size_t n = a.rows;
+    std::vector<double> y0(n), y1(n);
+    spmv(a, x, y0.data(), y1.data());
+    double rr = 0, bb = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        double r = (b[i] - y0[i]) - y1[i];
+        rr += r * r;
+        bb += b[i] * b[i];
+    }
+    return std::sqrt(rr / bb);
+}
+
+//----------------------------------------------------------------------
+//
+// spmv() versus plain double loop, nanoseconds per nonzero; and cg()
+// versus plain double CG on stiff diffusion, iterations, milliseconds,
+// and true relative residual reached
+//
+//----------------------------------------------------------------------
+
+TEST(TestPerfSparse, perf) {
+    static constexpr size_t g = 300;
+    static constexpr double tol = 1e-10;
+
+    csr_matrix<double> a = grid(g);
+    size_t n = a.rows, nnz = a.ptr[n];
+
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dis(-1, 1);
+    std::vector<double> x(n), y0(n), y1(n), b(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = dis(gen);
+        b[i] = dis(gen);
+    }
+
+    set_reduce_threads(1);
+
+    double ns_plain = measure(nnz, [&]() { spmv_plain(a, x.data(), y0.data()); }, 3);
+    double ns_spmv = measure(nnz, [&]() { spmv(a, x.data(), y0.data(), y1.data()); }, 3);
+
+    int iters_plain = 0, iters_cg = 0;
+    std::vector<double> xp(n), xc(n);
+    double ms_plain = measure_ms([&]() {
+        std::fill(xp.begin(), xp.end(), 0.0);
+        iters_plain = cg_plain(a, b.data(), xp.data(), tol, 20000);
+    });
+    double ms_cg = measure_ms([&]() {
+        std::fill(xc.begin(), xc.end(), 0.0);
+        iters_cg = cg(a, b.data(), xc.data(), tol, 20000);
+    });
+
+    set_reduce_threads(0);
+
+    double ns_spmv_mt = measure(nnz, [&]() { spmv(a, x.data(), y0.data(), y1.data()); }, 3);
+
+    printf("PERF: isa=%s nnz=%d ns/nonzero: plain=%.2f spmv=%.2f spmv(threads=%d)=%.2f\n",
+           isa_name(current_isa()), (int)nnz, ns_plain, ns_spmv, reduce_threads(), ns_spmv_mt);
+    printf("PERF: isa=%s n=%d cg: plain=%.1f ms (iters=%d residual=%.1e) "
+           "coupled=%.1f ms (iters=%d residual=%.1e)\n",
+           isa_name(current_isa()), (int)n, ms_plain, iters_plain,
+           residual(a, b.data(), xp.data()), ms_cg, iters_cg,
+           residual(a, b.data(), xc.data()));
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
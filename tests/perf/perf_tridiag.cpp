@@ -0,0 +1,116 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/tridiag.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_perf.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using namespace tfcp_test;
+
+//----------------------------------------------------------------------
+//
+// tridiag_solve() versus scalar Thomas loops over same interleaved
+// layout: in plain double, and by coupled<double> operators
+//
+// Prints nanoseconds per equation, by one thread and by all threads
+//
+//----------------------------------------------------------------------
+
+TEST(TestPerfTridiag, perf) {
+    static constexpr size_t n = 64;
+    static constexpr size_t batch = 1 << 14;
+    static constexpr size_t len = n * batch;
+
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dis(-1, 1);
+
+    std::vector<double> a(len), b(len), c(len), d(len), x0(len), x1(len);
+    for (size_t k = 0; k < len; k++)
+    {
+        a[k] = dis(gen);
+        c[k] = dis(gen);
+        b[k] = 2 + std::fabs(dis(gen));
+        d[k] = dis(gen);
+    }
+
+    double ns_plain = measure(len, [&]() {
+        std::vector<double> cp(n);
+        for (size_t s = 0; s < batch; s++)
+        {
+            cp[0] = c[s] / b[s];
+            x0[s] = d[s] / b[s];
+            for (size_t i = 1; i < n; i++)
+            {
+                size_t k = i*batch + s;
+                double m = b[k] - a[k] * cp[i - 1];
+                cp[i] = c[k] / m;
+                x0[k] = (d[k] - a[k] * x0[k - batch]) / m;
+            }
+            for (size_t i = n - 1; i-- > 0;)
+                x0[i*batch + s] -= cp[i] * x0[(i + 1)*batch + s];
+        }
+    });
+
+    double ns_coupled = measure(len, [&]() {
+        std::vector<coupled<double>> cp(n), x(n);
+        for (size_t s = 0; s < batch; s++)
+        {
+            coupled<double> b0(b[s], 0);
+            cp[0] = coupled<double>(c[s], 0) / b0;
+            x[0] = coupled<double>(d[s], 0) / b0;
+            for (size_t i = 1; i < n; i++)
+            {
+                size_t k = i*batch + s;
+                coupled<double> m = coupled<double>(b[k], 0) - cp[i - 1] * a[k];
+                cp[i] = coupled<double>(c[k], 0) / m;
+                x[i] = (coupled<double>(d[k], 0) - x[i - 1] * a[k]) / m;
+            }
+            for (size_t i = n - 1; i-- > 0;)
+                x[i] -= cp[i] * x[i + 1];
+            for (size_t i = 0; i < n; i++)
+            {
+                x0[i*batch + s] = x[i].value;
+                x1[i*batch + s] = x[i].error;
+            }
+        }
+    });
+
+    auto solve = [&]() {
+        tridiag_solve(n, batch, a.data(), b.data(), c.data(), d.data(),
+                      x0.data(), x1.data());
+    };
+
+    set_reduce_threads(1);
+    double ns_solve = measure(len, solve);
+
+    set_reduce_threads(0);
+    double ns_solve_mt = measure(len, solve);
+
+    printf("PERF: isa=%s n=%d batch=%d ns/equation: plain=%.2f coupled=%.2f "
+           "tridiag=%.2f tridiag(threads=%d)=%.2f\n",
+           isa_name(current_isa()), (int)n, (int)batch, ns_plain, ns_coupled,
+           ns_solve, reduce_threads(), ns_solve_mt);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
@@ -0,0 +1,55 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+// Only the public include path is given to this test, so each header
+// below must not reach src/include, directly or via other headers
+
+#include <tfcp/lazy.h>
+
+#include <tfcp/batch.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/elementary.h>
+#include <tfcp/elementaryx.h>
+#include <tfcp/fixed.h>
+#include <tfcp/fixedx.h>
+#include <tfcp/gemm.h>
+#include <tfcp/lu.h>
+#include <tfcp/polyval.h>
+#include <tfcp/predicates.h>
+#include <tfcp/qr.h>
+#include <tfcp/reduce.h>
+#include <tfcp/soa_vector.h>
+#include <tfcp/sparse.h>
+#include <tfcp/tridiag.h>
+#include <tfcp/twofoldx.h>
+#include <tfcp/twofold.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace {
+
+using namespace tfcp;
+
+//----------------------------------------------------------------------
+//
+// Smoke test of lazy_coupled: error term survives until renormalized
+//
+//----------------------------------------------------------------------
+
+TEST(TestPublicLazy, smoke)
+{
+    double tiny = std::ldexp(1.0, -80);
+
+    ldouble x(1.0, tiny, 1);  // not renormalized
+    ldouble y = x + 1.0;
+
+    coupled<double> z = coupled<double>(y);
+    EXPECT_EQ(z.value, 2.0);
+    EXPECT_EQ(z.error, tiny);
+}
+
+} // namespace
@@ -0,0 +1,254 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/batch.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/basic.h>
+
+#include <tfcp/test_utils.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test batch functions against the scalar basic.h templates
+//
+// For each ISA that CPU supports, results must be bitwise same as the
+// scalar template, including tails shorter than vector length
+//
+// Except division if only one of batch kernel and this test uses FMA:
+// then z0 + z1 must equal expected up to 4 units of eps^2
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using   OpName = std::string;
+using  IsaName = std::string;
+
+using Params = typename std::tuple<TypeName, OpName, IsaName>;
+
+class TestUnitBatchOps : public TestWithParam<Params> {
+protected:
+
+    // If batch kernel and this test differ in using FMA
+    // NB: assume generic kernels use FMA if this test does
+    static bool differ_fma()
+    {
+        if (current_isa() == isa::generic)
+            return false;
+        bool batch_fma = current_isa() >= isa::avx2;
+    #if defined(TFCP_SIMD_NOFMA)
+        return batch_fma;
+    #else
+        return !batch_fma;
+    #endif
+    }
+
+    // Compare actual z0 + z1 vs expected e0 + e1
+    template<typename T>
+    static bool equal(T z0, T z1, T e0, T e1, bool exact)
+    {
+        if (exact)
+            return z0 == e0 && z1 == e1;
+        T eps = std::numeric_limits<T>::epsilon();
+        return std::fabs((z0 - e0) + (z1 - e1)) <= 4 * eps * eps * std::fabs(e0);
+    }
+
+    // B is batch function, and F is the basic.h template
+    template<typename T, typename B, typename F>
+    static void test_case(const char type[], const char op[], const char isa[],
+                          B b, F f)
+    {
+        bool exact = !(differ_fma() && std::string(op).find("div") != std::string::npos);
+
+        std::mt19937 gen;
+        std::exponential_distribution<T> dis(1);
+
+        int errors = 0;
+
+        // lengths: empty, shorter than vector, with tails, ...
+        for (size_t n : { 0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 100 })
+        {
+            std::vector<T> x0(n), x1(n), y0(n), y1(n), z0(n), z1(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                x0[i] = dis(gen);
+                x1[i] = dis(gen) * x0[i] / 1000000;
+                y0[i] = dis(gen);
+                y1[i] = dis(gen) * y0[i] / 1000000;
+                x0[i] = renormalize(x0[i], x1[i], x1[i]);
+                y0[i] = renormalize(y0[i], y1[i], y1[i]);
+            }
+
+            b(n, x0.data(), x1.data(), y0.data(), y1.data(),
+                 z0.data(), z1.data());
+
+            for (size_t i = 0; i < n; i++)
+            {
+                T e0, e1;
+                e0 = f(x0[i], x1[i], y0[i], y1[i], e1);
+                if (!equal(z0[i], z1[i], e0, e1, exact))
+                {
+                    if (errors++ < 25)
+                    {
+                        printf("ERROR: type=%s op=%s isa=%s n=%d i=%d actual=%g + %g expected=%g + %g\n",
+                               type, op, isa, (int)n, (int)i, z0[i], z1[i], e0, e1);
+                    }
+                }
+            }
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitBatchOps, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto op    = std::get<1>(param);
+    auto name  = std::get<2>(param);
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+// Names X1, Y0, Y1 of lambdas' parameters are empty if not in ARGS
+#define CASE(T, F, X1, Y0, Y1, ARGS)                                           \
+    if (op == #F) {                                                            \
+        test_case<T>(#T, #F, name.c_str(),                                     \
+            [](size_t n, const T* x0, const T* X1, const T* Y0, const T* Y1,   \
+                         T* z0, T* z1) { batch::F(n, ARGS, z0, z1); },         \
+            [](T x0, T X1, T Y0, T Y1, T& z1) { return F(ARGS, z1); });        \
+        select_isa(saved);                                                     \
+        return;                                                                \
+    }
+
+#define OP_CASE(T, F)                                       \
+    CASE(T, F,      x1, y0, y1, PACK(x0, x1, y0, y1));      \
+    CASE(T, F ## 1, x1, y0,   , PACK(x0, x1, y0));          \
+    CASE(T, F ## 2,   , y0, y1, PACK(x0, y0, y1));          \
+    CASE(T, F ## 0,   , y0,   , PACK(x0, y0));
+
+#define SQRT_CASE(T, F)                                     \
+    CASE(T, F,      x1,   ,   , PACK(x0, x1));              \
+    CASE(T, F ## 0,   ,   ,   , PACK(x0));
+
+#define PACK(...) __VA_ARGS__
+
+#define TYPE_CASE(T)                        \
+    if (type == #T) {                       \
+        OP_CASE(T, tadd);                   \
+        OP_CASE(T, tsub);                   \
+        OP_CASE(T, tmul);                   \
+        OP_CASE(T, tdiv);                   \
+        SQRT_CASE(T, tsqrt);                \
+        OP_CASE(T, padd);                   \
+        OP_CASE(T, psub);                   \
+        OP_CASE(T, pmul);                   \
+        OP_CASE(T, pdiv);                   \
+        SQRT_CASE(T, psqrt);                \
+        FAIL() << "unknown op: " << op;     \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+#undef PACK
+#undef SQRT_CASE
+#undef OP_CASE
+#undef CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+// Span interface must give same result as pointers
+TEST(TestUnitBatchSpan, smoke) {
+    std::vector<double> x0(37), x1(37), y0(37), y1(37);
+    std::vector<double> z0(37), z1(37), e0(37), e1(37);
+    for (int i = 0; i < 37; i++) {
+        x0[i] = 1 + i;
+        x1[i] = x0[i] * 1e-20;
+        y0[i] = 3 + i;
+        y1[i] = y0[i] * 1e-18;
+    }
+
+    batch::pdiv(x0, x1, y0, y1, z0, z1);
+    batch::pdiv(37, x0.data(), x1.data(), y0.data(), y1.data(),
+                    e0.data(), e1.data());
+    EXPECT_EQ(z0, e0);
+    EXPECT_EQ(z1, e1);
+
+    batch::psqrt0(span<const double>(x0.data(), 37), z0, z1);
+    batch::psqrt0(37, x0.data(), e0.data(), e1.data());
+    EXPECT_EQ(z0, e0);
+    EXPECT_EQ(z1, e1);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesOpsAndIsas, TestUnitBatchOps,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("tadd",
+                                        "tadd1",
+                                        "tadd2",
+                                        "tadd0",
+                                        "tsub",
+                                        "tsub1",
+                                        "tsub2",
+                                        "tsub0",
+                                        "tmul",
+                                        "tmul1",
+                                        "tmul2",
+                                        "tmul0",
+                                        "tdiv",
+                                        "tdiv1",
+                                        "tdiv2",
+                                        "tdiv0",
+                                        "tsqrt",
+                                        "tsqrt0",
+                                        "padd",
+                                        "padd1",
+                                        "padd2",
+                                        "padd0",
+                                        "psub",
+                                        "psub1",
+                                        "psub2",
+                                        "psub0",
+                                        "pmul",
+                                        "pmul1",
+                                        "pmul2",
+                                        "pmul0",
+                                        "pdiv",
+                                        "pdiv1",
+                                        "pdiv2",
+                                        "pdiv0",
+                                        "psqrt",
+                                        "psqrt0"),
+                                 Values("generic",
+                                        "sse2",
+                                        "avx",
+                                        "avx2",
+                                        "avx512")));
@@ -0,0 +1,438 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/elementary.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_utils.h>
+#include <tfcp/test_quad.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test elementary functions versus reference in __float128:
+//   |z0 + z1 - f(x0 + x1)| <= 4 eps^2 |f| + denorm_min
+//
+// with pow() bound multiplied by (1 + |y log x|); and if f overflows,
+// result must be Inf
+//
+// Arguments cover the whole range, including subnormal for log, tiny
+// ones for expm1, log1p, sinh, tanh, and asin near +-1; with extreme
+// ratio y/x for atan2; for each ISA that CPU supports
+//
+// Result must be bitwise same for 1 and 3 threads, in-place arrays,
+// and single calls; special values must be same as by <cmath>
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using  IsaName = std::string;
+
+using Params = typename std::tuple<TypeName, IsaName>;
+
+#if defined(TFCP_TEST_QUAD)
+
+using tfcp_test::quad;
+
+#endif
+
+class TestUnitElementary : public TestWithParam<Params> {
+protected:
+
+#if defined(TFCP_TEST_QUAD)
+
+    template<typename T>
+    using batch_unary = void (*)(size_t, const T[], const T[], T[], T[]);
+
+    template<typename T>
+    using batch_binary = void (*)(size_t, const T[], const T[],
+                                  const T[], const T[], T[], T[]);
+
+    template<typename T>
+    struct sample {
+        std::vector<T> x0, x1, y0, y1;
+    };
+
+    // Tail of x: random within half ulp of x0
+    template<typename T>
+    static T tail(std::mt19937& gen, T x0)
+    {
+        using L = std::numeric_limits<T>;
+        std::uniform_real_distribution<T> dis(-1, 1);
+        if (std::fabs(x0) < L::min() / L::epsilon())
+            return 0;
+        return x0 * L::epsilon() * dis(gen) / 4;
+    }
+
+    template<typename T>
+    static void push(std::mt19937& gen, std::vector<T>& x0, std::vector<T>& x1, T x)
+    {
+        x0.push_back(x);
+        x1.push_back(tail(gen, x));
+    }
+
+    // 1 + d as coupled with exact tail, for log near 1
+    template<typename T>
+    static void push_one(std::vector<T>& x0, std::vector<T>& x1, T d)
+    {
+        T s = 1 + d;
+        x0.push_back(s);
+        x1.push_back(d - (s - 1));
+    }
+
+    // Check z versus reference, return number of errors
+    template<typename T>
+    static int check(const char type[], const char name[], const char func[],
+                     double x, double y, T z0, T z1, quad ref, double scale)
+    {
+        using L = std::numeric_limits<T>;
+        double eps = L::epsilon();
+        if (ref > L::max() || ref < -L::max()) {
+            if (std::isinf(z0) && (z0 > 0) == (ref > 0))
+                return 0;
+            printf("ERROR: type=%s isa=%s func=%s x=%.17g y=%.17g: "
+                   "%g expected=Inf\n", type, name, func, x, y, double(z0));
+            return 1;
+        }
+        quad diff = tfcp_test::fabs_quad(static_cast<quad>(z0) + z1 - ref);
+        double bound = 4 * scale * eps * eps * std::fabs(static_cast<double>(ref))
+                     + L::denorm_min();
+        if (diff <= bound)
+            return 0;
+        printf("ERROR: type=%s isa=%s func=%s x=%.17g y=%.17g: "
+               "%.17g + %g error=%g bound=%g\n", type, name, func, x, y,
+               double(z0), double(z1), static_cast<double>(diff), bound);
+        return 1;
+    }
+
+    // Same bits, or both NaN
+    template<typename T>
+    static bool same(T a, T b)
+    {
+        return a == b || (std::isnan(a) && std::isnan(b));
+    }
+
+    template<typename T>
+    static int test_unary(const char type[], const char name[], const char func[],
+                          batch_unary<T> batch, coupled<T> (*single)(const coupled<T>&),
+                          quad (*ref)(quad, quad), const sample<T>& s)
+    {
+        int errors = 0;
+        size_t n = s.x0.size();
+
+        std::vector<T> z0[2], z1[2];
+        for (int threads : { 1, 3 })
+        {
+            set_reduce_threads(threads);
+            auto& r0 = z0[threads > 1];
+            auto& r1 = z1[threads > 1];
+            r0.assign(n, -1);
+            r1.assign(n, -1);
+            batch(n, s.x0.data(), s.x1.data(), r0.data(), r1.data());
+        }
+        set_reduce_threads(0);
+
+        std::vector<T> w0(s.x0), w1(s.x1);
+        batch(n, w0.data(), w1.data(), w0.data(), w1.data());
+
+        for (size_t k = 0; k < n; k++)
+        {
+            T x0 = s.x0[k], x1 = s.x1[k];
+            coupled<T> z = single(coupled<T>(x0, x1));
+            if (!same(z0[1][k], z0[0][k]) || !same(z1[1][k], z1[0][k]) ||
+                !same(w0[k], z0[0][k]) || !same(w1[k], z1[0][k]) ||
+                !same(z.value, z0[0][k]) || !same(z.error, z1[0][k]))
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s isa=%s func=%s x=%.17g: "
+                           "%g + %g differs by threads, in-place, or single\n",
+                           type, name, func, double(x0),
+                           double(z0[0][k]), double(z1[0][k]));
+                continue;
+            }
+            quad r = ref(x0, x1);
+            int e = check(type, name, func, x0, 0, z0[0][k], z1[0][k], r, 1);
+            if (e && errors++ >= 25)
+                break;
+        }
+
+        return errors;
+    }
+
+    // Reference gives f(x, y) and scale of bound
+    template<typename T, typename R>
+    static int test_binary(const char type[], const char name[], const char func[],
+                           batch_binary<T> batch,
+                           coupled<T> (*single)(const coupled<T>&, const coupled<T>&),
+                           R ref, const sample<T>& s)
+    {
+        int errors = 0;
+        size_t n = s.x0.size();
+
+        std::vector<T> z0[2], z1[2];
+        for (int threads : { 1, 3 })
+        {
+            set_reduce_threads(threads);
+            auto& r0 = z0[threads > 1];
+            auto& r1 = z1[threads > 1];
+            r0.assign(n, -1);
+            r1.assign(n, -1);
+            batch(n, s.x0.data(), s.x1.data(), s.y0.data(), s.y1.data(),
+                  r0.data(), r1.data());
+        }
+        set_reduce_threads(0);
+
+        for (size_t k = 0; k < n; k++)
+        {
+            T x0 = s.x0[k], x1 = s.x1[k];
+            T y0 = s.y0[k], y1 = s.y1[k];
+            coupled<T> z = single(coupled<T>(x0, x1), coupled<T>(y0, y1));
+            if (!same(z0[1][k], z0[0][k]) || !same(z1[1][k], z1[0][k]) ||
+                !same(z.value, z0[0][k]) || !same(z.error, z1[0][k]))
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s isa=%s func=%s x=%.17g y=%.17g: "
+                           "%g + %g differs by threads or single\n",
+                           type, name, func, double(x0), double(y0),
+                           double(z0[0][k]), double(z1[0][k]));
+                continue;
+            }
+            quad x = static_cast<quad>(x0) + x1;
+            quad y = static_cast<quad>(y0) + y1;
+            double scale = 1;
+            quad r = ref(x, y, scale);
+            int e = check(type, name, func, x0, y0, z0[0][k], z1[0][k], r, scale);
+            if (e && errors++ >= 25)
+                break;
+        }
+
+        return errors;
+    }
+
+    template<typename T>
+    static int test_special(const char type[], const char name[])
+    {
+        using L = std::numeric_limits<T>;
+        T inf = L::infinity(), nan = L::quiet_NaN(), big = 1000;
+
+        int errors = 0;
+        auto expect = [&](const char func[], coupled<T> z, T z0, T x, T y) {
+            if (same(z.value, z0) && z.error == 0)
+                return;
+            if (errors++ < 25)
+                printf("ERROR: type=%s isa=%s func=%s x=%g y=%g: "
+                       "%g + %g expected=%g\n", type, name, func, double(x),
+                       double(y), double(z.value), double(z.error), double(z0));
+        };
+
+        for (T x : { inf, -inf, nan, big, -big }) {
+            expect("exp", tfcp::exp(coupled<T>(x)), std::exp(x), x, 0);
+            expect("expm1", tfcp::expm1(coupled<T>(x)), x < 0 ? -1 : std::expm1(x), x, 0);
+        }
+        for (T x : { T(0), T(-0.0), T(-1), inf, -inf, nan }) {
+            expect("log", tfcp::log(coupled<T>(x)), std::log(x), x, 0);
+        }
+        for (T x : { T(-1), T(-2), inf, -inf, nan }) {
+            expect("log1p", tfcp::log1p(coupled<T>(x)), std::log1p(x), x, 0);
+        }
+        struct { T x, y; } pows[] = {
+            { -2, 3 }, { -2, T(0.5) }, { 0, 2 }, { 0, -1 }, { 2, 2 * big },
+            { 2, -2 * big }, { inf, 2 }, { nan, 1 }, { 1, nan }, { 2, inf }
+        };
+        for (auto p : pows) {
+            expect("pow", tfcp::pow(coupled<T>(p.x), coupled<T>(p.y)),
+                   std::pow(p.x, p.y), p.x, p.y);
+        }
+        for (T x : { inf, -inf, nan }) {
+            expect("atan", tfcp::atan(coupled<T>(x)), std::atan(x), x, 0);
+            expect("sinh", tfcp::sinh(coupled<T>(x)), std::sinh(x), x, 0);
+            expect("cosh", tfcp::cosh(coupled<T>(x)), std::cosh(x), x, 0);
+            expect("tanh", tfcp::tanh(coupled<T>(x)), std::tanh(x), x, 0);
+        }
+        for (T x : { T(-2), T(2), inf, -inf, nan }) {
+            expect("asin", tfcp::asin(coupled<T>(x)), std::asin(x), x, 0);
+            expect("acos", tfcp::acos(coupled<T>(x)), std::acos(x), x, 0);
+        }
+        struct { T y, x; } atan2s[] = {
+            { 0, 0 }, { 0, T(-0.0) }, { T(-0.0), T(-0.0) }, { inf, inf },
+            { -inf, -inf }, { inf, 1 }, { 1, -inf }, { nan, 1 }, { 1, nan }
+        };
+        for (auto p : atan2s) {
+            expect("atan2", tfcp::atan2(coupled<T>(p.y), coupled<T>(p.x)),
+                   std::atan2(p.y, p.x), p.y, p.x);
+        }
+
+        // Zero argument is exact
+        expect("expm1", tfcp::expm1(coupled<T>(T(0))), 0, 0, 0);
+        expect("log1p", tfcp::log1p(coupled<T>(T(0))), 0, 0, 0);
+        expect("log", tfcp::log(coupled<T>(T(1))), 0, 1, 0);
+        for (T x : { T(0), T(-0.0) }) {
+            expect("atan", tfcp::atan(coupled<T>(x)), x, x, 0);
+            expect("asin", tfcp::asin(coupled<T>(x)), x, x, 0);
+            expect("sinh", tfcp::sinh(coupled<T>(x)), x, x, 0);
+            expect("cosh", tfcp::cosh(coupled<T>(x)), 1, x, 0);
+            expect("tanh", tfcp::tanh(coupled<T>(x)), x, x, 0);
+        }
+
+        return errors;
+    }
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        using L = std::numeric_limits<T>;
+        std::mt19937 gen;
+        std::uniform_real_distribution<T> dis(0, 1);
+        auto sign = [&]() { return dis(gen) < 0.5 ? T(-1) : T(1); };
+        auto power = [&](double lo, double hi) {
+            return static_cast<T>(std::pow(10.0, lo + (hi - lo) * dis(gen)));
+        };
+
+        // Sizes so arrays split into several chunks, with tails
+        const int n = 3001, m = 1000;
+        T big = std::log(L::max());
+
+        // Tiny arguments: down to 1e-30, while x^2 eps is normal, else
+        // coupled<float> cannot keep relative eps^2 by underflow
+        double tiny = std::max(-30.0, std::log10(double(L::min() / L::epsilon())) / 2);
+        int errors = 0;
+
+        sample<T> e, em, lg, lp, pw, at, as, at2, sh, th;
+        for (int k = 0; k < n; k++)
+        {
+            push(gen, e.x0, e.x1, static_cast<T>(-1.05 * big + 2.05 * big * dis(gen)));
+            push(gen, em.x0, em.x1, sign() * power(tiny, std::log10(big)));
+            push(gen, lp.x0, lp.x1, sign() * power(tiny, -0.01));
+
+            push(gen, at.x0, at.x1, sign() * power(std::log10(L::min()), std::log10(L::max())));
+            push(gen, as.x0, as.x1, sign() * dis(gen));
+            push(gen, at2.x0, at2.x1, sign() * power(-5, 5));
+            push(gen, at2.y0, at2.y1, sign() * power(-5, 5));
+            push(gen, sh.x0, sh.x1, sign() * power(tiny, std::log10(1.01 * big)));
+            push(gen, th.x0, th.x1, sign() * power(tiny, std::log10(2 * big / 3)));
+        }
+        for (int k = 0; k < m; k++)
+        {
+            push(gen, e.x0, e.x1, sign() * power(-20, 0));
+            int exponent = L::min_exponent - L::digits +
+                           static_cast<int>((L::max_exponent - L::min_exponent + L::digits) * dis(gen));
+            push(gen, lg.x0, lg.x1, std::ldexp(1 + dis(gen), exponent - 1));
+            push_one(lg.x0, lg.x1, sign() * power(tiny, -0.5));
+            push(gen, lp.x0, lp.x1, power(0, std::log10(L::max()) - 1));
+
+            T span = std::log10(L::max()) / 25;
+            push(gen, pw.x0, pw.x1, power(-span, span));
+            push(gen, pw.y0, pw.y1, 20 * sign() * dis(gen));
+
+            // asin near +-1, and tiny; atan2 of extreme ratio
+            push_one(as.x0, as.x1, -power(tiny, -0.5));
+            as.x0.back() *= sign();
+            as.x1.back() *= as.x0.back() > 0 ? 1 : -1;
+            push(gen, as.x0, as.x1, sign() * power(tiny, -1));
+            T extreme = power(std::log10(L::min()) / 4, std::log10(L::max()) / 4);
+            push(gen, at2.x0, at2.x1, sign() * (dis(gen) < 0.5 ? extreme : 1 / extreme));
+            push(gen, at2.y0, at2.y1, sign() * (dis(gen) < 0.5 ? extreme : 1 / extreme));
+        }
+        push_one(lg.x0, lg.x1, L::epsilon() / 2);
+        push(gen, lg.x0, lg.x1, L::denorm_min());
+        push(gen, lg.x0, lg.x1, L::max());
+        for (T x : { T(1), T(-1) }) {
+            as.x0.push_back(x);
+            as.x1.push_back(0);
+        }
+
+        errors += test_unary<T>(type, name, "exp", tfcp::exp, tfcp::exp, tfcp_test::exp_quad, e);
+        errors += test_unary<T>(type, name, "expm1", tfcp::expm1, tfcp::expm1, tfcp_test::expm1_quad, em);
+        errors += test_unary<T>(type, name, "log", tfcp::log, tfcp::log, tfcp_test::log_quad, lg);
+        errors += test_unary<T>(type, name, "log1p", tfcp::log1p, tfcp::log1p, tfcp_test::log1p_quad, lp);
+        errors += test_unary<T>(type, name, "atan", tfcp::atan, tfcp::atan, tfcp_test::atan_quad, at);
+        errors += test_unary<T>(type, name, "asin", tfcp::asin, tfcp::asin, tfcp_test::asin_quad, as);
+        errors += test_unary<T>(type, name, "acos", tfcp::acos, tfcp::acos, tfcp_test::acos_quad, as);
+        errors += test_unary<T>(type, name, "sinh", tfcp::sinh, tfcp::sinh, tfcp_test::sinh_quad, sh);
+        errors += test_unary<T>(type, name, "cosh", tfcp::cosh, tfcp::cosh, tfcp_test::cosh_quad, sh);
+        errors += test_unary<T>(type, name, "tanh", tfcp::tanh, tfcp::tanh, tfcp_test::tanh_quad, th);
+        errors += test_binary<T>(type, name, "pow", tfcp::pow, tfcp::pow,
+                                 [](quad x, quad y, double& scale) {
+                                     scale += std::fabs(static_cast<double>(y * tfcp_test::log_quad(x)));
+                                     return tfcp_test::pow_quad(x, y);
+                                 }, pw);
+        errors += test_binary<T>(type, name, "atan2", tfcp::atan2, tfcp::atan2,
+                                 [](quad y, quad x, double&) {
+                                     return tfcp_test::atan2_quad(y, x);
+                                 }, at2);
+        errors += test_special<T>(type, name);
+
+        ASSERT_EQ(errors, 0);
+    }
+
+#else
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        printf("SKIP: type=%s isa=%s no __float128 for reference\n", type, name);
+    }
+
+#endif
+};
+
+TEST_P(TestUnitElementary, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto name  = std::get<1>(param);
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+#define TYPE_CASE(T)                              \
+    if (type == #T) {                             \
+        test_case<T>(#T, name.c_str());           \
+        select_isa(saved);                        \
+        return;                                   \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    select_isa(saved);
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndIsas, TestUnitElementary,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("generic",
+                                        "sse2",
+                                        "avx",
+                                        "avx2",
+                                        "avx512")));
@@ -0,0 +1,292 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/fixedx.h>
+#include <tfcp/fixed.h>
+#include <tfcp/twofold.h>
+#include <tfcp/simd.h>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <string>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using TypeName = std::string;
+
+//----------------------------------------------------------------------
+//
+// Test fixed-size operations over coupled<T>:
+//
+// - integer matrices, unimodular as product of unit triangular: so det
+//   is exactly 1, and inverse is integer, both must be exact
+//
+// - random diagonally dominant a: |inverse(a) * a - I| <= 64 N eps^2
+//
+// - random u, v: |cross(u, v) . u| <= 8 eps^2 |u|^2 |v|, and the norm
+//   of normalize(u) is 1 within 8 eps^2
+//
+//----------------------------------------------------------------------
+
+class TestUnitFixed : public TestWithParam<TypeName> {
+protected:
+
+    template<size_t N, typename T>
+    static void test_size(const char type[], std::mt19937& gen, int& errors)
+    {
+        using S = coupled<T>;
+        double eps = std::numeric_limits<T>::epsilon();
+        std::uniform_real_distribution<T> dis(-1, 1);
+        std::uniform_int_distribution<int> small(-3, 3);
+
+        for (int n = 0; n < 100; n++)
+        {
+            // Unimodular: a = l * u, unit triangular integers
+            mat<N, N, S> l = identity<N, S>(), u = identity<N, S>();
+            for (size_t i = 0; i < N; i++)
+            {
+                for (size_t j = 0; j < i; j++)
+                {
+                    l[i][j] = S(T(small(gen)), 0);
+                    u[j][i] = S(T(small(gen)), 0);
+                }
+            }
+            mat<N, N, S> a = l * u;
+            S d = det(a);
+            if (d.value != 1 || d.error != 0)
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s N=%d det=%g + %g expected=1\n",
+                           type, (int)N, double(d.value), double(d.error));
+            }
+            mat<N, N, S> e = inverse(a) * a;
+            for (size_t i = 0; i < N; i++)
+            {
+                for (size_t j = 0; j < N; j++)
+                {
+                    if (e[i][j].value != (i == j ? 1 : 0) || e[i][j].error != 0)
+                    {
+                        if (errors++ < 25)
+                            printf("ERROR: type=%s N=%d unimodular i=%d j=%d "
+                                   "inverse*a=%g + %g\n", type, (int)N, (int)i, (int)j,
+                                   double(e[i][j].value), double(e[i][j].error));
+                    }
+                }
+            }
+
+            // Random, diagonally dominant
+            mat<N, N, S> b;
+            for (size_t i = 0; i < N; i++)
+            {
+                for (size_t j = 0; j < N; j++)
+                {
+                    T v = dis(gen);
+                    b[i][j] = S(i == j ? v + (v > 0 ? N : -T(N)) : v,
+                                v * T(eps) * dis(gen) / 2);
+                }
+            }
+            e = inverse(b) * b - identity<N, S>();
+            for (size_t i = 0; i < N; i++)
+            {
+                for (size_t j = 0; j < N; j++)
+                {
+                    if (std::fabs(e[i][j].value) > 64 * N * eps * eps)
+                    {
+                        if (errors++ < 25)
+                            printf("ERROR: type=%s N=%d random i=%d j=%d "
+                                   "inverse*a-I=%g\n", type, (int)N, (int)i, (int)j,
+                                   double(e[i][j].value));
+                    }
+                }
+            }
+        }
+    }
+
+    template<typename T>
+    static void test_case(const char type[])
+    {
+        using S = coupled<T>;
+        std::mt19937 gen;
+        double eps = std::numeric_limits<T>::epsilon();
+        std::uniform_real_distribution<T> dis(-1, 1);
+
+        int errors = 0;
+
+        test_size<1, T>(type, gen, errors);
+        test_size<2, T>(type, gen, errors);
+        test_size<3, T>(type, gen, errors);
+        test_size<4, T>(type, gen, errors);
+
+        for (int n = 0; n < 1000; n++)
+        {
+            vec<3, S> u, v;
+            for (size_t i = 0; i < 3; i++)
+            {
+                u[i] = S(dis(gen), 0);
+                v[i] = S(dis(gen), 0);
+            }
+            double uu = dot(u, u).value, vv = dot(v, v).value;
+            S p = dot(cross(u, v), u);
+            if (std::fabs(p.value) > 8 * eps * eps * uu * std::sqrt(vv))
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s cross(u,v).u=%g\n", type, double(p.value));
+            }
+            S r = norm(normalize(u)) - S(1.0);
+            if (std::fabs(r.value) > 8 * eps * eps)
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s norm(normalize(u))-1=%g\n", type, double(r.value));
+            }
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitFixed, smoke) {
+    auto type = GetParam();
+
+#define TYPE_CASE(T)            \
+    if (type == #T) {           \
+        test_case<T>(#T);       \
+        return;                 \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+//
+// Test batches of 3x3 over coupled<TX> against coupled<T> by fixed.h:
+// each position must equal exactly the scalar result
+//
+//----------------------------------------------------------------------
+
+class TestUnitFixedx : public TestWithParam<TypeName> {
+protected:
+
+    template<typename T, typename TX>
+    static void test_case(const char type[])
+    {
+        static constexpr int lenx = traitx<TX>::length;
+        using S = coupled<T>;
+        using SX = coupled<TX>;
+
+        std::mt19937 gen;
+        double eps = std::numeric_limits<T>::epsilon();
+        std::uniform_real_distribution<T> dis(-1, 1);
+
+        int errors = 0;
+
+        auto check = [&](const char op[], const S& r, const S& e, int n, int l) {
+            if (r.value != e.value || r.error != e.error)
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s op=%s iter=%d position=%d actual=%g + %g "
+                           "expected=%g + %g\n", type, op, n, l, double(r.value),
+                           double(r.error), double(e.value), double(e.error));
+            }
+        };
+
+        for (int n = 0; n < 100; n++)
+        {
+            mat<3, 3, S> a[lenx], b[lenx], c[lenx];
+            vec<3, S> u[lenx], w[lenx];
+            for (int l = 0; l < lenx; l++)
+            {
+                for (size_t i = 0; i < 3; i++)
+                {
+                    for (size_t j = 0; j < 3; j++)
+                    {
+                        T v = dis(gen);
+                        a[l][i][j] = S(v, v * T(eps) * dis(gen) / 2);
+                        b[l][i][j] = S(dis(gen), 0);
+                    }
+                    u[l][i] = S(dis(gen), 0);
+                }
+            }
+
+            mat<3, 3, SX> ax, bx;
+            vec<3, SX> ux;
+            loadx(ax, a);
+            loadx(bx, b);
+            loadx(ux, u);
+
+            storex(c, inverse(ax));
+            for (int l = 0; l < lenx; l++)
+            {
+                mat<3, 3, S> e = inverse(a[l]);
+                for (size_t i = 0; i < 3; i++)
+                    for (size_t j = 0; j < 3; j++)
+                        check("inverse", c[l][i][j], e[i][j], n, l);
+            }
+
+            storex(c, ax * bx);
+            for (int l = 0; l < lenx; l++)
+            {
+                mat<3, 3, S> e = a[l] * b[l];
+                for (size_t i = 0; i < 3; i++)
+                    for (size_t j = 0; j < 3; j++)
+                        check("mul", c[l][i][j], e[i][j], n, l);
+            }
+
+            SX dx = det(ax);
+            storex(w, normalize(cross(ax * ux, ux)));
+            for (int l = 0; l < lenx; l++)
+            {
+                check("det", getx(dx, l), det(a[l]), n, l);
+                vec<3, S> e = normalize(cross(a[l] * u[l], u[l]));
+                for (size_t i = 0; i < 3; i++)
+                    check("normalize", w[l][i], e[i], n, l);
+            }
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitFixedx, smoke) {
+    auto type = GetParam();
+
+#define TYPE_CASE(T, TX)        \
+    if (type == #T) {           \
+        test_case<T, TX>(#T);   \
+        return;                 \
+    }
+
+    TYPE_CASE(float, floatx);
+    TYPE_CASE(double, doublex);
+
+#undef TYPE_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(types, TestUnitFixed,
+                         Values("float",
+                                "double"));
+
+INSTANTIATE_TEST_SUITE_P(types, TestUnitFixedx,
+                         Values("float",
+                                "double"));
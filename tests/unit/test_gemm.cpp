@@ -0,0 +1,298 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/gemm.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+#include <tfcp/soa_vector.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_utils.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test gemm against scalar loop by coupled operators: must be bitwise
+// same for each ISA that CPU supports, and any number of threads
+//
+// Sizes include edges shorter than register tiles, and several cache
+// blocks and stripes by each dimension
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using  IsaName = std::string;
+
+using Params = typename std::tuple<TypeName, IsaName>;
+
+class TestUnitGemm : public TestWithParam<Params> {
+protected:
+
+    // Random coupled values: error is small versus value
+    template<typename T>
+    static void generate(soa_vector<coupled<T>>& x, size_t n, std::mt19937& gen)
+    {
+        T eps = std::numeric_limits<T>::epsilon();
+        std::uniform_real_distribution<T> dis(-1, 1);
+        x.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            T value = dis(gen);
+            x[i] = coupled<T>(value, value * eps * dis(gen) / 2);
+        }
+    }
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        std::mt19937 gen;
+
+        int errors = 0;
+
+        struct { size_t m, n, k; } sizes[] = {
+            { 0, 0, 0 }, { 1, 1, 1 }, { 3, 5, 7 }, { 4, 32, 0 },
+            { 17, 33, 130 }, { 70, 40, 300 }, { 130, 520, 9 }
+        };
+
+        for (auto s : sizes)
+        {
+            size_t m = s.m, n = s.n, k = s.k;
+
+            soa_vector<coupled<T>> a, b;
+            generate(a, m * k, gen);
+            generate(b, k * n, gen);
+
+            std::vector<coupled<T>> expected(m * n);
+            for (size_t i = 0; i < m; i++)
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    coupled<T> c(0, 0);
+                    for (size_t p = 0; p < k; p++)
+                        c += static_cast<coupled<T>>(a[i*k + p]) *
+                             static_cast<coupled<T>>(b[p*n + j]);
+                    expected[i*n + j] = c;
+                }
+            }
+
+            for (int threads : { 1, 3 })
+            {
+                set_reduce_threads(threads);
+                soa_vector<coupled<T>> c(m * n, coupled<T>(-1, 0));
+                gemm(m, n, k, a, b, c);
+                for (size_t i = 0; i < m * n; i++)
+                {
+                    coupled<T> z = c[i];
+                    if (z.value != expected[i].value || z.error != expected[i].error)
+                    {
+                        if (errors++ < 25)
+                        {
+                            printf("ERROR: type=%s isa=%s m=%d n=%d k=%d threads=%d i=%d "
+                                   "actual=%g + %g expected=%g + %g\n",
+                                   type, name, (int)m, (int)n, (int)k, threads, (int)i,
+                                   z.value, z.error, expected[i].value, expected[i].error);
+                        }
+                    }
+                }
+            }
+        }
+
+        set_reduce_threads(0);
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitGemm, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto name  = std::get<1>(param);
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+#define TYPE_CASE(T)                              \
+    if (type == #T) {                             \
+        test_case<T>(#T, name.c_str());           \
+        select_isa(saved);                        \
+        return;                                   \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    select_isa(saved);
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+//
+// Test gemm_accurate by Ozaki scheme versus scalar coupled loop:
+//   |c - expected| <= 4 (k + 1) eps^2 (sum |a| |b| + 2 max|a[i]| max|b[j]|)
+//
+// where max|a[i]| is max of row i of a, and max|b[j]| is of column j,
+// as the scheme drops lower slices relative to these
+//
+// Entries of a and b have exponents of wide range, so splitting takes
+// several slices; result must be bitwise same for any ISA and threads,
+// as all products of slices are exact
+//
+//----------------------------------------------------------------------
+
+class TestUnitGemmAccurate : public TestWithParam<IsaName> {
+protected:
+
+    static void generate(std::vector<double>& x, size_t n, std::mt19937& gen)
+    {
+        std::uniform_real_distribution<double> dis(-1, 1);
+        std::uniform_int_distribution<int> exp(-20, 20);
+        x.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] = std::ldexp(dis(gen), exp(gen));
+        }
+    }
+
+    static void test_case(const char name[])
+    {
+        std::mt19937 gen;
+        double eps = std::numeric_limits<double>::epsilon();
+
+        int errors = 0;
+
+        struct { size_t m, n, k; } sizes[] = {
+            { 0, 0, 0 }, { 1, 1, 1 }, { 3, 5, 7 }, { 4, 32, 0 },
+            { 17, 33, 130 }, { 70, 40, 300 }, { 130, 520, 9 }, { 5, 6, 3000 }
+        };
+
+        for (auto s : sizes)
+        {
+            size_t m = s.m, n = s.n, k = s.k;
+
+            std::vector<double> a, b;
+            generate(a, m * k, gen);
+            generate(b, k * n, gen);
+
+            set_reduce_threads(1);
+            soa_vector<coupled<double>> c(m * n);
+            gemm_accurate(m, n, k, a, b, c);
+
+            for (size_t i = 0; i < m; i++)
+            {
+                for (size_t j = 0; j < n; j++)
+                {
+                    coupled<double> e(0, 0);
+                    double sum = 0, ai = 0, bj = 0;
+                    for (size_t p = 0; p < k; p++)
+                    {
+                        e += coupled<double>(a[i*k + p], 0) * b[p*n + j];
+                        sum += std::fabs(a[i*k + p] * b[p*n + j]);
+                        ai = std::max(ai, std::fabs(a[i*k + p]));
+                        bj = std::max(bj, std::fabs(b[p*n + j]));
+                    }
+                    double bound = 4 * (k + 1) * eps * eps * (sum + 2 * ai * bj);
+
+                    coupled<double> z = c[i*n + j];
+                    coupled<double> d = z - e;
+                    if (std::fabs(d.value) > bound)
+                    {
+                        if (errors++ < 25)
+                        {
+                            printf("ERROR: isa=%s m=%d n=%d k=%d i=%d j=%d "
+                                   "actual=%.17g + %g expected=%.17g + %g diff=%g bound=%g\n",
+                                   name, (int)m, (int)n, (int)k, (int)i, (int)j,
+                                   z.value, z.error, e.value, e.error, d.value, bound);
+                        }
+                    }
+                }
+            }
+
+            // versus other threads, and baseline ISA if x86
+            isa saved = current_isa();
+            for (int threads : { 3, -1 })
+            {
+                if (threads < 0 && !select_isa(isa::sse2))
+                    continue;
+                set_reduce_threads(threads > 0 ? threads : 1);
+                soa_vector<coupled<double>> t(m * n);
+                gemm_accurate(m, n, k, a, b, t);
+                for (size_t i = 0; i < m * n; i++)
+                {
+                    coupled<double> x = t[i], y = c[i];
+                    if (x.value != y.value || x.error != y.error)
+                    {
+                        if (errors++ < 25)
+                        {
+                            printf("ERROR: isa=%s m=%d n=%d k=%d threads=%d i=%d "
+                                   "actual=%g + %g expected=%g + %g\n",
+                                   threads > 0 ? name : "sse2", (int)m, (int)n, (int)k,
+                                   threads, (int)i, x.value, x.error, y.value, y.error);
+                        }
+                    }
+                }
+                select_isa(saved);
+            }
+        }
+
+        set_reduce_threads(0);
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitGemmAccurate, smoke) {
+    auto name = GetParam();
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+    test_case(name.c_str());
+    select_isa(saved);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndIsas, TestUnitGemm,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("generic",
+                                        "sse2",
+                                        "avx",
+                                        "avx2",
+                                        "avx512")));
+
+INSTANTIATE_TEST_SUITE_P(isas, TestUnitGemmAccurate,
+                         Values("generic",
+                                "sse2",
+                                "avx",
+                                "avx2",
+                                "avx512"));
@@ -0,0 +1,253 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/lazy.h>
+#include <tfcp/twofoldx.h>
+#include <tfcp/twofold.h>
+#include <tfcp/simd.h>
+
+#include <tfcp/test_quad.h>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test lazy_coupled by long chains of operations:
+// - dot:    s = s + x[k] * y[k]
+// - cancel: same, but each next term nearly cancels previous
+// - horner: p = p * t + x[k], for plain |t| < 1
+// - divide: s = s / y[k] + x[k]
+//
+// Versus same chain in __float128, with bound relative to magnitudes,
+// which is same chain for |x[k]|, |y[k]|, |t|:
+//   |z0 + z1 - exact| <= 4 n eps^2 (magnitude) + denorm_min
+//
+// Result must be renormalized when observed; and each position of the
+// short-vector result must equal the scalar result exactly
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using  ChainOp = std::string;
+
+using Params = typename std::tuple<TypeName, ChainOp>;
+
+#if defined(TFCP_TEST_QUAD)
+
+using tfcp_test::quad;
+
+#endif
+
+class TestUnitLazy : public TestWithParam<Params> {
+protected:
+
+    // Chain of n operations in arithmetic of S; C is coupled, P is plain
+    template<typename S, typename C, typename P>
+    static S chain(const std::string& op, int n, const C x[], const C y[], P t)
+    {
+        S s = S(x[0]) * S(y[0]);
+        for (int k = 1; k < n; k++)
+        {
+            if (op == "dot" || op == "cancel")
+                s = s + S(x[k]) * S(y[k]);
+            else if (op == "horner")
+                s = s * t + S(x[k]);
+            else
+                s = s / S(y[k]) + S(x[k]);
+        }
+        return s;
+    }
+
+#if defined(TFCP_TEST_QUAD)
+
+    static quad exact(const shaped<double>& x) { return static_cast<quad>(x.value) + x.error; }
+    static quad exact(const shaped<float> & x) { return static_cast<quad>(x.value) + x.error; }
+
+    template<typename T, typename TX>
+    static void test_case(const char type[], const std::string& op)
+    {
+        using L = std::numeric_limits<T>;
+        static constexpr int lenx = traitx<TX>::length;
+        static constexpr int n = 100;
+        double eps = L::epsilon();
+
+        std::mt19937 gen;
+        std::exponential_distribution<T> dis(1);
+        std::uniform_real_distribution<T> tail(-1, 1);
+
+        // Random sign, tail within half ulp of value
+        auto random = [&]() {
+            T v = (dis(gen) + T(0.5)) * (tail(gen) < 0 ? -1 : 1);
+            return coupled<T>(v, v * L::epsilon() * tail(gen) / 2);
+        };
+
+        int errors = 0;
+
+        for (int iter = 0; iter < 200; iter++)
+        {
+            coupled<T> x[lenx][n], y[lenx][n];
+            T t[lenx];
+            for (int i = 0; i < lenx; i++)
+            {
+                t[i] = tail(gen);
+                for (int k = 0; k < n; k++)
+                {
+                    x[i][k] = random();
+                    y[i][k] = random();
+                    // Next term nearly cancels this one
+                    if (op == "cancel" && k % 2 == 1) {
+                        x[i][k] = -x[i][k - 1] * (1 + tail(gen) / 1024);
+                        y[i][k] = y[i][k - 1];
+                    }
+                }
+            }
+
+            coupled<TX> xx[n], yx[n];
+            for (int k = 0; k < n; k++)
+            {
+                coupled<T> xk[lenx], yk[lenx];
+                for (int i = 0; i < lenx; i++)
+                {
+                    xk[i] = x[i][k];
+                    yk[i] = y[i][k];
+                }
+                xx[k] = loadx<coupled<TX>>(xk);
+                yx[k] = loadx<coupled<TX>>(yk);
+            }
+            auto zlazy = chain<lazy_coupled<TX>>(op, n, xx, yx, loadx<TX>(t));
+            if (zlazy.count > lazy_coupled<TX>::limit)
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s op=%s iter=%d: count=%d above limit\n",
+                           type, op.c_str(), iter + 1, zlazy.count);
+            }
+            coupled<TX> zx = zlazy;
+
+            for (int i = 0; i < lenx; i++)
+            {
+                coupled<T> z = chain<lazy_coupled<T>>(op, n, x[i], y[i], t[i]);
+                coupled<T> zi = getx(zx, i);
+                if (zi.value != z.value || zi.error != z.error)
+                {
+                    if (errors++ < 25)
+                        printf("ERROR: type=%s op=%s iter=%d i=%d: vector=%g + %g "
+                               "scalar=%g + %g\n", type, op.c_str(), iter + 1, i,
+                               double(zi.value), double(zi.error),
+                               double(z.value), double(z.error));
+                    continue;
+                }
+
+                quad qx[n], qy[n], ax[n], ay[n];
+                for (int k = 0; k < n; k++)
+                {
+                    qx[k] = exact(x[i][k]);
+                    qy[k] = exact(y[i][k]);
+                    ax[k] = tfcp_test::fabs_quad(qx[k]);
+                    ay[k] = tfcp_test::fabs_quad(qy[k]);
+                }
+                quad e = chain<quad>(op, n, qx, qy, static_cast<quad>(t[i]));
+                quad magnitude = chain<quad>(op, n, ax, ay, tfcp_test::fabs_quad(t[i]));
+
+                quad diff = tfcp_test::fabs_quad(exact(z) - e);
+                double bound = 4 * n * eps * eps * static_cast<double>(magnitude)
+                             + L::denorm_min();
+                bool renormalized = static_cast<T>(z.value + z.error) == z.value;
+                if (diff <= bound && renormalized)
+                    continue;
+                if (errors++ < 25)
+                    printf("ERROR: type=%s op=%s iter=%d i=%d: %.17g + %g "
+                           "error=%g bound=%g renormalized=%d\n", type, op.c_str(),
+                           iter + 1, i, double(z.value), double(z.error),
+                           static_cast<double>(diff), bound, renormalized);
+            }
+        }
+
+        // Observing does not change renormalized, nor renormalizes twice
+        lazy_coupled<T> a = coupled<T>(1, L::epsilon() / 4);
+        coupled<T> b = a + a * a;
+        coupled<T> c = lazy_coupled<T>(b);
+        if (c.value != b.value || c.error != b.error || a != coupled<T>(a) ||
+            !(a < b) || !(b > a) || !(a + a == 2 * a))
+        {
+            errors++;
+            printf("ERROR: type=%s op=%s observing: %g + %g versus %g + %g\n",
+                   type, op.c_str(), double(c.value), double(c.error),
+                   double(b.value), double(b.error));
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+
+#else
+
+    template<typename T, typename TX>
+    static void test_case(const char type[], const std::string& op)
+    {
+        printf("SKIP: type=%s op=%s no __float128 for reference\n", type, op.c_str());
+    }
+
+#endif
+};
+
+TEST_P(TestUnitLazy, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto op    = std::get<1>(param);
+
+#define TYPE_CASE(T, TX)                      \
+    if (type == #T) {                         \
+        test_case<T, TX>(#T, op);             \
+        return;                               \
+    }
+
+    TYPE_CASE(float, floatx);
+    TYPE_CASE(double, doublex);
+
+#undef TYPE_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+// After cancelling, the error part may exceed the value part: observed
+// value must still be the exact renormalization, e.g. 1 + 2^-80 here
+TEST(TestUnitLazyRenorm, smoke) {
+    double tiny = std::ldexp(1.0, -80);
+
+    lazy_coupled<double> x(tiny, 1.0, 1);
+    coupled<double> p = x;
+    EXPECT_EQ(p.value, 1.0);
+    EXPECT_EQ(p.error, tiny);
+
+    x.renormalize();
+    EXPECT_EQ(x.value, 1.0);
+    EXPECT_EQ(x.error, tiny);
+    EXPECT_EQ(x.count, 0);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndOps, TestUnitLazy,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("dot",
+                                        "cancel",
+                                        "horner",
+                                        "divide")));
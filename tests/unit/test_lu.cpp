@@ -0,0 +1,169 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/lu.h>
+#include <tfcp/reduce.h>
+#include <tfcp/twofold.h>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test solve_refined() by residual computed in coupled arithmetic:
+//   |b - a*x| <= 16 (n + 1) eps^2 |a| |x|  -- for each row
+//
+// Matrices: random, which is well-conditioned; and like Hilbert's of
+// cond about 1e10, which needs several steps; and singular
+//
+// Also, plain lu_solve() must meet its usual backward error
+//
+//----------------------------------------------------------------------
+
+using MatrixName = std::string;
+
+class TestUnitLu : public TestWithParam<MatrixName> {
+protected:
+
+    static void generate(const std::string& kind, size_t n, std::vector<double>& a,
+                         std::mt19937& gen)
+    {
+        std::uniform_real_distribution<double> dis(-1, 1);
+        a.resize(n * n);
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t j = 0; j < n; j++)
+            {
+                if (kind == "random")
+                    a[i*n + j] = dis(gen);
+                else if (kind == "hilbert")
+                    a[i*n + j] = 1.0 / (i + j + 1);
+                else
+                    a[i*n + j] = j == n / 2 ? 0 : dis(gen);  // singular
+            }
+        }
+    }
+
+    static void test_case(const std::string& kind)
+    {
+        std::mt19937 gen;
+        double eps = std::numeric_limits<double>::epsilon();
+        std::uniform_real_distribution<double> dis(-1, 1);
+
+        int errors = 0;
+
+        for (size_t n : { 1, 2, 7, 65, 150 })
+        {
+            if (kind == "hilbert" && n > 7)
+                continue;
+
+            std::vector<double> a, b(n), x0(n), x1(n);
+            generate(kind, n, a, gen);
+            for (size_t i = 0; i < n; i++)
+                b[i] = dis(gen);
+
+            int steps = solve_refined(n, a.data(), n, b.data(), x0.data(), x1.data());
+
+            if (kind == "singular")
+            {
+                if (steps != -1)
+                {
+                    if (errors++ < 25)
+                        printf("ERROR: matrix=%s n=%d steps=%d expected=-1\n",
+                               kind.c_str(), (int)n, steps);
+                }
+                continue;
+            }
+
+            if (steps < 0)
+            {
+                if (errors++ < 25)
+                    printf("ERROR: matrix=%s n=%d steps=%d\n", kind.c_str(), (int)n, steps);
+                continue;
+            }
+
+            for (size_t i = 0; i < n; i++)
+            {
+                coupled<double> r(b[i], 0);
+                double bound = 0;
+                for (size_t j = 0; j < n; j++)
+                {
+                    r -= coupled<double>(a[i*n + j], 0) * coupled<double>(x0[j], x1[j]);
+                    bound += std::fabs(a[i*n + j] * x0[j]);
+                }
+                bound *= 16 * (n + 1) * eps * eps;
+                if (std::fabs(r.value) > bound)
+                {
+                    if (errors++ < 25)
+                        printf("ERROR: matrix=%s n=%d steps=%d i=%d residual=%g bound=%g\n",
+                               kind.c_str(), (int)n, steps, (int)i, r.value, bound);
+                }
+            }
+
+            // Plain LU: |b - a*x| <= 4 n eps |a| |x|, roughly
+            std::vector<double> lu(a);
+            std::vector<size_t> piv(n);
+            std::vector<double> x(b);
+            if (!lu_factor(n, lu.data(), n, piv.data()))
+            {
+                if (errors++ < 25)
+                    printf("ERROR: matrix=%s n=%d lu_factor failed\n", kind.c_str(), (int)n);
+                continue;
+            }
+            lu_solve(n, lu.data(), n, piv.data(), x.data());
+            for (size_t i = 0; i < n; i++)
+            {
+                coupled<double> r(b[i], 0);
+                double bound = 0;
+                for (size_t j = 0; j < n; j++)
+                {
+                    r -= coupled<double>(a[i*n + j], 0) * x[j];
+                    bound += std::fabs(a[i*n + j] * x[j]);
+                }
+                bound *= 4 * n * eps;
+                if (std::fabs(r.value) > bound)
+                {
+                    if (errors++ < 25)
+                        printf("ERROR: matrix=%s n=%d plain i=%d residual=%g bound=%g\n",
+                               kind.c_str(), (int)n, (int)i, r.value, bound);
+                }
+            }
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitLu, smoke) {
+    auto kind = GetParam();
+    for (int threads : { 1, 3 })
+    {
+        set_reduce_threads(threads);
+        test_case(kind);
+    }
+    set_reduce_threads(0);
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(matrices, TestUnitLu,
+                         Values("random",
+                                "hilbert",
+                                "singular"));
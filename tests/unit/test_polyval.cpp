@@ -0,0 +1,237 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/polyval.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_utils.h>
+#include <tfcp/test_quad.h>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test polyval() and polyval_estrin() versus Horner in __float128:
+//   |z0 + z1 - p(x)| <= n^2 eps^2 sum |c[i] x^i| + denorm_min
+//
+// for random coefficients, and for (1 - x)^n near its root, where the
+// plain Horner would lose all digits; degree crosses blocks of Estrin
+//
+// Result must be bitwise same for 1 and 3 threads, in-place arrays,
+// and single calls; for each ISA that CPU supports
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using  IsaName = std::string;
+
+using Params = typename std::tuple<TypeName, IsaName>;
+
+#if defined(TFCP_TEST_QUAD)
+
+using tfcp_test::quad;
+
+#endif
+
+class TestUnitPolyval : public TestWithParam<Params> {
+protected:
+
+#if defined(TFCP_TEST_QUAD)
+
+    template<typename T>
+    using batch_poly = void (*)(size_t, const T[], size_t, const T[], T[], T[]);
+
+    template<typename T>
+    using single_poly = coupled<T> (*)(size_t, const T[], T);
+
+    // Same bits, or both NaN
+    template<typename T>
+    static bool same(T a, T b)
+    {
+        return a == b || (std::isnan(a) && std::isnan(b));
+    }
+
+    template<typename T>
+    static int test_poly(const char type[], const char name[], const char func[],
+                         batch_poly<T> batch, single_poly<T> single,
+                         const std::vector<T>& c, const std::vector<T>& x)
+    {
+        using L = std::numeric_limits<T>;
+        double eps = L::epsilon();
+        size_t n = c.size(), m = x.size();
+        int errors = 0;
+
+        std::vector<T> z0[2], z1[2];
+        for (int threads : { 1, 3 })
+        {
+            set_reduce_threads(threads);
+            auto& r0 = z0[threads > 1];
+            auto& r1 = z1[threads > 1];
+            r0.assign(m, -1);
+            r1.assign(m, -1);
+            batch(n, c.data(), m, x.data(), r0.data(), r1.data());
+        }
+        set_reduce_threads(0);
+
+        std::vector<T> w0(x), w1(m);
+        batch(n, c.data(), m, w0.data(), w0.data(), w1.data());
+
+        for (size_t k = 0; k < m; k++)
+        {
+            coupled<T> z = single(n, c.data(), x[k]);
+            if (!same(z0[1][k], z0[0][k]) || !same(z1[1][k], z1[0][k]) ||
+                !same(w0[k], z0[0][k]) || !same(w1[k], z1[0][k]) ||
+                !same(z.value, z0[0][k]) || !same(z.error, z1[0][k]))
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s isa=%s func=%s n=%d x=%.17g: "
+                           "%g + %g differs by threads, in-place, or single\n",
+                           type, name, func, (int)n, double(x[k]),
+                           double(z0[0][k]), double(z1[0][k]));
+                continue;
+            }
+
+            quad p = 0, s = 0, a = tfcp_test::fabs_quad(x[k]);
+            for (size_t i = n; i-- > 0;)
+            {
+                p = p * x[k] + c[i];
+                s = s * a + tfcp_test::fabs_quad(c[i]);
+            }
+            quad diff = tfcp_test::fabs_quad(static_cast<quad>(z0[0][k]) + z1[0][k] - p);
+            double bound = n * n * eps * eps * static_cast<double>(s) + L::denorm_min();
+            if (diff <= bound)
+                continue;
+            if (errors++ < 25)
+                printf("ERROR: type=%s isa=%s func=%s n=%d x=%.17g: "
+                       "%.17g + %g error=%g bound=%g\n", type, name, func,
+                       (int)n, double(x[k]), double(z0[0][k]), double(z1[0][k]),
+                       static_cast<double>(diff), bound);
+        }
+
+        return errors;
+    }
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        std::mt19937 gen;
+        std::uniform_real_distribution<T> dis(-1, 1);
+
+        // Sizes so arrays split into several chunks, with tails
+        const int m = 3001;
+        int errors = 0;
+
+        std::vector<T> x(m), near(m);
+        for (int k = 0; k < m; k++)
+        {
+            x[k] = T(1.25) * dis(gen);
+            near[k] = 1 + dis(gen) / 8;
+        }
+
+        for (size_t n : { 0, 1, 2, 3, 5, 8, 13, 31, 32, 33, 40, 64, 100 })
+        {
+            std::vector<T> c(n);
+            for (auto& ci : c)
+                ci = dis(gen);
+            errors += test_poly<T>(type, name, "polyval", tfcp::polyval,
+                                   tfcp::polyval, c, x);
+            errors += test_poly<T>(type, name, "polyval_estrin", tfcp::polyval_estrin,
+                                   tfcp::polyval_estrin, c, x);
+        }
+
+        // (1 - x)^n by binomials, exact in T
+        for (size_t n : { 5, 9, 17 })
+        {
+            std::vector<T> c(n, 1);
+            for (size_t i = 1; i < n; i++)
+                c[i] = -c[i - 1] * T(n - i) / T(i);
+            errors += test_poly<T>(type, name, "polyval", tfcp::polyval,
+                                   tfcp::polyval, c, near);
+            errors += test_poly<T>(type, name, "polyval_estrin", tfcp::polyval_estrin,
+                                   tfcp::polyval_estrin, c, near);
+        }
+
+        // Trivial polynomials are exact
+        T c0 = T(0.1);
+        coupled<T> z = tfcp::polyval(0, &c0, T(2));
+        coupled<T> w = tfcp::polyval_estrin(1, &c0, T(2));
+        if (z.value != 0 || z.error != 0 || w.value != c0 || w.error != 0)
+        {
+            errors++;
+            printf("ERROR: type=%s isa=%s degree zero: %g + %g, %g + %g\n",
+                   type, name, double(z.value), double(z.error),
+                   double(w.value), double(w.error));
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+
+#else
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        printf("SKIP: type=%s isa=%s no __float128 for reference\n", type, name);
+    }
+
+#endif
+};
+
+TEST_P(TestUnitPolyval, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto name  = std::get<1>(param);
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+#define TYPE_CASE(T)                              \
+    if (type == #T) {                             \
+        test_case<T>(#T, name.c_str());           \
+        select_isa(saved);                        \
+        return;                                   \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    select_isa(saved);
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndIsas, TestUnitPolyval,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("generic",
+                                        "sse2",
+                                        "avx",
+                                        "avx2",
+                                        "avx512")));
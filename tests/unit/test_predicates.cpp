@@ -0,0 +1,255 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/predicates.h>
+#include <tfcp/reduce.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using PredicateName = std::string;
+
+//----------------------------------------------------------------------
+//
+// Test predicates versus reference signs:
+//
+// - random integer points, small enough that int64_t computes the exact
+//   determinant; and with tiny range, so that many are degenerate
+//
+// - points near degenerate, by few ulps from a line, a plane, or a
+//   circle, where the sign is known by construction
+//
+// Batch variant must give same signs, by 1 thread and by 3 threads
+//
+//----------------------------------------------------------------------
+
+int sign_of(int64_t x) { return x > 0 ? 1 : x < 0 ? -1 : 0; }
+
+// Queries as flat arrays of points, and reference signs
+struct queries {
+    std::vector<double> p[4];
+    std::vector<int> ref;
+};
+
+struct orient2d_case {
+    static constexpr int dim = 2;
+    static constexpr int points = 3;
+    static constexpr int64_t range = 1 << 20;
+
+    static int64_t exact(const int64_t* p[]) {
+        int64_t acx = p[0][0] - p[2][0], acy = p[0][1] - p[2][1];
+        int64_t bcx = p[1][0] - p[2][0], bcy = p[1][1] - p[2][1];
+        return acx * bcy - acy * bcx;
+    }
+
+    static int scalar(const double* p[]) { return orient2d(p[0], p[1], p[2]); }
+
+    static void batch(size_t n, const queries& q, int s[]) {
+        orient2d(n, q.p[0].data(), q.p[1].data(), q.p[2].data(), s);
+    }
+
+    // a near the line through b, c: sign of (ay - ax)
+    static void degenerate(queries& q) {
+        const double u = std::ldexp(1.0, -53);  // ulp of 0.5
+        for (int i = 0; i < 32; i++) {
+            for (int j = 0; j < 32; j++) {
+                double a[] = { 0.5 + i*u, 0.5 + j*u }, b[] = { 12, 12 }, c[] = { 24, 24 };
+                q.p[0].insert(q.p[0].end(), a, a + 2);
+                q.p[1].insert(q.p[1].end(), b, b + 2);
+                q.p[2].insert(q.p[2].end(), c, c + 2);
+                q.ref.push_back(j > i ? 1 : j < i ? -1 : 0);
+            }
+        }
+    }
+};
+
+struct orient3d_case {
+    static constexpr int dim = 3;
+    static constexpr int points = 4;
+    static constexpr int64_t range = 1 << 14;
+
+    static int64_t exact(const int64_t* p[]) {
+        int64_t d[3][3];
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                d[i][j] = p[i][j] - p[3][j];
+        return d[0][2] * (d[1][0] * d[2][1] - d[2][0] * d[1][1]) +
+               d[1][2] * (d[2][0] * d[0][1] - d[0][0] * d[2][1]) +
+               d[2][2] * (d[0][0] * d[1][1] - d[1][0] * d[0][1]);
+    }
+
+    static int scalar(const double* p[]) { return orient3d(p[0], p[1], p[2], p[3]); }
+
+    static void batch(size_t n, const queries& q, int s[]) {
+        orient3d(n, q.p[0].data(), q.p[1].data(), q.p[2].data(), q.p[3].data(), s);
+    }
+
+    // d near the plane z = x + y through a, b, c: sign of x + y - z,
+    // where x + y = s0 + s1 exactly, and z - s0 is exact
+    static void degenerate(queries& q) {
+        std::mt19937 gen;
+        std::uniform_real_distribution<double> dis(-1, 1);
+        for (int n = 0; n < 256; n++) {
+            double x = dis(gen), y = dis(gen);
+            double s0 = x + y, t = s0 - x;
+            double s1 = (x - (s0 - t)) + (y - t);
+            for (int k = -3; k <= 3; k++) {
+                double z = s0;
+                for (int i = 0; i < k; i++) z = std::nextafter(z, 2.0);
+                for (int i = 0; i > k; i--) z = std::nextafter(z, -2.0);
+                double r = s1 - (z - s0);
+                double a[] = { 0, 0, 0 }, b[] = { 1, 0, 1 }, c[] = { 0, 1, 1 }, d[] = { x, y, z };
+                q.p[0].insert(q.p[0].end(), a, a + 3);
+                q.p[1].insert(q.p[1].end(), b, b + 3);
+                q.p[2].insert(q.p[2].end(), c, c + 3);
+                q.p[3].insert(q.p[3].end(), d, d + 3);
+                q.ref.push_back(r > 0 ? 1 : r < 0 ? -1 : 0);
+            }
+        }
+    }
+};
+
+struct incircle_case {
+    static constexpr int dim = 2;
+    static constexpr int points = 4;
+    static constexpr int64_t range = 1 << 10;
+
+    static int64_t exact(const int64_t* p[]) {
+        int64_t d[3][3];
+        for (int i = 0; i < 3; i++) {
+            d[i][0] = p[i][0] - p[3][0];
+            d[i][1] = p[i][1] - p[3][1];
+            d[i][2] = d[i][0] * d[i][0] + d[i][1] * d[i][1];
+        }
+        return d[0][2] * (d[1][0] * d[2][1] - d[2][0] * d[1][1]) +
+               d[1][2] * (d[2][0] * d[0][1] - d[0][0] * d[2][1]) +
+               d[2][2] * (d[0][0] * d[1][1] - d[1][0] * d[0][1]);
+    }
+
+    static int scalar(const double* p[]) { return incircle(p[0], p[1], p[2], p[3]); }
+
+    static void batch(size_t n, const queries& q, int s[]) {
+        incircle(n, q.p[0].data(), q.p[1].data(), q.p[2].data(), q.p[3].data(), s);
+    }
+
+    // d near (3, 4) on the circle of radius 5, shifted by t: outside
+    // if x is greater than 3 + t, so sign is -1
+    static void degenerate(queries& q) {
+        const double shifts[] = { 0, 1024, std::ldexp(1.0, 30), -std::ldexp(1.0, 40) };
+        for (double t : shifts) {
+            for (int k = -8; k <= 8; k++) {
+                double x = 3 + t;
+                for (int i = 0; i < k; i++) x = std::nextafter(x, HUGE_VAL);
+                for (int i = 0; i > k; i--) x = std::nextafter(x, -HUGE_VAL);
+                double a[] = { 5 + t, t }, b[] = { t, 5 + t }, c[] = { -5 + t, t }, d[] = { x, 4 + t };
+                q.p[0].insert(q.p[0].end(), a, a + 2);
+                q.p[1].insert(q.p[1].end(), b, b + 2);
+                q.p[2].insert(q.p[2].end(), c, c + 2);
+                q.p[3].insert(q.p[3].end(), d, d + 2);
+                q.ref.push_back(k > 0 ? -1 : k < 0 ? 1 : 0);
+            }
+        }
+    }
+};
+
+class TestUnitPredicates : public TestWithParam<PredicateName> {
+protected:
+
+    template<typename P>
+    static void test_case(const char name[])
+    {
+        std::mt19937 gen;
+        queries q;
+
+        // Random integer points: with full range, and with range of 4
+        for (int n = 0; n < 20000; n++) {
+            int64_t range = n % 2 ? P::range : 4;
+            std::uniform_int_distribution<int64_t> dis(-range, range);
+            int64_t c[P::points][P::dim];
+            const int64_t* p[P::points];
+            for (int i = 0; i < P::points; i++) {
+                for (int j = 0; j < P::dim; j++) {
+                    c[i][j] = dis(gen);
+                    q.p[i].push_back(static_cast<double>(c[i][j]));
+                }
+                p[i] = c[i];
+            }
+            q.ref.push_back(sign_of(P::exact(p)));
+        }
+        P::degenerate(q);
+
+        int errors = 0;
+        size_t n = q.ref.size();
+
+        for (size_t k = 0; k < n; k++) {
+            const double* p[P::points];
+            for (int i = 0; i < P::points; i++)
+                p[i] = &q.p[i][k * P::dim];
+            int s = P::scalar(p);
+            if (s != q.ref[k]) {
+                if (errors++ < 10) {
+                    printf("ERROR: predicate=%s query=%d sign=%d expected=%d\n",
+                           name, static_cast<int>(k), s, q.ref[k]);
+                }
+            }
+        }
+
+        for (int threads : { 1, 3 }) {
+            set_reduce_threads(threads);
+            std::vector<int> s(n);
+            P::batch(n, q, s.data());
+            for (size_t k = 0; k < n; k++) {
+                if (s[k] != q.ref[k]) {
+                    if (errors++ < 10) {
+                        printf("ERROR: predicate=%s batch threads=%d query=%d sign=%d expected=%d\n",
+                               name, threads, static_cast<int>(k), s[k], q.ref[k]);
+                    }
+                }
+            }
+        }
+        set_reduce_threads(0);
+
+        EXPECT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitPredicates, smoke) {
+    auto name = GetParam();
+
+#define PREDICATE_CASE(P)               \
+    if (name == #P) {                   \
+        test_case<P ## _case>(#P);      \
+        return;                         \
+    }
+
+    PREDICATE_CASE(orient2d);
+    PREDICATE_CASE(orient3d);
+    PREDICATE_CASE(incircle);
+
+#undef PREDICATE_CASE
+
+    FAIL() << "unknown predicate: " << name;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(predicates, TestUnitPredicates,
+                         Values("orient2d",
+                                "orient3d",
+                                "incircle"));
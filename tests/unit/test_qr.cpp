@@ -0,0 +1,284 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/qr.h>
+#include <tfcp/reduce.h>
+#include <tfcp/twofold.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using TypeName = std::string;
+
+//----------------------------------------------------------------------
+//
+// Test qr_factor() by Q^T applied to columns of a, which must give R:
+//   |Q^T a[:][j] - R[:][j]| <= 16 (m + n) eps^2 |a[:][j]|  -- 2-norm
+//
+// Sizes below, at, and above the panel width; and m < n
+//
+//----------------------------------------------------------------------
+
+class TestUnitQrFactor : public TestWithParam<TypeName> {
+protected:
+
+    template<typename T>
+    static void test_case(const char type[])
+    {
+        std::mt19937 gen;
+        double eps = std::numeric_limits<T>::epsilon();
+        std::uniform_real_distribution<T> dis(-1, 1);
+
+        int errors = 0;
+
+        const size_t sizes[][2] = { {1, 1}, {5, 3}, {3, 5}, {32, 32},
+                                    {70, 40}, {100, 100}, {130, 70} };
+        for (const auto& size : sizes)
+        {
+            size_t m = size[0], n = size[1], k = std::min(m, n);
+
+            std::vector<T> a(m * n), r0(m * n), r1(m * n, 0), tau0(k), tau1(k);
+            for (size_t i = 0; i < m * n; i++)
+                a[i] = r0[i] = dis(gen);
+
+            qr_factor(m, n, r0.data(), r1.data(), n, tau0.data(), tau1.data());
+
+            for (size_t j = 0; j < n; j++)
+            {
+                std::vector<T> c0(m), c1(m, 0);
+                double norm = 0;
+                for (size_t i = 0; i < m; i++)
+                {
+                    c0[i] = a[i*n + j];
+                    norm += double(c0[i]) * c0[i];
+                }
+                qr_apply_qt(m, n, r0.data(), r1.data(), n, tau0.data(), tau1.data(),
+                            c0.data(), c1.data());
+
+                double bound = 16 * (m + n) * eps * eps * std::sqrt(norm);
+                for (size_t i = 0; i < m; i++)
+                {
+                    coupled<T> r(0, 0);
+                    if (i <= j)
+                        r = coupled<T>(r0[i*n + j], r1[i*n + j]);
+                    coupled<T> d = coupled<T>(c0[i], c1[i]) - r;
+                    if (std::fabs(d.value) > bound)
+                    {
+                        if (errors++ < 25)
+                            printf("ERROR: type=%s m=%d n=%d i=%d j=%d diff=%g bound=%g\n",
+                                   type, (int)m, (int)n, (int)i, (int)j,
+                                   double(d.value), bound);
+                    }
+                }
+            }
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitQrFactor, smoke) {
+    auto type = GetParam();
+    for (int threads : { 1, 3 })
+    {
+        set_reduce_threads(threads);
+
+    #define TYPE_CASE(T)            \
+        if (type == #T) {           \
+            test_case<T>(#T);       \
+            continue;               \
+        }
+
+        TYPE_CASE(float);
+        TYPE_CASE(double);
+
+    #undef TYPE_CASE
+
+        FAIL() << "unknown type: " << type;
+    }
+    set_reduce_threads(0);
+}
+
+//----------------------------------------------------------------------
+//
+// Test least_squares() on ill-conditioned fit by polynomial of degree
+// n - 1 at m points in [0, 1], which is Vandermonde matrix of cond of
+// about 1e11 for double (n = 14), and 1e4 for float (n = 6):
+//
+// - consistent b = a * x, so x must be found to about eps^2 * cond;
+//   check that it is better than eps / 64, not reachable by plain T
+//
+// - random b, so x must solve the normal equations a^T (b - a x) = 0
+//   up to 16 (m + n) eps^2 |a|^T (|b| + |a| |x|)
+//
+// Also, returns false if m < n, or if a has zero column
+//
+//----------------------------------------------------------------------
+
+class TestUnitQrLeastSquares : public TestWithParam<TypeName> {
+protected:
+
+    template<typename T>
+    static void test_case(const char type[])
+    {
+        std::mt19937 gen;
+        double eps = std::numeric_limits<T>::epsilon();
+        std::uniform_real_distribution<T> dis(-1, 1);
+
+        int errors = 0;
+
+        size_t m = 100;
+        size_t n = sizeof(T) == sizeof(double) ? 14 : 6;
+
+        std::vector<T> a0(m * n), a1(m * n, 0);
+        for (size_t i = 0; i < m; i++)
+        {
+            coupled<T> t = coupled<T>(T(i), 0) / coupled<T>(T(m - 1), 0);
+            coupled<T> p(1, 0);
+            for (size_t j = 0; j < n; j++)
+            {
+                a0[i*n + j] = p.value;
+                a1[i*n + j] = p.error;
+                p *= t;
+            }
+        }
+
+        // Consistent: b = a * x exactly, up to eps^2
+        std::vector<T> x(n), b0(m), b1(m), x0(n), x1(n);
+        for (size_t j = 0; j < n; j++)
+            x[j] = dis(gen);
+        for (size_t i = 0; i < m; i++)
+        {
+            coupled<T> s(0, 0);
+            for (size_t j = 0; j < n; j++)
+                s += coupled<T>(a0[i*n + j], a1[i*n + j]) * coupled<T>(x[j], 0);
+            b0[i] = s.value;
+            b1[i] = s.error;
+        }
+
+        if (!least_squares(m, n, a0.data(), a1.data(), n, b0.data(), b1.data(),
+                           x0.data(), x1.data()))
+        {
+            if (errors++ < 25)
+                printf("ERROR: type=%s consistent: least_squares failed\n", type);
+        }
+        double xmax = 0;
+        for (size_t j = 0; j < n; j++)
+            xmax = std::max(xmax, std::fabs(double(x[j])));
+        for (size_t j = 0; j < n; j++)
+        {
+            coupled<T> d = coupled<T>(x0[j], x1[j]) - coupled<T>(x[j], 0);
+            if (std::fabs(d.value) > eps / 64 * xmax)
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s consistent: j=%d x=%g diff=%g\n",
+                           type, (int)j, double(x[j]), double(d.value));
+            }
+        }
+
+        // Random b: check normal equations
+        for (size_t i = 0; i < m; i++)
+        {
+            b0[i] = dis(gen);
+            b1[i] = 0;
+        }
+        if (!least_squares(m, n, a0.data(), a1.data(), n, b0.data(), b1.data(),
+                           x0.data(), x1.data()))
+        {
+            if (errors++ < 25)
+                printf("ERROR: type=%s random: least_squares failed\n", type);
+        }
+        std::vector<coupled<T>> r(m);
+        std::vector<double> rbound(m);
+        for (size_t i = 0; i < m; i++)
+        {
+            r[i] = coupled<T>(b0[i], b1[i]);
+            rbound[i] = std::fabs(double(b0[i]));
+            for (size_t j = 0; j < n; j++)
+            {
+                r[i] -= coupled<T>(a0[i*n + j], a1[i*n + j]) * coupled<T>(x0[j], x1[j]);
+                rbound[i] += std::fabs(double(a0[i*n + j]) * x0[j]);
+            }
+        }
+        for (size_t j = 0; j < n; j++)
+        {
+            coupled<T> g(0, 0);
+            double bound = 0;
+            for (size_t i = 0; i < m; i++)
+            {
+                g += coupled<T>(a0[i*n + j], a1[i*n + j]) * r[i];
+                bound += std::fabs(double(a0[i*n + j])) * rbound[i];
+            }
+            bound *= 16 * (m + n) * eps * eps;
+            if (std::fabs(g.value) > bound)
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s random: j=%d gradient=%g bound=%g\n",
+                           type, (int)j, double(g.value), bound);
+            }
+        }
+
+        // Not solvable
+        if (least_squares(n - 1, n, a0.data(), a1.data(), n, b0.data(), b1.data(),
+                          x0.data(), x1.data()))
+        {
+            if (errors++ < 25)
+                printf("ERROR: type=%s m < n: least_squares must fail\n", type);
+        }
+        for (size_t i = 0; i < m; i++)
+            a0[i*n + n / 2] = a1[i*n + n / 2] = 0;
+        if (least_squares(m, n, a0.data(), a1.data(), n, b0.data(), b1.data(),
+                          x0.data(), x1.data()))
+        {
+            if (errors++ < 25)
+                printf("ERROR: type=%s zero column: least_squares must fail\n", type);
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitQrLeastSquares, smoke) {
+    auto type = GetParam();
+
+#define TYPE_CASE(T)            \
+    if (type == #T) {           \
+        test_case<T>(#T);       \
+        return;                 \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(types, TestUnitQrFactor,
+                         Values("float",
+                                "double"));
+
+INSTANTIATE_TEST_SUITE_P(types, TestUnitQrLeastSquares,
+                         Values("float",
+                                "double"));
@@ -0,0 +1,200 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/reduce.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_utils.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test Dot2 over ill-conditioned data: pairs of products cancel each
+// other exactly, so exact dot product is c, the only unpaired term
+//
+// Plain loop loses all digits of c, but Dot2 must meet its bound:
+//   |d - c| <= eps |c| + gamma(n)^2 |x|.|y|, gamma(n) = n eps / (1 - n eps)
+//
+// Also, result must be bitwise same for any ISA and number of threads
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using  IsaName = std::string;
+
+using Params = typename std::tuple<TypeName, IsaName>;
+
+class TestUnitReduceDot : public TestWithParam<Params> {
+protected:
+
+    static bool same(const coupled<double>& x, const coupled<double>& y) {
+        return x.value == y.value && x.error == y.error;
+    }
+    static bool same(const coupled<float>& x, const coupled<float>& y) {
+        return x.value == y.value && x.error == y.error;
+    }
+
+    // Products like 1/eps cancel, as well as their rounding errors
+    // Return |x|.|y|
+    template<typename T>
+    static double generate(size_t n, std::vector<T>& x, std::vector<T>& y,
+                           T& c, std::mt19937& gen)
+    {
+        T scale = std::sqrt(1 / std::numeric_limits<T>::epsilon());
+        std::uniform_real_distribution<T> dis(1, 2);
+        x.resize(n);
+        y.resize(n);
+        for (size_t i = 0; i + 1 < n; i += 2)
+        {
+            x[i] = dis(gen) * scale;
+            y[i] = dis(gen) * scale;
+            x[i + 1] = -x[i];
+            y[i + 1] =  y[i];
+        }
+        c = 0;
+        if (n % 2 != 0)
+        {
+            x[n - 1] = c = dis(gen);
+            y[n - 1] = 1;
+        }
+        std::vector<size_t> perm(n);
+        for (size_t i = 0; i < n; i++)
+            perm[i] = i;
+        std::shuffle(perm.begin(), perm.end(), gen);
+        std::vector<T> xp(n), yp(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            xp[i] = x[perm[i]];
+            yp[i] = y[perm[i]];
+        }
+        x.swap(xp);
+        y.swap(yp);
+        double a = 0;
+        for (size_t i = 0; i < n; i++)
+            a += std::fabs(double(x[i]) * double(y[i]));
+        return a;
+    }
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        std::mt19937 gen;
+        T eps = std::numeric_limits<T>::epsilon();
+
+        int errors = 0;
+
+        // lengths: empty, shorter than lanes, with tails, several chunks
+        for (size_t n : { 0, 1, 2, 7, 33, 64, 65, 1001, 100001 })
+        {
+            std::vector<T> x, y;
+            T c;
+            double a = generate(n, x, y, c, gen);
+            double gamma = n * eps / (1 - n * eps);
+
+            set_reduce_threads(1);
+            coupled<T> d = dot2(x, y);
+            if (std::fabs(d.value - c) > eps * std::fabs(c) + gamma * gamma * a)
+            {
+                if (errors++ < 25)
+                {
+                    printf("ERROR: type=%s isa=%s n=%d actual=%g + %g expected=%g\n",
+                           type, name, (int)n, d.value, d.error, c);
+                }
+            }
+
+            for (int threads : { 2, 3, 8 })
+            {
+                set_reduce_threads(threads);
+                coupled<T> t = dot2(x, y);
+                if (!same(t, d))
+                {
+                    if (errors++ < 25)
+                    {
+                        printf("ERROR: type=%s isa=%s n=%d threads=%d actual=%g + %g expected=%g + %g\n",
+                               type, name, (int)n, threads, t.value, t.error, d.value, d.error);
+                    }
+                }
+            }
+
+            // versus baseline ISA, if x86
+            isa saved = current_isa();
+            if (select_isa(isa::sse2))
+            {
+                coupled<T> b = dot2(x, y);
+                if (!same(b, d))
+                {
+                    if (errors++ < 25)
+                    {
+                        printf("ERROR: type=%s isa=%s n=%d sse2=%g + %g actual=%g + %g\n",
+                               type, name, (int)n, b.value, b.error, d.value, d.error);
+                    }
+                }
+                select_isa(saved);
+            }
+        }
+
+        set_reduce_threads(0);
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitReduceDot, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto name  = std::get<1>(param);
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+#define TYPE_CASE(T)                              \
+    if (type == #T) {                             \
+        test_case<T>(#T, name.c_str());           \
+        select_isa(saved);                        \
+        return;                                   \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    select_isa(saved);
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndIsas, TestUnitReduceDot,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("generic",
+                                        "sse2",
+                                        "avx",
+                                        "avx2",
+                                        "avx512")));
@@ -0,0 +1,265 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/reduce.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_utils.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test binned rsum: result must be bitwise same for any order of terms,
+// any ISA, and any number of threads
+//
+// Data like for Sum2: pairs of terms cancel each other exactly, so the
+// exact sum is c, the only unpaired term; rsum must meet its bound:
+//   |s - c| <= eps |c| + n 2^-79 max|x|
+//
+// Additionally, data of widely ranged exponents, and Inf and NaN
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using  IsaName = std::string;
+
+using Params = typename std::tuple<TypeName, IsaName>;
+
+class TestUnitReduceRsum : public TestWithParam<Params> {
+protected:
+
+    // NB: NaN is same as NaN here
+    template<typename T>
+    static bool same(const coupled<T>& x, const coupled<T>& y) {
+        if (std::isnan(x.value) || std::isnan(y.value))
+            return std::isnan(x.value) && std::isnan(y.value);
+        return x.value == y.value && x.error == y.error;
+    }
+
+    // Terms like 1/eps cancel; return max |x|
+    template<typename T>
+    static double generate(size_t n, std::vector<T>& x, T& c, std::mt19937& gen)
+    {
+        T scale = 1 / std::numeric_limits<T>::epsilon();
+        std::uniform_real_distribution<T> dis(1, 2);
+        x.resize(n);
+        for (size_t i = 0; i + 1 < n; i += 2)
+        {
+            x[i] = dis(gen) * scale;
+            x[i + 1] = -x[i];
+        }
+        c = 0;
+        if (n % 2 != 0)
+        {
+            x[n - 1] = c = dis(gen);
+        }
+        std::shuffle(x.begin(), x.end(), gen);
+        double m = 0;
+        for (size_t i = 0; i < n; i++)
+            m = std::max(m, std::fabs(double(x[i])));
+        return m;
+    }
+
+    // Random signs and exponents, so that binned sum raises top bin
+    // NB: rsum needs |x| < 2^960
+    template<typename T>
+    static void generate_wide(size_t n, std::vector<T>& x, std::mt19937& gen)
+    {
+        int range = std::numeric_limits<T>::max_exponent * 7 / 8;
+        std::uniform_real_distribution<T> dis(-1, 1);
+        std::uniform_int_distribution<int> exp(-range, range);
+        x.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] = std::ldexp(dis(gen), exp(gen));
+        }
+    }
+
+    // Versus reordered x, other ISA, and other numbers of threads
+    template<typename T>
+    static int check_same(const char type[], const char name[],
+                          std::vector<T> x, const coupled<T>& d,
+                          std::mt19937& gen)
+    {
+        int errors = 0;
+        size_t n = x.size();
+
+        for (int threads : { 2, 3, 8 })
+        {
+            set_reduce_threads(threads);
+            coupled<T> t = rsum(x);
+            if (!same(t, d))
+            {
+                if (errors++ < 25)
+                {
+                    printf("ERROR: type=%s isa=%s n=%d threads=%d actual=%g + %g expected=%g + %g\n",
+                           type, name, (int)n, threads, t.value, t.error, d.value, d.error);
+                }
+            }
+        }
+        set_reduce_threads(1);
+
+        for (int order = 0; order < 3; order++)
+        {
+            if (order == 0)
+                std::reverse(x.begin(), x.end());
+            else if (order == 1)
+                std::sort(x.begin(), x.end());
+            else
+                std::shuffle(x.begin(), x.end(), gen);
+            coupled<T> r = rsum(x);
+            if (!same(r, d))
+            {
+                if (errors++ < 25)
+                {
+                    printf("ERROR: type=%s isa=%s n=%d order=%d actual=%g + %g expected=%g + %g\n",
+                           type, name, (int)n, order, r.value, r.error, d.value, d.error);
+                }
+            }
+        }
+
+        // versus baseline ISA, if x86
+        isa saved = current_isa();
+        if (select_isa(isa::sse2))
+        {
+            coupled<T> b = rsum(x);
+            if (!same(b, d))
+            {
+                if (errors++ < 25)
+                {
+                    printf("ERROR: type=%s isa=%s n=%d sse2=%g + %g actual=%g + %g\n",
+                           type, name, (int)n, b.value, b.error, d.value, d.error);
+                }
+            }
+            select_isa(saved);
+        }
+
+        return errors;
+    }
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        std::mt19937 gen;
+        T eps = std::numeric_limits<T>::epsilon();
+        T inf = std::numeric_limits<T>::infinity();
+
+        int errors = 0;
+
+        // lengths: empty, shorter than vector, with tails, several chunks
+        for (size_t n : { 0, 1, 2, 7, 33, 64, 65, 1001, 100001 })
+        {
+            std::vector<T> x;
+            T c;
+            double m = generate(n, x, c, gen);
+
+            set_reduce_threads(1);
+            coupled<T> d = rsum(x);
+            if (std::fabs(d.value - c) > eps * std::fabs(c) + n * std::ldexp(m, -79))
+            {
+                if (errors++ < 25)
+                {
+                    printf("ERROR: type=%s isa=%s n=%d actual=%g + %g expected=%g\n",
+                           type, name, (int)n, d.value, d.error, c);
+                }
+            }
+            errors += check_same(type, name, x, d, gen);
+
+            generate_wide(n, x, gen);
+            d = rsum(x);
+            errors += check_same(type, name, x, d, gen);
+
+            // Inf and NaN
+            if (n >= 2)
+            {
+                x[n / 2] = inf;
+                d = rsum(x);
+                if (d.value != inf)
+                {
+                    if (errors++ < 25)
+                    {
+                        printf("ERROR: type=%s isa=%s n=%d actual=%g expected=inf\n",
+                               type, name, (int)n, d.value);
+                    }
+                }
+                errors += check_same(type, name, x, d, gen);
+
+                x[0] = -inf;
+                d = rsum(x);
+                if (!std::isnan(d.value))
+                {
+                    if (errors++ < 25)
+                    {
+                        printf("ERROR: type=%s isa=%s n=%d actual=%g expected=nan\n",
+                               type, name, (int)n, d.value);
+                    }
+                }
+                errors += check_same(type, name, x, d, gen);
+            }
+        }
+
+        set_reduce_threads(0);
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitReduceRsum, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto name  = std::get<1>(param);
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+#define TYPE_CASE(T)                              \
+    if (type == #T) {                             \
+        test_case<T>(#T, name.c_str());           \
+        select_isa(saved);                        \
+        return;                                   \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    select_isa(saved);
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndIsas, TestUnitReduceRsum,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("generic",
+                                        "sse2",
+                                        "avx",
+                                        "avx2",
+                                        "avx512")));
@@ -0,0 +1,183 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/reduce.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_utils.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test Sum2 over ill-conditioned data: pairs of terms cancel each other
+// exactly, so exact sum is c, the only unpaired term
+//
+// Plain loop loses all digits of c, but Sum2 must meet its bound:
+//   |s - c| <= eps |c| + gamma(n)^2 sum |x|, gamma(n) = n eps / (1 - n eps)
+//
+// Also, result must be bitwise same for any ISA and number of threads
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using  IsaName = std::string;
+
+using Params = typename std::tuple<TypeName, IsaName>;
+
+class TestUnitReduceSum : public TestWithParam<Params> {
+protected:
+
+    static bool same(const coupled<double>& x, const coupled<double>& y) {
+        return x.value == y.value && x.error == y.error;
+    }
+    static bool same(const coupled<float>& x, const coupled<float>& y) {
+        return x.value == y.value && x.error == y.error;
+    }
+
+    // Terms like 1/eps cancel; return sum |x|
+    template<typename T>
+    static double generate(size_t n, std::vector<T>& x, T& c, std::mt19937& gen)
+    {
+        T scale = 1 / std::numeric_limits<T>::epsilon();
+        std::uniform_real_distribution<T> dis(1, 2);
+        x.resize(n);
+        for (size_t i = 0; i + 1 < n; i += 2)
+        {
+            x[i] = dis(gen) * scale;
+            x[i + 1] = -x[i];
+        }
+        c = 0;
+        if (n % 2 != 0)
+        {
+            x[n - 1] = c = dis(gen);
+        }
+        std::shuffle(x.begin(), x.end(), gen);
+        double a = 0;
+        for (size_t i = 0; i < n; i++)
+            a += std::fabs(double(x[i]));
+        return a;
+    }
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        std::mt19937 gen;
+        T eps = std::numeric_limits<T>::epsilon();
+
+        int errors = 0;
+
+        // lengths: empty, shorter than lanes, with tails, several chunks
+        for (size_t n : { 0, 1, 2, 7, 33, 64, 65, 1001, 100001 })
+        {
+            std::vector<T> x;
+            T c;
+            double a = generate(n, x, c, gen);
+            double gamma = n * eps / (1 - n * eps);
+
+            set_reduce_threads(1);
+            coupled<T> d = sum(x);
+            if (std::fabs(d.value - c) > eps * std::fabs(c) + gamma * gamma * a)
+            {
+                if (errors++ < 25)
+                {
+                    printf("ERROR: type=%s isa=%s n=%d actual=%g + %g expected=%g\n",
+                           type, name, (int)n, d.value, d.error, c);
+                }
+            }
+
+            for (int threads : { 2, 3, 8 })
+            {
+                set_reduce_threads(threads);
+                coupled<T> t = sum(x);
+                if (!same(t, d))
+                {
+                    if (errors++ < 25)
+                    {
+                        printf("ERROR: type=%s isa=%s n=%d threads=%d actual=%g + %g expected=%g + %g\n",
+                               type, name, (int)n, threads, t.value, t.error, d.value, d.error);
+                    }
+                }
+            }
+
+            // versus baseline ISA, if x86
+            isa saved = current_isa();
+            if (select_isa(isa::sse2))
+            {
+                coupled<T> b = sum(x);
+                if (!same(b, d))
+                {
+                    if (errors++ < 25)
+                    {
+                        printf("ERROR: type=%s isa=%s n=%d sse2=%g + %g actual=%g + %g\n",
+                               type, name, (int)n, b.value, b.error, d.value, d.error);
+                    }
+                }
+                select_isa(saved);
+            }
+        }
+
+        set_reduce_threads(0);
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitReduceSum, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto name  = std::get<1>(param);
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+#define TYPE_CASE(T)                              \
+    if (type == #T) {                             \
+        test_case<T>(#T, name.c_str());           \
+        select_isa(saved);                        \
+        return;                                   \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    select_isa(saved);
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndIsas, TestUnitReduceSum,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("generic",
+                                        "sse2",
+                                        "avx",
+                                        "avx2",
+                                        "avx512")));
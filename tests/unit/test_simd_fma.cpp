@@ -13,12 +13,8 @@
 #include <random>
 #include <string>
 
-#if !defined(TFCP_SIMD_AVX)
-#error TFCP_SIMD_AVX undefined! (please enable AVX2)
-#endif
-
-#if !defined(TFCP_SIMD_FMA)
-#error TFCP_SIMD_FMA undefined! (please enable AVX2)
+#if !defined(TFCP_SIMD_AVX) && !defined(TFCP_SIMD_GENERIC)
+#error TFCP_SIMD_AVX undefined! (please enable AVX2 with FMA, or define TFCP_SIMD_GENERIC)
 #endif
 
 namespace {
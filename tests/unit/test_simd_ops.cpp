@@ -14,8 +14,8 @@
 
 #include <cstdio>
 
-#if !defined(TFCP_SIMD_AVX)
-#error TFCP_SIMD_AVX undefined! (please enable AVX2)
+#if !defined(TFCP_SIMD_AVX) && !defined(TFCP_SIMD_GENERIC)
+#error TFCP_SIMD_AVX undefined! (please enable AVX2 with FMA, or define TFCP_SIMD_GENERIC)
 #endif
 
 namespace {
@@ -116,6 +116,24 @@ TEST_P(TestUnitSimdOps, smoke) {
 
 //----------------------------------------------------------------------
 
+// Short-vector length must match the selected SIMD backend
+TEST(TestUnitSimdLength, smoke) {
+#if defined(TFCP_SIMD_GENERIC)
+    EXPECT_EQ(traitx<floatx>::length, TFCP_SIMD_WIDTH / 4);
+    EXPECT_EQ(traitx<doublex>::length, TFCP_SIMD_WIDTH / 8);
+#elif defined(TFCP_SIMD_AVX512)
+    EXPECT_EQ(traitx<floatx>::length, 16);
+    EXPECT_EQ(traitx<doublex>::length, 8);
+#else
+    EXPECT_EQ(traitx<floatx>::length, 8);
+    EXPECT_EQ(traitx<doublex>::length, 4);
+#endif
+    EXPECT_EQ(traitx<float>::length, 1);
+    EXPECT_EQ(traitx<double>::length, 1);
+}
+
+//----------------------------------------------------------------------
+
 } // namespace
 
 INSTANTIATE_TEST_SUITE_P(typesAndOps, TestUnitSimdOps,
@@ -0,0 +1,246 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/soa_vector.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/twofold.h>
+#include <tfcp/basic.h>
+#include <tfcp/simd.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test soa_vector of twofold/coupled against std::vector of same
+//
+// - Planes must be aligned, and proxy access must read/write exactly
+//   same numbers as the scalar types
+// - Array-wide batch operations, and basic.h templates called over
+//   the short-vector planes, must equal the scalar operators exactly
+//
+//----------------------------------------------------------------------
+
+// Moves must not throw, so std::vector of soa_vector moves them
+static_assert(std::is_nothrow_move_constructible<soa_vector<pdouble>>::value &&
+              std::is_nothrow_move_assignable<soa_vector<pdouble>>::value,
+              "soa_vector must move without throwing");
+
+using TypeName = std::string;
+using ShapeName = std::string;
+using   OpName = std::string;
+
+using Params = typename std::tuple<TypeName, ShapeName, OpName>;
+
+class TestUnitSoaVector : public TestWithParam<Params> {
+protected:
+
+    // Let batch kernels use FMA same way as this test, see test_batch_ops
+    void SetUp() override
+    {
+        m_saved = current_isa();
+    #if defined(TFCP_SIMD_NOFMA)
+        select_isa(isa::avx);
+    #endif
+    }
+
+    void TearDown() override
+    {
+        select_isa(m_saved);
+    }
+
+    isa m_saved;
+
+    template<typename P>
+    static void check(int& errors, const P& r, const P& e,
+                      const char type[], const char shape[], const char op[],
+                      size_t i)
+    {
+        if (r.value != e.value || r.error != e.error)
+        {
+            if (errors++ < 25)
+            {
+                printf("ERROR: type=%s shape=%s op=%s i=%d actual=%g + %g expected=%g + %g\n",
+                       type, shape, op, static_cast<int>(i),
+                       r.value, r.error, e.value, e.error);
+            }
+        }
+    }
+
+    template<typename T>
+    static bool aligned(const T* p)
+    {
+        return reinterpret_cast<uintptr_t>(p) % 64 == 0;
+    }
+
+    // Proxy access, copy, resize, alignment
+    template<typename T, typename P>
+    static void test_access(const char type[], const char shape[], const char op[])
+    {
+        size_t n = 1000;
+        soa_vector<P> x(n);
+        std::vector<P> e(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            e[i] = P(T(i), T(i) / (1 << 30));
+            x[i] = e[i];
+        }
+
+        EXPECT_TRUE(aligned(x.values().data()));
+        EXPECT_TRUE(aligned(x.errors().data()));
+
+        x[1] += x[2];
+        e[1] += e[2];
+        x[3] = x[4] * e[5];
+        e[3] = e[4] * e[5];
+        x[6].error = 0;
+        e[6].error = 0;
+
+        soa_vector<P> y = x;
+        y.resize(n + 17, e[7]);
+        y.push_back(e[8]);
+        e.resize(n + 17, e[7]);
+        e.push_back(e[8]);
+
+        EXPECT_EQ(y.size(), e.size());
+        EXPECT_TRUE(aligned(y.values().data()));
+        EXPECT_TRUE(aligned(y.errors().data()));
+
+        int errors = 0;
+        for (size_t i = 0; i < e.size(); i++)
+        {
+            check<P>(errors, y[i], e[i], type, shape, op, i);
+        }
+        EXPECT_EQ(errors, 0);
+    }
+
+    // Array-wide arithmetic: by batch, and by short-vector planes
+    template<typename T, typename P, typename TX, typename B, typename F, typename S>
+    static void test_case(const char type[], const char shape[], const char op[],
+                          B b, F f, S s)
+    {
+        std::seed_seq seed({ 1, 2, 3 });
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<T> dis(1, 2);
+
+        size_t n = 1000 + 3;  // not multiple of vector length
+        soa_vector<P> x(n), y(n), z(n), w(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            T x0 = dis(gen), y0 = dis(gen);
+            x[i] = P(x0, x0 * dis(gen) / (1 << 30));
+            y[i] = P(y0, y0 * dis(gen) / (1 << 30));
+        }
+
+        b(x, y, z);
+
+        const TX *x0 = x.template valuesx<TX>(), *x1 = x.template errorsx<TX>();
+        const TX *y0 = y.template valuesx<TX>(), *y1 = y.template errorsx<TX>();
+        TX *w0 = w.template valuesx<TX>(), *w1 = w.template errorsx<TX>();
+        for (size_t k = 0; k < w.template sizex<TX>(); k++)
+        {
+            w0[k] = f(x0[k], x1[k], y0[k], y1[k], w1[k]);
+        }
+
+        int errors = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            P e = s(P(x[i]), P(y[i]));
+            check<P>(errors, z[i], e, type, shape, op, i);
+            check<P>(errors, w[i], e, type, shape, op, i);
+        }
+        EXPECT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitSoaVector, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto shape = std::get<1>(param);
+    auto op    = std::get<2>(param);
+
+#define OP_CASE(T, TX, SHAPE, PREFIX, F, OP)                                  \
+    if (op == #F) {                                                           \
+        test_case<T, SHAPE<T>, TX>(#T, #SHAPE, #F,                            \
+            [](const soa_vector<SHAPE<T>>& x, const soa_vector<SHAPE<T>>& y,  \
+                     soa_vector<SHAPE<T>>& z) { batch::PREFIX ## F(x, y, z); }, \
+            [](TX x0, TX x1, TX y0, TX y1, TX& z1) {                          \
+                return PREFIX ## F(x0, x1, y0, y1, z1); },                    \
+            [](const SHAPE<T>& x, const SHAPE<T>& y) { return x OP y; });     \
+        return;                                                               \
+    }
+
+#define SQRT_CASE(T, TX, SHAPE, PREFIX)                                       \
+    if (op == "sqrt") {                                                       \
+        test_case<T, SHAPE<T>, TX>(#T, #SHAPE, "sqrt",                        \
+            [](const soa_vector<SHAPE<T>>& x, const soa_vector<SHAPE<T>>&,    \
+                     soa_vector<SHAPE<T>>& z) { batch::PREFIX ## sqrt(x, z); }, \
+            [](TX x0, TX x1, TX, TX, TX& z1) {                                \
+                return PREFIX ## sqrt(x0, x1, z1); },                         \
+            [](const SHAPE<T>& x, const SHAPE<T>&) { return sqrt(x); });      \
+        return;                                                               \
+    }
+
+#define SHAPE_CASE(T, TX, SHAPE, PREFIX)                                      \
+    if (shape == #SHAPE) {                                                    \
+        if (op == "access") {                                                 \
+            test_access<T, SHAPE<T>>(#T, #SHAPE, "access");                   \
+            return;                                                           \
+        }                                                                     \
+        OP_CASE(T, TX, SHAPE, PREFIX, add, +);                                \
+        OP_CASE(T, TX, SHAPE, PREFIX, sub, -);                                \
+        OP_CASE(T, TX, SHAPE, PREFIX, mul, *);                                \
+        OP_CASE(T, TX, SHAPE, PREFIX, div, /);                                \
+        SQRT_CASE(T, TX, SHAPE, PREFIX);                                      \
+        FAIL() << "unknown op: " << op;                                       \
+    }
+
+#define TYPE_CASE(T, TX)                                                      \
+    if (type == #T) {                                                         \
+        SHAPE_CASE(T, TX, twofold, t);                                        \
+        SHAPE_CASE(T, TX, coupled, p);                                        \
+        FAIL() << "unknown shape: " << shape;                                 \
+    }
+
+    TYPE_CASE(float, floatx);
+    TYPE_CASE(double, doublex);
+
+#undef TYPE_CASE
+#undef SHAPE_CASE
+#undef SQRT_CASE
+#undef OP_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesShapesAndOps, TestUnitSoaVector,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("twofold",
+                                        "coupled"),
+                                 Values("access",
+                                        "add",
+                                        "sub",
+                                        "mul",
+                                        "div",
+                                        "sqrt")));
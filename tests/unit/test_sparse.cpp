@@ -0,0 +1,334 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/sparse.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_utils.h>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+using TypeName = std::string;
+using  IsaName = std::string;
+
+using Params = typename std::tuple<TypeName, IsaName>;
+
+// Random matrix: rows have up to 40 nonzeros in random columns, and
+// every 7th row has pairs of canceling entries at the same columns
+template<typename T>
+csr_matrix<T> generate(size_t rows, size_t cols, std::mt19937& gen)
+{
+    std::uniform_real_distribution<T> dis(-1, 1);
+    std::uniform_int_distribution<size_t> count(0, 40);
+    std::uniform_int_distribution<size_t> column(0, cols > 0 ? cols - 1 : 0);
+
+    csr_matrix<T> a;
+    a.rows = rows;
+    a.cols = cols;
+    a.ptr.push_back(0);
+    for (size_t i = 0; i < rows; i++)
+    {
+        size_t nz = cols > 0 ? count(gen) : 0;
+        for (size_t k = 0; k < nz; k++)
+        {
+            size_t j = column(gen);
+            T v = dis(gen);
+            a.col.push_back(j);
+            a.val.push_back(v);
+            if (i % 7 == 0)
+            {
+                a.col.push_back(j);
+                a.val.push_back(-v * (1 + std::numeric_limits<T>::epsilon()));
+            }
+        }
+        a.ptr.push_back(a.col.size());
+    }
+    return a;
+}
+
+//----------------------------------------------------------------------
+//
+// Test spmv against scalar loop by coupled operators for each row:
+//   |y - expected| <= 4 nnz eps^2 sum |a| |x|
+//
+// Result must be bitwise same for any ISA and any number of threads:
+// compare to result by SSE2
+//
+//----------------------------------------------------------------------
+
+class TestUnitSparseSpmv : public TestWithParam<Params> {
+protected:
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        std::mt19937 gen;
+        double eps = std::numeric_limits<T>::epsilon();
+        std::uniform_real_distribution<T> dis(-1, 1);
+
+        int errors = 0;
+
+        for (size_t rows : { 0, 1, 7, 3000 })
+        {
+            size_t cols = rows + 5;
+            csr_matrix<T> a = generate<T>(rows, cols, gen);
+            std::vector<T> x(cols);
+            for (size_t j = 0; j < cols; j++)
+                x[j] = dis(gen);
+
+            // Reference by SSE2, if CPU is x86
+            isa saved = current_isa();
+            bool base = select_isa(isa::sse2);
+            std::vector<T> b0(rows), b1(rows);
+            spmv(a, x.data(), b0.data(), b1.data());
+            select_isa(saved);
+
+            for (int threads : { 1, 3 })
+            {
+                set_reduce_threads(threads);
+                soa_vector<coupled<T>> y(rows, coupled<T>(-1, 0));
+                spmv(a, x, y);
+                for (size_t i = 0; i < rows; i++)
+                {
+                    coupled<T> z = y[i];
+                    coupled<T> expected(0, 0);
+                    double bound = 0;
+                    for (size_t k = a.ptr[i]; k < a.ptr[i + 1]; k++)
+                    {
+                        expected += coupled<T>(a.val[k], 0) * coupled<T>(x[a.col[k]], 0);
+                        bound += std::fabs(double(a.val[k]) * x[a.col[k]]);
+                    }
+                    bound *= 4 * (a.ptr[i + 1] - a.ptr[i]) * eps * eps;
+                    coupled<T> d = z - expected;
+                    if (std::fabs(d.value) > bound)
+                    {
+                        if (errors++ < 25)
+                            printf("ERROR: type=%s isa=%s rows=%d threads=%d i=%d "
+                                   "actual=%g + %g expected=%g + %g\n",
+                                   type, name, (int)rows, threads, (int)i,
+                                   double(z.value), double(z.error),
+                                   double(expected.value), double(expected.error));
+                    }
+                    if (base && (z.value != b0[i] || z.error != b1[i]))
+                    {
+                        if (errors++ < 25)
+                            printf("ERROR: type=%s isa=%s rows=%d threads=%d i=%d "
+                                   "actual=%g + %g sse2=%g + %g\n",
+                                   type, name, (int)rows, threads, (int)i,
+                                   double(z.value), double(z.error),
+                                   double(b0[i]), double(b1[i]));
+                    }
+                }
+            }
+        }
+
+        set_reduce_threads(0);
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitSparseSpmv, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto name  = std::get<1>(param);
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+#define TYPE_CASE(T)                              \
+    if (type == #T) {                             \
+        test_case<T>(#T, name.c_str());           \
+        select_isa(saved);                        \
+        return;                                   \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    select_isa(saved);
+    FAIL() << "unknown type: " << type;
+}
+
+// Default-constructed matrix has no rows, and empty ptr
+TEST(TestUnitSparseEmpty, smoke) {
+    csr_matrix<double> a;
+    std::vector<double> x, y0, y1;
+    spmv(a, x.data(), y0.data(), y1.data());
+    ASSERT_EQ(cg(a, x.data(), x.data(), 1e-11, 10), 0);
+    ASSERT_EQ(bicgstab(a, x.data(), x.data(), 1e-11, 10), 0);
+}
+
+//----------------------------------------------------------------------
+//
+// Test cg and bicgstab by true residual computed in coupled arithmetic:
+//   |b - a*x| <= 2 tol |b|  -- by 2-norm
+//
+// Matrices are 2D grids by 5-point stencil: diffusion with coefficient
+// that jumps by 1e4 between checkerboard cells, which is SPD and stiff;
+// and convection-diffusion, which is not symmetric
+//
+//----------------------------------------------------------------------
+
+using SolverName = std::string;
+
+class TestUnitSparseSolver : public TestWithParam<std::tuple<TypeName, SolverName>> {
+protected:
+
+    template<typename T>
+    static csr_matrix<T> grid(size_t g, bool convection)
+    {
+        csr_matrix<T> a;
+        a.rows = a.cols = g * g;
+        a.ptr.push_back(0);
+        auto coef = [&](size_t i, size_t j) {
+            return ((i / 4 + j / 4) % 2) ? T(1e4) : T(1);
+        };
+        for (size_t i = 0; i < g; i++)
+        {
+            for (size_t j = 0; j < g; j++)
+            {
+                T c = convection ? T(1) : coef(i, j);
+                T diag = 0;
+                auto link = [&](size_t ni, size_t nj, T w, T skew) {
+                    diag += w;
+                    if (ni < g && nj < g)
+                    {
+                        a.col.push_back(ni*g + nj);
+                        a.val.push_back(-w + skew);
+                    }
+                };
+                T wn = convection ? T(1) : (c + coef(i - 1 < g ? i - 1 : i, j)) / 2;
+                T ws = convection ? T(1) : (c + coef(i + 1 < g ? i + 1 : i, j)) / 2;
+                T ww = convection ? T(1) : (c + coef(i, j - 1 < g ? j - 1 : j)) / 2;
+                T we = convection ? T(1) : (c + coef(i, j + 1 < g ? j + 1 : j)) / 2;
+                T v = convection ? T(0.4) : T(0);
+                link(i - 1, j, wn, -v);
+                link(i + 1, j, ws, v);
+                link(i, j - 1, ww, -v);
+                link(i, j + 1, we, v);
+                a.col.push_back(i*g + j);
+                a.val.push_back(diag);
+                a.ptr.push_back(a.col.size());
+            }
+        }
+        return a;
+    }
+
+    template<typename T>
+    static void test_case(const char type[], const std::string& solver)
+    {
+        std::mt19937 gen;
+        std::uniform_real_distribution<T> dis(-1, 1);
+        T tol = sizeof(T) == sizeof(double) ? T(1e-11) : T(1e-4);
+
+        int errors = 0;
+
+        for (size_t g : { 1, 5, 40 })
+        {
+            for (int threads : { 1, 3 })
+            {
+                set_reduce_threads(threads);
+
+                csr_matrix<T> a = grid<T>(g, solver == "bicgstab");
+                size_t n = a.rows;
+                std::vector<T> b(n), x(n, 0);
+                for (size_t i = 0; i < n; i++)
+                    b[i] = dis(gen);
+
+                int iters = solver == "cg" ? cg(a, b.data(), x.data(), tol, 10000)
+                                           : bicgstab(a, b.data(), x.data(), tol, 10000);
+                if (iters < 0)
+                {
+                    if (errors++ < 25)
+                        printf("ERROR: type=%s solver=%s grid=%d threads=%d not converged\n",
+                               type, solver.c_str(), (int)g, threads);
+                    continue;
+                }
+
+                double rr = 0, bb = 0;
+                for (size_t i = 0; i < n; i++)
+                {
+                    coupled<T> r(b[i], 0);
+                    for (size_t k = a.ptr[i]; k < a.ptr[i + 1]; k++)
+                        r -= coupled<T>(a.val[k], 0) * coupled<T>(x[a.col[k]], 0);
+                    rr += double(r.value) * r.value;
+                    bb += double(b[i]) * b[i];
+                }
+                if (std::sqrt(rr) > 2 * tol * std::sqrt(bb))
+                {
+                    if (errors++ < 25)
+                        printf("ERROR: type=%s solver=%s grid=%d threads=%d iters=%d "
+                               "residual=%g bound=%g\n", type, solver.c_str(), (int)g,
+                               threads, iters, std::sqrt(rr), 2 * tol * std::sqrt(bb));
+                }
+            }
+        }
+
+        set_reduce_threads(0);
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitSparseSolver, smoke) {
+    auto param = GetParam();
+    auto type   = std::get<0>(param);
+    auto solver = std::get<1>(param);
+
+#define TYPE_CASE(T)                              \
+    if (type == #T) {                             \
+        test_case<T>(#T, solver);                 \
+        return;                                   \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndIsas, TestUnitSparseSpmv,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("generic",
+                                        "sse2",
+                                        "avx",
+                                        "avx2",
+                                        "avx512")));
+
+INSTANTIATE_TEST_SUITE_P(typesAndSolvers, TestUnitSparseSolver,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("cg",
+                                        "bicgstab")));
@@ -0,0 +1,173 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/tridiag.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_utils.h>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test tridiag_solve by residual computed in coupled arithmetic:
+//   |d - a x[i-1] - b x[i] - c x[i+1]| <= 8 eps^2 (|a| |x| + ... + |d|)
+//
+// for diagonally dominant systems, for each ISA that CPU supports; and
+// result must be bitwise same for any number of threads
+//
+// Batch sizes include tails shorter than vector, and several chunks
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using  IsaName = std::string;
+
+using Params = typename std::tuple<TypeName, IsaName>;
+
+class TestUnitTridiag : public TestWithParam<Params> {
+protected:
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        std::mt19937 gen;
+        double eps = std::numeric_limits<T>::epsilon();
+        std::uniform_real_distribution<T> dis(-1, 1);
+
+        int errors = 0;
+
+        struct { size_t n, batch; } sizes[] = {
+            { 0, 3 }, { 1, 1 }, { 2, 3 }, { 5, 17 }, { 64, 100 }, { 33, 600 }
+        };
+
+        for (auto size : sizes)
+        {
+            size_t n = size.n, batch = size.batch, len = n * batch;
+
+            std::vector<T> a(len), b(len), c(len), d(len);
+            for (size_t k = 0; k < len; k++)
+            {
+                a[k] = dis(gen);
+                c[k] = dis(gen);
+                b[k] = (dis(gen) > 0 ? 1 : -1) * (2 + std::fabs(dis(gen)));
+                d[k] = dis(gen);
+            }
+
+            std::vector<T> x0[2], x1[2];
+            for (int threads : { 1, 3 })
+            {
+                set_reduce_threads(threads);
+                auto& y0 = x0[threads > 1];
+                auto& y1 = x1[threads > 1];
+                y0.assign(len, -1);
+                y1.assign(len, -1);
+                tridiag_solve(n, batch, a.data(), b.data(), c.data(), d.data(),
+                              y0.data(), y1.data());
+            }
+
+            for (size_t k = 0; k < len; k++)
+            {
+                if (x0[0][k] != x0[1][k] || x1[0][k] != x1[1][k])
+                {
+                    if (errors++ < 25)
+                        printf("ERROR: type=%s isa=%s n=%d batch=%d k=%d threads=3: "
+                               "%g + %g expected=%g + %g\n", type, name, (int)n,
+                               (int)batch, (int)k, double(x0[1][k]), double(x1[1][k]),
+                               double(x0[0][k]), double(x1[0][k]));
+                }
+            }
+
+            for (size_t s = 0; s < batch; s++)
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    size_t k = i*batch + s;
+                    coupled<T> r(d[k], 0);
+                    double bound = std::fabs(double(d[k]));
+                    auto term = [&](T coef, size_t j) {
+                        coupled<T> x(x0[0][j], x1[0][j]);
+                        r -= coupled<T>(coef, 0) * x;
+                        bound += std::fabs(double(coef) * x.value);
+                    };
+                    if (i > 0)
+                        term(a[k], k - batch);
+                    term(b[k], k);
+                    if (i + 1 < n)
+                        term(c[k], k + batch);
+                    bound *= 8 * eps * eps;
+                    if (std::fabs(r.value) > bound)
+                    {
+                        if (errors++ < 25)
+                            printf("ERROR: type=%s isa=%s n=%d batch=%d s=%d i=%d "
+                                   "residual=%g bound=%g\n", type, name, (int)n,
+                                   (int)batch, (int)s, (int)i, double(r.value), bound);
+                    }
+                }
+            }
+        }
+
+        set_reduce_threads(0);
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitTridiag, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto name  = std::get<1>(param);
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+#define TYPE_CASE(T)                              \
+    if (type == #T) {                             \
+        test_case<T>(#T, name.c_str());           \
+        select_isa(saved);                        \
+        return;                                   \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    select_isa(saved);
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndIsas, TestUnitTridiag,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("generic",
+                                        "sse2",
+                                        "avx",
+                                        "avx2",
+                                        "avx512")));
@@ -0,0 +1,404 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/elementary.h>
+#include <tfcp/elementaryx.h>
+#include <tfcp/dispatch.h>
+#include <tfcp/reduce.h>
+#include <tfcp/twofold.h>
+
+#include <tfcp/test_utils.h>
+#include <tfcp/test_quad.h>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test sin, cos, tan, and sincos versus reference in __float128:
+//   |z0 + z1 - f(x)| <= 4 eps^2 (|f| + eps |x| f') + denorm_min
+//
+// where eps |x| f' allows for the error of reducing x by pi/2, which
+// matters only if f(x) is close to zero; and twice more for tan
+//
+// Arguments are tiny to 10^12, so both Cody-Waite and Payne-Hanek go;
+// plus multiples of pi/2 rounded to T, and table of huge x for double
+//
+// Result must be bitwise same for 1 and 3 threads, in-place arrays,
+// single calls, and sincos; special values give NaN; and short-vector
+// forms of elementaryx.h must meet the same bound
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using  IsaName = std::string;
+
+using Params = typename std::tuple<TypeName, IsaName>;
+
+#if defined(TFCP_TEST_QUAD)
+
+using tfcp_test::quad;
+
+#endif
+
+class TestUnitTrig : public TestWithParam<Params> {
+protected:
+
+#if defined(TFCP_TEST_QUAD)
+
+    template<typename T>
+    using batch_unary = void (*)(size_t, const T[], const T[], T[], T[]);
+
+    // Tail of x: random within half ulp of x0
+    template<typename T>
+    static T tail(std::mt19937& gen, T x0)
+    {
+        using L = std::numeric_limits<T>;
+        std::uniform_real_distribution<T> dis(-1, 1);
+        if (std::fabs(x0) < L::min() / L::epsilon())
+            return 0;
+        return x0 * L::epsilon() * dis(gen) / 4;
+    }
+
+    // Reference sine, cosine, and tangent
+    struct reference {
+        quad s, c, t;
+        reference(quad x0, quad x1) {
+            tfcp_test::sincos_quad(x0, x1, s, c);
+            t = s / c;
+        }
+    };
+
+    // Check z versus reference, return number of errors
+    template<typename T>
+    static int check(const char type[], const char name[], const char func[],
+                     T x0, T z0, T z1, quad ref, double scale, double slope)
+    {
+        using L = std::numeric_limits<T>;
+        double eps = L::epsilon();
+        quad diff = tfcp_test::fabs_quad(static_cast<quad>(z0) + z1 - ref);
+        double bound = 4 * eps * eps * (scale * std::fabs(static_cast<double>(ref)) +
+                                        eps * std::fabs(double(x0)) * slope)
+                     + L::denorm_min();
+        if (diff <= bound)
+            return 0;
+        printf("ERROR: type=%s isa=%s func=%s x=%.17g: "
+               "%.17g + %g error=%g bound=%g\n", type, name, func, double(x0),
+               double(z0), double(z1), static_cast<double>(diff), bound);
+        return 1;
+    }
+
+    // Check sin, cos, tan of x versus reference
+    template<typename T>
+    static int check3(const char type[], const char name[], T x0, const reference& r,
+                      const coupled<T>& s, const coupled<T>& c, const coupled<T>& t)
+    {
+        double tt = static_cast<double>(r.t);
+        return check(type, name, "sin", x0, s.value, s.error, r.s, 1, 1) +
+               check(type, name, "cos", x0, c.value, c.error, r.c, 1, 1) +
+               check(type, name, "tan", x0, t.value, t.error, r.t, 2, 2 * (1 + tt * tt));
+    }
+
+    // Same bits, or both NaN
+    template<typename T>
+    static bool same(T a, T b)
+    {
+        return a == b || (std::isnan(a) && std::isnan(b));
+    }
+
+    // Batch by 1 and 3 threads, and in-place: same bits, else error
+    template<typename T>
+    static int batch(const char type[], const char name[], const char func[],
+                     batch_unary<T> f, const std::vector<T>& x0, const std::vector<T>& x1,
+                     std::vector<T>& z0, std::vector<T>& z1)
+    {
+        size_t n = x0.size();
+        std::vector<T> r0[2], r1[2];
+        for (int threads : { 1, 3 })
+        {
+            set_reduce_threads(threads);
+            auto& a0 = r0[threads > 1];
+            auto& a1 = r1[threads > 1];
+            a0.assign(n, -1);
+            a1.assign(n, -1);
+            f(n, x0.data(), x1.data(), a0.data(), a1.data());
+        }
+        set_reduce_threads(0);
+
+        std::vector<T> w0(x0), w1(x1);
+        f(n, w0.data(), w1.data(), w0.data(), w1.data());
+
+        int errors = 0;
+        for (size_t k = 0; k < n; k++) {
+            if (!same(r0[1][k], r0[0][k]) || !same(r1[1][k], r1[0][k]) ||
+                !same(w0[k], r0[0][k]) || !same(w1[k], r1[0][k]))
+            {
+                if (errors++ < 25)
+                    printf("ERROR: type=%s isa=%s func=%s x=%.17g: "
+                           "%g + %g differs by threads or in-place\n",
+                           type, name, func, double(x0[k]),
+                           double(r0[0][k]), double(r1[0][k]));
+            }
+        }
+        z0 = r0[0];
+        z1 = r1[0];
+        return errors;
+    }
+
+    template<typename T>
+    static int test_sample(const char type[], const char name[],
+                           const std::vector<T>& x0, const std::vector<T>& x1)
+    {
+        size_t n = x0.size();
+        std::vector<T> s0, s1, c0, c1, t0, t1;
+        int errors = 0;
+        errors += batch<T>(type, name, "sin", tfcp::sin, x0, x1, s0, s1);
+        errors += batch<T>(type, name, "cos", tfcp::cos, x0, x1, c0, c1);
+        errors += batch<T>(type, name, "tan", tfcp::tan, x0, x1, t0, t1);
+
+        std::vector<T> u0(n), u1(n), v0(n), v1(n);
+        tfcp::sincos(n, x0.data(), x1.data(), u0.data(), u1.data(), v0.data(), v1.data());
+
+        for (size_t k = 0; k < n && errors < 25; k++)
+        {
+            coupled<T> x(x0[k], x1[k]), s, c;
+            tfcp::sincos(x, s, c);
+            coupled<T> ss = tfcp::sin(x), cc = tfcp::cos(x), tt = tfcp::tan(x);
+            if (!same(ss.value, s0[k]) || !same(ss.error, s1[k]) ||
+                !same(cc.value, c0[k]) || !same(cc.error, c1[k]) ||
+                !same(tt.value, t0[k]) || !same(tt.error, t1[k]) ||
+                !same(s.value, s0[k]) || !same(s.error, s1[k]) ||
+                !same(c.value, c0[k]) || !same(c.error, c1[k]) ||
+                !same(u0[k], s0[k]) || !same(u1[k], s1[k]) ||
+                !same(v0[k], c0[k]) || !same(v1[k], c1[k]))
+            {
+                errors++;
+                printf("ERROR: type=%s isa=%s x=%.17g: single or sincos differs\n",
+                       type, name, double(x0[k]));
+                continue;
+            }
+            reference r(x0[k], x1[k]);
+            errors += check3(type, name, x0[k], r, ss, cc, tt);
+        }
+
+        return errors;
+    }
+
+    // Short-vector forms: same bound
+    template<typename T>
+    static int test_vector(const char type[], const char name[],
+                           const std::vector<T>& x0, const std::vector<T>& x1)
+    {
+        using TX = typename traitx<T>::vector;
+        constexpr int lenx = traitx<TX>::length;
+        int errors = 0;
+        for (size_t k = 0; k + lenx <= x0.size() && errors < 25; k += lenx)
+        {
+            coupled<TX> x(loadx<TX>(&x0[k]), loadx<TX>(&x1[k])), s, c;
+            tfcp::sincos(x, s, c);
+            coupled<TX> ss = tfcp::sin(x), cc = tfcp::cos(x), tt = tfcp::tan(x);
+            for (int l = 0; l < lenx; l++) {
+                reference r(x0[k + l], x1[k + l]);
+                errors += check3(type, name, x0[k + l], r,
+                                 getx(ss, l), getx(cc, l), getx(tt, l));
+                if (!same(getx(s.value, l), getx(ss.value, l)) ||
+                    !same(getx(c.error, l), getx(cc.error, l))) {
+                    errors++;
+                    printf("ERROR: type=%s isa=%s x=%.17g: short-vector sincos differs\n",
+                           type, name, double(x0[k + l]));
+                }
+            }
+        }
+        return errors;
+    }
+
+    // Huge x versus table, which is computed with thousands bits of pi
+    static int test_huge(const char name[])
+    {
+        static const double table[][6] = {
+            // x0, x1, sin(x) as hi + lo, cos(x) as hi + lo
+            { 1e+22, 0.0, -0.8522008497671888, -6.7806825896773284e-18,
+                          0.523214785395139, -4.7143201076575164e-17 },
+            { 1e+22, 100000.0, 0.8703604289819313, 4.988765426055437e-17,
+                               -0.4924151943861891, 1.7606918768182305e-18 },
+            { -1e+300, 0.0, 0.8178819121159085, 4.78135837440326e-17,
+                            -0.5753861119575491, 2.6770761918787068e-17 },
+            { 1.7976931348623157e+308, 0.0, 0.004961954789184062, -2.5049377676494104e-19,
+                                            -0.9999876894265599, -2.6032890267216748e-17 },
+            // closest double to multiple of pi/2
+            { 5.319372648326541e+255, 0.0, 1.0, -1.098476220074687e-37,
+                                           -4.687165924254628e-19, 4.3720557429382733e-36 },
+            { -5.319372648326541e+255, 6.064523798049644e+228,
+                 -0.9952241523071313, -3.961903030107022e-17,
+                 0.09761601643455721, 6.3429582649661004e-18 },
+            { 10000000.0, 1e-10, 0.42054779310005547, -1.431890374387829e-17,
+                                 -0.9072703862237943, -3.9814361219137503e-17 },
+            { 1000000.5, -3e-11, 0.14195469897104782, -6.889606398434541e-18,
+                                 0.9898731552274964, -7.758028683567419e-18 },
+            { -3000000000.0, -5e-08, -0.987004878439842, 7.248397046153829e-19,
+                                     -0.1606902919779312, 5.532635096086397e-18 },
+            { 123456789012345.0, 0.002, -0.597054087459717, -3.9323912286091647e-17,
+                                        0.8022009827017444, 4.0643146200728216e-17 },
+            { 1.152921504606847e+18, 22.4, 0.9835429366442356, 2.689774352424716e-17,
+                                           0.18067454656711615, -1.2755078051993962e-17 },
+            { -3.273390607896142e+150, 2.8392137667797144e+132,
+                 -0.9983375292778461, -2.4463750511660585e-17,
+                 -0.057638334773010745, -1.4524279897643197e-18 },
+            { 5000000000000000.0, 0.25, -0.98064178832097, -3.9685190194009703e-19,
+                                        -0.19581032403489296, -9.264152084058823e-18 }
+        };
+
+        int errors = 0;
+        for (auto& row : table) {
+            coupled<double> x(row[0], row[1]), s, c;
+            tfcp::sincos(x, s, c);
+            quad rs = static_cast<quad>(row[2]) + row[3];
+            quad rc = static_cast<quad>(row[4]) + row[5];
+            errors += check("double", name, "sin", 0.0, s.value, s.error, rs, 1, 0);
+            errors += check("double", name, "cos", 0.0, c.value, c.error, rc, 1, 0);
+        }
+        return errors;
+    }
+
+    template<typename T>
+    static int test_special(const char type[], const char name[])
+    {
+        using L = std::numeric_limits<T>;
+        T inf = L::infinity(), nan = L::quiet_NaN();
+
+        int errors = 0;
+        auto expect = [&](const char func[], coupled<T> z, T z0, T x) {
+            if (same(z.value, z0) && z.error == 0)
+                return;
+            if (errors++ < 25)
+                printf("ERROR: type=%s isa=%s func=%s x=%g: %g + %g expected=%g\n",
+                       type, name, func, double(x), double(z.value),
+                       double(z.error), double(z0));
+        };
+
+        for (T x : { inf, -inf, nan }) {
+            coupled<T> s, c;
+            tfcp::sincos(coupled<T>(x), s, c);
+            expect("sin", tfcp::sin(coupled<T>(x)), nan, x);
+            expect("cos", tfcp::cos(coupled<T>(x)), nan, x);
+            expect("tan", tfcp::tan(coupled<T>(x)), nan, x);
+            expect("sincos", s, nan, x);
+            expect("sincos", c, nan, x);
+        }
+
+        // Zero argument is exact
+        expect("sin", tfcp::sin(coupled<T>(T(0))), 0, 0);
+        expect("cos", tfcp::cos(coupled<T>(T(0))), 1, 0);
+        expect("tan", tfcp::tan(coupled<T>(T(0))), 0, 0);
+
+        return errors;
+    }
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        using L = std::numeric_limits<T>;
+        std::mt19937 gen;
+        std::uniform_real_distribution<T> dis(0, 1);
+        auto sign = [&]() { return dis(gen) < 0.5 ? T(-1) : T(1); };
+        auto power = [&](double lo, double hi) {
+            return static_cast<T>(std::pow(10.0, lo + (hi - lo) * dis(gen)));
+        };
+
+        // Sizes so arrays split into several chunks, with tails; range
+        // of Cody-Waite is 10^6 for double, and 10^4 for float
+        const int n = 3001, m = 1000;
+        double range = L::digits > 24 ? 6 : 4;
+        double tiny = std::log10(double(L::min() / L::epsilon())) / 2;
+        double pio2 = 1.5707963267948966;
+
+        std::vector<T> x0, x1;
+        auto push = [&](T x) {
+            x0.push_back(x);
+            x1.push_back(tail(gen, x));
+        };
+        for (int k = 0; k < n; k++) {
+            push(sign() * power(-1, range + 0.5));
+        }
+        for (int k = 0; k < m; k++) {
+            push(sign() * power(tiny, 0));
+            push(sign() * power(range, 12));
+            push(static_cast<T>(pio2 * std::floor(dis(gen) * std::pow(10.0, range))));
+        }
+
+        int errors = 0;
+        errors += test_sample<T>(type, name, x0, x1);
+        errors += test_vector<T>(type, name, x0, x1);
+        if (L::digits > 24)
+            errors += test_huge(name);
+        errors += test_special<T>(type, name);
+
+        ASSERT_EQ(errors, 0);
+    }
+
+#else
+
+    template<typename T>
+    static void test_case(const char type[], const char name[])
+    {
+        printf("SKIP: type=%s isa=%s no __float128 for reference\n", type, name);
+    }
+
+#endif
+};
+
+TEST_P(TestUnitTrig, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto name  = std::get<1>(param);
+
+    isa saved = current_isa();
+    if (!select_isa_by_name(name)) {
+        printf("SKIP: isa=%s not supported by CPU\n", name.c_str());
+        return;
+    }
+
+#define TYPE_CASE(T)                              \
+    if (type == #T) {                             \
+        test_case<T>(#T, name.c_str());           \
+        select_isa(saved);                        \
+        return;                                   \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+
+    select_isa(saved);
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndIsas, TestUnitTrig,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("generic",
+                                        "sse2",
+                                        "avx",
+                                        "avx2",
+                                        "avx512")));
@@ -0,0 +1,199 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/twofoldx.h>
+#include <tfcp/twofold.h>
+#include <tfcp/simd.h>
+
+#include <tfcp/test_quad.h>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test fused coupled operations: fma, fms, dot2, sum3
+//
+// Versus exact result in __float128, with bound relative to the sum of
+// magnitudes of the terms, as terms may cancel:
+//   |z0 + z1 - exact| <= 4 eps^2 (|terms|) + denorm_min
+//
+// Result must be renormalized: z0 + z1 rounds to z0; and each position
+// of short-vector result must equal the scalar result exactly
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using   OpName = std::string;
+
+using Params = typename std::tuple<TypeName, OpName>;
+
+#if defined(TFCP_TEST_QUAD)
+
+using tfcp_test::quad;
+
+#endif
+
+class TestUnitTwofoldFused : public TestWithParam<Params> {
+protected:
+
+#if defined(TFCP_TEST_QUAD)
+
+    static quad exact(const shaped<double>& x) { return static_cast<quad>(x.value) + x.error; }
+    static quad exact(const shaped<float> & x) { return static_cast<quad>(x.value) + x.error; }
+
+    // F computes result by scalar coupled, FX by short-vector coupled, and
+    // R gives exact result and sum of magnitudes of the terms
+    template<typename T, typename TX, typename F, typename FX, typename R>
+    static void test_case(const char type[], const char op[], F f, FX fx, R r)
+    {
+        using L = std::numeric_limits<T>;
+        static constexpr int lenx = traitx<TX>::length;
+        double eps = L::epsilon();
+
+        std::mt19937 gen;
+        std::exponential_distribution<T> dis(1);
+        std::uniform_real_distribution<T> tail(-1, 1);
+
+        // Random sign, tail within half ulp of value
+        auto random = [&]() {
+            T v = dis(gen) * (tail(gen) < 0 ? -1 : 1);
+            return coupled<T>(v, v * L::epsilon() * tail(gen) / 2);
+        };
+
+        int errors = 0;
+
+        for (int n = 0; n < 1000; n++)
+        {
+            coupled<T> a[4][lenx];
+            for (int i = 0; i < lenx; i++)
+            {
+                for (int k = 0; k < 4; k++)
+                    a[k][i] = random();
+                // Cancel often: w close to x*y or to -x*y, and d is 1
+                if (n % 2) {
+                    T sign = n % 4 == 1 ? 1 : -1;
+                    a[2][i] = a[0][i] * a[1][i] * (sign + tail(gen) / 1024);
+                    a[3][i] = coupled<T>(1, 0);
+                }
+            }
+
+            coupled<TX> ax[4];
+            for (int k = 0; k < 4; k++)
+                ax[k] = loadx<coupled<TX>>(a[k]);
+            coupled<TX> zx = fx(ax[0], ax[1], ax[2], ax[3]);
+
+            for (int i = 0; i < lenx; i++)
+            {
+                coupled<T> z = f(a[0][i], a[1][i], a[2][i], a[3][i]);
+                coupled<T> zi = getx(zx, i);
+                if (zi.value != z.value || zi.error != z.error)
+                {
+                    if (errors++ < 25)
+                        printf("ERROR: type=%s op=%s iter=%d i=%d: vector=%g + %g "
+                               "scalar=%g + %g\n", type, op, n + 1, i,
+                               double(zi.value), double(zi.error),
+                               double(z.value), double(z.error));
+                    continue;
+                }
+
+                quad magnitude, e = r(exact(a[0][i]), exact(a[1][i]),
+                                      exact(a[2][i]), exact(a[3][i]), magnitude);
+                quad diff = tfcp_test::fabs_quad(exact(z) - e);
+                double bound = 4 * eps * eps * static_cast<double>(magnitude)
+                             + L::denorm_min();
+                bool renormalized = static_cast<T>(z.value + z.error) == z.value;
+                if (diff <= bound && renormalized)
+                    continue;
+                if (errors++ < 25)
+                    printf("ERROR: type=%s op=%s iter=%d i=%d: %.17g + %g "
+                           "error=%g bound=%g renormalized=%d\n", type, op,
+                           n + 1, i, double(z.value), double(z.error),
+                           static_cast<double>(diff), bound, renormalized);
+            }
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+
+#else
+
+    template<typename T, typename TX, typename F, typename FX, typename R>
+    static void test_case(const char type[], const char op[], F, FX, R)
+    {
+        printf("SKIP: type=%s op=%s no __float128 for reference\n", type, op);
+    }
+
+#endif
+};
+
+TEST_P(TestUnitTwofoldFused, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto op    = std::get<1>(param);
+
+#if defined(TFCP_TEST_QUAD)
+    using Q = tfcp_test::quad;
+#else
+    using Q = double;
+#endif
+    auto fabsq = [](Q x) { return x < 0 ? -x : x; };
+
+// Name D of lambdas' 4th parameter is empty if only 3 operands
+#define OP_CASE(T, TX, F, D, CALL, EXPR, MAGNITUDE)                             \
+    if (op == #F) {                                                             \
+        using S = const coupled<T>&;                                            \
+        using SX = const coupled<TX>&;                                          \
+        test_case<T, TX>(#T, #F,                                                \
+            [](S x, S y, S w, S D) { return CALL; },                            \
+            [](SX x, SX y, SX w, SX D) { return CALL; },                        \
+            [&](Q x, Q y, Q w, Q D, Q& m) { m = MAGNITUDE; return EXPR; });     \
+        return;                                                                 \
+    }
+
+#define TYPE_CASE(T, TX)                                                        \
+    if (type == #T) {                                                           \
+        OP_CASE(T, TX, fma, , fma(x, y, w), x*y + w, fabsq(x*y) + fabsq(w));    \
+        OP_CASE(T, TX, fms, , fms(x, y, w), x*y - w, fabsq(x*y) + fabsq(w));    \
+        OP_CASE(T, TX, sum3, , sum3(x, y, w), x + y + w,                        \
+                fabsq(x) + fabsq(y) + fabsq(w));                                \
+        OP_CASE(T, TX, dot2, d, dot2(x, y, w, d), x*y + w*d,                    \
+                fabsq(x*y) + fabsq(w*d));                                       \
+        FAIL() << "unknown op: " << op;                                         \
+    }
+
+    TYPE_CASE(float, floatx);
+    TYPE_CASE(double, doublex);
+
+#undef TYPE_CASE
+#undef OP_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesAndOps, TestUnitTwofoldFused,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("fma",
+                                        "fms",
+                                        "sum3",
+                                        "dot2")));
@@ -0,0 +1,204 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/twofold.h>
+#include <tfcp/basic.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <tuple>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test operators over twofold/coupled against the basic.h templates
+//
+// Operators must return exactly same bits as the underlying template,
+// e.g. twofold x + dotted y must equal tadd1(x0, x1, y0, z1)
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using ShapeName = std::string;
+using   OpName = std::string;
+
+using Params = typename std::tuple<TypeName, ShapeName, OpName>;
+
+class TestUnitTwofoldOps : public TestWithParam<Params> {
+protected:
+
+    // Compare actual result r vs expected e0 + e1
+    template<typename T>
+    static void check(int& errors, const shaped<T>& r, T e0, T e1,
+                      const char type[], const char shape[], const char op[],
+                      const char args[], int n)
+    {
+        if (r.value != e0 || r.error != e1)
+        {
+            if (errors++ < 25)
+            {
+                printf("ERROR: type=%s shape=%s op=%s args=%s iter=%d actual=%g + %g expected=%g + %g\n",
+                       type, shape, op, args, n + 1, r.value, r.error, e0, e1);
+            }
+        }
+    }
+
+    // S is twofold<T> or coupled<T>
+    template<typename T, typename S,
+             typename F, typename F1, typename F2, typename F0,
+             typename G, typename G1, typename G2, typename G0>
+    static void test_case(const char type[], const char shape[], const char op[],
+                          F f, F1 f1, F2 f2, F0 f0,  // operators
+                          G g, G1 g1, G2 g2, G0 g0)  // basic.h templates
+    {
+        std::mt19937 gen;
+        std::exponential_distribution<T> dis(1);
+
+        int errors = 0;
+
+        // repeat this test 1000 times
+        for (int n = 0; n < 1000; n++)
+        {
+            T x0 = dis(gen);
+            T x1 = dis(gen) * x0 / 1000000;
+            T y0 = dis(gen);
+            T y1 = dis(gen) * y0 / 1000000;
+
+            x0 = renormalize(x0, x1, x1);
+            y0 = renormalize(y0, y1, y1);
+
+            S x(x0, x1);
+            S y(y0, y1);
+
+            T e0, e1;
+
+            e0 = g(x0, x1, y0, y1, e1);
+            check(errors, f(x, y), e0, e1, type, shape, op, "xy", n);
+
+            e0 = g1(x0, x1, y0, e1);
+            check(errors, f1(x, y0), e0, e1, type, shape, op, "x0", n);
+
+            e0 = g2(x0, y0, y1, e1);
+            check(errors, f2(x0, y), e0, e1, type, shape, op, "0y", n);
+
+            e0 = g0(x0, y0, e1);
+            check(errors, f0(x0, y0), e0, e1, type, shape, op, "00", n);
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+
+    // S is twofold<T> or coupled<T>
+    template<typename T, typename S, typename F, typename G, typename G0>
+    static void test_sqrt(const char type[], const char shape[], const char op[],
+                          F f, G g, G0 g0)
+    {
+        std::mt19937 gen;
+        std::exponential_distribution<T> dis(1);
+
+        int errors = 0;
+
+        // repeat this test 1000 times
+        for (int n = 0; n < 1000; n++)
+        {
+            T x0 = dis(gen);
+            T x1 = dis(gen) * x0 / 1000000;
+
+            x0 = renormalize(x0, x1, x1);
+
+            T e0, e1;
+
+            e0 = g(x0, x1, e1);
+            check(errors, f(S(x0, x1)), e0, e1, type, shape, op, "x", n);
+
+            e0 = g0(x0, e1);
+            check(errors, f(S(x0, 0)), e0, e1, type, shape, op, "0", n);
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitTwofoldOps, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto shape = std::get<1>(param);
+    auto op    = std::get<2>(param);
+
+#define OP_CASE(T, S, P, OP, F)                                                    \
+    if (op == #F) {                                                                \
+        test_case<T, S<T>>(#T, #S, #F,                                             \
+            [](const S<T>& x, const S<T>& y) { return x OP y; },                   \
+            [](const S<T>& x,          T y) { return x OP y; },                    \
+            [](         T x, const S<T>& y) { return x OP y; },                    \
+            [](         T x,          T y) { return P ## F(x, y); },               \
+            [](T x0, T x1, T y0, T y1, T& z1) { return P ## F(x0, x1, y0, y1, z1); }, \
+            [](T x0, T x1, T y0,       T& z1) { return P ## F ## 1(x0, x1, y0, z1); }, \
+            [](T x0,       T y0, T y1, T& z1) { return P ## F ## 2(x0, y0, y1, z1); }, \
+            [](T x0,       T y0,       T& z1) { return P ## F ## 0(x0, y0, z1); });    \
+        return;                                                                    \
+    }
+
+#define SQRT_CASE(T, S, P)                                                         \
+    if (op == "sqrt") {                                                            \
+        test_sqrt<T, S<T>>(#T, #S, "sqrt",                                         \
+            [](const S<T>& x) { return sqrt(x); },                                 \
+            [](T x0, T x1, T& z1) { return P ## sqrt(x0, x1, z1); },               \
+            [](T x0,       T& z1) { return P ## sqrt0(x0, z1); });                 \
+        return;                                                                    \
+    }
+
+#define SHAPE_CASE(T, S, P)                 \
+    if (shape == #S) {                      \
+        OP_CASE(T, S, P, +, add);           \
+        OP_CASE(T, S, P, -, sub);           \
+        OP_CASE(T, S, P, *, mul);           \
+        OP_CASE(T, S, P, /, div);           \
+        SQRT_CASE(T, S, P);                 \
+        FAIL() << "unknown op: " << op;     \
+    }
+
+#define TYPE_CASE(T)                        \
+    if (type == #T) {                       \
+        SHAPE_CASE(T, twofold, t);          \
+        SHAPE_CASE(T, coupled, p);          \
+        FAIL() << "unknown shape: " << shape; \
+    }
+
+    TYPE_CASE(float);
+    TYPE_CASE(double);
+
+#undef TYPE_CASE
+#undef SHAPE_CASE
+#undef SQRT_CASE
+#undef OP_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesShapesAndOps, TestUnitTwofoldOps,
+                         Combine(Values("float",
+                                        "double"),
+                                 Values("twofold",
+                                        "coupled"),
+                                 Values("add",
+                                        "sub",
+                                        "mul",
+                                        "div",
+                                        "sqrt")));
@@ -0,0 +1,219 @@
+//======================================================================
+// 2020 (c) Evgeny Latkin
+// License: Apache 2.0 (http://www.apache.org/licenses/)
+//======================================================================
+
+#include <tfcp/twofoldx.h>
+#include <tfcp/twofold.h>
+#include <tfcp/simd.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <tuple>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+using namespace tfcp;
+
+using namespace testing;
+
+//----------------------------------------------------------------------
+//
+// Test short-vector twofold/coupled against scalar twofold/coupled
+//
+// Each position of the short-vector result must equal exactly the
+// result of same operation over scalar twofold or coupled
+//
+//----------------------------------------------------------------------
+
+using TypeName = std::string;
+using ShapeName = std::string;
+using   OpName = std::string;
+
+using Params = typename std::tuple<TypeName, ShapeName, OpName>;
+
+class TestUnitTwofoldxOps : public TestWithParam<Params> {
+protected:
+
+    // Compare actual r vs expected e
+    template<typename T>
+    static void check(int& errors, const shaped<T>& r, const shaped<T>& e,
+                      const char type[], const char shape[], const char op[],
+                      const char args[], int n, int i)
+    {
+        if (r.value != e.value || r.error != e.error)
+        {
+            if (errors++ < 25)
+            {
+                printf("ERROR: type=%s shape=%s op=%s args=%s iter=%d i=%d actual=%g + %g expected=%g + %g\n",
+                       type, shape, op, args, n + 1, i, r.value, r.error, e.value, e.error);
+            }
+        }
+    }
+
+    // S is twofold<T> or coupled<T>, and SX is twofold<TX> or coupled<TX>
+    template<typename T, typename TX, typename S, typename SX,
+             typename F, typename FX>
+    static void test_case(const char type[], const char shape[], const char op[],
+                          F f, FX fx)
+    {
+        static constexpr int lenx = traitx<TX>::length;
+
+        std::mt19937 gen;
+        std::exponential_distribution<T> dis(1);
+
+        int errors = 0;
+
+        // repeat this test 1000 times
+        for (int n = 0; n < 1000; n++)
+        {
+            T x0[lenx], x1[lenx], y0[lenx], y1[lenx];
+            for (int i = 0; i < lenx; i++)
+            {
+                x0[i] = dis(gen);
+                x1[i] = dis(gen) * x0[i] / 1000000;
+                y0[i] = dis(gen);
+                y1[i] = dis(gen) * y0[i] / 1000000;
+                x0[i] = renormalize(x0[i], x1[i], x1[i]);
+                y0[i] = renormalize(y0[i], y1[i], y1[i]);
+            }
+
+            SX x = loadx<SX>(x0, x1);
+            SX y = loadx<SX>(y0, y1);
+            T  t = y0[0];
+
+            SX rxy = fx(x, y);
+            SX rx0 = fx(x, y.value);
+            SX r0y = fx(x.value, y);
+            SX rxt = fx(x, t);
+
+            for (int i = 0; i < lenx; i++)
+            {
+                S xi(x0[i], x1[i]);
+                S yi(y0[i], y1[i]);
+                check(errors, getx(rxy, i), f(xi, yi), type, shape, op, "xy", n, i);
+                check(errors, getx(rx0, i), f(xi, y0[i]), type, shape, op, "x0", n, i);
+                check(errors, getx(r0y, i), f(x0[i], yi), type, shape, op, "0y", n, i);
+                check(errors, getx(rxt, i), f(xi, t), type, shape, op, "xt", n, i);
+            }
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+
+    // Round-trip via arrays of twofolds, and via values/errors arrays
+    template<typename T, typename TX, typename S, typename SX>
+    static void test_load(const char type[], const char shape[])
+    {
+        static constexpr int lenx = traitx<TX>::length;
+
+        std::mt19937 gen;
+        std::exponential_distribution<T> dis(1);
+
+        int errors = 0;
+
+        for (int n = 0; n < 100; n++)
+        {
+            S a[lenx], b[lenx];
+            T v[lenx], e[lenx];
+            for (int i = 0; i < lenx; i++)
+            {
+                a[i] = S(dis(gen), dis(gen) / 1000000);
+            }
+
+            SX x = loadx<SX>(a);
+            storex(v, e, x);
+            SX y = loadx<SX>(v, e);
+            setx(y, 0, getx(x, lenx - 1));
+            setx(y, lenx - 1, getx(x, 0));
+            storex(b, y);
+
+            for (int i = 0; i < lenx; i++)
+            {
+                int j = (i == 0 ? lenx - 1 : i == lenx - 1 ? 0 : i);
+                check(errors, b[i], a[j], type, shape, "load", "a", n, i);
+            }
+        }
+
+        ASSERT_EQ(errors, 0);
+    }
+};
+
+TEST_P(TestUnitTwofoldxOps, smoke) {
+    auto param = GetParam();
+    auto type  = std::get<0>(param);
+    auto shape = std::get<1>(param);
+    auto op    = std::get<2>(param);
+
+#define OP_CASE(T, TX, S, OP, F)                                                \
+    if (op == #F) {                                                             \
+        test_case<T, TX, S<T>, S<TX>>(#TX, #S, #F,                              \
+            [](const S<T>& x, const S<T>& y) { return S<T>(x OP y); },          \
+            [](const S<TX>& x, const S<TX>& y) { return x OP y; });             \
+        return;                                                                 \
+    }
+
+#define SQRT_CASE(T, TX, S)                                                     \
+    if (op == "sqrt") {                                                         \
+        test_case<T, TX, S<T>, S<TX>>(#TX, #S, "sqrt",                          \
+            [](const S<T>& x, const S<T>&) { return S<T>(sqrt(x)); },          \
+            [](const S<TX>& x, const S<TX>&) { return sqrt(x); });             \
+        return;                                                                 \
+    }
+
+#define LOAD_CASE(T, TX, S)                                                     \
+    if (op == "load") {                                                         \
+        test_load<T, TX, S<T>, S<TX>>(#TX, #S);                                 \
+        return;                                                                 \
+    }
+
+#define SHAPE_CASE(T, TX, S)                \
+    if (shape == #S) {                      \
+        OP_CASE(T, TX, S, +, add);          \
+        OP_CASE(T, TX, S, -, sub);          \
+        OP_CASE(T, TX, S, *, mul);          \
+        OP_CASE(T, TX, S, /, div);          \
+        SQRT_CASE(T, TX, S);                \
+        LOAD_CASE(T, TX, S);                \
+        FAIL() << "unknown op: " << op;     \
+    }
+
+#define TYPE_CASE(T, TX)                    \
+    if (type == #TX) {                      \
+        SHAPE_CASE(T, TX, twofold);         \
+        SHAPE_CASE(T, TX, coupled);         \
+        FAIL() << "unknown shape: " << shape; \
+    }
+
+    TYPE_CASE(float, floatx);
+    TYPE_CASE(double, doublex);
+
+#undef TYPE_CASE
+#undef SHAPE_CASE
+#undef LOAD_CASE
+#undef SQRT_CASE
+#undef OP_CASE
+
+    FAIL() << "unknown type: " << type;
+}
+
+//----------------------------------------------------------------------
+
+} // namespace
+
+INSTANTIATE_TEST_SUITE_P(typesShapesAndOps, TestUnitTwofoldxOps,
+                         Combine(Values("floatx",
+                                        "doublex"),
+                                 Values("twofold",
+                                        "coupled"),
+                                 Values("add",
+                                        "sub",
+                                        "mul",
+                                        "div",
+                                        "sqrt",
+                                        "load")));